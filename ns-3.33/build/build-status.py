@@ -0,0 +1,8 @@
+#! /usr/bin/env python3
+
+# Programs that are runnable.
+ns3_runnable_programs = ['build/src/applications/examples/ns3.33-three-gpp-http-example-debug', 'build/src/config-store/examples/ns3.33-config-store-save-debug', 'build/src/core/examples/ns3.33-main-callback-debug', 'build/src/core/examples/ns3.33-sample-simulator-debug', 'build/src/core/examples/ns3.33-bench-scheduler-debug', 'build/src/core/examples/ns3.33-main-ptr-debug', 'build/src/core/examples/ns3.33-main-random-variable-stream-debug', 'build/src/core/examples/ns3.33-sample-random-variable-debug', 'build/src/core/examples/ns3.33-sample-random-variable-stream-debug', 'build/src/core/examples/ns3.33-command-line-example-debug', 'build/src/core/examples/ns3.33-hash-example-debug', 'build/src/core/examples/ns3.33-sample-log-time-format-debug', 'build/src/core/examples/ns3.33-test-string-value-formatting-debug', 'build/src/core/examples/ns3.33-sample-show-progress-debug', 'build/src/core/examples/ns3.33-system-path-examples-debug', 'build/src/core/examples/ns3.33-fatal-example-debug', 'build/src/core/examples/ns3.33-main-test-sync-debug', 'build/src/core/examples/ns3.33-length-example-debug', 'build/src/internet/examples/ns3.33-main-simple-debug', 'build/src/network/examples/ns3.33-main-packet-header-debug', 'build/src/network/examples/ns3.33-main-packet-tag-debug', 'build/src/network/examples/ns3.33-packet-socket-apps-debug', 'build/src/network/examples/ns3.33-lollipop-comparisions-debug', 'build/src/network/examples/ns3.33-bench-rate-math-debug', 'build/src/network/examples/ns3.33-bench-queue-debug', 'build/src/point-to-point/examples/ns3.33-main-attribute-value-debug', 'build/src/point-to-point/examples/ns3.33-bench-multithreaded-simulator-debug', 'build/src/stats/examples/ns3.33-gnuplot-example-debug', 'build/src/stats/examples/ns3.33-double-probe-example-debug', 'build/src/stats/examples/ns3.33-time-probe-example-debug', 'build/src/stats/examples/ns3.33-gnuplot-aggregator-example-debug', 'build/src/stats/examples/ns3.33-gnuplot-helper-example-debug', 'build/src/stats/examples/ns3.33-file-aggregator-example-debug', 'build/src/stats/examples/ns3.33-file-helper-example-debug', 'build/src/traffic-control/examples/ns3.33-codel-vs-pfifo-basic-test-debug', 'build/src/traffic-control/examples/ns3.33-codel-vs-pfifo-asymmetric-debug', 'build/examples/tcp/ns3.33-tcp-large-transfer-debug', 'build/examples/tcp/ns3.33-tcp-nsc-lfn-debug', 'build/examples/tcp/ns3.33-tcp-star-server-debug', 'build/examples/tcp/ns3.33-tcp-bulk-send-debug', 'build/examples/tcp/ns3.33-tcp-pcap-nanosec-example-debug', 'build/examples/tcp/ns3.33-dctcp-example-debug', 'build/examples/tcp/ns3.33-tcp-linux-reno-debug', 'build/examples/tcp/ns3.33-bench-tcp-tracing-debug', 'build/examples/tcp/ns3.33-bench-header-serialization-debug', 'build/examples/tcp/ns3.33-bench-pcap-writer-debug', 'build/examples/routing/ns3.33-simple-alternate-routing-debug', 'build/examples/routing/ns3.33-simple-multicast-flooding-debug', 'build/examples/error-model/ns3.33-simple-error-model-debug', 'build/examples/tutorial/ns3.33-hello-simulator-debug', 'build/examples/tutorial/ns3.33-first-debug', 'build/examples/tutorial/ns3.33-fourth-debug', 'build/examples/tutorial/ns3.33-fifth-debug', 'build/examples/tutorial/ns3.33-sixth-debug', 'build/examples/tutorial/ns3.33-seventh-debug', 'build/examples/ipv6/ns3.33-test-ipv6-debug', 'build/examples/traffic-control/ns3.33-tbf-example-debug', 'build/examples/traffic-control/ns3.33-cobalt-vs-codel-debug', 'build/scratch/ns3.33-tcp-test-debug', 'build/scratch/ns3.33-zz-check-debug', 'build/scratch/ns3.33-tcp-dumbbell-sweep-debug', 'build/scratch/ns3.33-tcp-dumbbell-debug']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = ['sample-simulator.py', 'first.py']
+
@@ -0,0 +1,345 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "system-mutex.h"
+#include "nstime.h"
+#include "ptr.h"
+
+#include <atomic>
+#include <list>
+#include <set>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Conservative parallel simulator running on the threads of a
+ * single process.
+ *
+ * The event contexts (the node ids) are split into partitions, the
+ * logical processes, each with its own event list and clock.  The
+ * partitions are run by a pool of threads in windows of simulated time:
+ * every window starts at the earliest pending event and lasts one
+ * lookahead, the shortest delay of an event sent from one partition to
+ * another.  No event of a window can then be caused by an event of
+ * another partition in the same window, so the partitions run the
+ * window independently, and synchronize only at its end.
+ *
+ * Events scheduled for a context of another partition are put in a
+ * mailbox, an array written by the sending partition only, which the
+ * receiving partition moves to its event list at the start of the next
+ * window.  The mailboxes are read in partition order, so the results
+ * do not depend on the number of threads nor on their timing.
+ *
+ * The partitioning and the lookahead are set with SetPartition() and
+ * SetLookahead() before the simulation starts;
+ * PointToPointPartitionHelper computes both for point to point
+ * topologies.  The events without a context, and the contexts which
+ * are not assigned, belong to partition 0.
+ *
+ * The events of a partition must only touch the objects of the
+ * partition, and the objects shared by all of them must not be
+ * modified during the simulation.  Events sent to another partition
+ * must be scheduled at least one lookahead in the future.
+ *
+ * Compared to DefaultSimulatorImpl:
+ * - Stop(const Time&) runs the events scheduled at the stop time;
+ * - a Stop() called from an event takes effect at once in its own
+ *   partition, but the other partitions may run up to the end of the
+ *   current window, one lookahead further; so does a Stop(const Time&)
+ *   shorter than the lookahead;
+ * - an event of another partition is cancelled, and not removed, by
+ *   Remove(); the cancellation is delivered as an event sent to the
+ *   partition, at the start of the next window, so the event still runs
+ *   if it is due less than one lookahead later;
+ * - IsExpired() called from an event, for an event of another
+ *   partition, only tells whether the clock of the calling partition
+ *   passed the event time;
+ * - GetEventCount() and the event list counts called from an event
+ *   cover the partition of the event only.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+  virtual uint64_t GetLiveEventCount (void) const;
+  virtual uint64_t GetCancelledEventCount (void) const;
+  virtual uint64_t GetPeakEventCount (void) const;
+
+  /**
+   * \brief Assign a context to a partition.
+   *
+   * This can only be done before the simulation is first run.
+   *
+   * \param [in] context The context, usually a node id.
+   * \param [in] partition The partition.
+   */
+  void SetPartition (uint32_t context, uint32_t partition);
+  /**
+   * \param [in] context The context.
+   * \returns The partition of the context.
+   */
+  uint32_t GetPartition (uint32_t context) const;
+  /** \returns The number of partitions. */
+  uint32_t GetPartitionCount (void) const;
+  /**
+   * \brief Set the lookahead of the simulation.
+   *
+   * This is the shortest delay of the events sent from one partition
+   * to another, for example the smallest propagation delay of the
+   * links between them.  It must be positive when there are several
+   * partitions.
+   *
+   * \param [in] lookahead The lookahead.
+   */
+  void SetLookahead (const Time &lookahead);
+  /** \returns The lookahead. */
+  Time GetLookahead (void) const;
+  /**
+   * \brief Get the number of windows run so far.
+   *
+   * This is the number of times the partitions synchronized; the
+   * ratio of events to windows tells how much parallel work each
+   * synchronization pays for.
+   *
+   * \returns The number of windows.
+   */
+  uint64_t GetWindowCount (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** The state of a partition. */
+  struct LogicalProcess
+  {
+    /** The event list. */
+    Ptr<Scheduler> events;
+    /** Index of the partition. */
+    uint32_t index;
+    /** Next event unique id. */
+    uint32_t uid;
+    /** Unique id of the current event. */
+    uint32_t currentUid;
+    /** Timestamp of the current event. */
+    uint64_t currentTs;
+    /** Execution context of the current event. */
+    uint32_t currentContext;
+    /** The event count. */
+    uint64_t eventCount;
+    /** Number of events in the event list. */
+    int unscheduledEvents;
+    /** Number of events cancelled through Cancel() still in the event list. */
+    uint64_t cancelledEvents;
+    /** Largest size of the event list. */
+    uint64_t peakEvents;
+    /**
+     * Timestamp of the earliest event of the partition after the
+     * current window, including the events it sent to others.
+     */
+    uint64_t nextTs;
+    /**
+     * Events sent to the other partitions, indexed by window parity
+     * and by destination partition.
+     */
+    std::vector<std::vector<Scheduler::Event> > outbox[2];
+    /**
+     * Events of the other partitions to cancel, indexed as the outbox.
+     * The events are not referenced: they wait in the event list of
+     * their partition until the cancellation is delivered.
+     */
+    std::vector<std::vector<Scheduler::Event> > cancelbox[2];
+    /** Stop() was called by an event of the current window. */
+    bool stopped;
+    /** Earliest stop time set by an event of the current window. */
+    uint64_t stopTs;
+  };
+
+  /**
+   * Create the partitions up to the given count.
+   * \param [in] count The number of partitions needed.
+   */
+  void AddPartitions (uint32_t count);
+  /**
+   * \param [in] context The event context.
+   * \returns The partition running the context.
+   */
+  LogicalProcess * GetLogicalProcess (uint32_t context) const;
+  /**
+   * \returns The partition of the calling event, or 0 when called
+   * out of the simulation threads.
+   */
+  LogicalProcess * GetCurrentLogicalProcess (void) const;
+  /**
+   * Insert an event in the event list of a partition.
+   * \param [in] lp The partition.
+   * \param [in] ev The event.
+   */
+  void Insert (LogicalProcess *lp, const Scheduler::Event &ev);
+  /**
+   * Move the events of the contexts assigned since the last run to
+   * their partition.
+   */
+  void Redistribute (void);
+  /**
+   * Move the events sent to a partition during the previous window to
+   * its event list.
+   * \param [in] lp The partition.
+   * \param [in] parity The parity of the window the events were sent in.
+   */
+  void DrainMailboxes (LogicalProcess *lp, uint32_t parity);
+  /**
+   * Send the cancellation of an event to the partition running it.
+   * \param [in] lp The partition of the calling event.
+   * \param [in] target The partition of the event.
+   * \param [in] id The event.
+   */
+  void PostCancel (LogicalProcess *lp, LogicalProcess *target, const EventId &id);
+  /**
+   * Run the events of a partition up to the end of the current window.
+   * \param [in] lp The partition.
+   */
+  void ProcessWindow (LogicalProcess *lp);
+  /**
+   * Process the next event of a partition.
+   * \param [in] lp The partition.
+   */
+  void ProcessOneEvent (LogicalProcess *lp);
+  /**
+   * Compute the next window from the partition states, or decide that
+   * the run is over.  Called by the last thread reaching the barrier.
+   */
+  void PlanWindow (void);
+  /**
+   * Wait for all the threads at the end of a window.
+   * \param [in,out] sense The barrier phase of the calling thread.
+   */
+  void Barrier (bool &sense);
+  /**
+   * Body of the simulation threads, the main one included.
+   */
+  void Work (void);
+  /**
+   * \returns The earliest pending stop time.
+   */
+  uint64_t GetStopTime (void) const;
+
+  /** The partitions. */
+  std::vector<LogicalProcess *> m_lps;
+  /** Partition of each context. */
+  std::vector<uint32_t> m_partition;
+  /** The contexts were moved to other partitions since the last run. */
+  bool m_repartitioned;
+  /** The simulation was run at least once. */
+  bool m_started;
+  /** The scheduler factory, to create the event lists. */
+  ObjectFactory m_schedulerFactory;
+  /** The lookahead, in time steps. */
+  uint64_t m_lookahead;
+  /** Number of threads requested; zero means one per core. */
+  uint32_t m_threadCount;
+
+  /** Number of threads running the current simulation. */
+  uint32_t m_threads;
+  /** Next partition to be run in the current window. */
+  std::atomic<uint32_t> m_nextLp;
+  /** Threads still to reach the barrier. */
+  std::atomic<uint32_t> m_barrierCount;
+  /** Phase of the barrier. */
+  std::atomic<bool> m_barrierSense;
+  /** Index of the current window. */
+  uint64_t m_window;
+  /** End of the current window, excluded. */
+  uint64_t m_windowEnd;
+  /** The run is over. */
+  bool m_done;
+  /** The stop time which ended the run, if any. */
+  uint64_t m_stopReached;
+
+  /** Flag calling for the end of the simulation. */
+  std::atomic<bool> m_stop;
+  /** The earliest of m_stopTimes, or the largest time. */
+  std::atomic<uint64_t> m_stopTime;
+  /** The times set by Stop(const Time&), not reached yet. */
+  std::multiset<uint64_t> m_stopTimes;
+  /** Mutex to control access to the stop times. */
+  SystemMutex m_stopMutex;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Mutex to control access to the destroy events. */
+  mutable SystemMutex m_destroyMutex;
+
+  /** Next event unique id, for the events scheduled out of a run. */
+  uint32_t m_uid;
+  /** Simulation time out of a run. */
+  uint64_t m_currentTs;
+  /** Number of windows run. */
+  uint64_t m_windowCount;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,73 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef PACING_RATE_TAG_H
+#define PACING_RATE_TAG_H
+
+#include "ns3/tag.h"
+#include "ns3/data-rate.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Packet tag carrying the pacing rate of the sending socket.
+ *
+ * This is the ns-3 counterpart of the Linux sk_pacing_rate, which a
+ * pacing queue disc (e.g., FqQueueDisc) reads from the socket owning
+ * the packet.
+ */
+class PacingRateTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+  PacingRateTag ();
+  /**
+   * \brief Constructs a PacingRateTag with the given pacing rate
+   * \param rate the pacing rate of the sender
+   */
+  PacingRateTag (DataRate rate);
+  /**
+   * \brief Set the pacing rate
+   * \param rate the pacing rate of the sender
+   */
+  void SetPacingRate (DataRate rate);
+  /**
+   * \brief Get the pacing rate
+   * \returns the pacing rate of the sender
+   */
+  DataRate GetPacingRate (void) const;
+private:
+  DataRate m_rate; //!< Pacing rate
+};
+
+} // namespace ns3
+
+#endif /* PACING_RATE_TAG_H */
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef PCAP_CAPTURE_FILTER_H
+#define PCAP_CAPTURE_FILTER_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Selection of the packets written to a pcap file.
+ *
+ * A packet is captured when it falls in one of the time windows, belongs
+ * to one of the flows and to a sampled flow; the criteria which are not
+ * set accept every packet.  Captured packets may further be truncated to
+ * their headers with SetSnapLength ().
+ *
+ * Flows are identified by the IPv4 5-tuple read from the first bytes of
+ * the frame, without copying or parsing the whole packet, for the PPP,
+ * Ethernet and raw IP data link types.  A flow matches the packets of
+ * both directions.  When flows or sampling are set, the packets without
+ * an IPv4 header are not captured.
+ *
+ * A filter is given to PcapFileWrapper through its CaptureFilter
+ * attribute, or to the device helpers with
+ * PcapHelperForDevice::SetCaptureFilter ().
+ */
+class PcapCaptureFilter : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /** Bytes of a frame which hold all the headers read by the filter */
+  static const uint32_t MAX_HEADER_BYTES = 80;
+
+  PcapCaptureFilter ();
+  virtual ~PcapCaptureFilter ();
+
+  /**
+   * \brief Truncate the captured packets
+   * \param snapLen the bytes kept from the start of each frame; 0 keeps
+   *        the snap length of the file
+   */
+  void SetSnapLength (uint32_t snapLen);
+  /**
+   * \returns the bytes kept from the start of each frame, 0 if not set
+   */
+  uint32_t GetSnapLength (void) const;
+  /**
+   * \brief Capture the packets of a flow.
+   *
+   * The any address and zero ports or protocol are wildcards.
+   *
+   * \param src the source address
+   * \param dst the destination address
+   * \param protocol the IP protocol number
+   * \param srcPort the TCP or UDP source port
+   * \param dstPort the TCP or UDP destination port
+   */
+  void AddFlow (Ipv4Address src, Ipv4Address dst, uint8_t protocol = 0,
+                uint16_t srcPort = 0, uint16_t dstPort = 0);
+  /**
+   * \brief Capture one flow in k, chosen by the hash of its 5-tuple
+   * \param k the sampling ratio; 0 and 1 capture every flow
+   */
+  void SetFlowSampling (uint32_t k);
+  /**
+   * \brief Capture the packets sent in [start, stop)
+   * \param start the start of the window
+   * \param stop the end of the window
+   */
+  void AddTimeWindow (Time start, Time stop);
+
+  /**
+   * \param t the time of the packet
+   * \returns false if no packet is captured at this time
+   */
+  bool IsCapturedAt (Time t) const;
+  /**
+   * \returns true if IsFlowCaptured () needs to read the frame
+   */
+  bool IsFlowFiltered (void) const;
+  /**
+   * \param dataLinkType the data link type of the frame, as in
+   *        PcapHelper::DataLinkType
+   * \param frame the first bytes of the frame
+   * \param size the number of bytes, at most MAX_HEADER_BYTES are read
+   * \returns true if the flow of the frame is captured
+   */
+  bool IsFlowCaptured (uint32_t dataLinkType, uint8_t const *frame, uint32_t size) const;
+
+private:
+  /** A flow, with wildcards */
+  struct Flow
+  {
+    Ipv4Address src;   //!< Source address
+    Ipv4Address dst;   //!< Destination address
+    uint8_t protocol;  //!< IP protocol number
+    uint16_t srcPort;  //!< Source port
+    uint16_t dstPort;  //!< Destination port
+  };
+
+  /**
+   * \param flow the filter
+   * \param src the source address of the packet
+   * \param dst the destination address of the packet
+   * \param protocol the IP protocol number of the packet
+   * \param srcPort the source port of the packet
+   * \param dstPort the destination port of the packet
+   * \returns true if the packet belongs to the flow, in one direction
+   */
+  static bool Matches (Flow const &flow, Ipv4Address src, Ipv4Address dst, uint8_t protocol,
+                       uint16_t srcPort, uint16_t dstPort);
+
+  uint32_t m_snapLen;                                //!< Bytes kept, 0 if not set
+  std::vector<Flow> m_flows;                         //!< Captured flows
+  uint32_t m_sampling;                               //!< One flow in m_sampling
+  std::vector<std::pair<Time, Time> > m_windows;     //!< Capture windows
+};
+
+} // namespace ns3
+
+#endif /* PCAP_CAPTURE_FILTER_H */
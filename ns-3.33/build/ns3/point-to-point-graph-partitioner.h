@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef POINT_TO_POINT_GRAPH_PARTITIONER_H
+#define POINT_TO_POINT_GRAPH_PARTITIONER_H
+
+#include <vector>
+
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+class PointToPointHelper;
+
+/**
+ * \brief Split a graph of point to point links into the partitions of
+ * a parallel simulation.
+ *
+ * The graph holds weighted nodes, a rough measure of their work, and
+ * links with a propagation delay and an expected traffic.  Partition()
+ * looks for a balanced cut in three steps:
+ *
+ *  - The lookahead of a parallel simulation is the smallest delay of
+ *    the links it cuts, so the nodes joined by links shorter than a
+ *    threshold are kept together; the threshold is the largest delay
+ *    which still leaves enough groups of nodes.
+ *  - The groups are visited breadth first, which keeps neighbours
+ *    together, and dealt to the partitions in turn so that each gets
+ *    the same share of the node weights.
+ *  - Groups at the border of two partitions are then moved while this
+ *    lowers the traffic across the cut, as long as no partition gets
+ *    heavier than the mean load times (1 + imbalance).
+ *
+ * The graph is described before the simulation is built, so that the
+ * nodes can be created with their partition as system id, which is
+ * what DistributedSimulatorImpl and NullMessageSimulatorImpl need:
+ *
+ * \code
+ *   PointToPointGraphPartitioner graph;
+ *   uint32_t a = graph.AddNode ();
+ *   uint32_t b = graph.AddNode ();
+ *   uint32_t link = graph.AddLink (a, b, MilliSeconds (10));
+ *   graph.Partition (MpiInterface::GetSize ());
+ *   NodeContainer nodes = graph.CreateNodes ();
+ *   graph.InstallLink (link, p2p, nodes);
+ * \endcode
+ *
+ * PointToPointHelper then installs a PointToPointRemoteChannel on each
+ * link between two system ids.
+ */
+class PointToPointGraphPartitioner
+{
+public:
+  PointToPointGraphPartitioner ();
+
+  /**
+   * \brief Add a node to the graph.
+   *
+   * \param weight the work of the node, e.g. its number of devices
+   * \returns the index of the node
+   */
+  uint32_t AddNode (uint32_t weight = 1);
+
+  /**
+   * \brief Add a point to point link to the graph.
+   *
+   * \param a the index of one end
+   * \param b the index of the other end
+   * \param delay the propagation delay of the link
+   * \param traffic the expected traffic on the link, in any unit shared
+   *        by all the links, e.g. Mb/s
+   * \returns the index of the link
+   */
+  uint32_t AddLink (uint32_t a, uint32_t b, Time delay, double traffic = 1);
+
+  /**
+   * \param imbalance the load allowed above the mean, as a fraction of
+   *        the mean load; 0.1 by default
+   */
+  void SetImbalance (double imbalance);
+
+  /**
+   * \brief Compute the partitions.
+   *
+   * \param partitions the number of partitions wanted
+   * \returns the number of partitions made, which is smaller when the
+   *          graph cannot be cut in that many pieces; they are numbered
+   *          from 0
+   */
+  uint32_t Partition (uint32_t partitions);
+
+  /**
+   * \returns the number of nodes of the graph
+   */
+  uint32_t GetNNodes (void) const;
+
+  /**
+   * \returns the number of links of the graph
+   */
+  uint32_t GetNLinks (void) const;
+
+  /**
+   * \param node the index of a node
+   * \returns the partition of the node
+   */
+  uint32_t GetPartition (uint32_t node) const;
+
+  /**
+   * \param link the index of a link
+   * \returns true if the ends of the link are in different partitions
+   */
+  bool IsCut (uint32_t link) const;
+
+  /**
+   * \returns the lookahead, the smallest delay of the links cut, or
+   *          zero if no link is cut
+   */
+  Time GetLookahead (void) const;
+
+  /**
+   * \returns the number of links between different partitions
+   */
+  uint32_t GetCutLinkCount (void) const;
+
+  /**
+   * \returns the expected traffic of the links between different partitions
+   */
+  double GetCutTraffic (void) const;
+
+  /**
+   * \brief Create one node per node of the graph, in index order, with
+   * its partition as system id.
+   *
+   * \returns the nodes
+   */
+  NodeContainer CreateNodes (void) const;
+
+  /**
+   * \brief Install a link of the graph, with its delay.
+   *
+   * \param link the index of the link
+   * \param helper the helper configured for the link; the channel
+   *        "Delay" attribute of a copy is set to the delay of the link
+   * \param nodes the nodes made by CreateNodes()
+   * \returns the devices, the one of the first end first
+   */
+  NetDeviceContainer InstallLink (uint32_t link, const PointToPointHelper &helper, const NodeContainer &nodes) const;
+
+private:
+  /** A link of the graph. */
+  struct Link
+  {
+    uint32_t a;     //!< Index of one end
+    uint32_t b;     //!< Index of the other end
+    int64_t delay;  //!< Propagation delay, in time steps
+    double traffic; //!< Expected traffic
+  };
+
+  std::vector<uint32_t> m_weight;    //!< Weight of each node
+  std::vector<Link> m_links;         //!< The links
+  std::vector<uint32_t> m_partition; //!< Partition of each node
+  double m_imbalance;                //!< Load allowed above the mean
+  Time m_lookahead;                  //!< Smallest delay of the links cut
+  uint32_t m_cutLinks;               //!< Number of links cut
+  double m_cutTraffic;               //!< Traffic of the links cut
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_GRAPH_PARTITIONER_H */
@@ -0,0 +1,16 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_POINT_TO_POINT
+    
+
+// Module headers:
+#include "point-to-point-channel.h"
+#include "point-to-point-graph-partitioner.h"
+#include "point-to-point-helper.h"
+#include "point-to-point-net-device.h"
+#include "point-to-point-partition-helper.h"
+#include "ppp-header.h"
+#endif
@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef POINT_TO_POINT_PARTITION_HELPER_H
+#define POINT_TO_POINT_PARTITION_HELPER_H
+
+#include <vector>
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+class Node;
+
+/**
+ * \brief Split a point to point topology into the partitions of a
+ * MultithreadedSimulatorImpl.
+ *
+ * The partitions only exchange packets through point to point links,
+ * and the lookahead of the simulation is the smallest delay of the
+ * links they cut.  The helper builds the graph of the point to point
+ * channels, with the number of devices of each node as its weight,
+ * and splits it with PointToPointGraphPartitioner, which favors
+ * cutting the long links.
+ *
+ * Install() configures the simulator: the partition of every node,
+ * the lookahead, and the channels crossing partitions.  It must be
+ * called once the topology is built and before the simulation runs,
+ * with ns3::MultithreadedSimulatorImpl as SimulatorImplementationType.
+ */
+class PointToPointPartitionHelper
+{
+public:
+  PointToPointPartitionHelper ();
+
+  /**
+   * \brief Partition all the nodes of the simulation.
+   *
+   * \param partitions the number of partitions wanted
+   * \returns the number of partitions made, which is smaller when the
+   *          topology cannot be cut in that many pieces
+   */
+  uint32_t Install (uint32_t partitions);
+
+  /**
+   * \brief Partition a set of nodes.
+   *
+   * The other nodes are left in partition 0.
+   *
+   * \param nodes the nodes to partition
+   * \param partitions the number of partitions wanted
+   * \returns the number of partitions made
+   */
+  uint32_t Install (NodeContainer nodes, uint32_t partitions);
+
+  /**
+   * \param node a node
+   * \returns the partition of the node
+   */
+  uint32_t GetPartition (Ptr<Node> node) const;
+
+  /**
+   * \returns the lookahead, the smallest delay of the links cut, or
+   *          zero if no link is cut
+   */
+  Time GetLookahead (void) const;
+
+  /**
+   * \returns the number of links between different partitions
+   */
+  uint32_t GetCutLinkCount (void) const;
+
+private:
+  std::vector<uint32_t> m_partition; //!< Partition of each node, by node id
+  Time m_lookahead;                  //!< Smallest delay of the links cut
+  uint32_t m_cutLinks;               //!< Number of links cut
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_PARTITION_HELPER_H */
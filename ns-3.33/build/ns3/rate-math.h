@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef RATE_MATH_H
+#define RATE_MATH_H
+
+#include "ns3/core-config.h"
+#include "ns3/nstime.h"
+#include "ns3/int64x64.h"
+#include "ns3/assert.h"
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup datarate
+ * Integer fixed point arithmetic between byte counts, times and rates.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup datarate
+ *
+ * \brief Integer-only conversions between bytes, Time and bit rates.
+ *
+ * Multiplying a DataRate by a Time, or building a Time from a number of
+ * seconds, goes through double and int64x64_t conversions.  The helpers
+ * below only use integer arithmetic on the time steps of the current
+ * Time resolution, with a 128 bit intermediate product when the
+ * compiler has one.  The results are rounded down.
+ *
+ * Gains are fixed point numbers, as in Linux BBR: a gain of \c g / 2^scale,
+ * with a scale of BBR_SCALE (1/256 units) or FINE_GAIN_SCALE (1/1024 units).
+ */
+namespace RateMath {
+
+/** The scale of the gains of Linux BBR: a gain of BBR_UNIT is 1. */
+const uint32_t BBR_SCALE = 8;
+/** A gain of one, with BBR_SCALE. */
+const uint32_t BBR_UNIT = 1 << BBR_SCALE;
+/** A finer gain scale, in 1/1024 units. */
+const uint32_t FINE_GAIN_SCALE = 10;
+
+/**
+ * \brief Compute a * b / c, rounded down.
+ * \param a first factor
+ * \param b second factor
+ * \param c divisor, not zero
+ * \returns the quotient, which must fit in 64 bits
+ */
+inline uint64_t
+MulDiv (uint64_t a, uint64_t b, uint64_t c)
+{
+  NS_ASSERT (c != 0);
+#if defined (HAVE___UINT128_T)
+  return static_cast<uint64_t> ((static_cast<unsigned __int128> (a) * b) / c);
+#else
+  int64x64_t q = int64x64_t (static_cast<int64_t> (a)) * static_cast<int64_t> (b);
+  q /= int64x64_t (static_cast<int64_t> (c));
+  return static_cast<uint64_t> (q.GetHigh ());
+#endif
+}
+
+/**
+ * \brief Get the number of Time steps in one second.
+ * \returns the steps per second at the current resolution
+ */
+inline uint64_t
+TicksPerSecond (void)
+{
+  switch (Time::GetResolution ())
+    {
+    case Time::S:
+      return 1;
+    case Time::MS:
+      return 1000;
+    case Time::US:
+      return 1000000;
+    case Time::NS:
+      return 1000000000;
+    case Time::PS:
+      return 1000000000000;
+    case Time::FS:
+      return 1000000000000000;
+    default:
+      NS_ASSERT_MSG (false, "Time resolution coarser than a second");
+      return 1;
+    }
+}
+
+/**
+ * \brief Time needed to send bytes at a rate.
+ * \param bytes the number of bytes
+ * \param bps the rate in bit/s, not zero
+ * \returns bytes * 8 / bps
+ */
+inline Time
+TxTime (uint64_t bytes, uint64_t bps)
+{
+  return Time (static_cast<int64_t> (MulDiv (bytes * 8, TicksPerSecond (), bps)));
+}
+
+/**
+ * \brief Rate of bytes delivered over an interval.
+ * \param bytes the number of bytes
+ * \param interval the interval, positive
+ * \returns bytes * 8 / interval, in bit/s
+ */
+inline uint64_t
+Rate (uint64_t bytes, const Time &interval)
+{
+  NS_ASSERT (interval.IsStrictlyPositive ());
+  return MulDiv (bytes * 8, TicksPerSecond (), static_cast<uint64_t> (interval.GetTimeStep ()));
+}
+
+/**
+ * \brief Bytes sent at a rate during an interval, e.g. a bandwidth-delay
+ * product.
+ * \param bps the rate in bit/s
+ * \param interval the interval, not negative
+ * \returns bps * interval / 8
+ */
+inline uint64_t
+Bytes (uint64_t bps, const Time &interval)
+{
+  NS_ASSERT (!interval.IsStrictlyNegative ());
+  return MulDiv (bps, static_cast<uint64_t> (interval.GetTimeStep ()), 8 * TicksPerSecond ());
+}
+
+/**
+ * \brief Convert a gain to fixed point.
+ * \param gain the gain
+ * \param scale the fixed point scale
+ * \returns gain * 2^scale, rounded to the nearest unit
+ */
+inline uint32_t
+GainToUnits (double gain, uint32_t scale = BBR_SCALE)
+{
+  NS_ASSERT (gain >= 0);
+  return static_cast<uint32_t> (gain * (1 << scale) + 0.5);
+}
+
+/**
+ * \brief Multiply a value, e.g. a rate, by a fixed point gain.
+ * \param value the value
+ * \param gain the gain, in 1/2^scale units
+ * \param scale the fixed point scale
+ * \returns value * gain / 2^scale
+ */
+inline uint64_t
+ApplyGain (uint64_t value, uint32_t gain, uint32_t scale = BBR_SCALE)
+{
+#if defined (HAVE___UINT128_T)
+  return static_cast<uint64_t> ((static_cast<unsigned __int128> (value) * gain) >> scale);
+#else
+  return MulDiv (value, gain, static_cast<uint64_t> (1) << scale);
+#endif
+}
+
+} // namespace RateMath
+
+/**
+ * \ingroup datarate
+ *
+ * \brief Transmission times at a fixed rate, without a division.
+ *
+ * The reciprocal of the rate is computed once, as a 64 bit multiplier m
+ * and a shift s, so that bytes * m >> s is exactly
+ * RateMath::TxTime (bytes, rate) for all the byte counts a link may
+ * send at once.  The larger counts fall back to the division.
+ *
+ * The reciprocal depends on the Time resolution: it must be computed
+ * after Time::SetResolution is called.
+ */
+class RateReciprocal
+{
+public:
+  RateReciprocal ();
+  /**
+   * \brief Precompute the reciprocal of a rate.
+   * \param bps the rate in bit/s, not zero
+   */
+  explicit RateReciprocal (uint64_t bps);
+  /**
+   * \brief Precompute the reciprocal of a new rate.
+   * \param bps the rate in bit/s, not zero
+   */
+  void SetBitRate (uint64_t bps);
+  /**
+   * \brief Get the rate.
+   * \returns the rate in bit/s, 0 if none was set
+   */
+  uint64_t GetBitRate (void) const
+  {
+    return m_bps;
+  }
+  /**
+   * \brief Time needed to send bytes at the rate.
+   * \param bytes the number of bytes
+   * \returns bytes * 8 / rate, rounded down
+   */
+  Time TxTime (uint64_t bytes) const
+  {
+    NS_ASSERT (m_bps != 0);
+#if defined (HAVE___UINT128_T)
+    if (bytes <= m_maxBytes)
+      {
+        return Time (static_cast<int64_t> ((static_cast<unsigned __int128> (bytes) * m_multiplier) >> m_shift));
+      }
+#endif
+    return RateMath::TxTime (bytes, m_bps);
+  }
+
+private:
+  uint64_t m_bps;        //!< The rate, in bit/s
+  uint64_t m_multiplier; //!< Scaled reciprocal of the rate
+  uint32_t m_shift;      //!< Scale of m_multiplier
+  uint64_t m_maxBytes;   //!< Largest exact byte count
+};
+
+} // namespace ns3
+
+#endif /* RATE_MATH_H */
@@ -0,0 +1,15 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_TCP_CLIENT
+    
+
+// Module headers:
+#include "tcp-client.h"
+#include "tcp-server.h"
+#include "tcp-sink.h"
+#include "tcp-tracer.h"
+#include "tcp-utils.h"
+#endif
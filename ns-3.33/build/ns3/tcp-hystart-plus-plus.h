@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef TCP_HYSTART_PLUS_PLUS_H
+#define TCP_HYSTART_PLUS_PLUS_H
+
+#include "ns3/tcp-slow-start.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup slowStart
+ *
+ * \brief HyStart++ slow start (RFC 9406)
+ *
+ * The algorithm tracks the minimum RTT observed in each RTT round. When it
+ * grows by more than a threshold (an eighth of the previous round minimum,
+ * between 4 and 16 ms) the path queue is building up, and slow start moves
+ * to Conservative Slow Start (CSS): the window grows a quarter as fast.
+ * If the RTT comes back to the baseline, the increase was spurious and
+ * slow start resumes; after CssRounds rounds in CSS, slow start ends by
+ * setting ssThresh to cWnd.
+ *
+ * A round ends when the segment acked was sent after the delivery of the
+ * data acked at the start of the round, using the delivered counters of
+ * the connection rate (as BBR counts its rounds). HyStart++ only runs in
+ * the initial slow start: once ssThresh changes, or the window reaches it,
+ * the classic growth applies.
+ *
+ * When the connection is not paced, the window growth per ACK is limited
+ * to AckLimit segments to avoid bursts from stretch ACKs.
+ */
+class TcpHyStartPlusPlus : public TcpSlowStart
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Constructor
+   */
+  TcpHyStartPlusPlus ();
+
+  /**
+   * \brief Copy constructor.
+   * \param other object to copy.
+   */
+  TcpHyStartPlusPlus (const TcpHyStartPlusPlus &other);
+
+  /**
+   * \brief Deconstructor
+   */
+  virtual ~TcpHyStartPlusPlus () override;
+
+  virtual std::string GetName () const override;
+
+  virtual void PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                          const Time &rtt, const TcpRateOps::TcpRateConnection &rc) override;
+
+  virtual uint32_t GetCwndIncrease (Ptr<const TcpSocketState> tcb, uint32_t segmentsAcked) override;
+
+  virtual Ptr<TcpSlowStart> Fork () override;
+
+  /**
+   * \brief Is the algorithm in Conservative Slow Start?
+   * \return true in CSS
+   */
+  bool InCss (void) const;
+
+  /**
+   * \brief Has the algorithm finished?
+   * \return true once the initial slow start is over
+   */
+  bool IsDone (void) const;
+
+private:
+  /**
+   * \brief Start a new RTT round
+   * \param rc rate information of the connection
+   */
+  void StartRound (const TcpRateOps::TcpRateConnection &rc);
+
+  // Attributes
+  Time m_minRttThresh;        //!< Lower bound of the RTT increase threshold
+  Time m_maxRttThresh;        //!< Upper bound of the RTT increase threshold
+  uint32_t m_minRttDivisor;   //!< Fraction of the last round min RTT used as threshold
+  uint32_t m_nRttSample;      //!< RTT samples needed in a round before checking
+  uint32_t m_cssGrowthDivisor; //!< Window growth divisor in CSS
+  uint32_t m_cssRounds;       //!< Rounds in CSS before leaving slow start
+  uint32_t m_ackLimit;        //!< Maximum growth per ACK, in segments (0: none)
+
+  // State
+  bool m_done {false};                     //!< Initial slow start is over
+  bool m_started {false};                  //!< First ACK seen
+  uint32_t m_initialSsThresh {0};          //!< ssThresh when the algorithm started
+  uint64_t m_roundEndDelivered {0};        //!< Delivered count ending the current round
+  Time m_lastRoundMinRtt {Time::Max ()};   //!< Minimum RTT of the previous round
+  Time m_currentRoundMinRtt {Time::Max ()}; //!< Minimum RTT of the current round
+  uint32_t m_rttSampleCount {0};           //!< RTT samples in the current round
+  Time m_cssBaselineMinRtt {Time::Max ()}; //!< Round min RTT when CSS started
+  bool m_inCss {false};                    //!< In Conservative Slow Start
+  uint32_t m_cssRoundCount {0};            //!< Rounds spent in CSS
+  uint32_t m_cssBytes {0};                 //!< Growth not yet applied in CSS
+};
+
+} // namespace ns3
+
+#endif /* TCP_HYSTART_PLUS_PLUS_H */
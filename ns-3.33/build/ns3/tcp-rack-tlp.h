@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef TCP_RACK_TLP_H
+#define TCP_RACK_TLP_H
+
+#include "ns3/tcp-loss-detection.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup lossDetection
+ *
+ * \brief RACK-TLP loss detection (RFC 8985)
+ *
+ * RACK (Recent ACKnowledgment) marks a segment as lost when a segment sent
+ * sufficiently later has been delivered, instead of counting the segments
+ * delivered above it. "Sufficiently" is the RTT of the most recently sent
+ * segment delivered, plus a reordering window. The reordering window is zero
+ * until the connection observes reordering, then a quarter of the minimum
+ * RTT, capped by the smoothed RTT. Segments not yet old enough to be
+ * declared lost are checked again by a timer.
+ *
+ * The segments are checked in the order of their last transmission, using
+ * the time-ordered sent list of TcpTxBuffer: the walk stops at the first
+ * segment sent after the most recently delivered one, so a retransmission is
+ * judged by its own transmission time.
+ *
+ * TLP (Tail Loss Probe) sends a probe two smoothed RTTs after the last
+ * transmission or ACK in the Open state: a new segment if possible,
+ * otherwise the last segment sent. The ACK of the probe carries the SACK
+ * information RACK needs to repair the losses at the tail of the flight,
+ * which would otherwise be recovered by an RTO.
+ *
+ * Neither timestamps nor D-SACK are used: retransmissions delivered in less
+ * than the minimum RTT are attributed to the original transmission, the
+ * reordering window does not adapt to D-SACKs and a probe retransmission
+ * acknowledged together with new data is always considered to have repaired
+ * a loss.
+ */
+class TcpRackTlp : public TcpLossDetection
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Constructor
+   */
+  TcpRackTlp ();
+
+  /**
+   * \brief Copy constructor.
+   * \param other object to copy.
+   */
+  TcpRackTlp (const TcpRackTlp &other);
+
+  /**
+   * \brief Deconstructor
+   */
+  virtual ~TcpRackTlp () override;
+
+  virtual std::string GetName () const override;
+
+  virtual bool IsTimeBased () const override;
+
+  virtual void SegmentDelivered (Ptr<const TcpSocketState> tcb, const TcpTxItem *item) override;
+
+  virtual Time DetectLoss (Ptr<const TcpSocketState> tcb, Ptr<TcpTxBuffer> txBuffer) override;
+
+  virtual Time GetProbeTimeout (Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight) const override;
+
+  virtual void ProbeSent (const SequenceNumber32 &highTxMark, bool isRetrans) override;
+
+  virtual bool ProcessProbeAck (const SequenceNumber32 &ackNumber, bool isPureDupAck) override;
+
+  virtual Ptr<TcpLossDetection> Fork () override;
+
+  /**
+   * \brief Get the reordering window
+   *
+   * \param tcb internal congestion state
+   * \param txBuffer the transmission buffer
+   * \return the reordering window
+   */
+  Time GetReorderingWindow (Ptr<const TcpSocketState> tcb, Ptr<const TcpTxBuffer> txBuffer) const;
+
+private:
+  /**
+   * \brief Is a transmission more recent than another one?
+   *
+   * Transmissions at the same time are ordered by their end sequence number.
+   *
+   * \param t1 time of the first transmission
+   * \param seq1 end sequence number of the first transmission
+   * \param t2 time of the second transmission
+   * \param seq2 end sequence number of the second transmission
+   * \return true if the first transmission is more recent
+   */
+  static bool SentAfter (const Time &t1, const SequenceNumber32 &seq1,
+                         const Time &t2, const SequenceNumber32 &seq2);
+
+  bool m_tlpEnabled {true};          //!< Send tail loss probes
+  bool m_staticReoWnd {false};       //!< Apply the reordering window before reordering is seen
+  Time m_wcDelAckT {MilliSeconds (200)}; //!< Worst case delayed ACK timer of the receiver
+
+  bool m_rackValid {false};          //!< A segment has been delivered
+  Time m_rackXmitTs {0};             //!< Transmission time of the most recent segment delivered
+  SequenceNumber32 m_rackEndSeq {0}; //!< End sequence of the most recent segment delivered
+  Time m_rackRtt {0};                //!< RTT of the most recent segment delivered
+  SequenceNumber32 m_fack {0};       //!< Highest end sequence delivered
+  SequenceNumber32 m_priorFack {0};  //!< Highest end sequence delivered by the previous ACKs
+  bool m_reorderingSeen {false};     //!< A segment was delivered below m_fack
+
+  bool m_tlpOutstanding {false};     //!< A probe has been sent and not yet acked
+  SequenceNumber32 m_tlpEndSeq {0};  //!< Highest sequence sent when the probe was sent
+  bool m_tlpIsRetrans {false};       //!< The probe was a retransmission
+};
+
+} // namespace ns3
+
+#endif /* TCP_RACK_TLP_H */
@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef TCP_SLOW_START_H
+#define TCP_SLOW_START_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "tcp-rate-ops.h"
+
+namespace ns3 {
+
+class TcpSocketState;
+
+/**
+ * \ingroup tcp
+ * \defgroup slowStart Slow Start Algorithms.
+ *
+ * The algorithms driving the startup of a connection: the initial window,
+ * the congestion window growth while cWnd < ssThresh, and the exit from
+ * slow start before the first loss. The interface is defined in class
+ * TcpSlowStart.
+ */
+
+/**
+ * \ingroup slowStart
+ *
+ * \brief Slow start algorithm interface
+ *
+ * Each socket owns one slow start algorithm, and hands it to its
+ * congestion control with TcpCongestionOps::SetSlowStart. The socket feeds
+ * it with every ACK received in the Open state through PktsAcked, before
+ * calling TcpCongestionOps::IncreaseWindow; the connection rate counters
+ * passed along let the algorithm count RTT rounds as the delivery rate
+ * estimation does. An algorithm may end slow start by setting ssThresh to
+ * cWnd.
+ *
+ * While in slow start, congestion controls delegating to the algorithm ask
+ * GetCwndIncrease how much the window should grow for the segments acked.
+ * Congestion controls with their own startup (e.g., those implementing
+ * TcpCongestionOps::CongControl) simply ignore it.
+ */
+class TcpSlowStart : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Constructor
+   */
+  TcpSlowStart ();
+
+  /**
+   * \brief Copy constructor.
+   * \param other object to copy.
+   */
+  TcpSlowStart (const TcpSlowStart &other);
+
+  /**
+   * \brief Deconstructor
+   */
+  virtual ~TcpSlowStart ();
+
+  /**
+   * \brief Get the name of the slow start algorithm
+   *
+   * \return A string identifying the name
+   */
+  virtual std::string GetName () const = 0;
+
+  /**
+   * \brief Get the initial congestion window of a connection
+   *
+   * The window is TcpSocket::InitialCwnd segments. With the
+   * \Attribute{LimitInitialWindow} attribute, it is also limited in bytes as
+   * in RFC 6928 (10 segments, but no more than 14600 bytes unless that is
+   * less than 2 segments); the byte limit grows with InitialCwnd.
+   *
+   * \param tcb internal congestion state
+   * \return the initial congestion window, in bytes
+   */
+  virtual uint32_t GetInitialWindow (Ptr<const TcpSocketState> tcb) const;
+
+  /**
+   * \brief An ACK acknowledging new data has been received in the Open state
+   *
+   * \param tcb internal congestion state
+   * \param segmentsAcked count of segments acked
+   * \param rtt last RTT sample
+   * \param rc rate information of the connection, after the ACK
+   */
+  virtual void PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                          const Time &rtt, const TcpRateOps::TcpRateConnection &rc);
+
+  /**
+   * \brief Get the slow start window growth for the segments acked
+   *
+   * \param tcb internal congestion state
+   * \param segmentsAcked count of segments acked
+   * \return the congestion window increase, in bytes
+   */
+  virtual uint32_t GetCwndIncrease (Ptr<const TcpSocketState> tcb, uint32_t segmentsAcked);
+
+  /**
+   * \brief Copy the slow start algorithm across socket
+   *
+   * \return a pointer of the copied object
+   */
+  virtual Ptr<TcpSlowStart> Fork () = 0;
+
+private:
+  bool m_limitInitialWindow {false}; //!< Apply the RFC 6928 byte limit
+};
+
+/**
+ * \ingroup slowStart
+ *
+ * \brief The classic slow start
+ *
+ * The congestion window grows by one segment for each segment acked until
+ * it reaches ssThresh (RFC 5681).
+ */
+class TcpClassicSlowStart : public TcpSlowStart
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Constructor
+   */
+  TcpClassicSlowStart ();
+
+  /**
+   * \brief Copy constructor.
+   * \param other object to copy.
+   */
+  TcpClassicSlowStart (const TcpClassicSlowStart &other);
+
+  /**
+   * \brief Deconstructor
+   */
+  virtual ~TcpClassicSlowStart () override;
+
+  virtual std::string GetName () const override;
+
+  virtual Ptr<TcpSlowStart> Fork () override;
+};
+
+} // namespace ns3
+
+#endif /* TCP_SLOW_START_H */
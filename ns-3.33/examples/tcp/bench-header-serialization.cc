@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/ppp-header.h"
+
+/**
+ * \file
+ * Serialization throughput of the headers of a TCP segment on a
+ * point-to-point link.
+ *
+ * Each row adds a header to a packet and removes it again, as the
+ * sending and the receiving node do; the "tcp receive" row also peeks
+ * at the TCP header twice before removing it, as TcpL4Protocol and
+ * TcpSocketBase do on every segment received, e.g.
+ *
+ * \code
+ *   ./waf --run "bench-header-serialization --calls=1000000"
+ *   ./waf --run "bench-header-serialization --structured=1"
+ * \endcode
+ */
+
+using namespace ns3;
+
+/**
+ * Print one result line.
+ * \param name the header and operation
+ * \param seconds the elapsed time
+ * \param headers the number of headers serialized or deserialized
+ */
+static void
+Report (std::string name, double seconds, uint64_t headers)
+{
+  std::cout << std::left << std::setw (16) << name
+            << std::right << std::setw (12) << seconds
+            << std::setw (12) << (seconds > 0 ? headers / seconds / 1e6 : 0)
+            << std::setw (12) << (seconds * 1e9 / headers) << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t calls = 200000;
+  uint32_t segmentSize = 1448;
+  bool structured = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Measure the serialization throughput of the TCP, IPv4 and PPP headers.");
+  cmd.AddValue ("calls", "number of packets per row", calls);
+  cmd.AddValue ("segmentSize", "TCP payload size", segmentSize);
+  cmd.AddValue ("structured", "carry the headers as objects instead of bytes", structured);
+  cmd.Parse (argc, argv);
+
+  if (structured)
+    {
+      Packet::EnableStructuredHeaders ();
+    }
+
+  TcpHeader tcp;
+  tcp.SetSourcePort (49153);
+  tcp.SetDestinationPort (9);
+  tcp.SetSequenceNumber (SequenceNumber32 (1));
+  tcp.SetAckNumber (SequenceNumber32 (1));
+  tcp.SetFlags (TcpHeader::ACK);
+  tcp.SetWindowSize (65535);
+  Ptr<TcpOptionTS> ts = CreateObject<TcpOptionTS> ();
+  ts->SetTimestamp (1000);
+  ts->SetEcho (900);
+  tcp.AppendOption (ts);
+
+  Ipv4Header ip;
+  ip.SetSource (Ipv4Address ("10.1.1.1"));
+  ip.SetDestination (Ipv4Address ("10.1.1.2"));
+  ip.SetProtocol (TcpL4Protocol::PROT_NUMBER);
+  ip.SetPayloadSize (segmentSize + tcp.GetSerializedSize ());
+  ip.SetTtl (64);
+
+  PppHeader ppp;
+  ppp.SetProtocol (0x0021);
+
+  std::cout << std::left << std::setw (16) << "Header"
+            << std::right << std::setw (12) << "Run (s)"
+            << std::setw (12) << "M hdr/s"
+            << std::setw (12) << "ns/hdr" << std::endl;
+  std::cout << std::fixed << std::setprecision (3);
+
+  Ptr<Packet> p = Create<Packet> (segmentSize);
+  SystemWallClockMs clock;
+  uint32_t sink = 0;
+
+  PppHeader pppCopy;
+  clock.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      p->AddHeader (ppp);
+      p->RemoveHeader (pppCopy);
+      sink += pppCopy.GetProtocol ();
+    }
+  Report ("ppp", clock.End () / 1000.0, 2ULL * calls);
+
+  Ipv4Header ipCopy;
+  clock.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      ip.SetIdentification (i);
+      p->AddHeader (ip);
+      p->RemoveHeader (ipCopy);
+      sink += ipCopy.GetIdentification ();
+    }
+  Report ("ipv4", clock.End () / 1000.0, 2ULL * calls);
+
+  TcpHeader tcpCopy;
+  clock.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      tcp.SetSequenceNumber (SequenceNumber32 (i * segmentSize));
+      p->AddHeader (tcp);
+      p->RemoveHeader (tcpCopy);
+      sink += tcpCopy.GetSequenceNumber ().GetValue ();
+    }
+  Report ("tcp", clock.End () / 1000.0, 2ULL * calls);
+
+  clock.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      tcp.SetSequenceNumber (SequenceNumber32 (i * segmentSize));
+      p->AddHeader (tcp);
+      p->PeekHeader (tcpCopy);
+      p->PeekHeader (tcpCopy);
+      p->RemoveHeader (tcpCopy);
+      sink += tcpCopy.GetSequenceNumber ().GetValue ();
+    }
+  Report ("tcp receive", clock.End () / 1000.0, 4ULL * calls);
+
+  NS_LOG_UNCOND ("checksum " << sink);
+  return 0;
+}
@@ -0,0 +1,235 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+
+/**
+ * \file
+ * Cost of pcap tracing on a TCP bulk transfer.
+ *
+ *       n0 ----------- n1
+ *          1 Gbit/s, 1 ms
+ *
+ * The same transfer runs without pcap files, with the files written
+ * synchronously, with the files written by the background thread, with
+ * gzip compression (when zlib is available), with a small snap length
+ * and with a capture filter leaving out every packet, e.g.
+ *
+ * \code
+ *   ./waf --run "bench-pcap-writer --time=2 --runs=3 --prefix=/tmp/bench"
+ * \endcode
+ *
+ * In a simulation, the background writer is enabled with
+ * \code
+ *   Config::SetDefault ("ns3::PcapFileWrapper::AsyncWrite", BooleanValue (true));
+ *   Config::SetDefault ("ns3::PcapFileWrapper::Compression", StringValue ("Gzip"));
+ * \endcode
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BenchPcapWriter");
+
+/** Number of packets seen by the pcap traces. */
+static uint64_t g_records = 0;
+
+/**
+ * Count a packet seen by a pcap trace.
+ * \param p the packet
+ */
+static void
+CountRecord (Ptr<const Packet> p)
+{
+  g_records++;
+}
+
+/**
+ * \param filename the name of a file
+ * \returns the size of the file, 0 if it does not exist
+ */
+static uint64_t
+GetFileSize (std::string const &filename)
+{
+  std::ifstream file (filename.c_str (), std::ios::binary | std::ios::ate);
+  return file ? static_cast<uint64_t> (file.tellg ()) : 0;
+}
+
+/** The ways of writing the pcap files. */
+enum Mode
+{
+  OFF,     //!< No pcap files
+  SYNC,    //!< Files written by the simulation thread
+  ASYNC,   //!< Files written by the background thread
+  GZIP,    //!< Compressed files written by the background thread
+  SNAPLEN, //!< Headers only, written by the background thread
+  FILTERED //!< No packet selected by the capture filter
+};
+
+/**
+ * \param mode the mode
+ * \returns the name of the mode
+ */
+static std::string
+GetModeName (Mode mode)
+{
+  switch (mode)
+    {
+    case OFF: return "off";
+    case SYNC: return "sync";
+    case ASYNC: return "async";
+    case GZIP: return "async+gzip";
+    case SNAPLEN: return "async+snap";
+    case FILTERED: return "filtered";
+    }
+  return "";
+}
+
+/**
+ * Run one bulk transfer.
+ * \param mode how the pcap files are written
+ * \param duration the simulated time
+ * \param prefix the prefix of the pcap files
+ * \param snapLen the snap length of the SNAPLEN mode
+ * \param [out] bytes the size of the pcap files
+ * \returns the wall clock time of the run, closing the files included, in s
+ */
+static double
+RunTransfer (Mode mode, Time duration, std::string const &prefix, uint32_t snapLen, uint64_t &bytes)
+{
+  Config::SetDefault ("ns3::PcapFileWrapper::AsyncWrite", BooleanValue (mode != SYNC));
+  Config::SetDefault ("ns3::PcapFileWrapper::Compression", StringValue (mode == GZIP ? "Gzip" : "None"));
+  Config::SetDefault ("ns3::PcapFileWrapper::CaptureSize", UintegerValue (mode == SNAPLEN ? snapLen : 65535));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (devices);
+
+  uint16_t port = 9;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (interfaces.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (0));
+  ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+  sourceApps.Start (Seconds (0.0));
+
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (1));
+  sinkApps.Start (Seconds (0.0));
+
+  g_records = 0;
+  if (mode == FILTERED)
+    {
+      // Another flow: each packet is looked at, and left out
+      Ptr<PcapCaptureFilter> filter = CreateObject<PcapCaptureFilter> ();
+      filter->AddFlow (interfaces.GetAddress (0), interfaces.GetAddress (1), 6, 0, port + 1);
+      pointToPoint.SetCaptureFilter (filter);
+    }
+  if (mode != OFF)
+    {
+      pointToPoint.EnablePcapAll (prefix);
+      Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::PointToPointNetDevice/PromiscSniffer",
+                                     MakeCallback (&CountRecord));
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (duration);
+  Simulator::Run ();
+  // The files are closed when the devices go away
+  Simulator::Destroy ();
+  double seconds = clock.End () / 1000.0;
+
+  bytes = 0;
+  if (mode != OFF)
+    {
+      std::string suffix = mode == GZIP ? ".pcap.gz" : ".pcap";
+      bytes = GetFileSize (prefix + "-0-0" + suffix) + GetFileSize (prefix + "-1-0" + suffix);
+    }
+  return seconds;
+}
+
+int
+main (int argc, char *argv[])
+{
+  double time = 0.5;
+  uint32_t runs = 1;
+  uint32_t snapLen = 96;
+  std::string prefix = "bench-pcap-writer";
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Compare the cost of the ways of writing pcap files.");
+  cmd.AddValue ("time", "simulated time of each transfer, in s", time);
+  cmd.AddValue ("runs", "number of runs per mode", runs);
+  cmd.AddValue ("snapLen", "snap length of the async+snap mode", snapLen);
+  cmd.AddValue ("prefix", "prefix of the pcap files", prefix);
+  cmd.Parse (argc, argv);
+
+  std::cout << time << " s per transfer" << std::endl;
+  std::cout << std::left << std::setw (12) << "Pcap"
+            << std::right << std::setw (12) << "Run (s)"
+            << std::setw (14) << "Records"
+            << std::setw (14) << "Records/s"
+            << std::setw (12) << "Slowdown"
+            << std::setw (14) << "File (MB)" << std::endl;
+  std::cout << std::fixed << std::setprecision (3);
+  for (uint32_t i = 0; i < runs; ++i)
+    {
+      double off = 0;
+      for (int m = OFF; m <= FILTERED; ++m)
+        {
+          Mode mode = static_cast<Mode> (m);
+          if (mode == GZIP && !AsyncFileBuf::IsSupported (AsyncFileBuf::GZIP))
+            {
+              continue;
+            }
+          uint64_t bytes;
+          double seconds = RunTransfer (mode, Seconds (time), prefix, snapLen, bytes);
+          if (mode == OFF)
+            {
+              off = seconds;
+            }
+          std::cout << std::left << std::setw (12) << GetModeName (mode)
+                    << std::right << std::setw (12) << seconds
+                    << std::setw (14) << g_records
+                    << std::setw (14) << std::setprecision (0) << (seconds > 0 ? g_records / seconds : 0)
+                    << std::setw (12) << std::setprecision (3) << (off > 0 ? seconds / off : 0)
+                    << std::setw (14) << bytes / 1e6 << std::endl;
+        }
+    }
+  return 0;
+}
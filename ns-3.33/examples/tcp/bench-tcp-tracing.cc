@@ -0,0 +1,187 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+
+/**
+ * \file
+ * ACK processing throughput of a TCP sender, with and without sinks on
+ * its traced values.
+ *
+ *       n0 ----------- n1
+ *          1 Gbit/s, 1 ms
+ *
+ * A bulk transfer runs twice for the same simulated time: once with no
+ * trace sink, where each TracedValue assignment is a plain store, and
+ * once with a counting sink on each traced value of the sender.  In an
+ * optimized build, the two runs differ by about 1%, less than the noise
+ * from one run to the next: the traced values are a negligible part of
+ * the processing of an ACK, with or without sinks.  Run it e.g. with
+ *
+ * \code
+ *   ./waf --run "bench-tcp-tracing --cc=ns3::TcpBbr --time=2 --runs=3"
+ * \endcode
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BenchTcpTracing");
+
+/** Number of trace sink invocations. */
+static uint64_t g_changes = 0;
+
+/**
+ * Count a change of a traced value.
+ * \tparam T the type of the traced value
+ * \param oldValue the previous value
+ * \param newValue the new value
+ */
+template <typename T>
+static void
+CountChange (T oldValue, T newValue)
+{
+  g_changes++;
+}
+
+/** Connect a counting sink to each traced value of the sender socket. */
+static void
+ConnectSinks (void)
+{
+  std::string socket = "/NodeList/0/$ns3::TcpL4Protocol/SocketList/0/";
+  Config::ConnectWithoutContext (socket + "CongestionWindow", MakeCallback (&CountChange<uint32_t>));
+  Config::ConnectWithoutContext (socket + "SlowStartThreshold", MakeCallback (&CountChange<uint32_t>));
+  Config::ConnectWithoutContext (socket + "BytesInFlight", MakeCallback (&CountChange<uint32_t>));
+  Config::ConnectWithoutContext (socket + "RWND", MakeCallback (&CountChange<uint32_t>));
+  Config::ConnectWithoutContext (socket + "PacingRate", MakeCallback (&CountChange<DataRate>));
+  Config::ConnectWithoutContext (socket + "CongState", MakeCallback (&CountChange<TcpSocketState::TcpCongState_t>));
+  Config::ConnectWithoutContext (socket + "NextTxSequence", MakeCallback (&CountChange<SequenceNumber32>));
+  Config::ConnectWithoutContext (socket + "HighestSequence", MakeCallback (&CountChange<SequenceNumber32>));
+  Config::ConnectWithoutContext (socket + "HighestRxAck", MakeCallback (&CountChange<SequenceNumber32>));
+  Config::ConnectWithoutContext (socket + "RTT", MakeCallback (&CountChange<Time>));
+  Config::ConnectWithoutContext (socket + "RTO", MakeCallback (&CountChange<Time>));
+}
+
+/**
+ * Run one bulk transfer.
+ * \param cc the congestion control of the sender
+ * \param duration the simulated time
+ * \param traced whether to connect the sinks
+ * \param [out] received the number of bytes received
+ * \returns the wall clock time of the run, in s
+ */
+static double
+RunTransfer (TypeId cc, Time duration, bool traced, uint64_t &received)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  // Only the sender runs the congestion control under test
+  nodes.Get (0)->GetObject<TcpL4Protocol> ()->SetAttribute ("SocketType", TypeIdValue (cc));
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (devices);
+
+  uint16_t port = 9;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (interfaces.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (0));
+  ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+  sourceApps.Start (Seconds (0.0));
+
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (1));
+  sinkApps.Start (Seconds (0.0));
+
+  g_changes = 0;
+  if (traced)
+    {
+      // The sender socket exists once the application started
+      Simulator::Schedule (MicroSeconds (1), &ConnectSinks);
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (duration);
+  Simulator::Run ();
+  double seconds = clock.End () / 1000.0;
+
+  received = DynamicCast<PacketSink> (sinkApps.Get (0))->GetTotalRx ();
+  Simulator::Destroy ();
+  return seconds;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string cc = "ns3::TcpBbr";
+  double time = 0.5;
+  uint32_t segmentSize = 1448;
+  uint32_t runs = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Compare the ACK processing throughput of a TCP sender with and without trace sinks.");
+  cmd.AddValue ("cc", "congestion control TypeId", cc);
+  cmd.AddValue ("time", "simulated time of each transfer, in s", time);
+  cmd.AddValue ("segmentSize", "TCP segment size", segmentSize);
+  cmd.AddValue ("runs", "number of runs per mode", runs);
+  cmd.Parse (argc, argv);
+
+  // BBR requires pacing
+  Config::SetDefault ("ns3::TcpSocketState::EnablePacing", BooleanValue (true));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (segmentSize));
+
+  std::cout << cc << ", " << time << " s per transfer" << std::endl;
+  std::cout << std::left << std::setw (12) << "Sinks"
+            << std::right << std::setw (12) << "Run (s)"
+            << std::setw (14) << "Segments"
+            << std::setw (14) << "ns/segment"
+            << std::setw (14) << "Sink calls" << std::endl;
+  std::cout << std::fixed << std::setprecision (3);
+  for (uint32_t i = 0; i < runs; ++i)
+    {
+      for (int traced = 0; traced < 2; ++traced)
+        {
+          uint64_t received;
+          double seconds = RunTransfer (TypeId::LookupByName (cc), Seconds (time), traced, received);
+          uint64_t segments = received / segmentSize;
+          std::cout << std::left << std::setw (12) << (traced ? "connected" : "none")
+                    << std::right << std::setw (12) << seconds
+                    << std::setw (14) << segments
+                    << std::setw (14) << (segments ? seconds * 1e9 / segments : 0)
+                    << std::setw (14) << g_changes << std::endl;
+        }
+    }
+  return 0;
+}
@@ -0,0 +1,266 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+/** Sweep of the dumbbell of tcp-dumbbell.cc, run as independent
+ *  replications on a thread pool of one process.
+ *       n0            n1
+ *        |            |
+ *        | l0         | l2
+ *        |            |
+ *        n2---l1------n3
+ *        |            |
+ *        |  l3        | l4
+ *        |            |
+ *        n4           n5
+ *  The flows alternate between n0->n1 (cc1) and n4->n5 (cc2).
+ */
+#include <string>
+#include <unistd.h>
+#include <stdio.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include "ns3/core-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/traffic-control-module.h"
+#include "ns3/tcp-client-module.h"
+using namespace ns3;
+using namespace std;
+NS_LOG_COMPONENT_DEFINE ("TcpDumbbellSweep");
+#define DEFAULT_PACKET_SIZE 1500
+struct SweepPoint{
+    std::string cc1;
+    std::string cc2;
+    uint32_t loss;//per mille
+    uint32_t instance;
+    uint32_t flows;
+};
+struct BottleneckStats:public SimpleRefCount<BottleneckStats>{
+    uint64_t rxBytes=0;
+    uint32_t queueDrops=0;
+    uint32_t lossDrops=0;
+    uint32_t bandwidth=0;
+};
+//read only once the replications start
+std::vector<SweepPoint> g_points;
+std::string g_folder("sweep");
+double g_duration=20.0;
+static std::vector<std::string> SplitList(const std::string &list){
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while(std::getline(ss,item,',')){
+        if(!item.empty()){
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+static void OnMacRx(Ptr<BottleneckStats> stats,Ptr<const Packet> packet){
+    stats->rxBytes+=packet->GetSize();
+}
+static void OnQueueDrop(Ptr<BottleneckStats> stats,Ptr<const QueueDiscItem> item){
+    stats->queueDrops++;
+}
+static void OnLossDrop(Ptr<BottleneckStats> stats,Ptr<const Packet> packet){
+    stats->lossDrops++;
+}
+static void ConfigureRandomLoss(Ptr<NetDevice> device,double loss_rate){
+    ObjectFactory factory;
+    factory.SetTypeId ("ns3::RateErrorModel");
+    factory.Set ("ErrorRate",DoubleValue (loss_rate));
+    factory.Set ("ErrorUnit",StringValue ("ERROR_UNIT_PACKET"));
+    Ptr<ErrorModel> em = factory.Create<ErrorModel> ();
+    device->SetAttribute ("ReceiveErrorModel", PointerValue (em));
+}
+static void Collect(uint32_t i,Ptr<BottleneckStats> stats,ReplicationResult &result){
+    const SweepPoint &point=g_points[i];
+    result.Set("cc1",point.cc1);
+    result.Set("cc2",point.cc2);
+    result.Set("loss",point.loss);
+    result.Set("it",point.instance);
+    result.Set("flows",point.flows);
+    double mbps=stats->rxBytes*8.0/g_duration/1000000;
+    result.Set("goodput_mbps",mbps);
+    result.Set("utilization",mbps*1000000*100/stats->bandwidth);
+    result.Set("queue_drops",stats->queueDrops);
+    result.Set("loss_drops",stats->lossDrops);
+}
+static ReplicationRunner::CollectCallback Setup(uint32_t i){
+    const SweepPoint &point=g_points[i];
+    {
+        char buf[FILENAME_MAX];
+        std::string trace_folder=std::string (getcwd(buf, FILENAME_MAX))+"/traces/"+
+                                g_folder+"/"+std::to_string(i)+"/";
+        MakePath(trace_folder);
+        TcpBbrDebug::SetTraceFolder(trace_folder.c_str());
+        TcpTracer::SetTraceFolder(trace_folder.c_str());
+    }
+    uint32_t bw_unit=1000000;
+    uint32_t bottleneck_bw=12*bw_unit;
+    uint32_t non_bottleneck_bw=100*bw_unit;
+    int links=5;
+    int bottleneck_i=1;
+    //instances 1-4 and 5-8 differ by the access delay, then by the buffer
+    uint32_t access_ms=point.instance>=5&&point.instance<=8?15:10;
+    uint16_t ends[5][2]={{0,2},{2,3},{3,1},{2,4},{3,5}};
+    uint32_t owd[5]={access_ms,10,access_ms,10,10};
+    uint32_t rtt=std::max(2*(owd[0]+owd[1]+owd[2]),2*(owd[1]+owd[3]+owd[4]));
+    uint32_t buffer_factor[4]={2,3,4,6};
+    uint32_t buffer_ms=rtt*4/2;
+    if(point.instance>=1&&point.instance<=8){
+        buffer_ms=rtt*buffer_factor[(point.instance-1)%4]/2;
+    }
+    TcpTracer::SetExperimentInfo(point.flows,bottleneck_bw);
+    TcpTracer::SetLossRateFlag(true);
+
+    Ptr<BottleneckStats> stats=Create<BottleneckStats>();
+    stats->bandwidth=bottleneck_bw;
+    NodeContainer topo;
+    topo.Create (links+1);
+    InternetStackHelper stack;
+    stack.Install (topo);
+    for (int l=0;l<links;l++){
+        uint32_t bps=bottleneck_i==l?bottleneck_bw:non_bottleneck_bw;
+        NodeContainer nodes=NodeContainer (topo.Get (ends[l][0]), topo.Get (ends[l][1]));
+        auto bufSize = std::max<uint32_t> (DEFAULT_PACKET_SIZE, bps * buffer_ms / 8000);
+        int packets=bufSize/DEFAULT_PACKET_SIZE;
+        PointToPointHelper pointToPoint;
+        pointToPoint.SetDeviceAttribute ("DataRate", DataRateValue  (DataRate (bps)));
+        pointToPoint.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (owd[l])));
+        if(bottleneck_i==l){
+            pointToPoint.SetQueue ("ns3::DropTailQueue","MaxSize", StringValue (std::to_string(20)+"p"));
+        }else{
+            pointToPoint.SetQueue ("ns3::DropTailQueue","MaxSize", StringValue (std::to_string(packets)+"p"));
+        }
+        NetDeviceContainer devices = pointToPoint.Install (nodes);
+        if(bottleneck_i==l){
+            TrafficControlHelper pfifoHelper;
+            uint16_t handle = pfifoHelper.SetRootQueueDisc ("ns3::FifoQueueDisc", "MaxSize", StringValue (std::to_string(packets)+"p"));
+            pfifoHelper.AddInternalQueues (handle, 1, "ns3::DropTailQueue", "MaxSize",StringValue (std::to_string(packets)+"p"));
+            QueueDiscContainer qdiscs=pfifoHelper.Install(devices);
+            qdiscs.Get(0)->TraceConnectWithoutContext("Drop",MakeBoundCallback(&OnQueueDrop,stats));
+            devices.Get(1)->TraceConnectWithoutContext("MacRx",MakeBoundCallback(&OnMacRx,stats));
+            devices.Get(1)->TraceConnectWithoutContext("PhyRxDrop",MakeBoundCallback(&OnLossDrop,stats));
+            if(point.loss>0){
+                Simulator::Schedule(Seconds(2),&ConfigureRandomLoss,devices.Get(1),point.loss*1.0/1000);
+            }
+        }
+        Ipv4AddressHelper address;
+        std::string nodeip="10.1."+std::to_string(l+1)+".0";
+        address.SetBase (nodeip.c_str(), "255.255.255.0");
+        address.Assign (devices);
+    }
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+    uint16_t serv_port = 5000;
+    Address sink_addr[2];
+    uint32_t servers[2]={1,5};
+    for(int s=0;s<2;s++){
+        Ptr<Node> host=topo.Get(servers[s]);
+        Ipv4Address serv_ip= host->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal();
+        sink_addr[s]=InetSocketAddress{serv_ip,serv_port};
+        Ptr<TcpServer> server=CreateObject<TcpServer>(sink_addr[s]);
+        host->AddApplication(server);
+        server->SetStartTime (Seconds (0.0));
+    }
+    uint64_t totalTxBytes = 100000*1500;
+    uint32_t clients[2]={0,4};
+    for(uint32_t f=0;f<point.flows;f++){
+        int side=f%2;
+        std::string cc=side==0?point.cc1:point.cc2;
+        Ptr<Node> host=topo.Get(clients[side]);
+        Ptr<TcpClient> client= CreateObject<TcpClient> (totalTxBytes);
+        host->AddApplication(client);
+        client->ConfigurePeer(sink_addr[side]);
+        client->SetCongestionAlgo(cc);
+        client->SetStartTime (Seconds (0));
+        client->SetStopTime (Seconds (g_duration));
+    }
+    Simulator::Stop (Seconds (g_duration));
+    return MakeBoundCallback(&Collect,i,stats);
+}
+//./waf --run "scratch/tcp-dumbbell-sweep --cc1=bbr,cubic --cc2=bbr --lo=0,10 --it=1,3 --flows=2 --threads=4"
+int main(int argc, char *argv[])
+{
+    std::string cc1_list("bbr,cubic");
+    std::string cc2_list("bbr");
+    std::string loss_list("0");
+    std::string instance_list("1");
+    std::string flows_list("2");
+    std::string table;
+    uint32_t threads=0;
+    uint64_t first_run=1;
+    bool structured=false;
+    CommandLine cmd;
+    cmd.AddValue ("cc1", "comma separated congestion algorithms of the n0 flows", cc1_list);
+    cmd.AddValue ("cc2", "comma separated congestion algorithms of the n4 flows", cc2_list);
+    cmd.AddValue ("lo", "comma separated random loss, per mille",loss_list);
+    cmd.AddValue ("it", "comma separated instances (delay and buffer)", instance_list);
+    cmd.AddValue ("flows", "comma separated flow counts", flows_list);
+    cmd.AddValue ("duration", "simulated seconds of each replication", g_duration);
+    cmd.AddValue ("threads", "number of threads, 0 for one per core", threads);
+    cmd.AddValue ("run", "RNG run number of the first replication", first_run);
+    cmd.AddValue ("folder", "folder name to collect data", g_folder);
+    cmd.AddValue ("table", "file of the results table, stdout if empty", table);
+    cmd.AddValue ("structured", "carry the headers as objects instead of bytes", structured);
+    cmd.Parse (argc, argv);
+    if(structured){
+        Packet::EnableStructuredHeaders();
+    }
+    //the defaults are shared by all the replications
+    uint32_t kMaxmiumSegmentSize=1400;
+    Config::SetDefault("ns3::TcpSocket::SndBufSize", UintegerValue(200*kMaxmiumSegmentSize));
+    Config::SetDefault("ns3::TcpSocket::RcvBufSize", UintegerValue(200*kMaxmiumSegmentSize));
+    Config::SetDefault("ns3::TcpSocket::SegmentSize",UintegerValue(kMaxmiumSegmentSize));
+    for(const std::string &cc1:SplitList(cc1_list)){
+        for(const std::string &cc2:SplitList(cc2_list)){
+            for(const std::string &loss:SplitList(loss_list)){
+                for(const std::string &instance:SplitList(instance_list)){
+                    for(const std::string &flows:SplitList(flows_list)){
+                        SweepPoint point;
+                        point.cc1=cc1;
+                        point.cc2=cc2;
+                        point.loss=std::stoi(loss);
+                        point.instance=std::stoi(instance);
+                        point.flows=std::stoi(flows);
+                        g_points.push_back(point);
+                    }
+                }
+            }
+        }
+    }
+    ReplicationRunner runner;
+    runner.SetThreads(threads);
+    runner.SetFirstRun(first_run);
+    runner.Run(g_points.size(),MakeCallback(&Setup));
+    if(table.empty()){
+        runner.Print(std::cout);
+    }else{
+        std::ofstream out(table.c_str());
+        runner.Print(out);
+    }
+    return 0;
+}
@@ -93,7 +93,7 @@ uint32_t CalMaxRttInDumbbell(LinkProperty *topoinfo,int links){
 #define DEFAULT_PACKET_SIZE 1500
 int ip=1;
 static NodeContainer BuildDumbbellTopo(LinkProperty *topoinfo,int links,int bottleneck_i,
-                                    uint32_t buffer_ms,TriggerRandomLoss *trigger=nullptr)
+                                    uint32_t buffer_ms,TriggerRandomLoss *trigger=nullptr,bool bql=false)
 {
     int hosts=links+1;
     NodeContainer topo;
@@ -122,6 +122,10 @@ static NodeContainer BuildDumbbellTopo(LinkProperty *topoinfo,int links,int bott
             TrafficControlHelper pfifoHelper;
             uint16_t handle = pfifoHelper.SetRootQueueDisc ("ns3::FifoQueueDisc", "MaxSize", StringValue (std::to_string(packets)+"p"));
             pfifoHelper.AddInternalQueues (handle, 1, "ns3::DropTailQueue", "MaxSize",StringValue (std::to_string(packets)+"p"));
+            if(bql){
+                //the device queue is sized by the bytes in flight on the wire, the backlog stays in the queue disc
+                pfifoHelper.SetQueueLimits ("ns3::DynamicQueueLimits");
+            }
             pfifoHelper.Install(devices);  
         }
         Ipv4AddressHelper address;
@@ -149,13 +153,24 @@ int main(int argc, char *argv[])
     std::string cc2("bbr2");
     std::string folder_name("no-one");
     std::string loss_str("0");
+    bool structured=false;
+    bool bql=false;
+    bool pcap=false;
+    uint32_t pcap_sampling=1;
     CommandLine cmd;
     cmd.AddValue ("it", "instacne", instance);
     cmd.AddValue ("cc1", "congestion algorithm1", cc1);
     cmd.AddValue ("cc2", "congestion algorithm2", cc2);
     cmd.AddValue ("folder", "folder name to collect data", folder_name);
     cmd.AddValue ("lo", "loss",loss_str);
+    cmd.AddValue ("structured", "carry the headers as objects instead of bytes", structured);
+    cmd.AddValue ("bql", "bound the bottleneck device queue with dynamic queue limits", bql);
+    cmd.AddValue ("pcap", "capture the headers on the bottleneck link", pcap);
+    cmd.AddValue ("pcapk", "capture one flow in k", pcap_sampling);
     cmd.Parse (argc, argv);
+    if(structured){
+        Packet::EnableStructuredHeaders();
+    }
     uint32_t kMaxmiumSegmentSize=1400;
     Config::SetDefault("ns3::TcpSocket::SndBufSize", UintegerValue(200*kMaxmiumSegmentSize));
     Config::SetDefault("ns3::TcpSocket::RcvBufSize", UintegerValue(200*kMaxmiumSegmentSize));
@@ -276,7 +291,7 @@ int main(int argc, char *argv[])
     TcpTracer::SetExperimentInfo(4,topoinfo_ptr[bottleneck_i].bandwidth);
     //for loss rate
     TcpTracer::SetLossRateFlag(true);
-    NodeContainer topo=BuildDumbbellTopo(topoinfo_ptr,links,bottleneck_i,buffer_ms,triggerloss.get());
+    NodeContainer topo=BuildDumbbellTopo(topoinfo_ptr,links,bottleneck_i,buffer_ms,triggerloss.get(),bql);
     uint16_t serv_port = 5000;
 
     //install server on h1
@@ -347,6 +362,15 @@ int main(int argc, char *argv[])
         client->SetStopTime (Seconds (simDuration));
     }
     */
+    if(pcap){
+        Ptr<PcapCaptureFilter> filter=CreateObject<PcapCaptureFilter>();
+        filter->SetSnapLength(96);
+        filter->SetFlowSampling(pcap_sampling);
+        PointToPointHelper pointToPoint;
+        pointToPoint.SetCaptureFilter(filter);
+        //n2 side of the bottleneck l1
+        pointToPoint.EnablePcap(trace_folder+"bottleneck.pcap",topo.Get(2)->GetDevice(2),false,true);
+    }
     Simulator::Stop (Seconds (simDuration+10.0));
     Simulator::Run ();
     Simulator::Destroy ();
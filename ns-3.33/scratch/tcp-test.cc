@@ -82,10 +82,15 @@ int main(int argc, char *argv[])
     LogComponentEnable("TcpBbr", LOG_LEVEL_ALL);
     std::string cc("bbr2");
     std::string folder_name("default");
+    bool structured=false;
     CommandLine cmd;
     cmd.AddValue ("cc", "congestion algorithm",cc);
     cmd.AddValue ("folder", "folder name to collect data", folder_name);
+    cmd.AddValue ("structured", "carry the headers as objects instead of bytes", structured);
     cmd.Parse (argc, argv);
+    if(structured){
+        Packet::EnableStructuredHeaders();
+    }
     uint32_t kMaxmiumSegmentSize=1400;
     Config::SetDefault("ns3::TcpSocket::SndBufSize", UintegerValue(200*kMaxmiumSegmentSize));
     Config::SetDefault("ns3::TcpSocket::RcvBufSize", UintegerValue(200*kMaxmiumSegmentSize));
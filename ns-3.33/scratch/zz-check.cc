@@ -0,0 +1,124 @@
+#include "ns3/core-module.h"
+#include "ns3/pcap-file.h"
+#include <vector>
+#include <fstream>
+#include <iostream>
+using namespace ns3;
+#define CHK(a,b,m) do { std::cerr << __LINE__ << " " << m << std::endl; } while (0)
+static const uint32_t N_KNOWN_PACKETS = 6;
+static const uint32_t N_PACKET_BYTES = 16;
+
+/**
+ * PCAP Packet structure
+ */
+typedef struct PACKET_ENTRY {
+  uint32_t tsSec;   //!< Time (seconds part)
+  uint32_t tsUsec;  //!< Time (micro seconds part)
+  uint32_t inclLen; //!< Length of the entry in the PCAP
+  uint32_t origLen; //!< length of the original packet
+  uint16_t data[N_PACKET_BYTES];  //!< Packet data
+} PacketEntry;
+
+static const PacketEntry knownPackets[] = {
+  { 2, 3696,   46,   46, { 0x0001, 0x0800, 0x0604, 0x0001, 0x0000, 0x0000, 0x0003, 0x0a01,
+                           0x0201, 0xffff, 0xffff, 0xffff, 0x0a01, 0x0204, 0x0000, 0x0000}},
+  { 2, 3707,   46,   46, { 0x0001, 0x0800, 0x0604, 0x0002, 0x0000, 0x0000, 0x0006, 0x0a01,
+                           0x0204, 0x0000, 0x0000, 0x0003, 0x0a01, 0x0201, 0x0000, 0x0000}},
+  { 2, 3801, 1070, 1070, { 0x4500, 0x041c, 0x0000, 0x0000, 0x3f11, 0x0000, 0x0a01, 0x0101,
+                           0x0a01, 0x0204, 0xc001, 0x0009, 0x0408, 0x0000, 0x0000, 0x0000}},
+  { 2, 3811,   46,   46, { 0x0001, 0x0800, 0x0604, 0x0001, 0x0000, 0x0000, 0x0006, 0x0a01,
+                           0x0204, 0xffff, 0xffff, 0xffff, 0x0a01, 0x0201, 0x0000, 0x0000}},
+  { 2, 3822,   46,   46, { 0x0001, 0x0800, 0x0604, 0x0002, 0x0000, 0x0000, 0x0003, 0x0a01,
+                           0x0201, 0x0000, 0x0000, 0x0006, 0x0a01, 0x0204, 0x0000, 0x0000}},
+  { 2, 3915, 1070, 1070, { 0x4500, 0x041c, 0x0000, 0x0000, 0x4011, 0x0000, 0x0a01, 0x0204,
+                           0x0a01, 0x0101, 0x0009, 0xc001, 0x0408, 0x0000, 0x0000, 0x0000}}
+};
+int main () {
+  //
+  // Write the known packets synchronously and in the background
+  //
+  std::string filename = std::string ("/tmp/zz-" "sync.pcap");
+  std::string filename2 = std::string ("/tmp/zz-" "async.pcap");
+  PcapFile f;
+
+  for (int async = 0; async < 2; ++async)
+    {
+      if (async)
+        {
+          f.OpenAsync (filename2, AsyncFileBuf::NONE);
+        }
+      else
+        {
+          f.Open (filename, std::ios::out);
+        }
+      CHK (f.Fail (), false, "Open returns error");
+      f.Init (1, N_PACKET_BYTES);
+      for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+        {
+          PacketEntry const & p = knownPackets[i];
+          f.Write (p.tsSec, p.tsUsec, (uint8_t const *)p.data, p.origLen);
+          CHK (f.Fail (), false, "Write must not fail");
+        }
+      f.Close ();
+    }
+
+  uint32_t sec (0), usec (0), packets (0);
+  bool diff = PcapFile::Diff (filename, filename2, sec, usec, packets);
+  CHK (diff, false, "PcapDiff(sync, async) must be false");
+  CHK (packets, N_KNOWN_PACKETS, "Records lost");
+
+  //
+  // Write many more bytes than the ring holds, and read them back
+  //
+  const uint32_t nRecords = 20000;
+  const uint32_t recordSize = 1500;
+  std::vector<uint8_t> data (recordSize);
+  f.OpenAsync (filename2, AsyncFileBuf::NONE);
+  f.Init (1, recordSize);
+  for (uint32_t i = 0; i < nRecords; ++i)
+    {
+      data[0] = i & 0xff;
+      f.Write (i, 0, &data[0], recordSize);
+    }
+  std::cerr << "written" << std::endl;
+  f.Close ();
+  std::cerr << "closed" << std::endl;
+
+  f.Open (filename2, std::ios::in);
+  CHK (f.Fail (), false, "Open (" << filename2 << ", \"std::ios::in\") returns error");
+  std::cerr << "reopened" << std::endl;
+  uint32_t records = 0;
+  while (true)
+    {
+      uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+      f.Read (&data[0], recordSize, tsSec, tsUsec, inclLen, origLen, readLen);
+      if (f.Eof ())
+        {
+          break;
+        }
+      CHK (tsSec, records, "Records out of order");
+      CHK ((uint32_t)data[0], (records & 0xff), "Bad record data");
+      CHK (readLen, recordSize, "Bad record length");
+      ++records;
+    }
+  f.Close ();
+  CHK (records, nRecords, "Records lost");
+
+  //
+  // Compressed files start with the gzip magic number
+  //
+  if (AsyncFileBuf::IsSupported (AsyncFileBuf::GZIP))
+    {
+      std::string filename3 = std::string ("/tmp/zz-" "async.pcap.gz");
+      f.OpenAsync (filename3, AsyncFileBuf::GZIP);
+      CHK (f.Fail (), false, "OpenAsync (" << filename3 << ") returns error");
+      f.Init (1, recordSize);
+      f.Write (0, 0, &data[0], recordSize);
+      f.Close ();
+      std::ifstream gz (filename3.c_str (), std::ios::binary);
+      uint8_t magic[2] = { 0, 0 };
+      gz.read ((char *)magic, 2);
+      CHK ((uint32_t)magic[0], 0x1f, "Not a gzip file");
+      CHK ((uint32_t)magic[1], 0x8b, "Not a gzip file");
+    }
+std::cerr << "done" << std::endl; }
@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+/**
+ * \file
+ * \ingroup core-examples
+ * \ingroup scheduler
+ * Compare all the schedulers on the same event distribution.
+ *
+ * Each scheduler runs the classic hold model: an initial population of
+ * events is scheduled, then each event executed schedules a new one,
+ * until the total number of events is reached. The event delays are
+ * drawn from an exponential distribution, or replayed from a file
+ * written by RecordingScheduler (one delay in seconds per line), e.g.
+ *
+ * \code
+ *   ./waf --run "tcp-dumbbell --SchedulerType=ns3::RecordingScheduler
+ *               --ns3::RecordingScheduler::FileName=dumbbell-events.txt"
+ *   ./waf --run "bench-scheduler --file=dumbbell-events.txt"
+ * \endcode
+ *
+ * Since the delays of a recorded trace are replayed as a hold model,
+ * the population stays constant, as in a network in steady state.
+ */
+
+using namespace ns3;
+
+/** Hold model benchmark. */
+class BenchScheduler
+{
+public:
+  /**
+   * Constructor
+   * \param stream the event delays, in ns
+   * \param population the event population
+   * \param total the total number of events executed
+   */
+  BenchScheduler (Ptr<RandomVariableStream> stream, uint32_t population, uint32_t total)
+    : m_rand (stream),
+      m_population (population),
+      m_total (total),
+      m_count (0)
+  {
+  }
+
+  /**
+   * Run the benchmark on a scheduler
+   * \param factory the scheduler factory
+   * \param [out] init the time to schedule the population, in s
+   * \param [out] simu the time to run the events, in s
+   */
+  void Run (ObjectFactory factory, double &init, double &simu);
+
+private:
+  /** Event: schedule the next one */
+  void Cb (void);
+
+  Ptr<RandomVariableStream> m_rand; //!< Event delays, in ns
+  uint32_t m_population;            //!< Event population
+  uint32_t m_total;                 //!< Total events to execute
+  uint32_t m_count;                 //!< Events executed
+};
+
+void
+BenchScheduler::Run (ObjectFactory factory, double &init, double &simu)
+{
+  Simulator::SetScheduler (factory);
+  m_count = 0;
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < m_population; ++i)
+    {
+      Simulator::Schedule (NanoSeconds (m_rand->GetValue ()), &BenchScheduler::Cb, this);
+    }
+  init = time.End () / 1000.0;
+
+  time.Start ();
+  Simulator::Run ();
+  simu = time.End () / 1000.0;
+  Simulator::Destroy ();
+}
+
+void
+BenchScheduler::Cb (void)
+{
+  if (m_count >= m_total)
+    {
+      return;
+    }
+  Simulator::Schedule (NanoSeconds (m_rand->GetValue ()), &BenchScheduler::Cb, this);
+  ++m_count;
+}
+
+/**
+ * Create the stream of event delays.
+ * \param filename the trace file, or empty for an exponential distribution
+ * \returns the stream of delays, in ns
+ */
+Ptr<RandomVariableStream>
+GetDelays (std::string filename)
+{
+  if (filename == "")
+    {
+      std::cout << "delays: exponential, mean 100 ns" << std::endl;
+      Ptr<ExponentialRandomVariable> erv = CreateObject<ExponentialRandomVariable> ();
+      erv->SetAttribute ("Mean", DoubleValue (100));
+      return erv;
+    }
+
+  std::ifstream input (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (input, "Cannot open " << filename);
+  std::vector<double> delays;
+  double value;
+  while (input >> value)
+    {
+      delays.push_back (value * 1e9);
+    }
+  NS_ABORT_MSG_IF (delays.empty (), "No delay found in " << filename);
+  std::cout << "delays: " << delays.size () << " from " << filename << std::endl;
+  Ptr<DeterministicRandomVariable> drv = CreateObject<DeterministicRandomVariable> ();
+  drv->SetValueArray (&delays[0], delays.size ());
+  return drv;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t pop = 100000;
+  uint32_t total = 1000000;
+  uint32_t runs = 1;
+  bool withList = false;
+  std::string filename = "";
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Compare the simulator schedulers on the same event distribution.");
+  cmd.AddValue ("pop", "event population size", pop);
+  cmd.AddValue ("total", "total number of events to run", total);
+  cmd.AddValue ("runs", "number of runs per scheduler", runs);
+  cmd.AddValue ("list", "include the (linear) ListScheduler", withList);
+  cmd.AddValue ("file", "file of event delays in seconds, from RecordingScheduler", filename);
+  cmd.Parse (argc, argv);
+
+  std::vector<std::string> schedulers;
+  schedulers.push_back ("ns3::MapScheduler");
+  schedulers.push_back ("ns3::HeapScheduler");
+  schedulers.push_back ("ns3::CalendarScheduler");
+  schedulers.push_back ("ns3::PriorityQueueScheduler");
+  schedulers.push_back ("ns3::LadderScheduler");
+  if (withList)
+    {
+      schedulers.push_back ("ns3::ListScheduler");
+    }
+
+  std::cout << "population: " << pop << " total events: " << total << std::endl;
+  BenchScheduler bench (GetDelays (filename), pop, total);
+
+  std::cout << std::left << std::setw (28) << "Scheduler"
+            << std::right << std::setw (12) << "Init (s)"
+            << std::setw (12) << "Run (s)"
+            << std::setw (12) << "ns/event" << std::endl;
+  std::cout << std::fixed << std::setprecision (3);
+  for (std::vector<std::string>::const_iterator it = schedulers.begin (); it != schedulers.end (); ++it)
+    {
+      ObjectFactory factory (*it);
+      for (uint32_t i = 0; i < runs; ++i)
+        {
+          double init;
+          double simu;
+          bench.Run (factory, init, simu);
+          std::cout << std::left << std::setw (28) << *it
+                    << std::right << std::setw (12) << init
+                    << std::setw (12) << simu
+                    << std::setw (12) << (simu * 1e9 / total) << std::endl;
+        }
+    }
+  return 0;
+}
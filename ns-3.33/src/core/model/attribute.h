@@ -65,7 +65,7 @@ class ObjectBase;
  * Most subclasses of this base class are implemented by the
  * ATTRIBUTE_HELPER_* macros.
  */
-class AttributeValue : public SimpleRefCount<AttributeValue>
+class AttributeValue : public AtomicSimpleRefCount<AttributeValue>
 {
 public:
   AttributeValue ();
@@ -111,7 +111,7 @@ public:
  * of this base class are usually provided through the MakeAccessorHelper
  * template functions, hidden behind an ATTRIBUTE_HELPER_* macro.
  */
-class AttributeAccessor : public SimpleRefCount<AttributeAccessor>
+class AttributeAccessor : public AtomicSimpleRefCount<AttributeAccessor>
 {
 public:
   AttributeAccessor ();
@@ -163,7 +163,7 @@ public:
  * Most subclasses of this base class are implemented by the
  * ATTRIBUTE_HELPER_HEADER and ATTRIBUTE_HELPER_CPP macros.
  */
-class AttributeChecker : public SimpleRefCount<AttributeChecker>
+class AttributeChecker : public AtomicSimpleRefCount<AttributeChecker>
 {
 public:
   AttributeChecker ();
@@ -25,6 +25,7 @@
 #include "names.h"
 #include "pointer.h"
 #include "log.h"
+#include "replication-context.h"
 
 #include <sstream>
 
@@ -657,6 +658,16 @@ private:
   /** Container type to hold the root Config path tokens. */
   typedef std::vector<Ptr<Object> > Roots;
 
+  /**
+   * Get the Config path roots of the calling thread.
+   *
+   * A thread running a replication has its own list.
+   * \returns The list of Config path roots.
+   */
+  Roots & GetRoots (void);
+  /** \copydoc GetRoots() */
+  const Roots & GetRoots (void) const;
+
   /** The list of Config path roots. */
   Roots m_roots;
 
@@ -766,7 +777,8 @@ public:
     std::vector<Ptr<Object> > m_objects;
     std::vector<std::string> m_contexts;
   } resolver = LookupMatchesResolver (path);
-  for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
+  const Roots &roots = GetRoots ();
+  for (Roots::const_iterator i = roots.begin (); i != roots.end (); i++)
     {
       resolver.Resolve (*i);
     }
@@ -785,7 +797,7 @@ void
 ConfigImpl::RegisterRootNamespaceObject (Ptr<Object> obj)
 {
   NS_LOG_FUNCTION (this << obj);
-  m_roots.push_back (obj);
+  GetRoots ().push_back (obj);
 }
 
 void
@@ -793,11 +805,12 @@ ConfigImpl::UnregisterRootNamespaceObject (Ptr<Object> obj)
 {
   NS_LOG_FUNCTION (this << obj);
 
-  for (std::vector<Ptr<Object> >::iterator i = m_roots.begin (); i != m_roots.end (); i++)
+  Roots &roots = GetRoots ();
+  for (std::vector<Ptr<Object> >::iterator i = roots.begin (); i != roots.end (); i++)
     {
       if (*i == obj)
         {
-          m_roots.erase (i);
+          roots.erase (i);
           return;
         }
     }
@@ -807,13 +820,26 @@ std::size_t
 ConfigImpl::GetRootNamespaceObjectN (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_roots.size ();
+  return GetRoots ().size ();
 }
 Ptr<Object>
 ConfigImpl::GetRootNamespaceObject (std::size_t i) const
 {
   NS_LOG_FUNCTION (this << i);
-  return m_roots[i];
+  return GetRoots ()[i];
+}
+
+ConfigImpl::Roots &
+ConfigImpl::GetRoots (void)
+{
+  static thread_local Roots replicationRoots;
+  return ReplicationContext::IsActive () ? replicationRoots : m_roots;
+}
+
+const ConfigImpl::Roots &
+ConfigImpl::GetRoots (void) const
+{
+  return const_cast<ConfigImpl *> (this)->GetRoots ();
 }
 
 
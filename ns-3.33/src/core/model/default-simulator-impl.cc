@@ -25,10 +25,13 @@
 
 #include "ptr.h"
 #include "pointer.h"
+#include "double.h"
+#include "uinteger.h"
 #include "assert.h"
 #include "log.h"
 
 #include <cmath>
+#include <vector>
 
 
 /**
@@ -53,6 +56,19 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("CompactionRatio",
+                   "Drop the cancelled events from the event list when "
+                   "there are more than this number of them per live "
+                   "event. Zero disables the compaction.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&DefaultSimulatorImpl::m_compactionRatio),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("CompactionMinimum",
+                   "Minimum number of cancelled events in the event list "
+                   "before it is compacted.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&DefaultSimulatorImpl::m_compactionMinimum),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -71,6 +87,8 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentTs = 0;
   m_currentContext = Simulator::NO_CONTEXT;
   m_unscheduledEvents = 0;
+  m_cancelledEvents = 0;
+  m_peakEvents = 0;
   m_eventCount = 0;
   m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self ();
@@ -143,6 +161,12 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   NS_ASSERT (next.key.m_ts >= m_currentTs);
   m_unscheduledEvents--;
   m_eventCount++;
+  if (next.impl->IsCancelled () && m_cancelledEvents > 0)
+    {
+      // Events cancelled directly through EventImpl::Cancel are not
+      // counted, hence the check
+      m_cancelledEvents--;
+    }
 
   NS_LOG_LOGIC ("handle " << next.key.m_ts);
   m_currentTs = next.key.m_ts;
@@ -154,6 +178,43 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   ProcessEventsWithContext ();
 }
 
+void
+DefaultSimulatorImpl::Insert (const Scheduler::Event &ev)
+{
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+  if (static_cast<uint64_t> (m_unscheduledEvents) > m_peakEvents)
+    {
+      m_peakEvents = m_unscheduledEvents;
+    }
+}
+
+void
+DefaultSimulatorImpl::Compact (void)
+{
+  NS_LOG_FUNCTION (this << m_unscheduledEvents << m_cancelledEvents);
+  std::vector<Scheduler::Event> live;
+  live.reserve (m_unscheduledEvents - m_cancelledEvents);
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event ev = m_events->RemoveNext ();
+      if (ev.impl->IsCancelled ())
+        {
+          ev.impl->Unref ();
+          m_unscheduledEvents--;
+        }
+      else
+        {
+          live.push_back (ev);
+        }
+    }
+  for (std::vector<Scheduler::Event>::const_iterator i = live.begin (); i != live.end (); ++i)
+    {
+      m_events->Insert (*i);
+    }
+  m_cancelledEvents = 0;
+}
+
 bool
 DefaultSimulatorImpl::IsFinished (void) const
 {
@@ -185,8 +246,7 @@ DefaultSimulatorImpl::ProcessEventsWithContext (void)
       ev.key.m_context = event.context;
       ev.key.m_uid = m_uid;
       m_uid++;
-      m_unscheduledEvents++;
-      m_events->Insert (ev);
+      Insert (ev);
     }
 }
 
@@ -241,8 +301,7 @@ DefaultSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
   ev.key.m_context = GetContext ();
   ev.key.m_uid = m_uid;
   m_uid++;
-  m_unscheduledEvents++;
-  m_events->Insert (ev);
+  Insert (ev);
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -260,8 +319,7 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       ev.key.m_context = context;
       ev.key.m_uid = m_uid;
       m_uid++;
-      m_unscheduledEvents++;
-      m_events->Insert (ev);
+      Insert (ev);
     }
   else
     {
@@ -289,8 +347,7 @@ DefaultSimulatorImpl::ScheduleNow (EventImpl *event)
   ev.key.m_context = GetContext ();
   ev.key.m_uid = m_uid;
   m_uid++;
-  m_unscheduledEvents++;
-  m_events->Insert (ev);
+  Insert (ev);
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -361,9 +418,22 @@ DefaultSimulatorImpl::Remove (const EventId &id)
 void
 DefaultSimulatorImpl::Cancel (const EventId &id)
 {
-  if (!IsExpired (id))
+  if (IsExpired (id))
+    {
+      return;
+    }
+  id.PeekEventImpl ()->Cancel ();
+  if (id.GetUid () == 2)
+    {
+      // destroy events are not in the event list
+      return;
+    }
+  m_cancelledEvents++;
+  if (m_compactionRatio > 0 && m_events != 0
+      && m_cancelledEvents >= m_compactionMinimum
+      && m_cancelledEvents > m_compactionRatio * (m_unscheduledEvents - m_cancelledEvents))
     {
-      id.PeekEventImpl ()->Cancel ();
+      Compact ();
     }
 }
 
@@ -418,4 +488,22 @@ DefaultSimulatorImpl::GetEventCount (void) const
   return m_eventCount;
 }
 
+uint64_t
+DefaultSimulatorImpl::GetLiveEventCount (void) const
+{
+  return m_unscheduledEvents - m_cancelledEvents;
+}
+
+uint64_t
+DefaultSimulatorImpl::GetCancelledEventCount (void) const
+{
+  return m_cancelledEvents;
+}
+
+uint64_t
+DefaultSimulatorImpl::GetPeakEventCount (void) const
+{
+  return m_peakEvents;
+}
+
 } // namespace ns3
@@ -78,10 +78,28 @@ public:
   virtual uint32_t GetSystemId (void) const;
   virtual uint32_t GetContext (void) const;
   virtual uint64_t GetEventCount (void) const;
+  virtual uint64_t GetLiveEventCount (void) const;
+  virtual uint64_t GetCancelledEventCount (void) const;
+  virtual uint64_t GetPeakEventCount (void) const;
 
 private:
   virtual void DoDispose (void);
 
+  /**
+   * Insert an event in the event list, and update the event counts.
+   * \param [in] ev The event.
+   */
+  void Insert (const Scheduler::Event &ev);
+  /**
+   * Drop all the cancelled events from the event list.
+   *
+   * The events are moved out of the scheduler and the live ones are
+   * inserted back, which works with any scheduler.  This is done
+   * when the cancelled events outnumber the live ones by the
+   * configured ratio, so the cost is amortized over the cancellations.
+   */
+  void Compact (void);
+
   /** Process the next event. */
   void ProcessOneEvent (void);
   /** Move events from a different context into the main event queue. */
@@ -133,6 +151,17 @@ private:
    *  not counting the Destroy events; this is used for validation
    */
   int m_unscheduledEvents;
+  /** Number of events cancelled through Cancel() still in the event list. */
+  uint64_t m_cancelledEvents;
+  /** Largest size of the event list. */
+  uint64_t m_peakEvents;
+  /**
+   * Compact the event list when there are more than this number of
+   * cancelled events per live event; zero disables compaction.
+   */
+  double m_compactionRatio;
+  /** Do not compact the event list with fewer cancelled events. */
+  uint32_t m_compactionMinimum;
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
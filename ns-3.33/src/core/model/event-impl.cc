@@ -20,6 +20,7 @@
 
 #include "event-impl.h"
 #include "log.h"
+#include "per-thread-pool.h"
 
 /**
  * \file
@@ -31,6 +32,126 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/** Granularity of the event pool size classes, in bytes. */
+const std::size_t POOL_GRANULE = 16;
+/** Number of event pool size classes. */
+const std::size_t POOL_CLASSES = EventImpl::MAX_POOLED_SIZE / POOL_GRANULE;
+
+/**
+ * A block of event storage, the identity of the pool of its size.
+ * \tparam S The size of the block, in bytes.
+ */
+template <std::size_t S>
+struct EventBlock
+{
+  char data[S]; //!< Storage
+};
+
+/**
+ * The pools of the first I size classes of events.
+ *
+ * The size class c holds blocks of (c + 1) * POOL_GRANULE bytes.
+ * \tparam I The number of size classes.
+ */
+template <std::size_t I>
+struct EventPools
+{
+  /** The blocks of the size class I - 1. */
+  typedef EventBlock<I * POOL_GRANULE> Block;
+  /** The pool of the size class I - 1. */
+  typedef PerThreadPool<Block, EventImpl::MAX_POOLED_EVENTS> Pool;
+
+  /**
+   * Take a block from the pool of a size class.
+   * \param [in] index The size class.
+   * \returns A released block, or 0 if the pool is empty.
+   */
+  static void * Pop (std::size_t index)
+  {
+    return index == I - 1 ? Pool::Pop () : EventPools<I - 1>::Pop (index);
+  }
+  /**
+   * Give a block to the pool of a size class.
+   * \param [in] index The size class.
+   * \param [in] p The released block.
+   * \returns false if the pool refused the block.
+   */
+  static bool Push (std::size_t index, void *p)
+  {
+    return index == I - 1
+           ? Pool::Push (static_cast<Block *> (p))
+           : EventPools<I - 1>::Push (index, p);
+  }
+  /** \returns The number of blocks in the pools. */
+  static uint32_t GetSize (void)
+  {
+    return Pool::GetSize () + EventPools<I - 1>::GetSize ();
+  }
+};
+
+/** No size class left. */
+template <>
+struct EventPools<0>
+{
+  /** \returns 0 */
+  static void * Pop (std::size_t)
+  {
+    return 0;
+  }
+  /** \returns false */
+  static bool Push (std::size_t, void *)
+  {
+    return false;
+  }
+  /** \returns 0 */
+  static uint32_t GetSize (void)
+  {
+    return 0;
+  }
+};
+
+/** The pools of all the size classes of events. */
+typedef EventPools<POOL_CLASSES> EventPool;
+
+} // unnamed namespace
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  if (size > MAX_POOLED_SIZE)
+    {
+      return ::operator new (size);
+    }
+  std::size_t index = (size - 1) / POOL_GRANULE;
+  void *p = EventPool::Pop (index);
+  if (p != 0)
+    {
+      return p;
+    }
+  return ::operator new ((index + 1) * POOL_GRANULE);
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  if (size > MAX_POOLED_SIZE || !EventPool::Push ((size - 1) / POOL_GRANULE, p))
+    {
+      ::operator delete (p);
+    }
+}
+
+uint32_t
+EventImpl::GetPoolSize (void)
+{
+  return EventPool::GetSize ();
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -40,6 +41,17 @@ namespace ns3 {
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are allocated and freed at a very high rate, so EventImpl
+ * provides its own operator new and delete.  Objects of up to
+ * MAX_POOLED_SIZE bytes, which covers the bound arguments of almost
+ * every MakeEvent() specialization, are rounded up to a size class and
+ * recycled through a PerThreadPool per size class instead of going to
+ * the system allocator.  Each thread keeps up to MAX_POOLED_EVENTS
+ * released blocks per size class, and gives them back to the system
+ * when it exits; the events released after that, such as the pending
+ * events of a simulator destroyed by the static objects, go straight
+ * back to the system allocator.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -66,6 +78,32 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate storage for an event from the event pool.
+   *
+   * \param [in] size The size of the most-derived event type.
+   * \returns Storage for the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Return the storage of an event to the event pool.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the most-derived event type.
+   */
+  static void operator delete (void *p, std::size_t size);
+
+  /**
+   * \returns The number of released blocks kept by the event pool of
+   *          the calling thread.
+   */
+  static uint32_t GetPoolSize (void);
+
+  /** Largest event, in bytes, served from the event pool. */
+  static const std::size_t MAX_POOLED_SIZE = 256;
+  /** Largest number of released blocks kept by each thread per size class. */
+  static const uint32_t MAX_POOLED_EVENTS = 1000;
+
 protected:
   /**
    * Implementation for Invoke().
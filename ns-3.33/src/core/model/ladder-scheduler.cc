@@ -0,0 +1,281 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+namespace {
+
+/** Bucket size above which a bucket is split into a new rung. */
+const uint32_t LADDER_THRESHOLD = 50;
+/** Maximum number of rungs. */
+const uint32_t LADDER_MAX_RUNGS = 8;
+
+/**
+ * Order events latest first.
+ * \param [in] a The first event.
+ * \param [in] b The second event.
+ * \returns \c true if \c a is later than \c b
+ */
+bool
+LaterThan (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return a.key > b.key;
+}
+
+} // unnamed namespace
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topMin (UINT64_MAX),
+    m_topMax (0),
+    m_topStart (0),
+    m_rungs (LADDER_MAX_RUNGS),
+    m_nRungs (0),
+    m_size (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+LadderScheduler::CurrentStart (const Rung &rung)
+{
+  return rung.m_start + rung.m_current * rung.m_width;
+}
+
+LadderScheduler::Bucket *
+LadderScheduler::Locate (uint64_t ts)
+{
+  if (ts >= m_topStart)
+    {
+      return &m_top;
+    }
+  for (uint32_t i = 0; i < m_nRungs; ++i)
+    {
+      Rung &rung = m_rungs[i];
+      if (ts >= CurrentStart (rung))
+        {
+          uint64_t index = (ts - rung.m_start) / rung.m_width;
+          NS_ASSERT (index < rung.m_buckets.size ());
+          return &rung.m_buckets[index];
+        }
+    }
+  return 0;
+}
+
+void
+LadderScheduler::SpawnRung (Bucket &events, uint64_t start, uint64_t end)
+{
+  NS_LOG_FUNCTION (this << events.size () << start << end);
+  NS_ASSERT (m_nRungs < LADDER_MAX_RUNGS && !events.empty () && end > start);
+
+  Rung &rung = m_rungs[m_nRungs++];
+  uint64_t span = end - start;
+  uint64_t width = std::max<uint64_t> ((span + events.size () - 1) / events.size (), 1);
+  rung.m_start = start;
+  rung.m_width = width;
+  rung.m_current = 0;
+  rung.m_buckets.resize ((span + width - 1) / width);
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      NS_ASSERT (i->key.m_ts >= start && i->key.m_ts < end);
+      rung.m_buckets[(i->key.m_ts - start) / width].push_back (*i);
+    }
+}
+
+void
+LadderScheduler::SortBottom (void)
+{
+  std::sort (m_bottom.begin (), m_bottom.end (), LaterThan);
+}
+
+void
+LadderScheduler::FillBottom (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (m_bottom.empty ())
+    {
+      if (m_nRungs == 0)
+        {
+          if (m_top.empty ())
+            {
+              return;
+            }
+          m_topStart = m_topMax + 1;
+          SpawnRung (m_top, m_topMin, m_topStart);
+          m_top.clear ();
+          m_topMin = UINT64_MAX;
+          m_topMax = 0;
+          continue;
+        }
+
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.m_current < rung.m_buckets.size ()
+             && rung.m_buckets[rung.m_current].empty ())
+        {
+          ++rung.m_current;
+        }
+      if (rung.m_current == rung.m_buckets.size ())
+        {
+          --m_nRungs;
+          continue;
+        }
+
+      uint64_t bucketStart = CurrentStart (rung);
+      Bucket &bucket = rung.m_buckets[rung.m_current];
+      ++rung.m_current;
+      if (bucket.size () > LADDER_THRESHOLD && rung.m_width > 1
+          && m_nRungs < LADDER_MAX_RUNGS)
+        {
+          SpawnRung (bucket, bucketStart, bucketStart + rung.m_width);
+          bucket.clear ();
+          continue;
+        }
+      m_bottom.swap (bucket);
+      SortBottom ();
+    }
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  ++m_size;
+
+  Bucket *bucket = Locate (ts);
+  if (bucket == &m_top)
+    {
+      m_top.push_back (ev);
+      m_topMin = std::min (m_topMin, ts);
+      m_topMax = std::max (m_topMax, ts);
+    }
+  else if (bucket != 0)
+    {
+      bucket->push_back (ev);
+    }
+  else
+    {
+      m_bottom.insert (std::lower_bound (m_bottom.begin (), m_bottom.end (), ev, LaterThan), ev);
+      if (m_bottom.size () > LADDER_THRESHOLD && m_nRungs < LADDER_MAX_RUNGS
+          && m_bottom.front ().key.m_ts != m_bottom.back ().key.m_ts)
+        {
+          // Bottom covers up to the current bucket of the lowest rung
+          uint64_t end = m_nRungs > 0 ? CurrentStart (m_rungs[m_nRungs - 1]) : m_topStart;
+          SpawnRung (m_bottom, m_bottom.back ().key.m_ts, end);
+          m_bottom.clear ();
+        }
+    }
+
+  if (m_bottom.empty ())
+    {
+      FillBottom ();
+    }
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_size == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_bottom.empty ());
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_bottom.empty ());
+  Scheduler::Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  --m_size;
+  if (m_bottom.empty ())
+    {
+      FillBottom ();
+    }
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  Bucket *bucket = Locate (ev.key.m_ts);
+  if (bucket == 0)
+    {
+      bucket = &m_bottom;
+    }
+  for (Bucket::reverse_iterator i = bucket->rbegin (); i != bucket->rend (); ++i)
+    {
+      if (i->key.m_uid == ev.key.m_uid)
+        {
+          NS_ASSERT (ev.impl == i->impl);
+          // Bottom must stay sorted, buckets need not
+          bucket->erase (--(i.base ()));
+          --m_size;
+          if (m_bottom.empty ())
+            {
+              FillBottom ();
+            }
+          return;
+        }
+    }
+  NS_ASSERT_MSG (false, "Event not found");
+}
+
+} // namespace ns3
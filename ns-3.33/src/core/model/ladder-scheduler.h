@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue published in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh and
+ * Ian Li-Jin Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * Events are kept in three tiers:
+ * - Top: an unsorted vector of the events far in the future.
+ * - Ladder: up to eight rungs of buckets. The first rung is built from
+ *   Top when the ladder is empty, with as many buckets as events and a
+ *   bucket width spreading them evenly. A bucket holding more than
+ *   50 events is not sorted but split into a new, finer rung whose
+ *   width adapts to the events in the bucket, so clustered timestamps
+ *   (serialization times, pacing, retransmission timers) end up in
+ *   small buckets.
+ * - Bottom: a small sorted vector holding the earliest events; RemoveNext
+ *   takes events from there. When it grows beyond the threshold, it is
+ *   turned into a new rung.
+ *
+ * An event is inserted in Top if it is later than the end of the first
+ * rung, else in the first rung whose current bucket starts before it,
+ * else in Bottom. Events are never sorted more than once, and each
+ * event crosses each rung at most once.
+ *
+ * Events with the same timestamp are kept in a single bucket, since
+ * buckets cannot be narrower than one time unit; they are sorted.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Bucket append, or small sorted insert in Bottom
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Bottom kept non-empty and sorted
+ * Remove()     | Linear          | Search in Top or in a bucket
+ * RemoveNext() | ~Constant       | Bucket transfers, spread over the events
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | ~8 rungs of `std::vector`        | Rungs are reused once allocated
+ * Per Event | 0                                | Events stored in `std::vector` directly
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Bucket type: an unsorted vector of Events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A rung of the ladder. */
+  struct Rung
+  {
+    uint64_t m_start;              //!< Timestamp of the first bucket
+    uint64_t m_width;              //!< Time span of each bucket
+    uint32_t m_current;            //!< Index of the next bucket to dequeue
+    std::vector<Bucket> m_buckets; //!< The buckets
+  };
+
+  /**
+   * Get the start of the next bucket to dequeue in a rung.
+   *
+   * Events earlier than this belong to a lower rung or to Bottom.
+   *
+   * \param [in] rung The rung.
+   * \returns The timestamp.
+   */
+  static uint64_t CurrentStart (const Rung &rung);
+  /**
+   * Find the bucket an event belongs to.
+   *
+   * \param [in] ts The event timestamp.
+   * \returns The bucket in the ladder, Top, or 0 if the event
+   *          belongs to Bottom.
+   */
+  Bucket * Locate (uint64_t ts);
+  /**
+   * Create a new rung, below the existing ones.
+   *
+   * \param [in] events The events to spread in the new rung.
+   * \param [in] start The first timestamp covered by the rung.
+   * \param [in] end The first timestamp not covered by the rung.
+   */
+  void SpawnRung (Bucket &events, uint64_t start, uint64_t end);
+  /** Move the earliest events from the ladder or Top to Bottom. */
+  void FillBottom (void);
+  /** Sort Bottom so that the earliest event is at the back. */
+  void SortBottom (void);
+
+  /** Events later than the ladder. */
+  Bucket m_top;
+  /** Lowest timestamp in Top. */
+  uint64_t m_topMin;
+  /** Highest timestamp in Top. */
+  uint64_t m_topMax;
+  /** Events from this timestamp on are stored in Top. */
+  uint64_t m_topStart;
+  /** The rungs; only the first m_nRungs are in use. */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** Earliest events, sorted in decreasing order. */
+  Bucket m_bottom;
+  /** Number of events in the queue. */
+  uint32_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
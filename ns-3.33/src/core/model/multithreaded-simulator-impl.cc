@@ -0,0 +1,911 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#include "multithreaded-simulator-impl.h"
+#include "simulator.h"
+#include "scheduler.h"
+#include "event-impl.h"
+
+#include "ptr.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "abort.h"
+#include "log.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Logging in the event processing functions is avoided, as in
+// DefaultSimulatorImpl.
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/** Timestamp later than any event. */
+const uint64_t NO_TIME = std::numeric_limits<uint64_t>::max ();
+/** Number of polls of the barrier before a waiting thread yields. */
+const uint32_t BARRIER_SPINS = 1024;
+/** The partition run by the calling thread, if any. */
+thread_local void *g_currentLp = 0;
+
+} // unnamed namespace
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("ThreadCount",
+                   "Number of threads running the partitions; zero uses "
+                   "one thread per core.  There are never more threads "
+                   "than partitions.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_threadCount),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_repartitioned (false),
+    m_started (false),
+    m_lookahead (0),
+    m_threadCount (0),
+    m_threads (1),
+    m_nextLp (0),
+    m_barrierCount (0),
+    m_barrierSense (false),
+    m_window (0),
+    m_windowEnd (NO_TIME),
+    m_done (false),
+    m_stopReached (NO_TIME),
+    m_stop (false),
+    m_stopTime (NO_TIME),
+    // uids 0 to 3 are reserved, see DefaultSimulatorImpl
+    m_uid (4),
+    m_currentTs (0),
+    m_windowCount (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      LogicalProcess *lp = *i;
+      for (uint32_t parity = 0; parity < 2; parity++)
+        {
+          for (uint32_t j = 0; j < lp->outbox[parity].size (); j++)
+            {
+              std::vector<Scheduler::Event> &box = lp->outbox[parity][j];
+              for (std::vector<Scheduler::Event>::iterator k = box.begin (); k != box.end (); ++k)
+                {
+                  k->impl->Unref ();
+                }
+            }
+        }
+      while (!lp->events->IsEmpty ())
+        {
+          Scheduler::Event next = lp->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      delete lp;
+    }
+  m_lps.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (true)
+    {
+      Ptr<EventImpl> ev;
+      {
+        CriticalSection cs (m_destroyMutex);
+        if (m_destroyEvents.empty ())
+          {
+            break;
+          }
+        ev = m_destroyEvents.front ().PeekEventImpl ();
+        m_destroyEvents.pop_front ();
+      }
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  m_schedulerFactory = schedulerFactory;
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      while (!(*i)->events->IsEmpty ())
+        {
+          scheduler->Insert ((*i)->events->RemoveNext ());
+        }
+      (*i)->events = scheduler;
+    }
+  AddPartitions (1);
+}
+
+void
+MultithreadedSimulatorImpl::AddPartitions (uint32_t count)
+{
+  NS_LOG_FUNCTION (this << count);
+  while (m_lps.size () < count)
+    {
+      LogicalProcess *lp = new LogicalProcess ();
+      lp->events = m_schedulerFactory.Create<Scheduler> ();
+      lp->index = m_lps.size ();
+      lp->uid = m_uid;
+      lp->currentUid = 0;
+      lp->currentTs = m_currentTs;
+      lp->currentContext = Simulator::NO_CONTEXT;
+      lp->eventCount = 0;
+      lp->unscheduledEvents = 0;
+      lp->cancelledEvents = 0;
+      lp->peakEvents = 0;
+      lp->nextTs = NO_TIME;
+      lp->stopped = false;
+      lp->stopTs = NO_TIME;
+      m_lps.push_back (lp);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetPartition (uint32_t context, uint32_t partition)
+{
+  NS_LOG_FUNCTION (this << context << partition);
+  NS_ABORT_MSG_IF (m_started, "The partitions cannot change once the simulation has run");
+  NS_ABORT_MSG_IF (context == Simulator::NO_CONTEXT, "The events without context stay in partition 0");
+  if (context >= m_partition.size ())
+    {
+      m_partition.resize (context + 1, 0);
+    }
+  m_partition[context] = partition;
+  AddPartitions (partition + 1);
+  m_repartitioned = true;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  return context < m_partition.size () ? m_partition[context] : 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount (void) const
+{
+  return m_lps.size ();
+}
+
+void
+MultithreadedSimulatorImpl::SetLookahead (const Time &lookahead)
+{
+  NS_LOG_FUNCTION (this << lookahead);
+  NS_ABORT_MSG_IF (!lookahead.IsStrictlyPositive (), "The lookahead must be positive");
+  m_lookahead = lookahead.GetTimeStep ();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead (void) const
+{
+  return TimeStep (m_lookahead);
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetWindowCount (void) const
+{
+  return m_windowCount;
+}
+
+MultithreadedSimulatorImpl::LogicalProcess *
+MultithreadedSimulatorImpl::GetLogicalProcess (uint32_t context) const
+{
+  return m_lps[GetPartition (context)];
+}
+
+MultithreadedSimulatorImpl::LogicalProcess *
+MultithreadedSimulatorImpl::GetCurrentLogicalProcess (void) const
+{
+  return static_cast<LogicalProcess *> (g_currentLp);
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+void
+MultithreadedSimulatorImpl::Insert (LogicalProcess *lp, const Scheduler::Event &ev)
+{
+  lp->unscheduledEvents++;
+  lp->events->Insert (ev);
+  if (static_cast<uint64_t> (lp->unscheduledEvents) > lp->peakEvents)
+    {
+      lp->peakEvents = lp->unscheduledEvents;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Redistribute (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<Scheduler::Event> moved;
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      LogicalProcess *lp = *i;
+      std::vector<Scheduler::Event> kept;
+      while (!lp->events->IsEmpty ())
+        {
+          Scheduler::Event ev = lp->events->RemoveNext ();
+          if (GetPartition (ev.key.m_context) == lp->index)
+            {
+              kept.push_back (ev);
+            }
+          else
+            {
+              moved.push_back (ev);
+            }
+        }
+      for (std::vector<Scheduler::Event>::const_iterator k = kept.begin (); k != kept.end (); ++k)
+        {
+          lp->events->Insert (*k);
+        }
+      lp->unscheduledEvents = kept.size ();
+      lp->cancelledEvents = 0;
+    }
+  for (std::vector<Scheduler::Event>::const_iterator k = moved.begin (); k != moved.end (); ++k)
+    {
+      Insert (GetLogicalProcess (k->key.m_context), *k);
+    }
+  m_repartitioned = false;
+}
+
+void
+MultithreadedSimulatorImpl::DrainMailboxes (LogicalProcess *lp, uint32_t parity)
+{
+  // The mailboxes are read in partition order, so that the uids, which
+  // order the events of the same timestamp, do not depend on the threads.
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      std::vector<Scheduler::Event> &box = (*i)->outbox[parity][lp->index];
+      for (std::vector<Scheduler::Event>::iterator k = box.begin (); k != box.end (); ++k)
+        {
+          k->key.m_uid = lp->uid;
+          lp->uid++;
+          Insert (lp, *k);
+        }
+      box.clear ();
+      std::vector<Scheduler::Event> &cancels = (*i)->cancelbox[parity][lp->index];
+      for (std::vector<Scheduler::Event>::iterator k = cancels.begin (); k != cancels.end (); ++k)
+        {
+          // Not run yet, hence still in the event list
+          bool run = k->key.m_ts < lp->currentTs
+            || (k->key.m_ts == lp->currentTs && k->key.m_uid <= lp->currentUid);
+          if (!run && !k->impl->IsCancelled ())
+            {
+              k->impl->Cancel ();
+              lp->cancelledEvents++;
+            }
+        }
+      cancels.clear ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (LogicalProcess *lp)
+{
+  Scheduler::Event next = lp->events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= lp->currentTs);
+  lp->unscheduledEvents--;
+  lp->eventCount++;
+  if (next.impl->IsCancelled () && lp->cancelledEvents > 0)
+    {
+      lp->cancelledEvents--;
+    }
+
+  lp->currentTs = next.key.m_ts;
+  lp->currentContext = next.key.m_context;
+  lp->currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow (LogicalProcess *lp)
+{
+  g_currentLp = lp;
+  DrainMailboxes (lp, (m_window + 1) & 1);
+  lp->nextTs = NO_TIME;
+  lp->stopped = false;
+  lp->stopTs = NO_TIME;
+  // The stops of the other partitions are only checked between windows,
+  // whose end is before the earliest stop time known at their start
+  while (!lp->events->IsEmpty () && !lp->stopped)
+    {
+      uint64_t ts = lp->events->PeekNext ().key.m_ts;
+      if (ts >= m_windowEnd || ts > lp->stopTs)
+        {
+          break;
+        }
+      ProcessOneEvent (lp);
+    }
+  if (!lp->events->IsEmpty ())
+    {
+      // nextTs already holds the earliest event sent to the others
+      lp->nextTs = std::min (lp->nextTs, lp->events->PeekNext ().key.m_ts);
+    }
+  g_currentLp = 0;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetStopTime (void) const
+{
+  return m_stopTime.load (std::memory_order_relaxed);
+}
+
+void
+MultithreadedSimulatorImpl::PlanWindow (void)
+{
+  uint64_t next = NO_TIME;
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      next = std::min (next, (*i)->nextTs);
+    }
+  uint64_t stop = GetStopTime ();
+  if (m_stop.load (std::memory_order_relaxed) || (next == NO_TIME && stop == NO_TIME))
+    {
+      m_done = true;
+      return;
+    }
+  if (next > stop)
+    {
+      // The stop time is reached before the next event, as the stop
+      // event of DefaultSimulatorImpl would be.
+      m_stopReached = stop;
+      m_done = true;
+      return;
+    }
+  if (m_lps.size () == 1 || NO_TIME - next <= m_lookahead)
+    {
+      m_windowEnd = NO_TIME;
+    }
+  else
+    {
+      m_windowEnd = next + m_lookahead;
+    }
+  if (stop != NO_TIME)
+    {
+      // The events at the stop time are run
+      m_windowEnd = std::min (m_windowEnd, stop + 1);
+    }
+  m_window++;
+  m_windowCount++;
+  m_nextLp.store (0, std::memory_order_relaxed);
+}
+
+void
+MultithreadedSimulatorImpl::Barrier (bool &sense)
+{
+  sense = !sense;
+  if (m_barrierCount.fetch_sub (1, std::memory_order_acq_rel) == 1)
+    {
+      // Last one in: all the partitions are done with the window
+      PlanWindow ();
+      m_barrierCount.store (m_threads, std::memory_order_relaxed);
+      m_barrierSense.store (sense, std::memory_order_release);
+    }
+  else
+    {
+      uint32_t spins = 0;
+      while (m_barrierSense.load (std::memory_order_acquire) != sense)
+        {
+          if (++spins >= BARRIER_SPINS)
+            {
+              std::this_thread::yield ();
+            }
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Work (void)
+{
+  const uint32_t n = m_lps.size ();
+  bool sense = false;
+  while (true)
+    {
+      uint32_t i;
+      while ((i = m_nextLp.fetch_add (1, std::memory_order_relaxed)) < n)
+        {
+          ProcessWindow (m_lps[i]);
+        }
+      Barrier (sense);
+      if (m_done)
+        {
+          break;
+        }
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop.load (std::memory_order_relaxed))
+    {
+      return true;
+    }
+  if (GetStopTime () != NO_TIME)
+    {
+      return false;
+    }
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      if (!(*i)->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_repartitioned)
+    {
+      Redistribute ();
+    }
+  m_started = true;
+  const uint32_t n = m_lps.size ();
+  NS_ABORT_MSG_IF (n > 1 && m_lookahead == 0,
+                   "MultithreadedSimulatorImpl: the lookahead must be set when there are several partitions");
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      LogicalProcess *lp = *i;
+      lp->outbox[0].resize (n);
+      lp->outbox[1].resize (n);
+      lp->cancelbox[0].resize (n);
+      lp->cancelbox[1].resize (n);
+      lp->uid = std::max (lp->uid, m_uid);
+      lp->nextTs = lp->events->IsEmpty () ? NO_TIME : lp->events->PeekNext ().key.m_ts;
+    }
+
+  uint32_t threads = m_threadCount;
+  if (threads == 0)
+    {
+      threads = std::max (1u, std::thread::hardware_concurrency ());
+    }
+  m_threads = std::min (threads, n);
+  m_stop.store (false);
+  m_stopReached = NO_TIME;
+  m_done = false;
+  m_window = 0;
+  m_barrierCount.store (m_threads);
+  m_barrierSense.store (false);
+  NS_LOG_LOGIC ("run " << n << " partitions on " << m_threads << " threads");
+
+  PlanWindow ();
+  if (!m_done)
+    {
+      std::vector<std::thread> workers;
+      for (uint32_t i = 1; i < m_threads; i++)
+        {
+          workers.push_back (std::thread (&MultithreadedSimulatorImpl::Work, this));
+        }
+      Work ();
+      for (std::vector<std::thread>::iterator i = workers.begin (); i != workers.end (); ++i)
+        {
+          i->join ();
+        }
+    }
+
+  // Deliver the events sent during the last window, and bring the
+  // out-of-run state up to date
+  for (std::vector<LogicalProcess *>::iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      DrainMailboxes (*i, 0);
+      DrainMailboxes (*i, 1);
+    }
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      m_currentTs = std::max (m_currentTs, (*i)->currentTs);
+      m_uid = std::max (m_uid, (*i)->uid);
+    }
+  if (m_stopReached != NO_TIME)
+    {
+      m_currentTs = std::max (m_currentTs, m_stopReached);
+      CriticalSection cs (m_stopMutex);
+      m_stopTimes.erase (m_stopTimes.begin (), m_stopTimes.upper_bound (m_stopReached));
+      m_stopTime.store (m_stopTimes.empty () ? NO_TIME : *m_stopTimes.begin ());
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  LogicalProcess *lp = GetCurrentLogicalProcess ();
+  if (lp != 0)
+    {
+      lp->stopped = true;
+    }
+  m_stop.store (true);
+}
+
+void
+MultithreadedSimulatorImpl::Stop (const Time &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  uint64_t ts = Now ().GetTimeStep () + delay.GetTimeStep ();
+  LogicalProcess *lp = GetCurrentLogicalProcess ();
+  if (lp != 0)
+    {
+      lp->stopTs = std::min (lp->stopTs, ts);
+    }
+  CriticalSection cs (m_stopMutex);
+  m_stopTimes.insert (ts);
+  m_stopTime.store (*m_stopTimes.begin ());
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule (const Time &delay, EventImpl *event)
+{
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+  LogicalProcess *lp = GetCurrentLogicalProcess ();
+  Scheduler::Event ev;
+  ev.impl = event;
+  if (lp != 0)
+    {
+      ev.key.m_ts = lp->currentTs + delay.GetTimeStep ();
+      ev.key.m_context = lp->currentContext;
+      ev.key.m_uid = lp->uid;
+      lp->uid++;
+    }
+  else
+    {
+      ev.key.m_ts = m_currentTs + delay.GetTimeStep ();
+      ev.key.m_context = Simulator::NO_CONTEXT;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      lp = GetLogicalProcess (ev.key.m_context);
+    }
+  Insert (lp, ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event)
+{
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::ScheduleWithContext(): Negative delay");
+  LogicalProcess *lp = GetCurrentLogicalProcess ();
+  LogicalProcess *target = GetLogicalProcess (context);
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_context = context;
+  if (lp == 0)
+    {
+      ev.key.m_ts = m_currentTs + delay.GetTimeStep ();
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      Insert (target, ev);
+    }
+  else if (lp == target)
+    {
+      ev.key.m_ts = lp->currentTs + delay.GetTimeStep ();
+      ev.key.m_uid = lp->uid;
+      lp->uid++;
+      Insert (lp, ev);
+    }
+  else
+    {
+      if (static_cast<uint64_t> (delay.GetTimeStep ()) < m_lookahead)
+        {
+          NS_FATAL_ERROR ("Event for context " << context << " sent from partition " << lp->index <<
+                          " to partition " << target->index << " with a delay of " << delay <<
+                          ", shorter than the lookahead " << TimeStep (m_lookahead));
+        }
+      // The uid is set by the receiving partition
+      ev.key.m_ts = lp->currentTs + delay.GetTimeStep ();
+      ev.key.m_uid = 0;
+      lp->outbox[m_window & 1][target->index].push_back (ev);
+      lp->nextTs = std::min (lp->nextTs, ev.key.m_ts);
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (TimeStep (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), Now ().GetTimeStep (), 0xffffffff, 2);
+  CriticalSection cs (m_destroyMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  LogicalProcess *lp = GetCurrentLogicalProcess ();
+  return TimeStep (lp != 0 ? lp->currentTs : m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - Now ().GetTimeStep ());
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  LogicalProcess *lp = GetLogicalProcess (id.GetContext ());
+  LogicalProcess *current = GetCurrentLogicalProcess ();
+  if (current != 0 && current != lp)
+    {
+      // The event list of another partition cannot be touched
+      PostCancel (current, lp, id);
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  lp->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  lp->unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::PostCancel (LogicalProcess *lp, LogicalProcess *target, const EventId &id)
+{
+  if (IsExpired (id))
+    {
+      return;
+    }
+  // The EventImpl is not referenced: its reference count is not atomic
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  lp->cancelbox[m_window & 1][target->index].push_back (event);
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (id.GetUid () != 2)
+    {
+      LogicalProcess *lp = GetLogicalProcess (id.GetContext ());
+      LogicalProcess *current = GetCurrentLogicalProcess ();
+      if (current != 0 && current != lp)
+        {
+          PostCancel (current, lp, id);
+          return;
+        }
+      if (IsExpired (id))
+        {
+          return;
+        }
+      id.PeekEventImpl ()->Cancel ();
+      lp->cancelledEvents++;
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  id.PeekEventImpl ()->Cancel ();
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0
+          || id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (m_destroyMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  // The event runs in the partition of its context, against whose
+  // clock it is compared
+  const LogicalProcess *lp = GetLogicalProcess (id.GetContext ());
+  const LogicalProcess *current = GetCurrentLogicalProcess ();
+  if (current != 0 && current != lp)
+    {
+      // The clock and the cancellations of a running partition cannot be
+      // read: compare with the clock of the calling partition
+      return id.PeekEventImpl () == 0 || id.GetTs () < current->currentTs;
+    }
+  if (id.PeekEventImpl () == 0
+      || id.GetTs () < lp->currentTs
+      || (id.GetTs () == lp->currentTs && id.GetUid () <= lp->currentUid)
+      || id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  LogicalProcess *lp = GetCurrentLogicalProcess ();
+  return lp != 0 ? lp->currentContext : Simulator::NO_CONTEXT;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount (void) const
+{
+  LogicalProcess *lp = GetCurrentLogicalProcess ();
+  if (lp != 0)
+    {
+      return lp->eventCount;
+    }
+  uint64_t count = 0;
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      count += (*i)->eventCount;
+    }
+  return count;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetLiveEventCount (void) const
+{
+  LogicalProcess *lp = GetCurrentLogicalProcess ();
+  if (lp != 0)
+    {
+      return lp->unscheduledEvents - lp->cancelledEvents;
+    }
+  uint64_t count = 0;
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      count += (*i)->unscheduledEvents - (*i)->cancelledEvents;
+    }
+  return count;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetCancelledEventCount (void) const
+{
+  LogicalProcess *lp = GetCurrentLogicalProcess ();
+  if (lp != 0)
+    {
+      return lp->cancelledEvents;
+    }
+  uint64_t count = 0;
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      count += (*i)->cancelledEvents;
+    }
+  return count;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetPeakEventCount (void) const
+{
+  LogicalProcess *lp = GetCurrentLogicalProcess ();
+  if (lp != 0)
+    {
+      return lp->peakEvents;
+    }
+  // The partitions may not peak at the same time: this is an upper bound
+  uint64_t count = 0;
+  for (std::vector<LogicalProcess *>::const_iterator i = m_lps.begin (); i != m_lps.end (); ++i)
+    {
+      count += (*i)->peakEvents;
+    }
+  return count;
+}
+
+} // namespace ns3
@@ -98,7 +98,7 @@ Ptr<Object>
 ObjectFactory::Create (void) const
 {
   NS_LOG_FUNCTION (this);
-  Callback<ObjectBase *> cb = m_tid.GetConstructor ();
+  const Callback<ObjectBase *> &cb = m_tid.GetConstructor ();
   ObjectBase *base = cb ();
   Object *derived = dynamic_cast<Object *> (base);
   NS_ASSERT (derived != 0);
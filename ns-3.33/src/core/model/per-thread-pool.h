@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef PER_THREAD_POOL_H
+#define PER_THREAD_POOL_H
+
+#include <stdint.h>
+#include <new>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ *
+ * \brief Per-thread free list of released memory blocks.
+ *
+ * Events, packets, packet tags and queue disc items are created and
+ * released at a very high rate; keeping their released storage for the
+ * next allocations saves most of the calls to the heap allocator.  The
+ * simulation of a partition or of a replication runs on its own thread,
+ * so there is one free list per thread and no locking: a block
+ * released by another thread than the one which allocated it simply
+ * joins the list of the releasing thread.
+ *
+ * The list of a thread is destroyed when the thread exits, before the
+ * static objects of the main thread, which may still hold events or
+ * packets, are destroyed.  From then on the pool of the thread stays
+ * empty and refuses the released blocks, which the callers give back to
+ * the heap.
+ *
+ * The blocks must be allocated with ::operator new: the blocks left in
+ * the list are released with ::operator delete when the thread exits.
+ * The pool does not know the size of its blocks, the callers put in a
+ * pool only blocks of the size they will pop from it.
+ *
+ * \tparam T The type of the blocks, also the identity of the pool.
+ * \tparam N The largest number of blocks kept by each thread.
+ */
+template <typename T, uint32_t N>
+class PerThreadPool
+{
+public:
+  /**
+   * \brief Take a block from the pool of the calling thread.
+   * \returns A released block, or 0 if the pool is empty.
+   */
+  static T * Pop (void);
+  /**
+   * \brief Give a block to the pool of the calling thread.
+   * \param [in] block The released block.
+   * \returns false if the pool is full or destroyed: the caller must
+   *          then release the block itself.
+   */
+  static bool Push (T *block);
+  /**
+   * \returns The number of blocks in the pool of the calling thread.
+   */
+  static uint32_t GetSize (void);
+
+private:
+  /** The released blocks of one thread. */
+  class FreeList : public std::vector<T *>
+  {
+  public:
+    ~FreeList ();
+  };
+  static thread_local FreeList m_freeList; //!< Released blocks of the thread
+  static thread_local bool m_destroyed;    //!< m_freeList has been destroyed
+};
+
+template <typename T, uint32_t N>
+thread_local typename PerThreadPool<T, N>::FreeList PerThreadPool<T, N>::m_freeList;
+
+template <typename T, uint32_t N>
+thread_local bool PerThreadPool<T, N>::m_destroyed = false;
+
+template <typename T, uint32_t N>
+PerThreadPool<T, N>::FreeList::~FreeList ()
+{
+  for (typename FreeList::iterator i = this->begin (); i != this->end (); i++)
+    {
+      ::operator delete (*i);
+    }
+  this->clear ();
+  m_destroyed = true;
+}
+
+template <typename T, uint32_t N>
+T *
+PerThreadPool<T, N>::Pop (void)
+{
+  if (m_destroyed || m_freeList.empty ())
+    {
+      return 0;
+    }
+  T *block = m_freeList.back ();
+  m_freeList.pop_back ();
+  return block;
+}
+
+template <typename T, uint32_t N>
+bool
+PerThreadPool<T, N>::Push (T *block)
+{
+  if (m_destroyed || m_freeList.size () >= N)
+    {
+      return false;
+    }
+  m_freeList.push_back (block);
+  return true;
+}
+
+template <typename T, uint32_t N>
+uint32_t
+PerThreadPool<T, N>::GetSize (void)
+{
+  return m_destroyed ? 0 : m_freeList.size ();
+}
+
+} // namespace ns3
+
+#endif /* PER_THREAD_POOL_H */
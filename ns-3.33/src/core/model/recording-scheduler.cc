@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#include "recording-scheduler.h"
+#include "map-scheduler.h"
+#include "simulator.h"
+#include "string.h"
+#include "type-id.h"
+#include "log.h"
+#include "abort.h"
+#include <iomanip>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::RecordingScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RecordingScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (RecordingScheduler);
+
+TypeId
+RecordingScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RecordingScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<RecordingScheduler> ()
+    .AddAttribute ("SchedulerType",
+                   "The scheduler keeping the events.",
+                   TypeIdValue (MapScheduler::GetTypeId ()),
+                   MakeTypeIdAccessor (&RecordingScheduler::m_schedulerTypeId),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("FileName",
+                   "The file the event delays are written to.",
+                   StringValue ("scheduler-events.txt"),
+                   MakeStringAccessor (&RecordingScheduler::m_fileName),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+RecordingScheduler::RecordingScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+RecordingScheduler::~RecordingScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ptr<Scheduler>
+RecordingScheduler::GetScheduler (void) const
+{
+  if (m_scheduler == 0)
+    {
+      ObjectFactory factory;
+      factory.SetTypeId (m_schedulerTypeId);
+      m_scheduler = factory.Create<Scheduler> ();
+    }
+  return m_scheduler;
+}
+
+void
+RecordingScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  if (!m_file.is_open ())
+    {
+      m_file.open (m_fileName.c_str ());
+      m_file << std::fixed << std::setprecision (9);
+      NS_ABORT_MSG_UNLESS (m_file, "Cannot open " << m_fileName);
+    }
+  m_file << (TimeStep (ev.key.m_ts) - Simulator::Now ()).GetSeconds () << "\n";
+  GetScheduler ()->Insert (ev);
+}
+
+bool
+RecordingScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return GetScheduler ()->IsEmpty ();
+}
+
+Scheduler::Event
+RecordingScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return GetScheduler ()->PeekNext ();
+}
+
+Scheduler::Event
+RecordingScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  return GetScheduler ()->RemoveNext ();
+}
+
+void
+RecordingScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  GetScheduler ()->Remove (ev);
+}
+
+} // namespace ns3
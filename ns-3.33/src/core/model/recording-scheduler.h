@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#ifndef RECORDING_SCHEDULER_H
+#define RECORDING_SCHEDULER_H
+
+#include "scheduler.h"
+#include "object-factory.h"
+#include <fstream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::RecordingScheduler class declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a scheduler recording the event delays of a simulation
+ *
+ * This scheduler forwards every operation to another scheduler, given by
+ * the \Attribute{SchedulerType} attribute, and writes the delay of each
+ * inserted event, in seconds, one per line, to \Attribute{FileName}.
+ * The file can be replayed by the scheduler benchmarks
+ * (src/core/examples/bench-scheduler.cc, utils/bench-simulator.cc) to
+ * compare the schedulers on the event distribution of a real model:
+ *
+ * \code
+ *   ./waf --run "tcp-dumbbell --SchedulerType=ns3::RecordingScheduler
+ *               --ns3::RecordingScheduler::FileName=dumbbell-events.txt"
+ *   ./waf --run "bench-scheduler --file=dumbbell-events.txt"
+ * \endcode
+ */
+class RecordingScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  RecordingScheduler ();
+  /** Destructor. */
+  virtual ~RecordingScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /**
+   * Get the scheduler the events are kept in, creating it if needed.
+   * \returns The scheduler.
+   */
+  Ptr<Scheduler> GetScheduler (void) const;
+
+  /** The scheduler type. */
+  TypeId m_schedulerTypeId;
+  /** The file name. */
+  std::string m_fileName;
+  /** The scheduler the events are kept in. */
+  mutable Ptr<Scheduler> m_scheduler;
+  /** The trace file. */
+  std::ofstream m_file;
+};
+
+} // namespace ns3
+
+#endif /* RECORDING_SCHEDULER_H */
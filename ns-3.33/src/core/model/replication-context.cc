@@ -0,0 +1,96 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include "replication-context.h"
+#include "simulator.h"
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ReplicationContext implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ReplicationContext");
+
+namespace {
+
+/** State of the replication run by the calling thread. */
+struct ReplicationState
+{
+  bool active;          //!< Between Enter() and Leave()
+  uint64_t run;         //!< RNG run number
+  uint64_t nextStream;  //!< Next automatically assigned stream
+};
+
+/** The replication of the calling thread. */
+thread_local ReplicationState g_replication = { false, 0, 0 };
+
+} // unnamed namespace
+
+void
+ReplicationContext::Enter (uint64_t run)
+{
+  NS_LOG_FUNCTION (run);
+  NS_ASSERT_MSG (!g_replication.active, "Replication context entered twice");
+  g_replication.active = true;
+  g_replication.run = run;
+  g_replication.nextStream = 0;
+}
+
+void
+ReplicationContext::Leave (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_ASSERT_MSG (g_replication.active, "No replication context to leave");
+  // Release what the replication did not, while its state is reachable
+  Simulator::Destroy ();
+  g_replication.active = false;
+}
+
+bool
+ReplicationContext::IsActive (void)
+{
+  return g_replication.active;
+}
+
+uint64_t
+ReplicationContext::GetRun (void)
+{
+  return g_replication.run;
+}
+
+void
+ReplicationContext::SetRun (uint64_t run)
+{
+  NS_LOG_FUNCTION (run);
+  g_replication.run = run;
+}
+
+uint64_t
+ReplicationContext::GetNextStreamIndex (void)
+{
+  return g_replication.nextStream++;
+}
+
+} // namespace ns3
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef REPLICATION_CONTEXT_H
+#define REPLICATION_CONTEXT_H
+
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ReplicationContext declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Per-thread state of an independent simulation replication.
+ *
+ * A simulation normally keeps its state in process-wide singletons: the
+ * simulator implementation, the NodeList and ChannelList, the
+ * SimulationSingleton instances, the Config root namespace, the address
+ * allocators and the random stream counter.  A thread which enters a
+ * replication context gets its own copy of each of them, so several
+ * simulations can be built, run and destroyed at the same time by the
+ * threads of one process, as ReplicationRunner does.
+ *
+ * Entering a context also gives the thread its own RNG run number, and
+ * restarts the automatic stream assignment at 0: a replication draws
+ * the same random numbers as a separate process started with
+ * --RngRun=run.
+ *
+ * The attribute defaults (Config::SetDefault), the global values other
+ * than the run number, the registered TypeIds, the object names and the
+ * log components are still shared by all the threads.  They should be
+ * set before the replications start; a parameter which differs between
+ * replications is set through the attributes of the objects instead.
+ *
+ * The threads of MultithreadedSimulatorImpl do not enter a context: they
+ * share the state of the thread which built the simulation.
+ */
+class ReplicationContext
+{
+public:
+  /**
+   * \brief Enter a replication context on the calling thread.
+   * \param run the RNG run number of the replication
+   *
+   * Must not be called while a simulation created outside the context
+   * is used by the thread.
+   */
+  static void Enter (uint64_t run);
+  /**
+   * \brief Leave the replication context of the calling thread.
+   *
+   * Destroys the simulation of the replication, if it was not done
+   * yet, so that the per-replication state is released.
+   */
+  static void Leave (void);
+  /**
+   * \brief Check whether the calling thread runs a replication.
+   * \returns true between Enter() and Leave()
+   */
+  static bool IsActive (void);
+  /**
+   * \brief Get the RNG run number of the calling thread.
+   * \returns the run number given to Enter()
+   */
+  static uint64_t GetRun (void);
+  /**
+   * \brief Set the RNG run number of the calling thread.
+   * \param run the new run number
+   */
+  static void SetRun (uint64_t run);
+  /**
+   * \brief Get the next automatically assigned stream of the replication.
+   * \returns the stream index, starting at 0 in each replication
+   */
+  static uint64_t GetNextStreamIndex (void);
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_CONTEXT_H */
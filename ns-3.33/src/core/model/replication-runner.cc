@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include "replication-runner.h"
+#include "replication-context.h"
+#include "simulator.h"
+#include "assert.h"
+#include "log.h"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ReplicationRunner and ns3::ReplicationResult implementations.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ReplicationRunner");
+
+void
+ReplicationResult::Set (const std::string &column, double value)
+{
+  std::ostringstream oss;
+  oss << value;
+  Set (column, oss.str ());
+}
+
+void
+ReplicationResult::Set (const std::string &column, const std::string &value)
+{
+  for (std::vector<std::pair<std::string, std::string> >::iterator i = m_values.begin ();
+       i != m_values.end (); ++i)
+    {
+      if (i->first == column)
+        {
+          i->second = value;
+          return;
+        }
+    }
+  m_values.push_back (std::make_pair (column, value));
+}
+
+std::string
+ReplicationResult::Get (const std::string &column) const
+{
+  for (std::vector<std::pair<std::string, std::string> >::const_iterator i = m_values.begin ();
+       i != m_values.end (); ++i)
+    {
+      if (i->first == column)
+        {
+          return i->second;
+        }
+    }
+  return "";
+}
+
+ReplicationRunner::ReplicationRunner ()
+  : m_threads (0),
+    m_firstRun (1),
+    m_n (0),
+    m_next (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ReplicationRunner::SetThreads (uint32_t threads)
+{
+  NS_LOG_FUNCTION (this << threads);
+  m_threads = threads;
+}
+
+void
+ReplicationRunner::SetFirstRun (uint64_t run)
+{
+  NS_LOG_FUNCTION (this << run);
+  m_firstRun = run;
+}
+
+void
+ReplicationRunner::Run (uint32_t n, SetupCallback setup)
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ASSERT_MSG (!ReplicationContext::IsActive (), "Replications cannot be nested");
+  m_setup = setup;
+  m_n = n;
+  m_next = 0;
+  m_results.clear ();
+  m_results.resize (n);
+
+  uint32_t threads = m_threads;
+  if (threads == 0)
+    {
+      threads = std::max (1u, std::thread::hardware_concurrency ());
+    }
+  threads = std::min (threads, n);
+  NS_LOG_INFO ("Running " << n << " replications on " << threads << " threads");
+
+  std::vector<std::thread> workers;
+  for (uint32_t i = 1; i < threads; ++i)
+    {
+      workers.push_back (std::thread (&ReplicationRunner::Work, this));
+    }
+  if (threads > 0)
+    {
+      Work ();
+    }
+  for (std::vector<std::thread>::iterator i = workers.begin (); i != workers.end (); ++i)
+    {
+      i->join ();
+    }
+  m_setup = SetupCallback ();
+}
+
+void
+ReplicationRunner::Work (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (true)
+    {
+      uint32_t index;
+      CollectCallback collect;
+      {
+        CriticalSection cs (m_lock);
+        if (m_next == m_n)
+          {
+            return;
+          }
+        index = m_next++;
+        ReplicationContext::Enter (m_firstRun + index);
+        collect = m_setup (index);
+      }
+      NS_LOG_LOGIC ("Replication " << index << " built");
+      Simulator::Run ();
+      if (!collect.IsNull ())
+        {
+          collect (m_results[index]);
+        }
+      Simulator::Destroy ();
+      ReplicationContext::Leave ();
+      NS_LOG_LOGIC ("Replication " << index << " done");
+    }
+}
+
+uint32_t
+ReplicationRunner::GetN (void) const
+{
+  return m_n;
+}
+
+const ReplicationResult &
+ReplicationRunner::GetResult (uint32_t i) const
+{
+  NS_ASSERT (i < m_results.size ());
+  return m_results[i];
+}
+
+void
+ReplicationRunner::Print (std::ostream &os) const
+{
+  std::vector<std::string> columns;
+  for (std::vector<ReplicationResult>::const_iterator r = m_results.begin ();
+       r != m_results.end (); ++r)
+    {
+      for (std::vector<std::pair<std::string, std::string> >::const_iterator v = r->m_values.begin ();
+           v != r->m_values.end (); ++v)
+        {
+          if (std::find (columns.begin (), columns.end (), v->first) == columns.end ())
+            {
+              columns.push_back (v->first);
+            }
+        }
+    }
+  os << "replication\trun";
+  for (std::vector<std::string>::const_iterator c = columns.begin (); c != columns.end (); ++c)
+    {
+      os << "\t" << *c;
+    }
+  os << std::endl;
+  for (uint32_t i = 0; i < m_results.size (); ++i)
+    {
+      os << i << "\t" << m_firstRun + i;
+      for (std::vector<std::string>::const_iterator c = columns.begin (); c != columns.end (); ++c)
+        {
+          os << "\t" << m_results[i].Get (*c);
+        }
+      os << std::endl;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+#include "callback.h"
+#include "system-mutex.h"
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::ReplicationRunner and ns3::ReplicationResult declarations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief The values measured by one replication.
+ *
+ * Each value is stored in a named column of the results table of
+ * ReplicationRunner.
+ */
+class ReplicationResult
+{
+public:
+  /**
+   * \brief Record a number.
+   * \param column the column name
+   * \param value the value
+   */
+  void Set (const std::string &column, double value);
+  /**
+   * \brief Record a string.
+   * \param column the column name
+   * \param value the value
+   */
+  void Set (const std::string &column, const std::string &value);
+  /**
+   * \brief Get a recorded value.
+   * \param column the column name
+   * \returns the value, or an empty string if it was not recorded
+   */
+  std::string Get (const std::string &column) const;
+
+private:
+  friend class ReplicationRunner;
+  /** The recorded (column, value) pairs, in recording order. */
+  std::vector<std::pair<std::string, std::string> > m_values;
+};
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Run independent replications of a simulation on the threads of
+ * one process.
+ *
+ * A parameter sweep is usually run as one process per point, each
+ * paying the startup, the TypeId registration and the construction of
+ * the topology.  ReplicationRunner runs the points as replications on a
+ * pool of threads instead.  Every replication runs in a
+ * ReplicationContext: it has its own simulator, node list, singletons
+ * and RNG run number, so the replications do not see each other.
+ *
+ * For each replication, the runner calls the setup callback with the
+ * replication index; the setup builds the simulation, schedules
+ * Simulator::Stop() and returns a collect callback.  The runner then
+ * runs the simulation, calls the collect callback to record the results
+ * and destroys the simulation.  The setups are serialized, since they
+ * may register TypeIds and read the attribute defaults; the simulations
+ * themselves run in parallel.
+ *
+ * \code
+ *   static void Collect (Ptr<PacketSink> sink, ReplicationResult &result)
+ *   {
+ *     result.Set ("rx", sink->GetTotalRx ());
+ *   }
+ *   static ReplicationRunner::CollectCallback Setup (uint32_t i)
+ *   {
+ *     ... build the topology of point i ...
+ *     Simulator::Stop (Seconds (10));
+ *     return MakeBoundCallback (&Collect, sink);
+ *   }
+ *
+ *   ReplicationRunner runner;
+ *   runner.SetThreads (4);
+ *   runner.Run (points, MakeCallback (&Setup));
+ *   runner.Print (std::cout);
+ * \endcode
+ *
+ * Replication \c i uses the RNG run number FirstRun + \c i, so the
+ * results do not depend on the number of threads.  The attribute
+ * defaults and global values are shared: set them before Run().
+ */
+class ReplicationRunner
+{
+public:
+  /** Callback recording the results of a replication after its run. */
+  typedef Callback<void, ReplicationResult &> CollectCallback;
+  /** Callback building replication \c i and returning its collector. */
+  typedef Callback<CollectCallback, uint32_t> SetupCallback;
+
+  ReplicationRunner ();
+
+  /**
+   * \brief Set the number of threads.
+   * \param threads the number of threads, or 0 for one per core
+   */
+  void SetThreads (uint32_t threads);
+  /**
+   * \brief Set the RNG run number of the first replication.
+   * \param run the run number of replication 0
+   */
+  void SetFirstRun (uint64_t run);
+  /**
+   * \brief Run replications and collect their results.
+   * \param n the number of replications
+   * \param setup the callback building each replication
+   *
+   * Returns when all the replications are done.  The results of a
+   * previous call are discarded.
+   */
+  void Run (uint32_t n, SetupCallback setup);
+  /**
+   * \brief Get the number of replications of the last Run().
+   * \returns the number of rows of the results table
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \brief Get the results of a replication.
+   * \param i the replication index
+   * \returns the values recorded by the replication
+   */
+  const ReplicationResult & GetResult (uint32_t i) const;
+  /**
+   * \brief Print the results table.
+   * \param os the output stream
+   *
+   * One tab-separated row per replication, in replication order, after a
+   * header row.  The first columns are the replication index and its
+   * run number, followed by the recorded columns in order of first
+   * appearance.
+   */
+  void Print (std::ostream &os) const;
+
+private:
+  /** Run the replications handed out by m_next, on a worker thread. */
+  void Work (void);
+
+  uint32_t m_threads;                      //!< Number of threads
+  uint64_t m_firstRun;                     //!< Run number of replication 0
+  SetupCallback m_setup;                   //!< Builds the replications
+  uint32_t m_n;                            //!< Number of replications
+  uint32_t m_next;                         //!< Next replication to start
+  SystemMutex m_lock;                      //!< Guards m_next and the setups
+  std::vector<ReplicationResult> m_results; //!< Results, by replication
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_RUNNER_H */
@@ -23,6 +23,9 @@
 #include "uinteger.h"
 #include "config.h"
 #include "log.h"
+#include "replication-context.h"
+
+#include <atomic>
 
 /**
  * \file
@@ -39,7 +42,7 @@ NS_LOG_COMPONENT_DEFINE ("RngSeedManager");
  * The next random number generator stream number to use
  * for automatic assignment.
  */
-static uint64_t g_nextStreamIndex = 0;
+static std::atomic<uint64_t> g_nextStreamIndex (0);
 /**
  * \relates RngSeedManager
  * \anchor GlobalValueRngSeed
@@ -87,12 +90,21 @@ RngSeedManager::SetSeed (uint32_t seed)
 void RngSeedManager::SetRun (uint64_t run)
 {
   NS_LOG_FUNCTION (run);
+  if (ReplicationContext::IsActive ())
+    {
+      ReplicationContext::SetRun (run);
+      return;
+    }
   Config::SetGlobal ("RngRun", UintegerValue (run));
 }
 
 uint64_t RngSeedManager::GetRun ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  if (ReplicationContext::IsActive ())
+    {
+      return ReplicationContext::GetRun ();
+    }
   UintegerValue value;
   g_rngRun.GetValue (value);
   uint64_t run = value.Get ();
@@ -102,9 +114,11 @@ uint64_t RngSeedManager::GetRun ()
 uint64_t RngSeedManager::GetNextStreamIndex (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  uint64_t next = g_nextStreamIndex;
-  g_nextStreamIndex++;
-  return next;
+  if (ReplicationContext::IsActive ())
+    {
+      return ReplicationContext::GetNextStreamIndex ();
+    }
+  return g_nextStreamIndex++;
 }
 
 } // namespace ns3
@@ -28,6 +28,7 @@
 #include "unused.h"
 #include <stdint.h>
 #include <limits>
+#include <atomic>
 
 /**
  * \file
@@ -144,6 +145,75 @@ private:
   mutable uint32_t m_count;
 };
 
+/**
+ * \ingroup ptr
+ * \brief A SimpleRefCount whose count can be updated from several threads.
+ *
+ * This is meant for the few objects which are shared by all the
+ * threads of a parallel simulation, such as the attribute and trace
+ * source descriptions kept by the TypeId database: every object
+ * construction takes references to them.  Ordinary objects should
+ * keep using SimpleRefCount, which avoids the cost of atomic updates.
+ *
+ * \tparam T \explicit The typename of the subclass (CRTP).
+ * \tparam PARENT \explicit The typename of the parent of this template.
+ * \tparam DELETER \explicit The typename of a class which implements
+ *      a public static method named 'Delete'.
+ */
+template <typename T, typename PARENT = empty, typename DELETER = DefaultDeleter<T> >
+class AtomicSimpleRefCount : public PARENT
+{
+public:
+  /** Default constructor.  */
+  AtomicSimpleRefCount ()
+    : m_count (1)
+  {}
+  /**
+   * Copy constructor
+   * \param [in] o The object to copy into this one.
+   */
+  AtomicSimpleRefCount (const AtomicSimpleRefCount &o)
+    : m_count (1)
+  {
+    NS_UNUSED (o);
+  }
+  /**
+   * Assignment operator
+   * \param [in] o The object to copy
+   * \returns The copy of \pname{o}
+   */
+  AtomicSimpleRefCount &operator = (const AtomicSimpleRefCount &o)
+  {
+    NS_UNUSED (o);
+    return *this;
+  }
+  /** Increment the reference count. */
+  inline void Ref (void) const
+  {
+    m_count.fetch_add (1, std::memory_order_relaxed);
+  }
+  /** Decrement the reference count, deleting the object on the last one. */
+  inline void Unref (void) const
+  {
+    if (m_count.fetch_sub (1, std::memory_order_acq_rel) == 1)
+      {
+        DELETER::Delete (static_cast<T*> (const_cast<AtomicSimpleRefCount *> (this)));
+      }
+  }
+  /**
+   * Get the reference count of the object.
+   * \return The reference count.
+   */
+  inline uint32_t GetReferenceCount (void) const
+  {
+    return m_count.load (std::memory_order_relaxed);
+  }
+
+private:
+  /** The reference count. */
+  mutable std::atomic<uint32_t> m_count;
+};
+
 } // namespace ns3
 
 #endif /* SIMPLE_REF_COUNT_H */
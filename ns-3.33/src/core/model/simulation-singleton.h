@@ -38,6 +38,9 @@ namespace ns3 {
  *
  * For a singleton with a lifetime bounded by the process,
  * not the simulation run, see Singleton.
+ *
+ * A thread running a replication (see ReplicationContext) has
+ * its own instance.
  */
 template <typename T>
 class SimulationSingleton
@@ -99,6 +102,7 @@ private:
  ********************************************************************/
 
 #include "simulator.h"
+#include "replication-context.h"
 
 namespace ns3 {
 
@@ -115,12 +119,14 @@ T **
 SimulationSingleton<T>::GetObject (void)
 {
   static T *pobject = 0;
-  if (pobject == 0)
+  static thread_local T *replicationObject = 0;
+  T **ppobject = ReplicationContext::IsActive () ? &replicationObject : &pobject;
+  if (*ppobject == 0)
     {
-      pobject = new T ();
+      *ppobject = new T ();
       Simulator::ScheduleDestroy (&SimulationSingleton<T>::DeleteObject);
     }
-  return &pobject;
+  return ppobject;
 }
 
 template <typename T>
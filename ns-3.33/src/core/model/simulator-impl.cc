@@ -42,4 +42,22 @@ SimulatorImpl::GetTypeId (void)
   return tid;
 }
 
+uint64_t
+SimulatorImpl::GetLiveEventCount (void) const
+{
+  return 0;
+}
+
+uint64_t
+SimulatorImpl::GetCancelledEventCount (void) const
+{
+  return 0;
+}
+
+uint64_t
+SimulatorImpl::GetPeakEventCount (void) const
+{
+  return 0;
+}
+
 } // namespace ns3
@@ -101,6 +101,25 @@ public:
   virtual uint32_t GetContext (void) const = 0;
   /** \copydoc Simulator::GetEventCount */
   virtual uint64_t GetEventCount (void) const = 0;
+  /**
+   * \copydoc Simulator::GetLiveEventCount
+   *
+   * The default implementation does not keep event list statistics
+   * and returns 0.
+   */
+  virtual uint64_t GetLiveEventCount (void) const;
+  /**
+   * \copydoc Simulator::GetCancelledEventCount
+   *
+   * The default implementation returns 0.
+   */
+  virtual uint64_t GetCancelledEventCount (void) const;
+  /**
+   * \copydoc Simulator::GetPeakEventCount
+   *
+   * The default implementation returns 0.
+   */
+  virtual uint64_t GetPeakEventCount (void) const;
 
 };
 
@@ -19,6 +19,7 @@
  */
 #include "ns3/core-config.h"
 #include "simulator.h"
+#include "replication-context.h"
 #include "simulator-impl.h"
 #include "scheduler.h"
 #include "map-scheduler.h"
@@ -81,12 +82,15 @@ static GlobalValue g_schedTypeImpl = GlobalValue ("SchedulerType",
 /**
  * \ingroup simulator
  * \brief Get the static SimulatorImpl instance.
+ *
+ * A thread running a replication has its own instance.
  * \return The SimulatorImpl instance pointer.
  */
 static SimulatorImpl ** PeekImpl (void)
 {
   static SimulatorImpl *impl = 0;
-  return &impl;
+  static thread_local SimulatorImpl *replicationImpl = 0;
+  return ReplicationContext::IsActive () ? &replicationImpl : &impl;
 }
 
 /**
@@ -126,8 +130,13 @@ static SimulatorImpl * GetImpl (void)
 // Simulator::Now which would call Simulator::GetImpl, and, thus, get us
 // in an infinite recursion until the stack explodes.
 //
-      LogSetTimePrinter (&DefaultTimePrinter);
-      LogSetNodePrinter (&DefaultNodePrinter);
+// The printers are process-wide: the replications leave them alone.
+//
+      if (!ReplicationContext::IsActive ())
+        {
+          LogSetTimePrinter (&DefaultTimePrinter);
+          LogSetNodePrinter (&DefaultNodePrinter);
+        }
     }
   return *pimpl;
 }
@@ -147,8 +156,11 @@ Simulator::Destroy (void)
    * legal), Simulator::GetImpl will trigger again an infinite recursion until
    * the stack explodes.
    */
-  LogSetTimePrinter (0);
-  LogSetNodePrinter (0);
+  if (!ReplicationContext::IsActive ())
+    {
+      LogSetTimePrinter (0);
+      LogSetNodePrinter (0);
+    }
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
@@ -308,6 +320,24 @@ Simulator::GetEventCount (void)
   return GetImpl ()->GetEventCount ();
 }
 
+uint64_t
+Simulator::GetLiveEventCount (void)
+{
+  return GetImpl ()->GetLiveEventCount ();
+}
+
+uint64_t
+Simulator::GetCancelledEventCount (void)
+{
+  return GetImpl ()->GetCancelledEventCount ();
+}
+
+uint64_t
+Simulator::GetPeakEventCount (void)
+{
+  return GetImpl ()->GetPeakEventCount ();
+}
+
 uint32_t
 Simulator::GetSystemId (void)
 {
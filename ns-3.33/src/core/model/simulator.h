@@ -205,6 +205,28 @@ public:
    */
   static uint64_t GetEventCount (void);
 
+  /**
+   * Get the number of pending events which will run, that is the
+   * events in the event list which have not been cancelled.
+   * \returns The number of live events.
+   */
+  static uint64_t GetLiveEventCount (void);
+
+  /**
+   * Get the number of cancelled events still held by the event list.
+   * Cancelled events are dropped when they reach the head of the list,
+   * or earlier if the implementation compacts the list.
+   * \returns The number of cancelled events.
+   */
+  static uint64_t GetCancelledEventCount (void);
+
+  /**
+   * Get the largest size reached by the event list, counting both live
+   * and cancelled events.
+   * \returns The peak number of events in the event list.
+   */
+  static uint64_t GetPeakEventCount (void);
+
 
   /**
    * @name Schedule events (in the same context) to run at a future time.
@@ -0,0 +1,416 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include "timer-wheel.h"
+#include "simulator.h"
+#include "make-event.h"
+#include "log.h"
+#include <limits>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel and ns3::WheelTimer implementations.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimerWheel");
+
+NS_OBJECT_ENSURE_REGISTERED (TimerWheel);
+
+namespace {
+
+/** log2 of TimerWheel::SLOTS. */
+const uint32_t SLOT_BITS = 6;
+/** Value of TimerWheel::m_nextDue when no slot is occupied. */
+const uint64_t NO_DUE = std::numeric_limits<uint64_t>::max ();
+
+} // unnamed namespace
+
+TypeId
+TimerWheel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TimerWheel")
+    .SetParent<Object> ()
+    .SetGroupName ("Core")
+    .AddConstructor<TimerWheel> ()
+    .AddAttribute ("Resolution",
+                   "Duration of a tick of the lowest level. Must not be "
+                   "changed once timers have been added.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&TimerWheel::m_resolution),
+                   MakeTimeChecker (TimeStep (1)))
+  ;
+  return tid;
+}
+
+TimerWheel::TimerWheel ()
+  : m_nextDue (NO_DUE),
+    m_nTimers (0)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT ((1u << SLOT_BITS) == SLOTS);
+  for (uint32_t level = 0; level < LEVELS; ++level)
+    {
+      m_occupied[level] = 0;
+      for (uint32_t slot = 0; slot < SLOTS; ++slot)
+        {
+          m_slots[level][slot] = 0;
+          m_due[level][slot] = 0;
+        }
+    }
+}
+
+TimerWheel::~TimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TimerWheel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  Object::DoDispose ();
+}
+
+uint32_t
+TimerWheel::GetNTimers (void) const
+{
+  return m_nTimers;
+}
+
+uint64_t
+TimerWheel::GetTick (void) const
+{
+  return Simulator::Now ().GetTimeStep () / m_resolution.GetTimeStep ();
+}
+
+void
+TimerWheel::Add (WheelTimer *timer)
+{
+  Advance ();
+  Place (timer, GetTick ());
+}
+
+void
+TimerWheel::Place (WheelTimer *timer, uint64_t now)
+{
+  uint64_t tick = timer->m_tick;
+  if (tick <= now)
+    {
+      timer->ScheduleEvent ();
+      return;
+    }
+
+  // Lowest level whose range covers the expiration
+  uint64_t delta = tick - now;
+  uint32_t level = 0;
+  while (level + 1 < LEVELS && delta >= (uint64_t (1) << (SLOT_BITS * (level + 1))))
+    {
+      ++level;
+    }
+  uint32_t shift = SLOT_BITS * level;
+  uint64_t granule = tick >> shift;
+  // Expirations beyond the range of the wheel wait in its last slot
+  uint64_t last = (now >> shift) + SLOTS;
+  if (granule > last)
+    {
+      granule = last;
+    }
+  uint32_t slot = granule & (SLOTS - 1);
+  uint64_t due = granule << shift;
+  uint64_t bit = uint64_t (1) << slot;
+  NS_ASSERT (!(m_occupied[level] & bit) || m_due[level][slot] == due);
+
+  timer->m_level = level;
+  timer->m_slot = slot;
+  timer->m_inWheel = true;
+  timer->m_prev = 0;
+  timer->m_next = m_slots[level][slot];
+  if (timer->m_next != 0)
+    {
+      timer->m_next->m_prev = timer;
+    }
+  m_slots[level][slot] = timer;
+  m_occupied[level] |= bit;
+  m_due[level][slot] = due;
+  ++m_nTimers;
+
+  if (due < m_nextDue)
+    {
+      m_nextDue = due;
+      Reschedule ();
+    }
+}
+
+void
+TimerWheel::Unlink (WheelTimer *timer)
+{
+  NS_ASSERT (timer->m_inWheel);
+  if (timer->m_prev != 0)
+    {
+      timer->m_prev->m_next = timer->m_next;
+    }
+  else
+    {
+      m_slots[timer->m_level][timer->m_slot] = timer->m_next;
+    }
+  if (timer->m_next != 0)
+    {
+      timer->m_next->m_prev = timer->m_prev;
+    }
+  if (m_slots[timer->m_level][timer->m_slot] == 0)
+    {
+      // m_nextDue stays a lower bound: the wheel event may find
+      // nothing to do.
+      m_occupied[timer->m_level] &= ~(uint64_t (1) << timer->m_slot);
+    }
+  timer->m_inWheel = false;
+  timer->m_prev = 0;
+  timer->m_next = 0;
+  --m_nTimers;
+}
+
+void
+TimerWheel::Advance (void)
+{
+  uint64_t now = GetTick ();
+  if (m_nextDue > now)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << now);
+
+  for (uint32_t level = 0; level < LEVELS; ++level)
+    {
+      for (uint32_t slot = 0; slot < SLOTS && m_occupied[level] != 0; ++slot)
+        {
+          uint64_t bit = uint64_t (1) << slot;
+          if (!(m_occupied[level] & bit) || m_due[level][slot] > now)
+            {
+              continue;
+            }
+          WheelTimer *timer = m_slots[level][slot];
+          m_slots[level][slot] = 0;
+          m_occupied[level] &= ~bit;
+          while (timer != 0)
+            {
+              WheelTimer *next = timer->m_next;
+              timer->m_inWheel = false;
+              timer->m_prev = 0;
+              timer->m_next = 0;
+              --m_nTimers;
+              // Lands in a lower level, or gets its event
+              Place (timer, now);
+              timer = next;
+            }
+        }
+    }
+
+  m_nextDue = NO_DUE;
+  for (uint32_t level = 0; level < LEVELS; ++level)
+    {
+      for (uint32_t slot = 0; slot < SLOTS && m_occupied[level] != 0; ++slot)
+        {
+          if ((m_occupied[level] & (uint64_t (1) << slot)) && m_due[level][slot] < m_nextDue)
+            {
+              m_nextDue = m_due[level][slot];
+            }
+        }
+    }
+  Reschedule ();
+}
+
+void
+TimerWheel::Reschedule (void)
+{
+  if (m_nextDue == NO_DUE)
+    {
+      m_event.Cancel ();
+      return;
+    }
+  int64_t ts = static_cast<int64_t> (m_nextDue) * m_resolution.GetTimeStep ();
+  if (m_event.IsRunning () && static_cast<int64_t> (m_event.GetTs ()) == ts)
+    {
+      return;
+    }
+  m_event.Cancel ();
+  m_event = Simulator::Schedule (TimeStep (ts) - Simulator::Now (), &TimerWheel::Expire, this);
+}
+
+void
+TimerWheel::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  Advance ();
+}
+
+
+WheelTimer::WheelTimer ()
+  : m_impl (0),
+    m_wheel (0),
+    m_expiration (TimeStep (0)),
+    m_context (0),
+    m_tick (0),
+    m_level (0),
+    m_slot (0),
+    m_inWheel (false),
+    m_eventPending (false),
+    m_contextEvent (0),
+    m_prev (0),
+    m_next (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+WheelTimer::~WheelTimer ()
+{
+  NS_LOG_FUNCTION (this);
+  Cancel ();
+  delete m_impl;
+}
+
+void
+WheelTimer::SetWheel (Ptr<TimerWheel> wheel)
+{
+  NS_LOG_FUNCTION (this << wheel);
+  if (m_inWheel)
+    {
+      // Keep running, on a plain event
+      m_wheel->Unlink (this);
+      ScheduleEvent ();
+    }
+  m_wheel = wheel;
+}
+
+void
+WheelTimer::Schedule (Time delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  NS_ASSERT (m_impl != 0);
+  Cancel ();
+  m_expiration = Simulator::Now () + delay;
+  m_context = Simulator::GetContext ();
+  if (m_wheel == 0)
+    {
+      ScheduleEvent ();
+      return;
+    }
+  m_tick = m_expiration.GetTimeStep () / m_wheel->m_resolution.GetTimeStep ();
+  m_wheel->Add (this);
+}
+
+void
+WheelTimer::Cancel (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_inWheel)
+    {
+      m_wheel->Unlink (this);
+    }
+  else
+    {
+      m_event.Cancel ();
+      m_event = EventId ();
+      if (m_contextEvent != 0)
+        {
+          m_contextEvent->Cancel ();
+          m_contextEvent = 0;
+        }
+      m_eventPending = false;
+    }
+}
+
+WheelTimer &
+WheelTimer::operator = (const EventId &event)
+{
+  NS_LOG_FUNCTION (this);
+  Cancel ();
+  m_event = event;
+  m_expiration = TimeStep (event.GetTs ());
+  return *this;
+}
+
+WheelTimer::operator EventId ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_inWheel)
+    {
+      m_wheel->Unlink (this);
+      ScheduleEvent ();
+    }
+  return m_event;
+}
+
+bool
+WheelTimer::IsExpired (void) const
+{
+  return !IsRunning ();
+}
+
+bool
+WheelTimer::IsRunning (void) const
+{
+  // m_event alone is an event scheduled outside the timer
+  return m_inWheel || m_eventPending
+         || (m_event.PeekEventImpl () != 0 && m_event.IsRunning ());
+}
+
+Time
+WheelTimer::GetDelayLeft (void) const
+{
+  if (!IsRunning ())
+    {
+      return TimeStep (0);
+    }
+  return m_expiration - Simulator::Now ();
+}
+
+void
+WheelTimer::ScheduleEvent (void)
+{
+  Time delay = m_expiration - Simulator::Now ();
+  if (m_context == Simulator::GetContext ())
+    {
+      m_event = Simulator::Schedule (delay, &WheelTimer::Expire, this);
+    }
+  else
+    {
+      EventImpl *event = MakeEvent (&WheelTimer::Expire, this);
+      m_contextEvent = event;
+      // The simulator owns the reference taken by MakeEvent
+      Simulator::ScheduleWithContext (m_context, delay, event);
+    }
+  m_eventPending = true;
+}
+
+void
+WheelTimer::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_eventPending = false;
+  m_event = EventId ();
+  m_contextEvent = 0;
+  m_impl->Invoke ();
+}
+
+} // namespace ns3
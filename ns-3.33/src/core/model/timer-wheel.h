@@ -0,0 +1,282 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "object.h"
+#include "nstime.h"
+#include "event-id.h"
+#include "event-impl.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel and ns3::WheelTimer declarations.
+ */
+
+namespace ns3 {
+
+class TimerImpl;
+class WheelTimer;
+
+/**
+ * \ingroup timer
+ * \brief A hierarchical timing wheel for frequently rearmed timers.
+ *
+ * Timers such as the TCP retransmission timer are restarted on almost
+ * every packet but rarely fire.  Scheduling a simulator event on each
+ * restart fills the event list with cancelled events.  A WheelTimer
+ * attached to a TimerWheel instead sits in a slot of the wheel, and
+ * restarting it only moves it between two intrusive lists.
+ *
+ * The wheel has LEVELS levels of SLOTS slots.  A slot of level l covers
+ * SLOTS^l ticks of Resolution each.  A timer is put in the lowest level
+ * that can hold its expiration; when the start of its slot is reached,
+ * the timers of the slot move to a lower level.  A timer whose
+ * expiration falls in the current tick gets a regular simulator event
+ * at its exact expiration time, so wheel timers fire at the same time
+ * as plain events.  The wheel schedules a single simulator event, for
+ * the earliest occupied slot.
+ */
+class TimerWheel : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TimerWheel ();
+  virtual ~TimerWheel ();
+
+  /** Number of levels of the wheel. */
+  static const uint32_t LEVELS = 4;
+  /** Number of slots of each level; a power of 2. */
+  static const uint32_t SLOTS = 64;
+
+  /**
+   * \brief Get the number of timers waiting in the wheel
+   * \returns the number of timers in the slots of the wheel
+   */
+  uint32_t GetNTimers (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  friend class WheelTimer;
+
+  /**
+   * \brief Add a timer to the wheel
+   * \param timer the timer, whose expiration time is set
+   */
+  void Add (WheelTimer *timer);
+  /**
+   * \brief Remove a timer from its slot
+   * \param timer the timer, which must be in the wheel
+   */
+  void Unlink (WheelTimer *timer);
+  /**
+   * \brief Put a timer in its slot, or give it an event if it
+   * expires in the current tick
+   * \param timer the timer
+   * \param now the current tick
+   */
+  void Place (WheelTimer *timer, uint64_t now);
+  /**
+   * \brief Move the timers of all due slots to lower levels
+   */
+  void Advance (void);
+  /**
+   * \brief Schedule the wheel event for the earliest occupied slot
+   */
+  void Reschedule (void);
+  /**
+   * \brief Called when the earliest occupied slot is due
+   */
+  void Expire (void);
+  /**
+   * \brief Get the current tick
+   * \returns the tick containing the current simulation time
+   */
+  uint64_t GetTick (void) const;
+
+  Time m_resolution;                       //!< Duration of a tick
+  WheelTimer *m_slots[LEVELS][SLOTS];      //!< Head of the timer list of each slot
+  uint64_t m_due[LEVELS][SLOTS];           //!< Tick at which each occupied slot is due
+  uint64_t m_occupied[LEVELS];             //!< Bitmap of the occupied slots of each level
+  uint64_t m_nextDue;                      //!< Lower bound of the due ticks of the occupied slots
+  uint32_t m_nTimers;                      //!< Number of timers in the slots
+  EventId m_event;                         //!< Event for the slot due at m_nextDue
+};
+
+/**
+ * \ingroup timer
+ * \brief A restartable timer, optionally kept in a TimerWheel.
+ *
+ * The interface follows Timer: set the function and its arguments,
+ * then Schedule () the timer.  Unlike Timer, scheduling a running
+ * WheelTimer restarts it.  Without a wheel, the timer simply uses a
+ * simulator event.  The timer expires in the simulation context in
+ * which it was last scheduled, and it is cancelled when destroyed.
+ */
+class WheelTimer
+{
+public:
+  WheelTimer ();
+  ~WheelTimer ();
+
+  /**
+   * \tparam MEM_PTR \deduced The type of the class member function.
+   * \tparam OBJ_PTR \deduced The type of the class instance pointer.
+   * \param [in] memPtr The member function pointer
+   * \param [in] objPtr The pointer to object
+   *
+   * Store this function and object in this timer for later use by
+   * Schedule ().
+   */
+  template <typename MEM_PTR, typename OBJ_PTR>
+  void SetFunction (MEM_PTR memPtr, OBJ_PTR objPtr);
+
+  /**
+   * \tparam Ts \deduced Argument types
+   * \param [in] args arguments
+   *
+   * Store these arguments in this timer for later use by Schedule ().
+   */
+  template <typename... Ts>
+  void SetArguments (Ts... args);
+
+  /**
+   * \brief Keep this timer in a wheel from now on
+   * \param wheel the wheel, or 0 to use plain simulator events
+   */
+  void SetWheel (Ptr<TimerWheel> wheel);
+
+  /**
+   * \brief Start, or restart, the timer
+   * \param delay the delay after which the function is invoked
+   */
+  void Schedule (Time delay);
+  /** Stop the timer, if running. */
+  void Cancel (void);
+  /**
+   * \returns true if the timer is not running.
+   */
+  bool IsExpired (void) const;
+  /**
+   * \returns true if the timer is running.
+   */
+  bool IsRunning (void) const;
+  /**
+   * \returns the time left before the timer expires, or zero if it is
+   * not running.
+   */
+  Time GetDelayLeft (void) const;
+
+  /**
+   * \brief Follow an event scheduled outside the timer
+   *
+   * The timer stops, and then runs as long as the event is pending: code
+   * written for an EventId member keeps working on a WheelTimer.
+   * \param [in] event the simulator event
+   * \returns the timer
+   */
+  WheelTimer & operator = (const EventId &event);
+  /**
+   * \brief Get the simulator event of the timer
+   *
+   * A timer held by the wheel first moves to its own simulator event, at
+   * the same expiration time, so that the EventId tracks it.
+   * \returns the simulator event
+   */
+  operator EventId ();
+
+private:
+  friend class TimerWheel;
+
+  /** Copying a timer is not supported. */
+  WheelTimer (const WheelTimer &);
+  /**
+   * Copying a timer is not supported.
+   * \returns the timer
+   */
+  WheelTimer & operator = (const WheelTimer &);
+
+  /**
+   * \brief Schedule the simulator event of the timer at its expiration
+   */
+  void ScheduleEvent (void);
+  /**
+   * \brief Called by the simulator event of the timer
+   */
+  void Expire (void);
+
+  TimerImpl *m_impl;            //!< The bound function
+  Ptr<TimerWheel> m_wheel;      //!< The wheel, if any
+  Time m_expiration;            //!< Absolute expiration time, when running
+  uint32_t m_context;           //!< Context in which the timer expires
+  uint64_t m_tick;              //!< Tick of m_expiration
+  uint32_t m_level;             //!< Level of the slot holding the timer
+  uint32_t m_slot;              //!< Slot holding the timer
+  bool m_inWheel;               //!< Whether the timer is in a slot of the wheel
+  bool m_eventPending;          //!< Whether the timer waits for a simulator event
+  EventId m_event;              //!< Simulator event, when not in the wheel
+  Ptr<EventImpl> m_contextEvent; //!< Simulator event in another context, which has no EventId
+  WheelTimer *m_prev;           //!< Previous timer of the slot
+  WheelTimer *m_next;           //!< Next timer of the slot
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+#include "timer-impl.h"
+
+namespace ns3 {
+
+template <typename MEM_PTR, typename OBJ_PTR>
+void
+WheelTimer::SetFunction (MEM_PTR memPtr, OBJ_PTR objPtr)
+{
+  delete m_impl;
+  m_impl = MakeTimerImpl (memPtr, objPtr);
+}
+
+template <typename... Ts>
+void
+WheelTimer::SetArguments (Ts... args)
+{
+  if (m_impl == 0)
+    {
+      NS_FATAL_ERROR ("You cannot set the arguments of a WheelTimer before setting its function.");
+      return;
+    }
+  m_impl->SetArgs (args...);
+}
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
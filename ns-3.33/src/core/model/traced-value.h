@@ -212,11 +212,16 @@ public:
    * Set the value of the underlying variable.
    *
    * If the new value differs from the old, the Callback will be invoked.
+   * Without any connected sink, this is a plain store.
    * \param [in] v The new value.
    */
   void Set (const T &v)
   {
-    if (m_v != v)
+    if (m_cb.IsEmpty ())
+      {
+        m_v = v;
+      }
+    else if (m_v != v)
       {
         m_cb (m_v, v);
         m_v = v;
@@ -160,7 +160,7 @@ public:
    * \param [in] uid The id.
    * \returns The constructor Callback of the type id.
    */
-  Callback<ObjectBase *> GetConstructor (uint16_t uid) const;
+  const Callback<ObjectBase *> & GetConstructor (uint16_t uid) const;
   /**
    * Check if a type id has a constructor Callback.
    * \param [in] uid The id.
@@ -577,7 +577,7 @@ IidManager::GetSize (uint16_t uid) const
   return size;
 }
 
-Callback<ObjectBase *>
+const Callback<ObjectBase *> &
 IidManager::GetConstructor (uint16_t uid) const
 {
   NS_LOG_FUNCTION (IID << uid);
@@ -1057,12 +1057,11 @@ TypeId::SetAttributeInitialValue (std::size_t i,
 }
 
 
-Callback<ObjectBase *>
+const Callback<ObjectBase *> &
 TypeId::GetConstructor (void) const
 {
   NS_LOG_FUNCTION (this);
-  Callback<ObjectBase *>  cb = IidManager::Get ()->GetConstructor (m_tid);
-  return cb;
+  return IidManager::Get ()->GetConstructor (m_tid);
 }
 
 bool
@@ -270,9 +270,12 @@ public:
    * Get the constructor callback.
    *
    * \returns A callback which can be used to instantiate an object
-   *          of this type.
+   *          of this type.  The callback is shared by all the
+   *          users of the type, so it is returned by reference: this
+   *          keeps its reference count untouched when objects are
+   *          created from several threads.
    */
-  Callback<ObjectBase *> GetConstructor (void) const;
+  const Callback<ObjectBase *> & GetConstructor (void) const;
 
   /**
    * Check if this TypeId should not be listed in documentation.
@@ -0,0 +1,464 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+
+using namespace ns3;
+
+namespace {
+
+/** Number of contexts of the tests. */
+const uint32_t CONTEXTS = 8;
+/** Number of partitions of the tests. */
+const uint32_t PARTITIONS = 4;
+
+/**
+ * Use the given simulator implementation; for MultithreadedSimulatorImpl,
+ * spread the contexts over the partitions.
+ * \param type The implementation TypeId name.
+ * \param threads The number of threads.
+ */
+void
+UseImplementation (const std::string &type, uint32_t threads)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (type));
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      impl->SetAttribute ("ThreadCount", UintegerValue (threads));
+      for (uint32_t context = 0; context < CONTEXTS; context++)
+        {
+          impl->SetPartition (context, context % PARTITIONS);
+        }
+      impl->SetLookahead (MilliSeconds (1));
+    }
+}
+
+} // unnamed namespace
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the partitions run the events at the same times as
+ * the sequential simulator, whatever the number of threads.
+ */
+class MultithreadedSimulatorEventsTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorEventsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /**
+   * Run the scenario.
+   * \param type The simulator implementation.
+   * \param threads The number of threads.
+   */
+  void RunScenario (const std::string &type, uint32_t threads);
+  /**
+   * Record the event and send the next one to another context.
+   * \param context The expected context.
+   * \param hops The number of hops so far.
+   */
+  void Hop (uint32_t context, uint32_t hops);
+  /**
+   * Record a local event.
+   * \param context The expected context.
+   */
+  void Local (uint32_t context);
+
+  std::vector<std::vector<int64_t> > m_log; //!< Event times, by context
+  std::vector<int> m_badContext;           //!< An event ran in the wrong context
+};
+
+MultithreadedSimulatorEventsTestCase::MultithreadedSimulatorEventsTestCase ()
+  : TestCase ("Check MultithreadedSimulatorImpl against DefaultSimulatorImpl")
+{
+}
+
+void
+MultithreadedSimulatorEventsTestCase::Hop (uint32_t context, uint32_t hops)
+{
+  if (Simulator::GetContext () != context)
+    {
+      m_badContext[context] = 1;
+    }
+  m_log[context].push_back (Simulator::Now ().GetTimeStep ());
+  Simulator::Schedule (MicroSeconds (100 + context), &MultithreadedSimulatorEventsTestCase::Local, this, context);
+  if (hops < 200)
+    {
+      uint32_t next = (context * 3 + 1) % CONTEXTS;
+      Time delay = MilliSeconds (1) + MicroSeconds ((context * 7 + hops) % 13);
+      Simulator::ScheduleWithContext (next, delay, &MultithreadedSimulatorEventsTestCase::Hop, this, next, hops + 1);
+    }
+}
+
+void
+MultithreadedSimulatorEventsTestCase::Local (uint32_t context)
+{
+  if (Simulator::GetContext () != context)
+    {
+      m_badContext[context] = 1;
+    }
+  m_log[context].push_back (-Simulator::Now ().GetTimeStep ());
+}
+
+void
+MultithreadedSimulatorEventsTestCase::RunScenario (const std::string &type, uint32_t threads)
+{
+  m_log.assign (CONTEXTS, std::vector<int64_t> ());
+  m_badContext.assign (CONTEXTS, 0);
+  UseImplementation (type, threads);
+  for (uint32_t context = 0; context < CONTEXTS; context++)
+    {
+      Simulator::ScheduleWithContext (context, MicroSeconds (context), &MultithreadedSimulatorEventsTestCase::Hop, this, context, 0);
+    }
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), Seconds (1), "Wrong time at the end of " << type);
+  Simulator::Destroy ();
+  for (uint32_t context = 0; context < CONTEXTS; context++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_badContext[context], 0, "Event out of its context in " << type);
+    }
+}
+
+void
+MultithreadedSimulatorEventsTestCase::DoRun (void)
+{
+  RunScenario ("ns3::DefaultSimulatorImpl", 1);
+  std::vector<std::vector<int64_t> > expected = m_log;
+  uint32_t threadCounts[] = { 1, 2, 4 };
+  for (uint32_t i = 0; i < sizeof (threadCounts) / sizeof (threadCounts[0]); i++)
+    {
+      RunScenario ("ns3::MultithreadedSimulatorImpl", threadCounts[i]);
+      for (uint32_t context = 0; context < CONTEXTS; context++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_log[context].size (), expected[context].size (),
+                                 "Wrong number of events with " << threadCounts[i] << " threads");
+          for (uint32_t k = 0; k < m_log[context].size (); k++)
+            {
+              NS_TEST_ASSERT_MSG_EQ (m_log[context][k], expected[context][k],
+                                     "Wrong event time with " << threadCounts[i] << " threads");
+            }
+        }
+    }
+}
+
+void
+MultithreadedSimulatorEventsTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check Stop, Cancel, Remove and the event counts of
+ * MultithreadedSimulatorImpl.
+ */
+class MultithreadedSimulatorControlTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorControlTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /**
+   * Count an event.
+   * \param context The context of the event.
+   */
+  void Count (uint32_t context);
+  /** Check the event identifiers within a partition. */
+  void CheckEventIds (void);
+
+  std::vector<uint32_t> m_count; //!< Events run, by context
+  bool m_idsChecked;             //!< CheckEventIds ran
+};
+
+MultithreadedSimulatorControlTestCase::MultithreadedSimulatorControlTestCase ()
+  : TestCase ("Check the simulation control of MultithreadedSimulatorImpl")
+{
+}
+
+void
+MultithreadedSimulatorControlTestCase::Count (uint32_t context)
+{
+  m_count[context]++;
+}
+
+void
+MultithreadedSimulatorControlTestCase::CheckEventIds (void)
+{
+  EventId a = Simulator::Schedule (MilliSeconds (1), &MultithreadedSimulatorControlTestCase::Count, this, 5);
+  EventId b = Simulator::Schedule (MilliSeconds (2), &MultithreadedSimulatorControlTestCase::Count, this, 5);
+  NS_TEST_EXPECT_MSG_EQ (a.GetContext (), 5, "Event scheduled out of its context");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsExpired (a), false, "Pending event reported expired");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetDelayLeft (b), MilliSeconds (2), "Wrong delay left");
+  Simulator::Cancel (a);
+  Simulator::Remove (b);
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsExpired (a), true, "Cancelled event not expired");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsExpired (b), true, "Removed event not expired");
+  m_idsChecked = true;
+}
+
+void
+MultithreadedSimulatorControlTestCase::DoRun (void)
+{
+  m_count.assign (CONTEXTS, 0);
+  m_idsChecked = false;
+  UseImplementation ("ns3::MultithreadedSimulatorImpl", 2);
+  for (uint32_t context = 0; context < CONTEXTS; context++)
+    {
+      for (uint32_t ms = 5; ms <= 15; ms += 5)
+        {
+          Simulator::ScheduleWithContext (context, MilliSeconds (ms), &MultithreadedSimulatorControlTestCase::Count, this, context);
+        }
+    }
+  Simulator::ScheduleWithContext (5, MilliSeconds (1), &MultithreadedSimulatorControlTestCase::CheckEventIds, this);
+
+  // The events at the stop time are run
+  Simulator::Stop (MilliSeconds (10));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), MilliSeconds (10), "Wrong stop time");
+  NS_TEST_EXPECT_MSG_EQ (m_idsChecked, true, "Event ids not checked");
+  for (uint32_t context = 0; context < CONTEXTS; context++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_count[context], 2, "Wrong number of events before the stop time");
+    }
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsFinished (), false, "Events left but simulation finished");
+
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), MilliSeconds (15), "Wrong end time");
+  for (uint32_t context = 0; context < CONTEXTS; context++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_count[context], 3, "Wrong number of events");
+    }
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsFinished (), true, "Simulation not finished");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetEventCount (), CONTEXTS * 3 + 2, "Wrong event count");
+  Simulator::Destroy ();
+}
+
+void
+MultithreadedSimulatorControlTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the cancellations of events of other partitions and a
+ * Stop() called from an event, over many windows.
+ *
+ * Context 0 arms a target event for every context every 10 ms; each
+ * context cancels or removes its own target of some rounds 3 ms later,
+ * from another partition, while the contexts exchange events.  An event
+ * stops the simulation half-way.
+ */
+class MultithreadedSimulatorCancelTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorCancelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /**
+   * Run the scenario.
+   * \param type The simulator implementation.
+   * \param threads The number of threads.
+   */
+  void RunScenario (const std::string &type, uint32_t threads);
+  /**
+   * Arm the targets of a round, in context 0.
+   * \param round The round.
+   */
+  void Arm (uint32_t round);
+  /**
+   * Cancel the target of a context, if its round calls for it.
+   * \param context The context.
+   * \param round The round.
+   */
+  void Cancel (uint32_t context, uint32_t round);
+  /**
+   * Record a target event.
+   * \param round The round.
+   * \param context The context which may cancel it.
+   */
+  void Fire (uint32_t round, uint32_t context);
+  /**
+   * Record an event sent by another partition.
+   * \param context The context.
+   */
+  void Ping (uint32_t context);
+  /** Stop the simulation. */
+  void StopNow (void);
+
+  /** Number of rounds. */
+  static const uint32_t ROUNDS = 100;
+  /** Round during which the simulation is stopped. */
+  static const uint32_t STOP_ROUND = 50;
+
+  std::vector<std::vector<EventId> > m_targets; //!< Target events, by round and context
+  std::vector<std::vector<int> > m_fired;       //!< Target events run, by round and context
+  std::vector<uint32_t> m_pings;                //!< Pings received, by context
+};
+
+MultithreadedSimulatorCancelTestCase::MultithreadedSimulatorCancelTestCase ()
+  : TestCase ("Check the cancellations across the partitions of MultithreadedSimulatorImpl")
+{
+}
+
+void
+MultithreadedSimulatorCancelTestCase::Arm (uint32_t round)
+{
+  for (uint32_t context = 0; context < CONTEXTS; context++)
+    {
+      m_targets[round][context] = Simulator::Schedule (MilliSeconds (8), &MultithreadedSimulatorCancelTestCase::Fire, this, round, context);
+    }
+  if (round + 1 < ROUNDS)
+    {
+      Simulator::Schedule (MilliSeconds (10), &MultithreadedSimulatorCancelTestCase::Arm, this, round + 1);
+    }
+}
+
+void
+MultithreadedSimulatorCancelTestCase::Cancel (uint32_t context, uint32_t round)
+{
+  if ((round + context) % 3 == 0)
+    {
+      if (context % 2 == 0)
+        {
+          Simulator::Remove (m_targets[round][context]);
+        }
+      else
+        {
+          Simulator::Cancel (m_targets[round][context]);
+        }
+    }
+  uint32_t next = (context + 1) % CONTEXTS;
+  Simulator::ScheduleWithContext (next, MilliSeconds (1), &MultithreadedSimulatorCancelTestCase::Ping, this, next);
+  if (round + 1 < ROUNDS)
+    {
+      Simulator::Schedule (MilliSeconds (10), &MultithreadedSimulatorCancelTestCase::Cancel, this, context, round + 1);
+    }
+}
+
+void
+MultithreadedSimulatorCancelTestCase::Fire (uint32_t round, uint32_t context)
+{
+  m_fired[round][context] = 1;
+}
+
+void
+MultithreadedSimulatorCancelTestCase::Ping (uint32_t context)
+{
+  m_pings[context]++;
+}
+
+void
+MultithreadedSimulatorCancelTestCase::StopNow (void)
+{
+  Simulator::Stop ();
+}
+
+void
+MultithreadedSimulatorCancelTestCase::RunScenario (const std::string &type, uint32_t threads)
+{
+  m_targets.assign (ROUNDS, std::vector<EventId> (CONTEXTS));
+  m_fired.assign (ROUNDS, std::vector<int> (CONTEXTS, 0));
+  m_pings.assign (CONTEXTS, 0);
+  UseImplementation (type, threads);
+  Simulator::ScheduleWithContext (0, Seconds (0), &MultithreadedSimulatorCancelTestCase::Arm, this, 0);
+  for (uint32_t context = 1; context < CONTEXTS; context++)
+    {
+      Simulator::ScheduleWithContext (context, MilliSeconds (3), &MultithreadedSimulatorCancelTestCase::Cancel, this, context, 0);
+    }
+  // Half-way between the last cancellations and the targets of a round
+  Time stopAt = MilliSeconds (STOP_ROUND * 10 + 5);
+  Simulator::ScheduleWithContext (6, stopAt, &MultithreadedSimulatorCancelTestCase::StopNow, this);
+  Simulator::Run ();
+
+  // The other partitions may run up to one lookahead after the stop
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (Simulator::Now (), stopAt, "Stopped early in " << type);
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (Simulator::Now (), stopAt + MilliSeconds (1), "Stopped late in " << type);
+  for (uint32_t round = 0; round < ROUNDS; round++)
+    {
+      for (uint32_t context = 0; context < CONTEXTS; context++)
+        {
+          bool cancelled = context != 0 && (round + context) % 3 == 0;
+          int expected = (round < STOP_ROUND && !cancelled) ? 1 : 0;
+          NS_TEST_EXPECT_MSG_EQ (m_fired[round][context], expected,
+                                 "Wrong target " << round << "/" << context << " in " << type
+                                 << " with " << threads << " threads");
+        }
+    }
+  for (uint32_t context = 0; context < CONTEXTS; context++)
+    {
+      uint32_t from = (context + CONTEXTS - 1) % CONTEXTS;
+      uint32_t expected = from == 0 ? 0 : STOP_ROUND + 1;
+      NS_TEST_EXPECT_MSG_EQ (m_pings[context], expected, "Wrong pings in " << type);
+    }
+  Simulator::Destroy ();
+}
+
+void
+MultithreadedSimulatorCancelTestCase::DoRun (void)
+{
+  RunScenario ("ns3::DefaultSimulatorImpl", 1);
+  uint32_t threadCounts[] = { 1, 2, 4 };
+  for (uint32_t i = 0; i < sizeof (threadCounts) / sizeof (threadCounts[0]); i++)
+    {
+      RunScenario ("ns3::MultithreadedSimulatorImpl", threadCounts[i]);
+    }
+}
+
+void
+MultithreadedSimulatorCancelTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief The MultithreadedSimulatorImpl TestSuite.
+ */
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator")
+  {
+    AddTestCase (new MultithreadedSimulatorEventsTestCase, TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorControlTestCase, TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorCancelTestCase, TestCase::QUICK);
+  }
+};
+
+static MultithreadedSimulatorTestSuite g_multithreadedSimulatorTestSuite;
@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simulation-singleton.h"
+#include "ns3/replication-runner.h"
+#include "ns3/replication-context.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/double.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+namespace {
+
+/** State of one replication of the tests. */
+struct Accumulator : public SimpleRefCount<Accumulator>
+{
+  Accumulator () : events (0), sum (0) {}
+  uint32_t events;                    //!< Number of events run
+  double sum;                         //!< Sum of the random draws
+  Ptr<UniformRandomVariable> uniform; //!< Random draws
+};
+
+/** Counter bounded by the simulation of a replication. */
+struct ReplicationCounter
+{
+  ReplicationCounter () : count (0) {}
+  uint32_t count; //!< Number of increments
+};
+
+/**
+ * Draw a number and schedule the next draw.
+ * \param acc The replication state.
+ * \param left The number of draws left.
+ */
+void
+Draw (Ptr<Accumulator> acc, uint32_t left)
+{
+  acc->events++;
+  acc->sum += acc->uniform->GetValue ();
+  SimulationSingleton<ReplicationCounter>::Get ()->count++;
+  if (left > 1)
+    {
+      Simulator::Schedule (MilliSeconds (1), &Draw, acc, left - 1);
+    }
+}
+
+/**
+ * Record the results of a replication.
+ * \param acc The replication state.
+ * \param result The result row.
+ */
+void
+Collect (Ptr<Accumulator> acc, ReplicationResult &result)
+{
+  result.Set ("events", acc->events);
+  result.Set ("counter", SimulationSingleton<ReplicationCounter>::Get ()->count);
+  result.Set ("now", Simulator::Now ().GetMilliSeconds ());
+  std::ostringstream oss;
+  oss.precision (17);
+  oss << acc->sum;
+  result.Set ("sum", oss.str ());
+}
+
+/**
+ * Build replication \c i: \c i + 1 draws, 1 ms apart.
+ * \param i The replication index.
+ * \returns The collector of the replication.
+ */
+ReplicationRunner::CollectCallback
+Setup (uint32_t i)
+{
+  Ptr<Accumulator> acc = Create<Accumulator> ();
+  acc->uniform = CreateObject<UniformRandomVariable> ();
+  Simulator::Schedule (MilliSeconds (1), &Draw, acc, i + 1);
+  return MakeBoundCallback (&Collect, acc);
+}
+
+/** Event of the simulation of the main thread. */
+void
+MainEvent (void)
+{
+}
+
+} // unnamed namespace
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the replications are isolated from each other and
+ * from the main thread, and do not depend on the number of threads.
+ */
+class ReplicationRunnerTestCase : public TestCase
+{
+public:
+  ReplicationRunnerTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the replications.
+   * \param threads The number of threads.
+   * \returns The results table.
+   */
+  std::string RunReplications (uint32_t threads);
+};
+
+ReplicationRunnerTestCase::ReplicationRunnerTestCase ()
+  : TestCase ("Check independent replications on a thread pool")
+{
+}
+
+std::string
+ReplicationRunnerTestCase::RunReplications (uint32_t threads)
+{
+  const uint32_t n = 6;
+  ReplicationRunner runner;
+  runner.SetThreads (threads);
+  runner.SetFirstRun (7);
+  runner.Run (n, MakeCallback (&Setup));
+  NS_TEST_EXPECT_MSG_EQ (runner.GetN (), n, "Wrong number of rows");
+  for (uint32_t i = 0; i < n; i++)
+    {
+      std::ostringstream expected;
+      expected << i + 1;
+      NS_TEST_EXPECT_MSG_EQ (runner.GetResult (i).Get ("events"), expected.str (),
+                             "Replication " << i << " ran the events of another one");
+      NS_TEST_EXPECT_MSG_EQ (runner.GetResult (i).Get ("counter"), expected.str (),
+                             "Replication " << i << " shares a simulation singleton");
+      NS_TEST_EXPECT_MSG_EQ (runner.GetResult (i).Get ("now"), expected.str (),
+                             "Replication " << i << " shares a clock");
+    }
+  NS_TEST_EXPECT_MSG_NE (runner.GetResult (0).Get ("sum"), runner.GetResult (1).Get ("sum"),
+                         "Replications share a run number");
+  std::ostringstream oss;
+  runner.Print (oss);
+  return oss.str ();
+}
+
+void
+ReplicationRunnerTestCase::DoRun (void)
+{
+  // A simulation of the main thread, which the replications must not touch
+  uint64_t mainRun = RngSeedManager::GetRun ();
+  Simulator::Schedule (Seconds (1), &MainEvent);
+
+  std::string sequential = RunReplications (1);
+  std::string parallel = RunReplications (3);
+  NS_TEST_ASSERT_MSG_EQ (parallel, sequential, "Results depend on the number of threads");
+
+  NS_TEST_ASSERT_MSG_EQ (ReplicationContext::IsActive (), false, "Context left active");
+  NS_TEST_ASSERT_MSG_EQ (RngSeedManager::GetRun (), mainRun, "Main run number changed");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (0), "Main clock moved");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::IsFinished (), false, "Main event lost");
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (1), "Main event not run");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief The ReplicationRunner TestSuite.
+ */
+class ReplicationRunnerTestSuite : public TestSuite
+{
+public:
+  ReplicationRunnerTestSuite ()
+    : TestSuite ("replication-runner", UNIT)
+  {
+    AddTestCase (new ReplicationRunnerTestCase, TestCase::QUICK);
+  }
+};
+
+/** Static variable for test initialization. */
+static ReplicationRunnerTestSuite g_replicationRunnerTestSuite;
@@ -24,6 +24,14 @@
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include <set>
+#include <thread>
+#include <vector>
 
 using namespace ns3;
 
@@ -465,6 +473,307 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check the event order with clustered timestamps with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{}
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+  std::set<Scheduler::EventKey> expected;
+  uint64_t now = 0;
+  uint32_t uid = 0;
+
+  // Network-like delays: many identical serialization times and
+  // zero delays, some spread delays, a few long timers.
+  for (uint32_t i = 0; i < 20000; ++i)
+    {
+      // Grow the population first, then keep it stable
+      uint32_t inserts = i < 3000 ? 4 : rng->GetInteger (0, 2);
+      for (uint32_t j = 0; j < inserts || expected.empty (); ++j)
+        {
+          double kind = rng->GetValue ();
+          uint64_t delay = kind < 0.4 ? 1200 : kind < 0.7 ? 0 :
+            kind < 0.9 ? rng->GetInteger (0, 100000) : 200000000;
+          Scheduler::Event ev;
+          ev.impl = 0;
+          ev.key.m_ts = now + delay;
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          scheduler->Insert (ev);
+          expected.insert (ev.key);
+        }
+      if (rng->GetValue () < 0.1)
+        {
+          std::set<Scheduler::EventKey>::iterator it = expected.begin ();
+          std::advance (it, rng->GetInteger (0, expected.size () - 1));
+          Scheduler::Event ev;
+          ev.impl = 0;
+          ev.key = *it;
+          scheduler->Remove (ev);
+          expected.erase (it);
+          if (expected.empty ())
+            {
+              continue;
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), false, "Events lost");
+      Scheduler::Event next = scheduler->RemoveNext ();
+      NS_TEST_ASSERT_MSG_EQ (next.key.m_uid, expected.begin ()->m_uid, "Wrong event order");
+      now = next.key.m_ts;
+      expected.erase (expected.begin ());
+    }
+  while (!expected.empty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (scheduler->PeekNext ().key.m_uid, expected.begin ()->m_uid, "Wrong next event");
+      NS_TEST_ASSERT_MSG_EQ (scheduler->RemoveNext ().key.m_uid, expected.begin ()->m_uid, "Wrong event order");
+      expected.erase (expected.begin ());
+    }
+  NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), true, "Events left");
+}
+
+/** Event argument larger than EventImpl::MAX_POOLED_SIZE */
+struct LargeArgument
+{
+  uint8_t data[2 * EventImpl::MAX_POOLED_SIZE]; //!< Payload
+};
+
+/**
+ * \ingroup core-tests
+ * \ingroup tests
+ *
+ * \brief Check the pooled allocation of the events: the storage of the
+ * released events is reused, and given back to the system when the
+ * thread exits.
+ */
+class EventPoolTestCase : public TestCase
+{
+public:
+  EventPoolTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Add a value to m_sum.
+   * \param value The value.
+   */
+  void Count (int value);
+  /**
+   * Add the first and last bytes of an argument to m_sum.
+   * \param arg The argument.
+   */
+  void CheckLarge (LargeArgument arg);
+  int m_sum; //!< Sum of the values of the events executed
+};
+
+namespace {
+
+/** What the event pool of an exiting thread held. */
+struct EventPoolExit
+{
+  uint32_t running;  //!< Pool size before the thread exits
+  uint32_t exited;   //!< Pool size once the pools are destroyed
+  uint32_t released; //!< Pool size once a pending event is released
+};
+
+EventPoolExit g_eventPoolExit; //!< Result of the last exiting thread
+
+/**
+ * A thread_local object constructed before the event pools of its
+ * thread, hence destroyed after them, which releases a pending event
+ * like a simulator destroyed by the static objects.
+ */
+struct EventPoolLateRelease
+{
+  ~EventPoolLateRelease ()
+  {
+    g_eventPoolExit.exited = EventImpl::GetPoolSize ();
+    pending = 0;
+    g_eventPoolExit.released = EventImpl::GetPoolSize ();
+  }
+  Ptr<EventImpl> pending; //!< The pending event
+};
+
+/**
+ * Body of the thread of EventPoolTestCase.
+ * \param test The test case, target of the events.
+ */
+void
+EventPoolThread (EventPoolTestCase *test)
+{
+  static thread_local EventPoolLateRelease late;
+  std::vector<Ptr<EventImpl> > events;
+  for (int i = 0; i < 10; ++i)
+    {
+      events.push_back (Ptr<EventImpl> (MakeEvent (&EventPoolTestCase::Count, test, i), false));
+    }
+  late.pending = Ptr<EventImpl> (MakeEvent (&EventPoolTestCase::Count, test, 0), false);
+  events.clear ();
+  g_eventPoolExit.running = EventImpl::GetPoolSize ();
+}
+
+} // unnamed namespace
+
+EventPoolTestCase::EventPoolTestCase ()
+  : TestCase ("Check the pooled EventImpl allocation")
+{}
+void
+EventPoolTestCase::Count (int value)
+{
+  m_sum += value;
+}
+void
+EventPoolTestCase::CheckLarge (LargeArgument arg)
+{
+  m_sum += arg.data[0] + arg.data[sizeof (arg.data) - 1];
+}
+void
+EventPoolTestCase::DoRun (void)
+{
+  m_sum = 0;
+
+  // A released event is recycled for the next event of the same size
+  Ptr<EventImpl> event = Ptr<EventImpl> (MakeEvent (&EventPoolTestCase::Count, this, 1), false);
+  EventImpl *storage = PeekPointer (event);
+  event = 0;
+  event = Ptr<EventImpl> (MakeEvent (&EventPoolTestCase::Count, this, 2), false);
+  NS_TEST_EXPECT_MSG_EQ (PeekPointer (event), storage, "Event storage not recycled");
+  event->Invoke ();
+  NS_TEST_EXPECT_MSG_EQ (m_sum, 2, "Recycled event not invoked");
+  event = 0;
+
+  // Events too large for the pool still work
+  LargeArgument arg;
+  arg.data[0] = 3;
+  arg.data[sizeof (arg.data) - 1] = 4;
+  event = Ptr<EventImpl> (MakeEvent (&EventPoolTestCase::CheckLarge, this, arg), false);
+  event->Invoke ();
+  event = 0;
+  NS_TEST_EXPECT_MSG_EQ (m_sum, 9, "Large event not invoked");
+
+  // An EventId keeps its event alive, so the storage of a cancelled
+  // or executed event is never handed to a new event behind its back
+  EventId cancelled = Simulator::Schedule (Seconds (1), &EventPoolTestCase::Count, this, 10);
+  EventId executed = Simulator::Schedule (Seconds (1), &EventPoolTestCase::Count, this, 20);
+  cancelled.Cancel ();
+  NS_TEST_EXPECT_MSG_EQ (cancelled.IsExpired (), true, "Cancelled event not expired");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_sum, 29, "Wrong events executed");
+  NS_TEST_EXPECT_MSG_EQ (executed.IsExpired (), true, "Executed event not expired");
+  for (int i = 0; i < 100; ++i)
+    {
+      EventId other = Simulator::Schedule (Seconds (1), &EventPoolTestCase::Count, this, 0);
+      NS_TEST_EXPECT_MSG_NE (other.PeekEventImpl (), cancelled.PeekEventImpl (), "Live storage reused");
+      NS_TEST_EXPECT_MSG_NE (other.PeekEventImpl (), executed.PeekEventImpl (), "Live storage reused");
+    }
+  NS_TEST_EXPECT_MSG_EQ (cancelled.IsExpired (), true, "Cancelled event revived");
+  NS_TEST_EXPECT_MSG_EQ (executed.IsExpired (), true, "Executed event revived");
+  Simulator::Destroy ();
+
+  // A thread gives its pooled blocks back when it exits, and the events
+  // released afterwards go back to the system allocator
+  g_eventPoolExit.running = 0;
+  g_eventPoolExit.exited = 1;
+  g_eventPoolExit.released = 1;
+  std::thread thread (&EventPoolThread, this);
+  thread.join ();
+  NS_TEST_EXPECT_MSG_EQ (g_eventPoolExit.running, 10, "Released events not pooled");
+  NS_TEST_EXPECT_MSG_EQ (g_eventPoolExit.exited, 0, "Pooled events kept after the thread exit");
+  NS_TEST_EXPECT_MSG_EQ (g_eventPoolExit.released, 0, "Pending event pooled after the thread exit");
+}
+
+class EventListCompactionTestCase : public TestCase
+{
+public:
+  EventListCompactionTestCase ();
+  virtual void DoRun (void);
+  void Record (uint32_t index);
+  std::vector<uint32_t> m_fired;
+};
+
+EventListCompactionTestCase::EventListCompactionTestCase ()
+  : TestCase ("Check the event list statistics and compaction")
+{}
+void
+EventListCompactionTestCase::Record (uint32_t index)
+{
+  m_fired.push_back (index);
+}
+void
+EventListCompactionTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::CompactionMinimum", UintegerValue (100));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::CompactionRatio", DoubleValue (1.0));
+  m_fired.clear ();
+
+  // Pairs of events share a timestamp, to check that the compaction
+  // keeps the insertion order
+  const uint32_t n = 1000;
+  std::vector<EventId> ids;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      ids.push_back (Simulator::Schedule (MilliSeconds (1 + i / 2), &EventListCompactionTestCase::Record, this, i));
+    }
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetLiveEventCount (), n, "Wrong live events");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetCancelledEventCount (), 0, "Wrong cancelled events");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetPeakEventCount (), n, "Wrong peak");
+
+  // Cancel every event but those with an index multiple of 3, until
+  // the cancelled events outnumber the live ones
+  std::vector<bool> cancelled (n, false);
+  uint32_t nCancelled = 0;
+  for (uint32_t i = 0; i < n && nCancelled < n / 2; ++i)
+    {
+      if (i % 3 == 0)
+        {
+          continue;
+        }
+      ids[i].Cancel ();
+      ids[i].Cancel ();    // no effect
+      cancelled[i] = true;
+      ++nCancelled;
+      NS_TEST_EXPECT_MSG_EQ (Simulator::GetCancelledEventCount (), nCancelled, "Wrong cancelled events");
+      NS_TEST_EXPECT_MSG_EQ (Simulator::GetLiveEventCount (), n - nCancelled, "Wrong live events");
+    }
+  // The next cancellation compacts the event list
+  uint32_t last = n - 1;
+  NS_TEST_ASSERT_MSG_EQ (cancelled[last], false, "Wrong test setup");
+  ids[last].Cancel ();
+  cancelled[last] = true;
+  ++nCancelled;
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetCancelledEventCount (), 0, "Event list not compacted");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetLiveEventCount (), n - nCancelled, "Live events lost");
+  NS_TEST_EXPECT_MSG_EQ (ids[last].IsExpired (), true, "Cancelled event not expired");
+  NS_TEST_EXPECT_MSG_EQ (ids[0].IsRunning (), true, "Live event expired");
+
+  Simulator::Run ();
+  std::vector<uint32_t> expected;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      if (!cancelled[i])
+        {
+          expected.push_back (i);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_fired.size (), expected.size (), "Wrong number of events run");
+  NS_TEST_EXPECT_MSG_EQ ((m_fired == expected), true, "Wrong events run, or in the wrong order");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetLiveEventCount (), 0, "Live events left");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetPeakEventCount (), n, "Wrong peak");
+  Simulator::Destroy ();
+
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::CompactionMinimum", UintegerValue (1024));
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -483,5 +792,19 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+
+    AddTestCase (new EventPoolTestCase (), TestCase::QUICK);
+    AddTestCase (new EventListCompactionTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -18,6 +18,8 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "ns3/timer.h"
+#include "ns3/timer-wheel.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/test.h"
 #include "ns3/simulator.h"
 #include "ns3/nstime.h"
@@ -179,6 +181,165 @@ TimerTemplateTestCase::DoTeardown (void)
   Simulator::Destroy ();
 }
 
+class WheelTimerTestCase : public TestCase
+{
+public:
+  WheelTimerTestCase ();
+  virtual void DoRun (void);
+  void Rearm (uint32_t index, Time delay);
+  void Stop (uint32_t index);
+  void Fire (uint32_t index);
+
+  static const uint32_t N_TIMERS = 64;  //!< Number of timers
+  WheelTimer m_timers[N_TIMERS];        //!< The timers
+  Time m_expected[N_TIMERS];            //!< Expected expiration, or zero
+  uint32_t m_context[N_TIMERS];         //!< Expected context
+  uint32_t m_fired;                     //!< Number of expirations
+};
+
+WheelTimerTestCase::WheelTimerTestCase ()
+  : TestCase ("Check WheelTimer expiration times")
+{}
+void
+WheelTimerTestCase::Rearm (uint32_t index, Time delay)
+{
+  m_timers[index].Schedule (delay);
+  m_expected[index] = Simulator::Now () + delay;
+  m_context[index] = Simulator::GetContext ();
+  NS_TEST_EXPECT_MSG_EQ (m_timers[index].IsRunning (), true, "Timer not running");
+  NS_TEST_EXPECT_MSG_EQ (m_timers[index].GetDelayLeft (), delay, "Wrong delay left");
+}
+void
+WheelTimerTestCase::Stop (uint32_t index)
+{
+  m_timers[index].Cancel ();
+  m_expected[index] = Seconds (0);
+  NS_TEST_EXPECT_MSG_EQ (m_timers[index].IsExpired (), true, "Timer still running");
+}
+void
+WheelTimerTestCase::Fire (uint32_t index)
+{
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), m_expected[index], "Timer " << index << " fired at the wrong time");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetContext (), m_context[index], "Timer fired in the wrong context");
+  NS_TEST_EXPECT_MSG_EQ (m_timers[index].IsExpired (), true, "Fired timer still running");
+  m_expected[index] = Seconds (0);
+  ++m_fired;
+}
+void
+WheelTimerTestCase::DoRun (void)
+{
+  Ptr<TimerWheel> wheel = CreateObject<TimerWheel> ();
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+  m_fired = 0;
+  for (uint32_t i = 0; i < N_TIMERS; ++i)
+    {
+      m_timers[i].SetFunction (&WheelTimerTestCase::Fire, this);
+      m_timers[i].SetArguments (i);
+      // A few timers use plain events
+      m_timers[i].SetWheel (i % 8 == 0 ? 0 : wheel);
+      m_expected[i] = Seconds (0);
+    }
+
+  // Rearm timers at random, mostly before they expire: sub-tick, short,
+  // long, and beyond the range of the wheel
+  uint32_t rearms = 0;
+  for (uint32_t i = 0; i < 20000; ++i)
+    {
+      Time at = Seconds (rng->GetValue (0, 20));
+      uint32_t index = rng->GetInteger (0, N_TIMERS - 1);
+      double kind = rng->GetValue ();
+      Time delay = kind < 0.1 ? MicroSeconds (rng->GetInteger (0, 999)) :
+        kind < 0.8 ? MicroSeconds (rng->GetInteger (1000, 2000000)) :
+        kind < 0.98 ? Seconds (rng->GetValue (2, 300)) : Hours (rng->GetValue (5, 10));
+      if (rng->GetValue () < 0.05)
+        {
+          Simulator::Schedule (at, &WheelTimerTestCase::Stop, this, index);
+          continue;
+        }
+      Simulator::ScheduleWithContext (index % 3, at, &WheelTimerTestCase::Rearm, this, index, delay);
+      ++rearms;
+    }
+  Simulator::Run ();
+
+  for (uint32_t i = 0; i < N_TIMERS; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_expected[i], Seconds (0), "Timer " << i << " did not fire");
+      NS_TEST_EXPECT_MSG_EQ (m_timers[i].IsRunning (), false, "Timer still running");
+    }
+  NS_TEST_EXPECT_MSG_EQ (wheel->GetNTimers (), 0, "Timers left in the wheel");
+  NS_TEST_EXPECT_MSG_GT (m_fired, 0, "No timer fired");
+  NS_TEST_EXPECT_MSG_LT (m_fired, rearms, "Rearmed timers fired");
+  Simulator::Destroy ();
+}
+
+class WheelTimerEventIdTestCase : public TestCase
+{
+public:
+  WheelTimerEventIdTestCase ();
+  virtual void DoRun (void);
+  void Fire (void);
+  void Foreign (void);
+
+  uint32_t m_fired;                     //!< Expirations of the bound function
+  uint32_t m_foreign;                   //!< Expirations of the outside events
+};
+
+WheelTimerEventIdTestCase::WheelTimerEventIdTestCase ()
+  : TestCase ("Check WheelTimer use as an EventId")
+{}
+void
+WheelTimerEventIdTestCase::Fire (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), Seconds (1), "Timer fired at the wrong time");
+  ++m_fired;
+}
+void
+WheelTimerEventIdTestCase::Foreign (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), Seconds (2), "Event fired at the wrong time");
+  ++m_foreign;
+}
+void
+WheelTimerEventIdTestCase::DoRun (void)
+{
+  m_fired = 0;
+  m_foreign = 0;
+  Ptr<TimerWheel> wheel = CreateObject<TimerWheel> ();
+
+  // A timer in the wheel leaves it to hand out its event
+  WheelTimer timer;
+  timer.SetWheel (wheel);
+  timer.SetFunction (&WheelTimerEventIdTestCase::Fire, this);
+  timer.Schedule (Seconds (1));
+  NS_TEST_EXPECT_MSG_EQ (wheel->GetNTimers (), 1, "Timer not in the wheel");
+  EventId event = timer;
+  NS_TEST_EXPECT_MSG_EQ (wheel->GetNTimers (), 0, "Timer still in the wheel");
+  NS_TEST_EXPECT_MSG_EQ (event.IsRunning (), true, "Event not running");
+  NS_TEST_EXPECT_MSG_EQ (TimeStep (event.GetTs ()), Seconds (1), "Wrong event time");
+  NS_TEST_EXPECT_MSG_EQ (timer.IsRunning (), true, "Timer not running");
+
+  // A timer follows an event scheduled outside it
+  WheelTimer outside;
+  outside.SetWheel (wheel);
+  outside = Simulator::Schedule (Seconds (2), &WheelTimerEventIdTestCase::Foreign, this);
+  NS_TEST_EXPECT_MSG_EQ (outside.IsRunning (), true, "Timer not running");
+  NS_TEST_EXPECT_MSG_EQ (outside.GetDelayLeft (), Seconds (2), "Wrong delay left");
+
+  // and cancels it
+  WheelTimer cancelled;
+  cancelled = Simulator::Schedule (Seconds (2), &WheelTimerEventIdTestCase::Foreign, this);
+  cancelled.Cancel ();
+  NS_TEST_EXPECT_MSG_EQ (cancelled.IsExpired (), true, "Timer still running");
+
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_fired, 1, "Timer did not fire once");
+  NS_TEST_EXPECT_MSG_EQ (m_foreign, 1, "Outside events did not fire once");
+  NS_TEST_EXPECT_MSG_EQ (timer.IsRunning (), false, "Timer still running");
+  NS_TEST_EXPECT_MSG_EQ (outside.IsRunning (), false, "Timer still running");
+  Simulator::Destroy ();
+}
+
 static class TimerTestSuite : public TestSuite
 {
 public:
@@ -187,5 +348,7 @@ public:
   {
     AddTestCase (new TimerStateTestCase (), TestCase::QUICK);
     AddTestCase (new TimerTemplateTestCase (), TestCase::QUICK);
+    AddTestCase (new WheelTimerTestCase (), TestCase::QUICK);
+    AddTestCase (new WheelTimerEventIdTestCase (), TestCase::QUICK);
   }
 } g_timerTestSuite;
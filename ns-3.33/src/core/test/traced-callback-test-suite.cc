@@ -67,6 +67,7 @@ BasicTracedCallbackTestCase::DoRun (void)
   // these methods do is to set corresponding member variables m_one and m_two.
   //
   TracedCallback<uint8_t, double> trace;
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "New trace has sinks");
 
   //
   // Connect both callbacks to their respective test methods.  If we hit the
@@ -100,6 +101,7 @@ BasicTracedCallbackTestCase::DoRun (void)
   trace (1, 2);
   NS_TEST_ASSERT_MSG_EQ (m_one, false, "Callback CbOne unexpectedly called");
   NS_TEST_ASSERT_MSG_EQ (m_two, false, "Callback CbTwo unexpectedly called");
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "Disconnected trace has sinks");
 
   //
   // If we connect them back up, then both callbacks should be called.
@@ -111,6 +113,7 @@ BasicTracedCallbackTestCase::DoRun (void)
   trace (1, 2);
   NS_TEST_ASSERT_MSG_EQ (m_one, true, "Callback CbOne not called");
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), false, "Connected trace has no sink");
 }
 
 class TracedCallbackTestSuite : public TestSuite
@@ -102,7 +102,8 @@ CsmaHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool prom
     }
 
   Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, 
-                                                     PcapHelper::DLT_EN10MB);
+                                                     PcapHelper::DLT_EN10MB,
+                                                     GetCaptureFilter ());
   if (promiscuous)
     {
       pcapHelper.HookDefaultSink<CsmaNetDevice> (device, "PromiscSniffer", file);
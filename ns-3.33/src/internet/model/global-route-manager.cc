@@ -21,6 +21,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulation-singleton.h"
+#include "ns3/replication-context.h"
 #include "global-route-manager.h"
 #include "global-route-manager-impl.h"
 
@@ -28,6 +29,20 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("GlobalRouteManager");
 
+namespace {
+
+/**
+ * \ingroup globalrouting
+ * The router ids allocated by a replication.
+ */
+struct GlobalRouterIdState
+{
+  GlobalRouterIdState () : routerId (0) {}
+  uint32_t routerId; //!< The next router id
+};
+
+} // unnamed namespace
+
 // ---------------------------------------------------------------------------
 //
 // GlobalRouteManager Implementation
@@ -63,6 +78,10 @@ GlobalRouteManager::AllocateRouterId (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   static uint32_t routerId = 0;
+  if (ReplicationContext::IsActive ())
+    {
+      return SimulationSingleton<GlobalRouterIdState>::Get ()->routerId++;
+    }
   return routerId++;
 }
 
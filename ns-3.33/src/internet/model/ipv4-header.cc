@@ -22,6 +22,7 @@
 #include "ns3/abort.h"
 #include "ns3/log.h"
 #include "ns3/header.h"
+#include "ns3/unaligned-access.h"
 #include "ipv4-header.h"
 
 namespace ns3 {
@@ -52,6 +53,13 @@ Ipv4Header::EnableChecksum (void)
   m_calcChecksum = true;
 }
 
+bool
+Ipv4Header::IsChecksumEnabled (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_calcChecksum;
+}
+
 void
 Ipv4Header::SetPayloadSize (uint16_t size)
 {
@@ -386,10 +394,6 @@ Ipv4Header::Serialize (Buffer::Iterator start) const
   Buffer::Iterator i = start;
 
   uint8_t verIhl = (4 << 4) | (5);
-  i.WriteU8 (verIhl);
-  i.WriteU8 (m_tos);
-  i.WriteHtonU16 (m_payloadSize + 5*4);
-  i.WriteHtonU16 (m_identification);
   uint32_t fragmentOffset = m_fragmentOffset / 8;
   uint8_t flagsFrag = (fragmentOffset >> 8) & 0x1f;
   if (m_flags & DONT_FRAGMENT) 
@@ -400,14 +404,37 @@ Ipv4Header::Serialize (Buffer::Iterator start) const
     {
       flagsFrag |= (1<<5);
     }
-  i.WriteU8 (flagsFrag);
   uint8_t frag = fragmentOffset & 0xff;
-  i.WriteU8 (frag);
-  i.WriteU8 (m_ttl);
-  i.WriteU8 (m_protocol);
-  i.WriteHtonU16 (0);
-  i.WriteHtonU32 (m_source.Get ());
-  i.WriteHtonU32 (m_destination.Get ());
+  uint8_t *buffer = i.PeekContiguous (20);
+  if (buffer != 0)
+    {
+      using namespace UnalignedAccess;
+      buffer[0] = verIhl;
+      buffer[1] = m_tos;
+      StoreHtonU16 (buffer + 2, m_payloadSize + 5*4);
+      StoreHtonU16 (buffer + 4, m_identification);
+      buffer[6] = flagsFrag;
+      buffer[7] = frag;
+      buffer[8] = m_ttl;
+      buffer[9] = m_protocol;
+      StoreHtonU16 (buffer + 10, 0);
+      StoreHtonU32 (buffer + 12, m_source.Get ());
+      StoreHtonU32 (buffer + 16, m_destination.Get ());
+    }
+  else
+    {
+      i.WriteU8 (verIhl);
+      i.WriteU8 (m_tos);
+      i.WriteHtonU16 (m_payloadSize + 5*4);
+      i.WriteHtonU16 (m_identification);
+      i.WriteU8 (flagsFrag);
+      i.WriteU8 (frag);
+      i.WriteU8 (m_ttl);
+      i.WriteU8 (m_protocol);
+      i.WriteHtonU16 (0);
+      i.WriteHtonU32 (m_source.Get ());
+      i.WriteHtonU32 (m_destination.Get ());
+    }
 
   if (m_calcChecksum) 
     {
@@ -435,11 +462,42 @@ Ipv4Header::Deserialize (Buffer::Iterator start)
       return 0;
     }
 
-  m_tos = i.ReadU8 ();
-  uint16_t size = i.ReadNtohU16 ();
+  uint16_t size;
+  uint8_t flags;
+  const uint8_t *buffer = start.PeekContiguous (20);
+  if (buffer != 0)
+    {
+      using namespace UnalignedAccess;
+      m_tos = buffer[1];
+      size = LoadNtohU16 (buffer + 2);
+      m_identification = LoadNtohU16 (buffer + 4);
+      flags = buffer[6];
+      m_fragmentOffset = ((flags & 0x1f) << 8 | buffer[7]) << 3;
+      m_ttl = buffer[8];
+      m_protocol = buffer[9];
+      m_checksum = buffer[10] | (buffer[11] << 8);
+      m_source.Set (LoadNtohU32 (buffer + 12));
+      m_destination.Set (LoadNtohU32 (buffer + 16));
+    }
+  else
+    {
+      m_tos = i.ReadU8 ();
+      size = i.ReadNtohU16 ();
+      m_identification = i.ReadNtohU16 ();
+      flags = i.ReadU8 ();
+      i.Prev ();
+      m_fragmentOffset = i.ReadU8 () & 0x1f;
+      m_fragmentOffset <<= 8;
+      m_fragmentOffset |= i.ReadU8 ();
+      m_fragmentOffset <<= 3;
+      m_ttl = i.ReadU8 ();
+      m_protocol = i.ReadU8 ();
+      m_checksum = i.ReadU16 ();
+      /* i.Next (2); // checksum */
+      m_source.Set (i.ReadNtohU32 ());
+      m_destination.Set (i.ReadNtohU32 ());
+    }
   m_payloadSize = size - headerSize;
-  m_identification = i.ReadNtohU16 ();
-  uint8_t flags = i.ReadU8 ();
   m_flags = 0;
   if (flags & (1<<6)) 
     {
@@ -449,17 +507,6 @@ Ipv4Header::Deserialize (Buffer::Iterator start)
     {
       m_flags |= MORE_FRAGMENTS;
     }
-  i.Prev ();
-  m_fragmentOffset = i.ReadU8 () & 0x1f;
-  m_fragmentOffset <<= 8;
-  m_fragmentOffset |= i.ReadU8 ();
-  m_fragmentOffset <<= 3;
-  m_ttl = i.ReadU8 ();
-  m_protocol = i.ReadU8 ();
-  m_checksum = i.ReadU16 ();
-  /* i.Next (2); // checksum */
-  m_source.Set (i.ReadNtohU32 ());
-  m_destination.Set (i.ReadNtohU32 ());
   m_headerSize = headerSize;
 
   if (m_calcChecksum) 
@@ -41,6 +41,10 @@ public:
    * \brief Enable checksum calculation for this header.
    */
   void EnableChecksum (void);
+  /**
+   * \returns true if the checksum is calculated for this header.
+   */
+  bool IsChecksumEnabled (void) const;
   /**
    * \param size the size of the payload in bytes
    */
@@ -262,6 +266,24 @@ private:
   uint16_t m_headerSize; //!< IP header size
 };
 
+/**
+ * \brief Packets may carry an Ipv4Header unserialized.
+ * \sa Packet::EnableStructuredHeaders
+ */
+template <>
+struct IsStructuredHeader<Ipv4Header>
+{
+  static const bool value = true; //!< Ipv4Header is structured
+  /**
+   * \param header the header to read
+   * \returns true if the header verifies the checksum of the bytes
+   */
+  static bool NeedsBytes (const Ipv4Header &header)
+  {
+    return header.IsChecksumEnabled ();
+  }
+};
+
 } // namespace ns3
 
 
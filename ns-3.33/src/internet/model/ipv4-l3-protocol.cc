@@ -35,6 +35,7 @@
 #include "ns3/boolean.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/traffic-control-layer.h"
+#include "ns3/gso-tag.h"
 
 #include "loopback-net-device.h"
 #include "arp-l3-protocol.h"
@@ -779,6 +780,16 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
   // can construct the header here
   Ipv4Header ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment);
 
+  // A super-segment takes one identification per wire segment, the
+  // segmentation numbering them from the one of the header
+  GsoTag gsoTag;
+  if (packet->PeekPacketTag (gsoTag) && gsoTag.GetSegmentCount () > 1)
+    {
+      uint64_t srcDst = destination.Get () | (static_cast<uint64_t> (source.Get ()) << 32);
+      std::pair<uint64_t, uint8_t> key = std::make_pair (srcDst, protocol);
+      m_identification[key] += gsoTag.GetSegmentCount () - 1;
+    }
+
   // Handle a few cases:
   // 1) packet is passed in with a route entry
   // 1a) packet is passed in with a route entry but route->GetGateway is not set (e.g., on-demand)
@@ -989,21 +1000,54 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   if (outInterface->IsUp ())
     {
       NS_LOG_LOGIC ("Send to " << targetLabel << " " << target);
-      if ( packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
+      std::list<Ipv4PayloadHeaderPair> listPackets;
+      GsoTag gsoTag;
+      if (packet->PeekPacketTag (gsoTag) && !outInterface->GetDevice ()->SupportsGso ())
         {
-          std::list<Ipv4PayloadHeaderPair> listFragments;
-          DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
-          for ( std::list<Ipv4PayloadHeaderPair>::iterator it = listFragments.begin (); it != listFragments.end (); it++ )
+          // The device does not split super-segments: split them here
+          Ptr<Packet> superSegment = packet->Copy ();
+          superSegment->AddHeader (ipHeader);
+          std::list<Ptr<Packet> > segments;
+          if (GsoSegmentation::Segment (superSegment, PROT_NUMBER, segments))
             {
-              NS_LOG_LOGIC ("Sending fragment " << *(it->first) );
-              CallTxTrace (it->second, it->first, m_node->GetObject<Ipv4> (), interface);
-              outInterface->Send (it->first, it->second, target);
+              for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); it++)
+                {
+                  Ipv4Header segmentHeader;
+                  (*it)->RemoveHeader (segmentHeader);
+                  listPackets.push_back (Ipv4PayloadHeaderPair (*it, segmentHeader));
+                }
+            }
+          else
+            {
+              packet->RemovePacketTag (gsoTag);
+              listPackets.push_back (Ipv4PayloadHeaderPair (packet, ipHeader));
             }
         }
       else
         {
-          CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv4> (), interface);
-          outInterface->Send (packet, ipHeader, target);
+          listPackets.push_back (Ipv4PayloadHeaderPair (packet, ipHeader));
+        }
+
+      for (std::list<Ipv4PayloadHeaderPair>::iterator pkt = listPackets.begin (); pkt != listPackets.end (); pkt++)
+        {
+          // Super-segments left are split by the device at transmission time
+          if ( pkt->first->GetSize () + pkt->second.GetSerializedSize () > outInterface->GetDevice ()->GetMtu ()
+               && !pkt->first->PeekPacketTag (gsoTag) )
+            {
+              std::list<Ipv4PayloadHeaderPair> listFragments;
+              DoFragmentation (pkt->first, pkt->second, outInterface->GetDevice ()->GetMtu (), listFragments);
+              for ( std::list<Ipv4PayloadHeaderPair>::iterator it = listFragments.begin (); it != listFragments.end (); it++ )
+                {
+                  NS_LOG_LOGIC ("Sending fragment " << *(it->first) );
+                  CallTxTrace (it->second, it->first, m_node->GetObject<Ipv4> (), interface);
+                  outInterface->Send (it->first, it->second, target);
+                }
+            }
+          else
+            {
+              CallTxTrace (pkt->second, pkt->first, m_node->GetObject<Ipv4> (), interface);
+              outInterface->Send (pkt->first, pkt->second, target);
+            }
         }
     }
 }
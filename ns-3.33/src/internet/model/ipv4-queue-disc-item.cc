@@ -18,18 +18,23 @@
 
 #include "ns3/log.h"
 #include "ipv4-queue-disc-item.h"
-#include "ns3/tcp-header.h"
-#include "ns3/udp-header.h"
+#include "ns3/hash.h"
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv4QueueDiscItem");
 
+static_assert (sizeof (Ipv4QueueDiscItem) <= QueueDiscItem::POOLED_ITEM_SIZE,
+               "Ipv4QueueDiscItem does not fit in the item pool");
+
 Ipv4QueueDiscItem::Ipv4QueueDiscItem (Ptr<Packet> p, const Address& addr,
                                       uint16_t protocol, const Ipv4Header & header)
   : QueueDiscItem (p, addr, protocol),
     m_header (header),
-    m_headerAdded (false)
+    m_headerAdded (false),
+    m_hashCached (false),
+    m_hashPerturbation (0),
+    m_hash (0)
 {
 }
 
@@ -116,27 +121,22 @@ Ipv4QueueDiscItem::Hash (uint32_t perturbation) const
 {
   NS_LOG_FUNCTION (this << perturbation);
 
+  if (m_hashCached && m_hashPerturbation == perturbation)
+    {
+      return m_hash;
+    }
+
   Ipv4Address src = m_header.GetSource ();
   Ipv4Address dest = m_header.GetDestination ();
   uint8_t prot = m_header.GetProtocol ();
   uint16_t fragOffset = m_header.GetFragmentOffset ();
 
-  TcpHeader tcpHdr;
-  UdpHeader udpHdr;
   uint16_t srcPort = 0;
   uint16_t destPort = 0;
 
-  if (prot == 6 && fragOffset == 0) // TCP
+  if ((prot == 6 || prot == 17) && fragOffset == 0) // TCP or UDP
     {
-      GetPacket ()->PeekHeader (tcpHdr);
-      srcPort = tcpHdr.GetSourcePort ();
-      destPort = tcpHdr.GetDestinationPort ();
-    }
-  else if (prot == 17 && fragOffset == 0) // UDP
-    {
-      GetPacket ()->PeekHeader (udpHdr);
-      srcPort = udpHdr.GetSourcePort ();
-      destPort = udpHdr.GetDestinationPort ();
+      PeekPorts (GetPacket (), srcPort, destPort);
     }
   if (prot != 6 && prot != 17)
     {
@@ -163,6 +163,10 @@ Ipv4QueueDiscItem::Hash (uint32_t perturbation) const
 
   NS_LOG_DEBUG ("Hash value " << hash);
 
+  m_hashCached = true;
+  m_hashPerturbation = perturbation;
+  m_hash = hash;
+
   return hash;
 }
 
@@ -92,6 +92,10 @@ public:
    *
    * \param perturbation hash perturbation value
    * \return the hash of the packet's 5-tuple
+   *
+   * The hash is computed on the first call and kept in the item, so that
+   * the later calls with the same perturbation, e.g. by the classification
+   * and the flow queue of a queue disc, return it at once.
    */
   virtual uint32_t Hash (uint32_t perturbation) const;
 
@@ -118,6 +122,9 @@ private:
 
   Ipv4Header m_header;  //!< The IPv4 header.
   bool m_headerAdded;   //!< True if the header has already been added to the packet.
+  mutable bool m_hashCached;           //!< True if m_hash holds the hash for m_hashPerturbation
+  mutable uint32_t m_hashPerturbation; //!< The perturbation of the cached hash
+  mutable uint32_t m_hash;             //!< The cached hash of the 5-tuple
 };
 
 } // namespace ns3
@@ -18,18 +18,23 @@
 
 #include "ns3/log.h"
 #include "ipv6-queue-disc-item.h"
-#include "ns3/tcp-header.h"
-#include "ns3/udp-header.h"
+#include "ns3/hash.h"
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv6QueueDiscItem");
 
+static_assert (sizeof (Ipv6QueueDiscItem) <= QueueDiscItem::POOLED_ITEM_SIZE,
+               "Ipv6QueueDiscItem does not fit in the item pool");
+
 Ipv6QueueDiscItem::Ipv6QueueDiscItem (Ptr<Packet> p, const Address& addr,
                                       uint16_t protocol, const Ipv6Header & header)
   : QueueDiscItem (p, addr, protocol),
     m_header (header),
-    m_headerAdded (false)
+    m_headerAdded (false),
+    m_hashCached (false),
+    m_hashPerturbation (0),
+    m_hash (0)
 {
 }
 
@@ -115,26 +120,21 @@ Ipv6QueueDiscItem::Hash (uint32_t perturbation) const
 {
   NS_LOG_FUNCTION (this << perturbation);
 
+  if (m_hashCached && m_hashPerturbation == perturbation)
+    {
+      return m_hash;
+    }
+
   Ipv6Address src = m_header.GetSourceAddress ();
   Ipv6Address dest = m_header.GetDestinationAddress ();
   uint8_t prot = m_header.GetNextHeader ();
 
-  TcpHeader tcpHdr;
-  UdpHeader udpHdr;
   uint16_t srcPort = 0;
   uint16_t destPort = 0;
 
-  if (prot == 6) // TCP
+  if (prot == 6 || prot == 17) // TCP or UDP
     {
-      GetPacket ()->PeekHeader (tcpHdr);
-      srcPort = tcpHdr.GetSourcePort ();
-      destPort = tcpHdr.GetDestinationPort ();
-    }
-  else if (prot == 17) // UDP
-    {
-      GetPacket ()->PeekHeader (udpHdr);
-      srcPort = udpHdr.GetSourcePort ();
-      destPort = udpHdr.GetDestinationPort ();
+      PeekPorts (GetPacket (), srcPort, destPort);
     }
   if (prot != 6 && prot != 17)
     {
@@ -161,6 +161,10 @@ Ipv6QueueDiscItem::Hash (uint32_t perturbation) const
 
   NS_LOG_DEBUG ("Found Ipv6 packet; hash of the five tuple " << hash);
 
+  m_hashCached = true;
+  m_hashPerturbation = perturbation;
+  m_hash = hash;
+
   return hash;
 }
 
@@ -1,19 +1,34 @@
 #include <unistd.h>
 #include <memory.h>
+#include "ns3/replication-context.h"
+#include "ns3/simulation-singleton.h"
 #include "tcp-bbr-debug.h"
 namespace ns3{
 namespace{
+struct DebugState{
+    DebugState(){memset(RootDir,0,FILENAME_MAX);}
     uint32_t kDebugUniqueIdCount=0;
-    char RootDir[FILENAME_MAX]={0};
+    char RootDir[FILENAME_MAX];
+};
+//a replication keeps its own folder and numbering
+DebugState *GetDebugState(){
+    if(ReplicationContext::IsActive()){
+        return SimulationSingleton<DebugState>::Get();
+    }
+    static DebugState state;
+    return &state;
+}
 }
 void TcpBbrDebug::SetTraceFolder(const char *path){
+    char *RootDir=GetDebugState()->RootDir;
     memset(RootDir,0,FILENAME_MAX);
     int sz=std::min((int)(FILENAME_MAX-1),(int)strlen(path));
     memcpy(RootDir,path,sz);
 }
 TcpBbrDebug::TcpBbrDebug(std::string prefix){
-    m_uuid=kDebugUniqueIdCount;
-    kDebugUniqueIdCount++;
+    DebugState *state=GetDebugState();
+    m_uuid=state->kDebugUniqueIdCount;
+    state->kDebugUniqueIdCount++;
     OpenFile(prefix);
 }
 TcpBbrDebug::~TcpBbrDebug(){
@@ -22,6 +37,7 @@ TcpBbrDebug::~TcpBbrDebug(){
 void TcpBbrDebug::OpenFile(std::string prefix){
     char buf[FILENAME_MAX];
     std::string path = std::string (getcwd(buf, FILENAME_MAX))+ "/traces/";
+    const char *RootDir=GetDebugState()->RootDir;
     int len=strlen(RootDir);
     if(len>0){
         std::string parent_dir(RootDir,len);
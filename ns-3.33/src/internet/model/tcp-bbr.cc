@@ -19,12 +19,13 @@
  * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
 */
 #include <unistd.h>
-#include <time.h>
 #include <limits>
 #include <algorithm>
 #include "tcp-bbr.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/rate-math.h"
+#include "tcp-socket-base.h"
 #include "tcp-bbr-debug.h"
 namespace ns3{
 NS_LOG_COMPONENT_DEFINE ("TcpBbr");
@@ -68,9 +69,9 @@ static const uint32_t bbr_lt_intvl_min_rtts = 4;
 static const uint32_t bbr_lt_loss_thresh_num=2;
 static const uint32_t bbr_lt_loss_thresh_den=10;
 /* If 2 intervals have a bw ratio <= 1/8, their bw is "consistent": */
-static const double bbr_lt_bw_ratio = 0.125;
+static const uint32_t bbr_lt_bw_ratio = RateMath::BBR_UNIT/8;
 /* If 2 intervals have a bw diff <= 4 Kbit/sec their bw is "consistent": */
-static const DataRate bbr_lt_bw_diff =DataRate(4000);
+static constexpr DataRate bbr_lt_bw_diff =DataRate(4000);
 /* If we estimate we're policed, use lt_bw for this many round trips: */
 const uint32_t bbr_lt_bw_max_rtts =48;
 
@@ -82,6 +83,8 @@ static const uint32_t bbr_extra_acked_win_rtts = 5;
 static const uint32_t bbr_ack_epoch_acked_reset_thresh = 1U << 20;
 /* Time period for clamping cwnd increment due to ack aggregation */
 static const Time bbr_extra_acked_max_time = MilliSeconds(100);
+/* Pace at ~1.2Mbit/sec or slower to use 1 segment per skb: */
+static constexpr DataRate bbr_min_tso_rate = DataRate(1200000);
 }  // namespace
 namespace{
     uint32_t kAddPackets=8;
@@ -111,7 +114,6 @@ TypeId TcpBbr::GetTypeId (void){
 TcpBbr::TcpBbr():TcpCongestionOps(),
 m_maxBwFilter(kBandwidthWindowSize,DataRate(0),0){
     m_uv = CreateObject<UniformRandomVariable> ();
-    m_uv->SetStream(time(NULL));
 #if (TCP_BBR_DEGUG)
     m_debug=CreateObject<TcpBbrDebug>(GetName());
 #endif
@@ -120,7 +122,6 @@ TcpBbr::TcpBbr(const TcpBbr &sock):TcpCongestionOps(sock),
 m_maxBwFilter(kBandwidthWindowSize,DataRate(0),0),
 m_highGain(sock.m_highGain){
     m_uv = CreateObject<UniformRandomVariable> ();
-    m_uv->SetStream(time(NULL));
 #if (TCP_BBR_DEGUG)
     m_debug=sock.m_debug;
 #endif
@@ -271,16 +272,12 @@ uint64_t TcpBbr::BbrExtraAcked() const{
     return std::max<uint64_t>(m_extraAckedBytes[0],m_extraAckedBytes[1]);
 }
 DataRate TcpBbr::BbrRate(DataRate bw,double gain) const{
-    double bps=gain*bw.GetBitRate();
-    double value=bps*(100-bbr_pacing_margin_percent)/100;
-    return DataRate(value);
+    DataRate rate=bw.Scale(RateMath::GainToUnits(gain),RateMath::BBR_UNIT);
+    return rate.Scale(100-bbr_pacing_margin_percent,100);
 }
 DataRate TcpBbr::BbrBandwidthToPacingRate(Ptr<TcpSocketState> tcb,DataRate bw,double gain) const{
     DataRate rate=BbrRate(bw,gain);
-    if(rate>tcb->m_maxPacingRate){
-        rate=tcb->m_maxPacingRate;
-    }
-    return rate;
+    return Min(rate,tcb->m_maxPacingRate);
 }
 void TcpBbr::InitPacingRateFromRtt(Ptr<TcpSocketState> tcb){
     uint32_t mss=tcb->m_segmentSize;
@@ -295,8 +292,7 @@ void TcpBbr::InitPacingRateFromRtt(Ptr<TcpSocketState> tcb){
         pacing_rate=BbrBandwidthToPacingRate(tcb,bw,m_highGain);
     }else{
         m_hasSeenRtt=1;
-        double bps=1.0*congestion_window*8000/rtt.GetMilliSeconds();
-        bw=DataRate(bps);
+        bw=DataRate(RateMath::Rate(congestion_window,rtt));
         pacing_rate=BbrBandwidthToPacingRate(tcb,bw,m_highGain);
     }
 #if (TCP_BBR_DEGUG)
@@ -317,18 +313,14 @@ void TcpBbr::SetPacingRate(Ptr<TcpSocketState> tcb,DataRate bw, double gain){
         }
         if(rtt_valid){
             uint32_t mss=tcb->m_segmentSize;
-            double bps=1.0*kAddPackets*8*1000/m_minRtt.GetMilliSeconds();
-            double add_on=bps;
+            uint64_t add_on=RateMath::Rate(kAddPackets,m_minRtt);
             if(gain==kPacingGain[0]){
-                bps=bw.GetBitRate()+add_on;
-                rate=DataRate(bps);
+                rate=DataRate(bw.GetBitRate()+add_on);
             }
             if(gain==kPacingGain[1]){
-                bps=1.0*4*mss*8*1000/m_minRtt.GetMilliSeconds();
-                DataRate min_rate(bps);
+                DataRate min_rate(RateMath::Rate(4*mss,m_minRtt));
                 if(bw.GetBitRate()>min_rate.GetBitRate()+add_on){
-                    bps=bw.GetBitRate()-add_on;
-                    rate=DataRate(bps);
+                    rate=DataRate(bw.GetBitRate()-add_on);
                 }else{
                     rate=min_rate;
                 }
@@ -370,7 +362,7 @@ void TcpBbr::LongTermBandwidthIntervalDone(Ptr<TcpSocketState> tcb,DataRate bw){
             uint64_t value=bw.GetBitRate()-m_ltBandwidth.GetBitRate();
             diff=DataRate(value);
         }
-        if((diff.GetBitRate()<=bbr_lt_bw_ratio*m_ltBandwidth.GetBitRate())||(BbrRate(diff,1.0)<=bbr_lt_bw_diff)){
+        if((diff<=m_ltBandwidth.Scale(bbr_lt_bw_ratio,RateMath::BBR_UNIT))||(BbrRate(diff,1.0)<=bbr_lt_bw_diff)){
             /* All criteria are met; estimate we're policed. */
             uint64_t average=(bw.GetBitRate()+m_ltBandwidth.GetBitRate())/2;
             m_ltBandwidth=DataRate(average);
@@ -449,8 +441,7 @@ void TcpBbr::LongTermBandwidthSampling(Ptr<TcpSocketState> tcb,const TcpRateOps:
         #endif
         return ;
     }
-    double bps=1.0*delivered*8000/t.GetMilliSeconds();
-    DataRate bw(bps);
+    DataRate bw(RateMath::Rate(delivered,t));
     #if (TCP_BBR_DEGUG)
     NS_LOG_FUNCTION(m_debug->GetUuid()<<delivered<<t.GetMilliSeconds()<<bw<<BbrMaxBandwidth());
     #endif
@@ -521,8 +512,7 @@ void TcpBbr::UpdateAckAggregation(Ptr<TcpSocketState> tcb,const TcpRateOps::TcpR
     NS_ASSERT(rc.m_deliveredTime>=m_ackEpochStamp);
     /* Compute how many packets we expected to be delivered over epoch. */
     epoch_time=rc.m_deliveredTime-m_ackEpochStamp;
-    double bytes=BbrBandwidth()*epoch_time/8;
-    expected_acked_bytes=bytes;
+    expected_acked_bytes=RateMath::Bytes(BbrBandwidth().GetBitRate(),epoch_time);
     /* Reset the aggregation epoch if ACK rate is below expected rate or
     * significantly large no. of ack received since epoch (potentially
     * quite old epoch).
@@ -551,8 +541,7 @@ void TcpBbr::CheckFullBandwidthReached(const TcpRateOps::TcpRateSample &rs){
     if(BbrFullBandwidthReached()||!m_roundStart||rs.m_isAppLimited){
         return;
     }
-    double value=kStartupGrowthTarget*m_fullBandwidth.GetBitRate();
-    DataRate target(value);
+    DataRate target=m_fullBandwidth.Scale(RateMath::GainToUnits(kStartupGrowthTarget),RateMath::BBR_UNIT);
     DataRate bw=m_maxBwFilter.GetBest();
     if (bw>=target){
         m_fullBandwidth=bw;
@@ -568,7 +557,7 @@ void TcpBbr::CheckDrain(Ptr<TcpSocketState> tcb){
         m_mode=DRAIN;
         tcb->m_ssThresh=BbrInflight(tcb,BbrMaxBandwidth(),1.0);
     }
-    if(DRAIN==m_mode&&BbrBytesInNetAtEdt(tcb->m_bytesInFlight)<=BbrInflight(tcb,BbrMaxBandwidth(),1.0)){
+    if(DRAIN==m_mode&&BbrBytesInNetAtEdt(tcb,tcb->m_bytesInFlight)<=BbrInflight(tcb,BbrMaxBandwidth(),1.0)){
         ResetProbeBandwidthMode();  /* we estimate queue is drained */
     }
 }
@@ -693,8 +682,8 @@ uint64_t TcpBbr::BbrBdp(Ptr<TcpSocketState> tcb,DataRate bw,double gain){
     if(Time::Max()==m_minRtt||m_minRtt.IsZero()){
         return tcb->m_initialCWnd*mss;
     }
-    double value=bw*m_minRtt*gain/(8.0*mss);
-    uint64_t packet=value;
+    uint64_t bytes=RateMath::Bytes(bw.GetBitRate(),m_minRtt);
+    uint64_t packet=RateMath::ApplyGain(bytes,RateMath::GainToUnits(gain))/mss;
     uint64_t bdp=packet*mss;
     if(bdp<=kMinCWndSegment*mss){
     #if (TCP_BBR_DEGUG)
@@ -705,13 +694,21 @@ uint64_t TcpBbr::BbrBdp(Ptr<TcpSocketState> tcb,DataRate bw,double gain){
     }
     return bdp;
 }
+//refer to bbr_tso_segs_goal
+uint32_t TcpBbr::TsoSegsGoal(Ptr<TcpSocketState> tcb) const{
+    uint32_t min_segs=tcb->m_pacingRate.Get()<bbr_min_tso_rate?1:2;
+    uint32_t segs=TcpSocketBase::GsoSegsGoal(tcb,true,min_segs);
+    return std::min<uint32_t>(segs,0x7F);
+}
 uint64_t TcpBbr::QuantizationBudget(Ptr<TcpSocketState> tcb,uint64_t cwnd){
-    //cwnd += 3 * bbr_tso_segs_goal(sk);
     uint32_t mss=tcb->m_segmentSize;
+    /* Allow enough full-sized skbs in flight to utilize end systems.
+     * Without GSO every segment is its own skb, there is nothing to budget.
+     */
+    if(tcb->m_gsoMaxSegs>1){
+        cwnd+=3*TsoSegsGoal(tcb)*mss;
+    }
     uint32_t w=cwnd/mss;
-    //TODO
-    /* Allow enough full-sized skbs in flight to utilize end systems. */
-    //cwnd += 3 * bbr_tso_segs_goal(sk);
     
     /* Reduce delayed ACKs by rounding up cwnd to the next even number. */
     w=(w+1)&~1U;
@@ -727,16 +724,32 @@ uint64_t TcpBbr::BbrInflight(Ptr<TcpSocketState> tcb,DataRate bw,double gain){
     return inflight;
 }
 //refer to bbr_packets_in_net_at_edt;
-uint64_t TcpBbr::BbrBytesInNetAtEdt(uint64_t inflight_now){
-    return inflight_now;
+/* With EDT pacing the skb we are about to send leaves at m_departureTime,
+ * by then part of the current inflight has been delivered. With timer
+ * pacing the next departure is now.
+ */
+uint64_t TcpBbr::BbrBytesInNetAtEdt(Ptr<TcpSocketState> tcb,uint64_t inflight_now){
+    if(!tcb->m_edtPacing){
+        return inflight_now;
+    }
+    Time now=Simulator::Now();
+    Time edt=std::max(tcb->m_departureTime,now);
+    uint64_t interval_delivered=RateMath::Bytes(BbrBandwidth().GetBitRate(),edt-now);
+    uint64_t inflight_at_edt=inflight_now;
+    if(m_pacingGain>1.0){   /* increasing inflight */
+        inflight_at_edt+=TsoSegsGoal(tcb)*tcb->m_segmentSize;   /* include EDT skb */
+    }
+    if(interval_delivered>=inflight_at_edt){
+        return 0;
+    }
+    return inflight_at_edt-interval_delivered;
 }
 /* Find the cwnd increment based on estimate of ack aggregation */
 uint64_t TcpBbr::AckAggregationCongestionWindow(){
     uint64_t max_aggr_cwnd, aggr_cwnd = 0;
     if(bbr_extra_acked_gain>0&&BbrFullBandwidthReached()){
-        double bytes=BbrBandwidth()*bbr_extra_acked_max_time/8.0;
-        max_aggr_cwnd=bytes;
-        bytes=bbr_extra_acked_gain*BbrExtraAcked();
+        max_aggr_cwnd=RateMath::Bytes(BbrBandwidth().GetBitRate(),bbr_extra_acked_max_time);
+        double bytes=bbr_extra_acked_gain*BbrExtraAcked();
         aggr_cwnd=bytes;
         aggr_cwnd=std::min<uint64_t>(max_aggr_cwnd,aggr_cwnd);
     }
@@ -831,7 +844,7 @@ bool TcpBbr::IsNextCyclePhase(Ptr<TcpSocketState> tcb,const TcpRateOps::TcpRateS
     if(1.0==m_pacingGain){
         return is_full_length;
     }
-    uint64_t inflight=BbrBytesInNetAtEdt(rs.m_priorDelivered);
+    uint64_t inflight=BbrBytesInNetAtEdt(tcb,rs.m_priorDelivered);
     DataRate bw=BbrMaxBandwidth();
     /* A pacing_gain > 1.0 probes for bw by trying to raise inflight to at
     * least pacing_gain*BDP; this may take more than min_rtt if min_rtt is
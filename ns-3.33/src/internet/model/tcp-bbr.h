@@ -113,9 +113,10 @@ protected:
                             const TcpRateOps::TcpRateSample &rs);
     FUNC_INLINE void SaveCongestionWindow(uint32_t congestion_window);
     FUNC_INLINE uint64_t BbrBdp(Ptr<TcpSocketState> tcb,DataRate bw,double gain);
+    FUNC_INLINE uint32_t TsoSegsGoal(Ptr<TcpSocketState> tcb) const;
     FUNC_INLINE uint64_t QuantizationBudget(Ptr<TcpSocketState> tcb,uint64_t cwnd);
     FUNC_INLINE uint64_t BbrInflight(Ptr<TcpSocketState> tcb,DataRate bw,double gain);
-    FUNC_INLINE uint64_t BbrBytesInNetAtEdt(uint64_t inflight_now);
+    FUNC_INLINE uint64_t BbrBytesInNetAtEdt(Ptr<TcpSocketState> tcb,uint64_t inflight_now);
     FUNC_INLINE uint64_t AckAggregationCongestionWindow();
     bool SetCongestionWindowRecoveryOrRestore(Ptr<TcpSocketState> tcb,const TcpRateOps::TcpRateConnection &rc,
                                                 const TcpRateOps::TcpRateSample &rs,uint32_t *new_cwnd);
@@ -21,6 +21,8 @@
 #pragma once
 #include <stdint.h>
 #include <type_traits>
+#include "ns3/replication-context.h"
+#include "ns3/simulation-singleton.h"
 namespace ns3{
 //SingletonEnv stolen from leveldb
 template <typename EnvType>
@@ -45,6 +47,10 @@ class SingletonEnv {
 class TcpUuidManager{
 public:
     static TcpUuidManager* Instance(){
+        if(ReplicationContext::IsActive()){
+            //a replication numbers its connections from 0
+            return SimulationSingleton<TcpUuidManager>::Get();
+        }
         static SingletonEnv<TcpUuidManager> single;
         return single.Content();
     }
@@ -56,6 +62,7 @@ public:
     }
 private:
     friend SingletonEnv<TcpUuidManager>;
+    friend SimulationSingleton<TcpUuidManager>;
     TcpUuidManager(){}
     uint16_t m_base=0;
     uint16_t m_count=0;
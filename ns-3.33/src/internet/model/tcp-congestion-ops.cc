@@ -43,6 +43,12 @@ TcpCongestionOps::TcpCongestionOps (const TcpCongestionOps &other) : Object (oth
 {
 }
 
+void
+TcpCongestionOps::SetSlowStart (Ptr<TcpSlowStart> slowStart)
+{
+  m_slowStart = slowStart;
+}
+
 TcpCongestionOps::~TcpCongestionOps ()
 {
 }
@@ -169,7 +175,7 @@ TcpNewReno::SlowStart (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
 
   if (segmentsAcked >= 1)
     {
-      tcb->m_cWnd += tcb->m_segmentSize;
+      tcb->m_cWnd += m_slowStart ? m_slowStart->GetCwndIncrease (tcb, 1) : tcb->m_segmentSize;
       NS_LOG_INFO ("In SlowStart, updated to cwnd " << tcb->m_cWnd << " ssthresh " << tcb->m_ssThresh);
       return segmentsAcked - 1;
     }
@@ -21,6 +21,7 @@
 
 #include "tcp-rate-ops.h"
 #include "tcp-socket-state.h"
+#include "tcp-slow-start.h"
 
 namespace ns3 {
 
@@ -174,6 +175,17 @@ public:
    */
   virtual bool HasCongControl () const;
 
+  /**
+   * \brief Set the slow start algorithm of the socket
+   *
+   * Congestion controls using the classic slow start ask the algorithm
+   * for the window growth; if none is set, the growth is one segment per
+   * segment acked.
+   *
+   * \param slowStart the slow start algorithm
+   */
+  void SetSlowStart (Ptr<TcpSlowStart> slowStart);
+
   /**
    * \brief Called when packets are delivered to update cwnd and pacing rate
    *
@@ -202,6 +214,9 @@ public:
    * \return a pointer of the copied object
    */
   virtual Ptr<TcpCongestionOps> Fork () = 0;
+
+protected:
+  Ptr<TcpSlowStart> m_slowStart; //!< Slow start algorithm of the socket
 };
 
 /**
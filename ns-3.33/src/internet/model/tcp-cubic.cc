@@ -180,7 +180,8 @@ TcpCubic::IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
       // not reach as large of an initial window as in Linux.  Therefore,
       // we can approximate the effect of QUICKACK by making this slow
       // start phase perform Appropriate Byte Counting (RFC 3465)
-      tcb->m_cWnd += segmentsAcked * tcb->m_segmentSize;
+      tcb->m_cWnd += m_slowStart ? m_slowStart->GetCwndIncrease (tcb, segmentsAcked)
+                                 : segmentsAcked * tcb->m_segmentSize;
       segmentsAcked = 0;
 
       NS_LOG_INFO ("In SlowStart, updated to cwnd " << tcb->m_cWnd <<
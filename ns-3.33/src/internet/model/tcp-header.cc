@@ -24,12 +24,39 @@
 #include "tcp-option.h"
 #include "ns3/buffer.h"
 #include "ns3/address-utils.h"
+#include "ns3/unaligned-access.h"
 #include "ns3/log.h"
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TcpHeader");
 
+namespace {
+
+/**
+ * \ingroup tcp
+ *
+ * The options of the last TCP header deserialized by this thread.
+ *
+ * A received segment is parsed three times: by TcpL4Protocol, and twice
+ * by TcpSocketBase.  Creating the TcpOption objects dominates the cost
+ * of each parse, so the parsed list is kept along with the option bytes
+ * it came from, and shared when the same bytes are parsed again.  The
+ * options in the list are const, so sharing them is safe.
+ */
+struct TcpOptionCache
+{
+  uint8_t bytes[40];                  //!< Option bytes of the header
+  uint32_t length;                    //!< Number of option bytes, zero if empty
+  TcpHeader::TcpOptionList options;   //!< Options parsed from the bytes
+  uint8_t optionsLen;                 //!< Length of the parsed options
+};
+
+/// The option cache of this thread
+thread_local TcpOptionCache g_tcpOptionCache = { {}, 0, TcpHeader::TcpOptionList (), 0 };
+
+} // unnamed namespace
+
 NS_OBJECT_ENSURE_REGISTERED (TcpHeader);
 
 TcpHeader::TcpHeader ()
@@ -85,6 +112,12 @@ TcpHeader::EnableChecksums (void)
   m_calcChecksum = true;
 }
 
+bool
+TcpHeader::IsChecksumEnabled (void) const
+{
+  return m_calcChecksum;
+}
+
 void
 TcpHeader::SetSourcePort (uint16_t port)
 {
@@ -315,14 +348,31 @@ void
 TcpHeader::Serialize (Buffer::Iterator start)  const
 {
   Buffer::Iterator i = start;
-  i.WriteHtonU16 (m_sourcePort);
-  i.WriteHtonU16 (m_destinationPort);
-  i.WriteHtonU32 (m_sequenceNumber.GetValue ());
-  i.WriteHtonU32 (m_ackNumber.GetValue ());
-  i.WriteHtonU16 (GetLength () << 12 | m_flags); //reserved bits are all zero
-  i.WriteHtonU16 (m_windowSize);
-  i.WriteHtonU16 (0);
-  i.WriteHtonU16 (m_urgentPointer);
+  uint8_t *buffer = i.PeekContiguous (20);
+  if (buffer != 0)
+    {
+      using namespace UnalignedAccess;
+      StoreHtonU16 (buffer, m_sourcePort);
+      StoreHtonU16 (buffer + 2, m_destinationPort);
+      StoreHtonU32 (buffer + 4, m_sequenceNumber.GetValue ());
+      StoreHtonU32 (buffer + 8, m_ackNumber.GetValue ());
+      StoreHtonU16 (buffer + 12, GetLength () << 12 | m_flags);
+      StoreHtonU16 (buffer + 14, m_windowSize);
+      StoreHtonU16 (buffer + 16, 0);
+      StoreHtonU16 (buffer + 18, m_urgentPointer);
+      i.Next (20);
+    }
+  else
+    {
+      i.WriteHtonU16 (m_sourcePort);
+      i.WriteHtonU16 (m_destinationPort);
+      i.WriteHtonU32 (m_sequenceNumber.GetValue ());
+      i.WriteHtonU32 (m_ackNumber.GetValue ());
+      i.WriteHtonU16 (GetLength () << 12 | m_flags); //reserved bits are all zero
+      i.WriteHtonU16 (m_windowSize);
+      i.WriteHtonU16 (0);
+      i.WriteHtonU16 (m_urgentPointer);
+    }
 
   // Serialize options if they exist
   // This implementation does not presently try to align options on word
@@ -361,16 +411,33 @@ TcpHeader::Deserialize (Buffer::Iterator start)
 {
   m_optionsLen = 0;
   Buffer::Iterator i = start;
-  m_sourcePort = i.ReadNtohU16 ();
-  m_destinationPort = i.ReadNtohU16 ();
-  m_sequenceNumber = i.ReadNtohU32 ();
-  m_ackNumber = i.ReadNtohU32 ();
-  uint16_t field = i.ReadNtohU16 ();
+  uint16_t field;
+  const uint8_t *buffer = i.PeekContiguous (20);
+  if (buffer != 0)
+    {
+      using namespace UnalignedAccess;
+      m_sourcePort = LoadNtohU16 (buffer);
+      m_destinationPort = LoadNtohU16 (buffer + 2);
+      m_sequenceNumber = LoadNtohU32 (buffer + 4);
+      m_ackNumber = LoadNtohU32 (buffer + 8);
+      field = LoadNtohU16 (buffer + 12);
+      m_windowSize = LoadNtohU16 (buffer + 14);
+      m_urgentPointer = LoadNtohU16 (buffer + 18);
+      i.Next (20);
+    }
+  else
+    {
+      m_sourcePort = i.ReadNtohU16 ();
+      m_destinationPort = i.ReadNtohU16 ();
+      m_sequenceNumber = i.ReadNtohU32 ();
+      m_ackNumber = i.ReadNtohU32 ();
+      field = i.ReadNtohU16 ();
+      m_windowSize = i.ReadNtohU16 ();
+      i.Next (2);
+      m_urgentPointer = i.ReadNtohU16 ();
+    }
   m_flags = field & 0xFF;
   m_length = field >> 12;
-  m_windowSize = i.ReadNtohU16 ();
-  i.Next (2);
-  m_urgentPointer = i.ReadNtohU16 ();
 
   // Deserialize options if they exist
   m_options.clear ();
@@ -380,6 +447,19 @@ TcpHeader::Deserialize (Buffer::Iterator start)
       NS_LOG_ERROR ("Illegal TCP option length " << optionLen << "; options discarded");
       return 20;
     }
+  const uint8_t *optionBytes = i.PeekContiguous (optionLen);
+  TcpOptionCache &cache = g_tcpOptionCache;
+  if (optionLen != 0 && optionBytes != 0 && cache.length == optionLen
+      && std::memcmp (cache.bytes, optionBytes, optionLen) == 0)
+    {
+      m_options = cache.options;
+      m_optionsLen = cache.optionsLen;
+      i.Next (optionLen);
+      optionLen = 0;
+      optionBytes = 0;
+    }
+  uint32_t parsedLen = optionLen;
+  bool parsed = true;
   while (optionLen)
     {
       uint8_t kind = i.PeekU8 ();
@@ -398,6 +478,7 @@ TcpHeader::Deserialize (Buffer::Iterator start)
       if (optionSize != op->GetSerializedSize ())
         {
           NS_LOG_ERROR ("Option did not deserialize correctly");
+          parsed = false;
           break;
         }
       if (optionLen >= optionSize)
@@ -410,6 +491,7 @@ TcpHeader::Deserialize (Buffer::Iterator start)
       else
         {
           NS_LOG_ERROR ("Option exceeds TCP option space; option discarded");
+          parsed = false;
           break;
         }
       if (op->GetKind () == TcpOption::END)
@@ -423,6 +505,13 @@ TcpHeader::Deserialize (Buffer::Iterator start)
             }
         }
     }
+  if (parsed && parsedLen != 0 && optionBytes != 0)
+    {
+      std::memcpy (cache.bytes, optionBytes, parsedLen);
+      cache.length = parsedLen;
+      cache.options = m_options;
+      cache.optionsLen = m_optionsLen;
+    }
 
   if (m_length != CalculateHeaderLength ())
     {
@@ -82,6 +82,12 @@ public:
    */
   void EnableChecksums (void);
 
+  /**
+   * \brief Is the TCP checksum calculated for this header ?
+   * \returns true if EnableChecksums has been called
+   */
+  bool IsChecksumEnabled (void) const;
+
 //Setters
 
 /**
@@ -353,6 +359,24 @@ private:
   uint8_t m_optionsLen;        //!< Tcp options length.
 };
 
+/**
+ * \brief Packets may carry a TcpHeader unserialized.
+ * \sa Packet::EnableStructuredHeaders
+ */
+template <>
+struct IsStructuredHeader<TcpHeader>
+{
+  static const bool value = true; //!< TcpHeader is structured
+  /**
+   * \param header the header to read
+   * \returns true if the header verifies the checksum of the bytes
+   */
+  static bool NeedsBytes (const TcpHeader &header)
+  {
+    return header.IsChecksumEnabled ();
+  }
+};
+
 } // namespace ns3
 
 #endif /* TCP_HEADER */
@@ -0,0 +1,232 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include "tcp-hystart-plus-plus.h"
+#include "tcp-socket-state.h"
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpHyStartPlusPlus");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpHyStartPlusPlus);
+
+TypeId
+TcpHyStartPlusPlus::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpHyStartPlusPlus")
+    .SetParent<TcpSlowStart> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpHyStartPlusPlus> ()
+    .AddAttribute ("MinRttThresh", "Lower bound of the RTT increase threshold",
+                   TimeValue (MilliSeconds (4)),
+                   MakeTimeAccessor (&TcpHyStartPlusPlus::m_minRttThresh),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxRttThresh", "Upper bound of the RTT increase threshold",
+                   TimeValue (MilliSeconds (16)),
+                   MakeTimeAccessor (&TcpHyStartPlusPlus::m_maxRttThresh),
+                   MakeTimeChecker ())
+    .AddAttribute ("MinRttDivisor",
+                   "The RTT increase threshold is the last round min RTT over this value",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&TcpHyStartPlusPlus::m_minRttDivisor),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("NRttSample", "RTT samples needed in a round to check for an increase",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&TcpHyStartPlusPlus::m_nRttSample),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("CssGrowthDivisor", "Window growth divisor in Conservative Slow Start",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&TcpHyStartPlusPlus::m_cssGrowthDivisor),
+                   MakeUintegerChecker<uint32_t> (2))
+    .AddAttribute ("CssRounds", "Rounds in Conservative Slow Start before leaving slow start",
+                   UintegerValue (5),
+                   MakeUintegerAccessor (&TcpHyStartPlusPlus::m_cssRounds),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("AckLimit",
+                   "Maximum window growth per ACK, in segments, when not paced (0 for no limit)",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&TcpHyStartPlusPlus::m_ackLimit),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+TcpHyStartPlusPlus::TcpHyStartPlusPlus () : TcpSlowStart ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpHyStartPlusPlus::TcpHyStartPlusPlus (const TcpHyStartPlusPlus &other)
+  : TcpSlowStart (other),
+    m_minRttThresh (other.m_minRttThresh),
+    m_maxRttThresh (other.m_maxRttThresh),
+    m_minRttDivisor (other.m_minRttDivisor),
+    m_nRttSample (other.m_nRttSample),
+    m_cssGrowthDivisor (other.m_cssGrowthDivisor),
+    m_cssRounds (other.m_cssRounds),
+    m_ackLimit (other.m_ackLimit)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpHyStartPlusPlus::~TcpHyStartPlusPlus ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+TcpHyStartPlusPlus::GetName () const
+{
+  return "TcpHyStartPlusPlus";
+}
+
+bool
+TcpHyStartPlusPlus::InCss (void) const
+{
+  return m_inCss;
+}
+
+bool
+TcpHyStartPlusPlus::IsDone (void) const
+{
+  return m_done;
+}
+
+void
+TcpHyStartPlusPlus::StartRound (const TcpRateOps::TcpRateConnection &rc)
+{
+  NS_LOG_FUNCTION (this);
+  m_roundEndDelivered = rc.m_delivered;
+  m_lastRoundMinRtt = m_currentRoundMinRtt;
+  m_currentRoundMinRtt = Time::Max ();
+  m_rttSampleCount = 0;
+}
+
+void
+TcpHyStartPlusPlus::PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                               const Time &rtt, const TcpRateOps::TcpRateConnection &rc)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked << rtt);
+
+  if (m_done)
+    {
+      return;
+    }
+  if (!m_started)
+    {
+      m_started = true;
+      m_initialSsThresh = tcb->m_ssThresh;
+    }
+  if (tcb->m_ssThresh != m_initialSsThresh || tcb->m_cWnd >= tcb->m_ssThresh)
+    {
+      NS_LOG_INFO ("Initial slow start is over");
+      m_done = true;
+      m_inCss = false;
+      return;
+    }
+
+  // The data acked was sent after the round started
+  if (rc.m_txItemDelivered >= m_roundEndDelivered)
+    {
+      StartRound (rc);
+      if (m_inCss && ++m_cssRoundCount >= m_cssRounds)
+        {
+          tcb->m_ssThresh = tcb->m_cWnd;
+          m_done = true;
+          m_inCss = false;
+          NS_LOG_INFO ("Leaving slow start after " << m_cssRounds <<
+                       " CSS rounds, ssThresh " << tcb->m_ssThresh);
+          return;
+        }
+    }
+
+  if (rtt.IsZero ())
+    {
+      return;
+    }
+  m_currentRoundMinRtt = std::min (m_currentRoundMinRtt, rtt);
+  ++m_rttSampleCount;
+  if (m_rttSampleCount < m_nRttSample
+      || m_currentRoundMinRtt == Time::Max ())
+    {
+      return;
+    }
+
+  if (!m_inCss)
+    {
+      if (m_lastRoundMinRtt == Time::Max ())
+        {
+          return;
+        }
+      Time rttThresh = std::max (m_minRttThresh,
+                                 std::min (m_lastRoundMinRtt / m_minRttDivisor, m_maxRttThresh));
+      if (m_currentRoundMinRtt >= m_lastRoundMinRtt + rttThresh)
+        {
+          NS_LOG_INFO ("RTT increased from " << m_lastRoundMinRtt << " to " <<
+                       m_currentRoundMinRtt << ", entering CSS");
+          m_cssBaselineMinRtt = m_currentRoundMinRtt;
+          m_inCss = true;
+          m_cssRoundCount = 0;
+          m_cssBytes = 0;
+        }
+    }
+  else if (m_currentRoundMinRtt < m_cssBaselineMinRtt)
+    {
+      NS_LOG_INFO ("RTT back to " << m_currentRoundMinRtt << ", resuming slow start");
+      m_cssBaselineMinRtt = Time::Max ();
+      m_inCss = false;
+    }
+}
+
+uint32_t
+TcpHyStartPlusPlus::GetCwndIncrease (Ptr<const TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+
+  uint32_t increase = TcpSlowStart::GetCwndIncrease (tcb, segmentsAcked);
+  if (m_done)
+    {
+      return increase;
+    }
+  if (m_ackLimit > 0 && !tcb->m_pacing)
+    {
+      increase = std::min (increase, m_ackLimit * tcb->m_segmentSize);
+    }
+  if (m_inCss)
+    {
+      m_cssBytes += increase;
+      increase = m_cssBytes / m_cssGrowthDivisor;
+      m_cssBytes -= increase * m_cssGrowthDivisor;
+    }
+  return increase;
+}
+
+Ptr<TcpSlowStart>
+TcpHyStartPlusPlus::Fork ()
+{
+  return CopyObject<TcpHyStartPlusPlus> (this);
+}
+
+} // namespace ns3
@@ -29,6 +29,8 @@
 #include "ns3/simulator.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv6-route.h"
+#include "ns3/gso-tag.h"
+#include "ns3/timer-wheel.h"
 
 #include "tcp-l4-protocol.h"
 #include "tcp-header.h"
@@ -44,6 +46,8 @@
 #include "tcp-congestion-ops.h"
 #include "tcp-recovery-ops.h"
 #include "tcp-prr-recovery.h"
+#include "tcp-loss-detection.h"
+#include "tcp-slow-start.h"
 #include "rtt-estimator.h"
 
 #include <vector>
@@ -87,6 +91,22 @@ TcpL4Protocol::GetTypeId (void)
                    TypeIdValue (TcpPrrRecovery::GetTypeId ()),
                    MakeTypeIdAccessor (&TcpL4Protocol::m_recoveryTypeId),
                    MakeTypeIdChecker ())
+    .AddAttribute ("LossDetectionType",
+                   "Loss detection type of TCP objects.",
+                   TypeIdValue (TcpClassicLossDetection::GetTypeId ()),
+                   MakeTypeIdAccessor (&TcpL4Protocol::m_lossDetectionTypeId),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("SlowStartType",
+                   "Slow start type of TCP objects.",
+                   TypeIdValue (TcpClassicSlowStart::GetTypeId ()),
+                   MakeTypeIdAccessor (&TcpL4Protocol::m_slowStartTypeId),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("UseTimerWheel",
+                   "Keep the frequently restarted timers of the sockets in "
+                   "a timer wheel instead of scheduling simulator events.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpL4Protocol::m_useTimerWheel),
+                   MakeBooleanChecker ())
     .AddAttribute ("SocketList", "The list of sockets associated to this protocol.",
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&TcpL4Protocol::m_sockets),
@@ -99,6 +119,7 @@ TcpL4Protocol::TcpL4Protocol ()
   : m_endPoints (new Ipv4EndPointDemux ()), m_endPoints6 (new Ipv6EndPointDemux ())
 {
   NS_LOG_FUNCTION (this);
+  GsoSegmentation::Register (Ipv4L3Protocol::PROT_NUMBER, MakeCallback (&TcpL4Protocol::GsoSegment));
 }
 
 TcpL4Protocol::~TcpL4Protocol ()
@@ -174,12 +195,28 @@ TcpL4Protocol::DoDispose (void)
       m_endPoints6 = 0;
     }
 
+  if (m_timerWheel != 0)
+    {
+      m_timerWheel->Dispose ();
+      m_timerWheel = 0;
+    }
+
   m_node = 0;
   m_downTarget.Nullify ();
   m_downTarget6.Nullify ();
   IpL4Protocol::DoDispose ();
 }
 
+Ptr<TimerWheel>
+TcpL4Protocol::GetTimerWheel (void)
+{
+  if (m_useTimerWheel && m_timerWheel == 0)
+    {
+      m_timerWheel = CreateObject<TimerWheel> ();
+    }
+  return m_timerWheel;
+}
+
 Ptr<Socket>
 TcpL4Protocol::CreateSocket (TypeId congestionTypeId)
 {
@@ -193,20 +230,28 @@ TcpL4Protocol::CreateSocket (TypeId congestionTypeId, TypeId recoveryTypeId)
   ObjectFactory rttFactory;
   ObjectFactory congestionAlgorithmFactory;
   ObjectFactory recoveryAlgorithmFactory;
+  ObjectFactory lossDetectionFactory;
+  ObjectFactory slowStartFactory;
   rttFactory.SetTypeId (m_rttTypeId);
   congestionAlgorithmFactory.SetTypeId (congestionTypeId);
   recoveryAlgorithmFactory.SetTypeId (recoveryTypeId);
+  lossDetectionFactory.SetTypeId (m_lossDetectionTypeId);
+  slowStartFactory.SetTypeId (m_slowStartTypeId);
 
   Ptr<RttEstimator> rtt = rttFactory.Create<RttEstimator> ();
   Ptr<TcpSocketBase> socket = CreateObject<TcpSocketBase> ();
   Ptr<TcpCongestionOps> algo = congestionAlgorithmFactory.Create<TcpCongestionOps> ();
   Ptr<TcpRecoveryOps> recovery = recoveryAlgorithmFactory.Create<TcpRecoveryOps> ();
+  Ptr<TcpLossDetection> lossDetection = lossDetectionFactory.Create<TcpLossDetection> ();
+  Ptr<TcpSlowStart> slowStart = slowStartFactory.Create<TcpSlowStart> ();
 
   socket->SetNode (m_node);
   socket->SetTcp (this);
   socket->SetRtt (rtt);
+  socket->SetSlowStartAlgorithm (slowStart);
   socket->SetCongestionControlAlgorithm (algo);
   socket->SetRecoveryAlgorithm (recovery);
+  socket->SetLossDetectionAlgorithm (lossDetection);
 
   m_sockets.push_back (socket);
   return socket;
@@ -551,6 +596,61 @@ TcpL4Protocol::Receive (Ptr<Packet> packet,
   return IpL4Protocol::RX_OK;
 }
 
+std::list<Ptr<Packet> >
+TcpL4Protocol::GsoSegment (Ptr<Packet> packet)
+{
+  // No logging here: NS_LOG_APPEND_CONTEXT needs an instance
+  std::list<Ptr<Packet> > segments;
+  GsoTag gsoTag;
+  Ptr<Packet> p = packet->Copy ();
+  p->RemovePacketTag (gsoTag);
+
+  Ipv4Header ipHeader;
+  p->RemoveHeader (ipHeader);
+  if (ipHeader.GetProtocol () != PROT_NUMBER || gsoTag.GetSegmentSize () == 0)
+    {
+      p->AddHeader (ipHeader);
+      segments.push_back (p);
+      return segments;
+    }
+  TcpHeader tcpHeader;
+  p->RemoveHeader (tcpHeader);
+
+  uint32_t payloadSize = p->GetSize ();
+  uint32_t segmentSize = gsoTag.GetSegmentSize ();
+  uint8_t lastFlags = tcpHeader.GetFlags ();
+  // Ipv4L3Protocol reserved one identification per segment, as Linux
+  // inet_gso_segment numbers the segments
+  uint16_t identification = ipHeader.GetIdentification ();
+  for (uint32_t offset = 0; offset < payloadSize; offset += segmentSize)
+    {
+      uint32_t size = std::min (segmentSize, payloadSize - offset);
+      Ptr<Packet> segment = p->CreateFragment (offset, size);
+      TcpHeader header = tcpHeader;
+      header.SetSequenceNumber (tcpHeader.GetSequenceNumber () + SequenceNumber32 (offset));
+      if (offset + size < payloadSize)
+        {
+          header.SetFlags (lastFlags & ~(TcpHeader::FIN | TcpHeader::PSH));
+        }
+      if (Node::ChecksumEnabled ())
+        {
+          header.EnableChecksums ();
+          header.InitializeChecksum (ipHeader.GetSource (), ipHeader.GetDestination (), PROT_NUMBER);
+        }
+      segment->AddHeader (header);
+      Ipv4Header ip = ipHeader;
+      ip.SetPayloadSize (segment->GetSize ());
+      ip.SetIdentification (identification++);
+      if (Node::ChecksumEnabled ())
+        {
+          ip.EnableChecksum ();
+        }
+      segment->AddHeader (ip);
+      segments.push_back (segment);
+    }
+  return segments;
+}
+
 void
 TcpL4Protocol::SendPacketV4 (Ptr<Packet> packet, const TcpHeader &outgoing,
                              const Ipv4Address &saddr, const Ipv4Address &daddr,
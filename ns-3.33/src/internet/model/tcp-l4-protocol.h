@@ -22,6 +22,7 @@
 #define TCP_L4_PROTOCOL_H
 
 #include <stdint.h>
+#include <list>
 
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
@@ -32,6 +33,7 @@
 namespace ns3 {
 
 class Node;
+class TimerWheel;
 class Socket;
 class TcpHeader;
 class Ipv4EndPointDemux;
@@ -128,6 +130,17 @@ public:
     */
   Ptr<Socket> CreateSocket (TypeId congestionTypeId);
 
+  /**
+   * \brief Get the timer wheel shared by the sockets of this protocol
+   *
+   * The retransmission, delayed ACK and other frequently restarted
+   * timers of the sockets are kept in the wheel, rather than each
+   * scheduling its own simulator events.
+   *
+   * \return the wheel, or 0 if the UseTimerWheel attribute is false
+   */
+  Ptr<TimerWheel> GetTimerWheel (void);
+
   /**
    * \brief Allocate an IPv4 Endpoint
    * \return the Endpoint
@@ -269,6 +282,19 @@ public:
   virtual IpL4Protocol::DownTargetCallback GetDownTarget (void) const;
   virtual IpL4Protocol::DownTargetCallback6 GetDownTarget6 (void) const;
 
+  /**
+   * \brief Split an IPv4 TCP super-segment into wire segments
+   *
+   * The packet starts with the Ipv4Header and carries a GsoTag.  Every
+   * segment gets a copy of the IP and TCP headers with the sequence
+   * number, IP payload size and checksums fixed up; FIN and PSH are kept
+   * on the last segment only.  Registered to GsoSegmentation for IPv4.
+   *
+   * \param packet the super-segment
+   * \return the wire segments, in sequence order
+   */
+  static std::list<Ptr<Packet> > GsoSegment (Ptr<Packet> packet);
+
 protected:
   virtual void DoDispose (void);
 
@@ -320,6 +346,10 @@ private:
   TypeId m_rttTypeId;              //!< The RTT Estimator TypeId
   TypeId m_congestionTypeId;       //!< The socket TypeId
   TypeId m_recoveryTypeId;         //!< The recovery TypeId
+  TypeId m_lossDetectionTypeId;    //!< The loss detection TypeId
+  TypeId m_slowStartTypeId;        //!< The slow start TypeId
+  bool m_useTimerWheel;            //!< Whether sockets keep their timers in m_timerWheel
+  Ptr<TimerWheel> m_timerWheel;    //!< Timer wheel of the sockets, created on demand
   std::vector<Ptr<TcpSocketBase> > m_sockets;      //!< list of sockets
   IpL4Protocol::DownTargetCallback m_downTarget;   //!< Callback to send packets over IPv4
   IpL4Protocol::DownTargetCallback6 m_downTarget6; //!< Callback to send packets over IPv6
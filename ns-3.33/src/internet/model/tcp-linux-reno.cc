@@ -63,7 +63,9 @@ TcpLinuxReno::SlowStart (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
   if (segmentsAcked >= 1)
     {
       uint32_t sndCwnd = tcb->m_cWnd;
-      tcb->m_cWnd = std::min ((sndCwnd + (segmentsAcked * tcb->m_segmentSize)), (uint32_t)tcb->m_ssThresh);
+      uint32_t increase = m_slowStart ? m_slowStart->GetCwndIncrease (tcb, segmentsAcked)
+                                      : segmentsAcked * tcb->m_segmentSize;
+      tcb->m_cWnd = std::min ((sndCwnd + increase), (uint32_t)tcb->m_ssThresh);
       NS_LOG_INFO ("In SlowStart, updated to cwnd " << tcb->m_cWnd << " ssthresh " << tcb->m_ssThresh);
       return segmentsAcked - ((tcb->m_cWnd - sndCwnd) / tcb->m_segmentSize);
     }
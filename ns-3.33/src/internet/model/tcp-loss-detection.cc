@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include "tcp-loss-detection.h"
+#include "tcp-socket-state.h"
+#include "tcp-tx-buffer.h"
+
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpLossDetection");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpLossDetection);
+
+TypeId
+TcpLossDetection::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpLossDetection")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+  ;
+  return tid;
+}
+
+TcpLossDetection::TcpLossDetection () : Object ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpLossDetection::TcpLossDetection (const TcpLossDetection &other) : Object (other)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpLossDetection::~TcpLossDetection ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TcpLossDetection::SegmentDelivered (Ptr<const TcpSocketState> tcb, const TcpTxItem *item)
+{
+  NS_LOG_FUNCTION (this << tcb << item);
+}
+
+Time
+TcpLossDetection::DetectLoss (Ptr<const TcpSocketState> tcb, Ptr<TcpTxBuffer> txBuffer)
+{
+  NS_LOG_FUNCTION (this << tcb << txBuffer);
+  return Time (0);
+}
+
+Time
+TcpLossDetection::GetProbeTimeout (Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight) const
+{
+  NS_LOG_FUNCTION (this << tcb << bytesInFlight);
+  return Time::Max ();
+}
+
+void
+TcpLossDetection::ProbeSent (const SequenceNumber32 &highTxMark, bool isRetrans)
+{
+  NS_LOG_FUNCTION (this << highTxMark << isRetrans);
+}
+
+bool
+TcpLossDetection::ProcessProbeAck (const SequenceNumber32 &ackNumber, bool isPureDupAck)
+{
+  NS_LOG_FUNCTION (this << ackNumber << isPureDupAck);
+  return false;
+}
+
+// Classic loss detection
+
+NS_OBJECT_ENSURE_REGISTERED (TcpClassicLossDetection);
+
+TypeId
+TcpClassicLossDetection::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpClassicLossDetection")
+    .SetParent<TcpLossDetection> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpClassicLossDetection> ()
+  ;
+  return tid;
+}
+
+TcpClassicLossDetection::TcpClassicLossDetection () : TcpLossDetection ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpClassicLossDetection::TcpClassicLossDetection (const TcpClassicLossDetection &other)
+  : TcpLossDetection (other)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpClassicLossDetection::~TcpClassicLossDetection ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+TcpClassicLossDetection::GetName () const
+{
+  return "TcpClassicLossDetection";
+}
+
+bool
+TcpClassicLossDetection::IsTimeBased () const
+{
+  return false;
+}
+
+Ptr<TcpLossDetection>
+TcpClassicLossDetection::Fork ()
+{
+  return CopyObject<TcpClassicLossDetection> (this);
+}
+
+} // namespace ns3
@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef TCP_LOSS_DETECTION_H
+#define TCP_LOSS_DETECTION_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/sequence-number.h"
+
+namespace ns3 {
+
+class TcpSocketState;
+class TcpTxBuffer;
+class TcpTxItem;
+
+/**
+ * \ingroup tcp
+ * \defgroup lossDetection Loss Detection Algorithms.
+ *
+ * The algorithms deciding which segments in flight are lost, and when the
+ * sender should probe for losses at the tail of a flight. The interface is
+ * defined in class TcpLossDetection.
+ */
+
+/**
+ * \ingroup lossDetection
+ *
+ * \brief Loss detection algorithm interface
+ *
+ * TcpSocketBase always counts duplicate acknowledgments and, on SACK
+ * connections, TcpTxBuffer marks a segment as lost once DupAckThresh
+ * segments above it are sacked (RFC 6675). A time-based algorithm
+ * (IsTimeBased returns true) replaces both on SACK connections: the socket
+ * enters recovery only when the algorithm marks segments as lost in
+ * DetectLoss, and runs DetectLoss again when the returned timeout expires.
+ *
+ * The algorithm may also ask for a tail loss probe, a segment sent when no
+ * ACK arrived for a while in the Open state, to trigger an ACK revealing the
+ * losses at the tail of a flight without waiting for the RTO.
+ */
+class TcpLossDetection : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Constructor
+   */
+  TcpLossDetection ();
+
+  /**
+   * \brief Copy constructor.
+   * \param other object to copy.
+   */
+  TcpLossDetection (const TcpLossDetection &other);
+
+  /**
+   * \brief Deconstructor
+   */
+  virtual ~TcpLossDetection ();
+
+  /**
+   * \brief Get the name of the loss detection algorithm
+   *
+   * \return A string identifying the name
+   */
+  virtual std::string GetName () const = 0;
+
+  /**
+   * \brief Does the algorithm replace the DupAckThresh-based detection?
+   *
+   * \return true if the socket should rely on DetectLoss only
+   */
+  virtual bool IsTimeBased () const = 0;
+
+  /**
+   * \brief A segment has been acked or sacked
+   *
+   * The function is called before the segment is removed from the
+   * transmission buffer.
+   *
+   * \param tcb internal congestion state
+   * \param item the segment delivered
+   */
+  virtual void SegmentDelivered (Ptr<const TcpSocketState> tcb, const TcpTxItem *item);
+
+  /**
+   * \brief Mark the lost segments in flight
+   *
+   * The function is called after each ACK has been processed by the
+   * transmission buffer, and when the timeout returned previously expires.
+   *
+   * \param tcb internal congestion state
+   * \param txBuffer the transmission buffer
+   * \return the time after which DetectLoss should be called again,
+   * or zero if not needed
+   */
+  virtual Time DetectLoss (Ptr<const TcpSocketState> tcb, Ptr<TcpTxBuffer> txBuffer);
+
+  /**
+   * \brief Get the tail loss probe timeout
+   *
+   * The function is called in the Open state, each time data is sent or
+   * an ACK is received with data still in flight.
+   *
+   * \param tcb internal congestion state
+   * \param bytesInFlight the bytes in flight
+   * \return the probe timeout, or Time::Max () if no probe is needed
+   */
+  virtual Time GetProbeTimeout (Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight) const;
+
+  /**
+   * \brief A tail loss probe has been sent
+   *
+   * \param highTxMark the highest sequence number sent, after the probe
+   * \param isRetrans true if the probe is a retransmission
+   */
+  virtual void ProbeSent (const SequenceNumber32 &highTxMark, bool isRetrans);
+
+  /**
+   * \brief Check if an ACK tells that a tail loss probe repaired a loss
+   *
+   * \param ackNumber the cumulative ACK received
+   * \param isPureDupAck true if the ACK neither advances SND.UNA nor sacks data
+   * \return true if the congestion window should be reduced
+   */
+  virtual bool ProcessProbeAck (const SequenceNumber32 &ackNumber, bool isPureDupAck);
+
+  /**
+   * \brief Copy the loss detection algorithm across socket
+   *
+   * \return a pointer of the copied object
+   */
+  virtual Ptr<TcpLossDetection> Fork () = 0;
+};
+
+/**
+ * \ingroup lossDetection
+ *
+ * \brief The classic loss detection
+ *
+ * Segments are considered lost after DupAckThresh duplicate ACKs or, with
+ * SACK, DupAckThresh sacked segments above them (RFC 5681, RFC 6675). This
+ * is implemented by TcpSocketBase and TcpTxBuffer; the class adds nothing.
+ */
+class TcpClassicLossDetection : public TcpLossDetection
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Constructor
+   */
+  TcpClassicLossDetection ();
+
+  /**
+   * \brief Copy constructor.
+   * \param other object to copy.
+   */
+  TcpClassicLossDetection (const TcpClassicLossDetection &other);
+
+  /**
+   * \brief Deconstructor
+   */
+  virtual ~TcpClassicLossDetection () override;
+
+  virtual std::string GetName () const override;
+
+  virtual bool IsTimeBased () const override;
+
+  virtual Ptr<TcpLossDetection> Fork () override;
+};
+
+} // namespace ns3
+
+#endif /* TCP_LOSS_DETECTION_H */
@@ -70,7 +70,6 @@ TcpOption::CreateOption (uint8_t kind)
     TypeId tid;
   };
 
-  static ObjectFactory objectFactory;
   static kindToTid toTid[] =
   {
     { TcpOption::END,           TcpOptionEnd::GetTypeId () },
@@ -87,6 +86,8 @@ TcpOption::CreateOption (uint8_t kind)
     {
       if (toTid[i].kind == kind)
         {
+          // Not static: the options may be parsed by several threads
+          ObjectFactory objectFactory;
           objectFactory.SetTypeId (toTid[i].tid);
           return objectFactory.Create<TcpOption> ();
         }
@@ -0,0 +1,290 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include <vector>
+#include "tcp-rack-tlp.h"
+#include "tcp-socket-state.h"
+#include "tcp-tx-buffer.h"
+
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpRackTlp");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpRackTlp);
+
+TypeId
+TcpRackTlp::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpRackTlp")
+    .SetParent<TcpLossDetection> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpRackTlp> ()
+    .AddAttribute ("EnableTlp", "Send tail loss probes",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpRackTlp::m_tlpEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("StaticReoWnd",
+                   "Apply the reordering window even before any reordering is observed",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpRackTlp::m_staticReoWnd),
+                   MakeBooleanChecker ())
+    .AddAttribute ("WorstCaseDelAck",
+                   "Worst case delayed ACK timer of the receiver, added to the "
+                   "probe timeout when a single segment is in flight",
+                   TimeValue (MilliSeconds (200)),
+                   MakeTimeAccessor (&TcpRackTlp::m_wcDelAckT),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+TcpRackTlp::TcpRackTlp () : TcpLossDetection ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpRackTlp::TcpRackTlp (const TcpRackTlp &other)
+  : TcpLossDetection (other),
+    m_tlpEnabled (other.m_tlpEnabled),
+    m_staticReoWnd (other.m_staticReoWnd),
+    m_wcDelAckT (other.m_wcDelAckT)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpRackTlp::~TcpRackTlp ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+TcpRackTlp::GetName () const
+{
+  return "TcpRackTlp";
+}
+
+bool
+TcpRackTlp::IsTimeBased () const
+{
+  return true;
+}
+
+bool
+TcpRackTlp::SentAfter (const Time &t1, const SequenceNumber32 &seq1,
+                       const Time &t2, const SequenceNumber32 &seq2)
+{
+  return t1 > t2 || (t1 == t2 && seq1 > seq2);
+}
+
+void
+TcpRackTlp::SegmentDelivered (Ptr<const TcpSocketState> tcb, const TcpTxItem *item)
+{
+  NS_LOG_FUNCTION (this << tcb << item);
+
+  // A SACKed segment is delivered again when the cumulative ACK covers it:
+  // as TcpRateLinux::SkbDelivered, which marks it, only count it once
+  if (item->GetRateInformation ().m_deliveredTime == Time::Max ())
+    {
+      return;
+    }
+
+  SequenceNumber32 endSeq = item->GetStartSeq () + item->GetSeqSize ();
+  const Time &xmitTs = item->GetLastSent ();
+
+  // RFC 8985, step 3: a segment never retransmitted, delivered below the
+  // highest sequence delivered, has been reordered. As prior_fack in Linux,
+  // only the previous ACKs count: the socket processes the SACK blocks
+  // before the cumulative ACK, which may fill the hole below them
+  if (m_rackValid && endSeq < m_priorFack && !item->IsRetrans ())
+    {
+      m_reorderingSeen = true;
+    }
+  if (!m_rackValid || endSeq > m_fack)
+    {
+      m_fack = endSeq;
+    }
+
+  // RFC 8985, step 2: the ACK of a retransmission faster than the minimum
+  // RTT is probably the ACK of the original transmission
+  Time rtt = Simulator::Now () - xmitTs;
+  if (item->IsRetrans () && rtt < tcb->m_minRtt)
+    {
+      NS_LOG_LOGIC ("Ambiguous RTT sample " << rtt << " ignored");
+      return;
+    }
+
+  m_rackRtt = rtt;
+  if (!m_rackValid || SentAfter (xmitTs, endSeq, m_rackXmitTs, m_rackEndSeq))
+    {
+      m_rackXmitTs = xmitTs;
+      m_rackEndSeq = endSeq;
+    }
+  m_rackValid = true;
+}
+
+Time
+TcpRackTlp::GetReorderingWindow (Ptr<const TcpSocketState> tcb, Ptr<const TcpTxBuffer> txBuffer) const
+{
+  if (!m_reorderingSeen && !m_staticReoWnd)
+    {
+      if (tcb->m_congState == TcpSocketState::CA_RECOVERY
+          || tcb->m_congState == TcpSocketState::CA_LOSS)
+        {
+          return Time (0);
+        }
+      if (txBuffer->GetSacked () >= txBuffer->GetDupAckThresh () * tcb->m_segmentSize)
+        {
+          return Time (0);
+        }
+    }
+  if (tcb->m_minRtt == Time::Max ())
+    {
+      return Time (0);
+    }
+  return std::min (tcb->m_minRtt / 4, tcb->m_srtt);
+}
+
+Time
+TcpRackTlp::DetectLoss (Ptr<const TcpSocketState> tcb, Ptr<TcpTxBuffer> txBuffer)
+{
+  NS_LOG_FUNCTION (this << tcb << txBuffer);
+
+  // Called once the segments delivered by an ACK are processed
+  m_priorFack = m_fack;
+  if (!m_rackValid)
+    {
+      return Time (0);
+    }
+
+  Time now = Simulator::Now ();
+  Time reoWnd = GetReorderingWindow (tcb, txBuffer);
+  Time timeout (0);
+  std::vector<TcpTxItem *> lost;
+
+  for (TcpTxItem *item : txBuffer->GetTimeOrderedSentList ())
+    {
+      SequenceNumber32 endSeq = item->GetStartSeq () + item->GetSeqSize ();
+      if (!SentAfter (m_rackXmitTs, m_rackEndSeq, item->GetLastSent (), endSeq))
+        {
+          // This and the following segments were sent after the most recent
+          // segment delivered
+          break;
+        }
+      if (item->IsRetrans () && item->GetLastSent () == m_rackXmitTs)
+        {
+          // The sequence tie-break assumes the segments of an instant leave in
+          // order, but a retransmission can follow new data sent by an earlier
+          // ACK of the same instant: the order is unknown, wait for more ACKs
+          continue;
+        }
+
+      Time remaining = m_rackRtt + reoWnd - (now - item->GetLastSent ());
+      if (remaining <= Time (0))
+        {
+          lost.push_back (item);
+        }
+      else
+        {
+          timeout = std::max (timeout, remaining);
+        }
+    }
+
+  for (TcpTxItem *item : lost)
+    {
+      NS_LOG_INFO ("RACK marks lost " << *item);
+      txBuffer->MarkAsLost (item);
+    }
+  return timeout;
+}
+
+Time
+TcpRackTlp::GetProbeTimeout (Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight) const
+{
+  NS_LOG_FUNCTION (this << tcb << bytesInFlight);
+
+  if (!m_tlpEnabled || m_tlpOutstanding)
+    {
+      return Time::Max ();
+    }
+
+  // RFC 8985, section 7.2
+  Time srtt = tcb->m_srtt;
+  if (srtt.IsZero ())
+    {
+      return Seconds (1);
+    }
+  Time pto = srtt + srtt;
+  if (bytesInFlight <= tcb->m_segmentSize)
+    {
+      pto += m_wcDelAckT;
+    }
+  // Same lower bound as Linux
+  return std::max (pto, MilliSeconds (10));
+}
+
+void
+TcpRackTlp::ProbeSent (const SequenceNumber32 &highTxMark, bool isRetrans)
+{
+  NS_LOG_FUNCTION (this << highTxMark << isRetrans);
+  m_tlpOutstanding = true;
+  m_tlpEndSeq = highTxMark;
+  m_tlpIsRetrans = isRetrans;
+}
+
+bool
+TcpRackTlp::ProcessProbeAck (const SequenceNumber32 &ackNumber, bool isPureDupAck)
+{
+  NS_LOG_FUNCTION (this << ackNumber << isPureDupAck);
+
+  // RFC 8985, section 7.4, without D-SACK
+  if (!m_tlpOutstanding || ackNumber < m_tlpEndSeq)
+    {
+      return false;
+    }
+  if (!m_tlpIsRetrans)
+    {
+      m_tlpOutstanding = false;
+      return false;
+    }
+  if (ackNumber > m_tlpEndSeq)
+    {
+      NS_LOG_INFO ("Tail loss probe repaired a loss");
+      m_tlpOutstanding = false;
+      return true;
+    }
+  if (isPureDupAck)
+    {
+      // The probe was a duplicate: the original segment was not lost
+      m_tlpOutstanding = false;
+    }
+  return false;
+}
+
+Ptr<TcpLossDetection>
+TcpRackTlp::Fork ()
+{
+  return CopyObject<TcpRackTlp> (this);
+}
+
+} // namespace ns3
@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include "tcp-slow-start.h"
+#include "tcp-socket-state.h"
+
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpSlowStart");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpSlowStart);
+
+TypeId
+TcpSlowStart::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpSlowStart")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+    .AddAttribute ("LimitInitialWindow",
+                   "Limit the initial window in bytes as in RFC 6928",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSlowStart::m_limitInitialWindow),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+TcpSlowStart::TcpSlowStart () : Object ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpSlowStart::TcpSlowStart (const TcpSlowStart &other)
+  : Object (other),
+    m_limitInitialWindow (other.m_limitInitialWindow)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpSlowStart::~TcpSlowStart ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+TcpSlowStart::GetInitialWindow (Ptr<const TcpSocketState> tcb) const
+{
+  NS_LOG_FUNCTION (this << tcb);
+  uint32_t window = tcb->m_initialCWnd * tcb->m_segmentSize;
+  if (m_limitInitialWindow)
+    {
+      // RFC 6928: min (10*MSS, max (2*MSS, 14600)), scaled to InitialCwnd
+      uint32_t limit = std::max (2 * tcb->m_segmentSize, tcb->m_initialCWnd * 1460);
+      window = std::min (window, limit);
+    }
+  return window;
+}
+
+void
+TcpSlowStart::PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                         const Time &rtt, const TcpRateOps::TcpRateConnection &rc)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked << rtt);
+}
+
+uint32_t
+TcpSlowStart::GetCwndIncrease (Ptr<const TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+  return segmentsAcked * tcb->m_segmentSize;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (TcpClassicSlowStart);
+
+TypeId
+TcpClassicSlowStart::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpClassicSlowStart")
+    .SetParent<TcpSlowStart> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpClassicSlowStart> ()
+  ;
+  return tid;
+}
+
+TcpClassicSlowStart::TcpClassicSlowStart () : TcpSlowStart ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpClassicSlowStart::TcpClassicSlowStart (const TcpClassicSlowStart &other)
+  : TcpSlowStart (other)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpClassicSlowStart::~TcpClassicSlowStart ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+TcpClassicSlowStart::GetName () const
+{
+  return "TcpClassicSlowStart";
+}
+
+Ptr<TcpSlowStart>
+TcpClassicSlowStart::Fork ()
+{
+  return CopyObject<TcpClassicSlowStart> (this);
+}
+
+} // namespace ns3
@@ -43,6 +43,9 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/data-rate.h"
 #include "ns3/object.h"
+#include "ns3/gso-tag.h"
+#include "ns3/departure-time-tag.h"
+#include "ns3/pacing-rate-tag.h"
 #include "tcp-socket-base.h"
 #include "tcp-l4-protocol.h"
 #include "ipv4-end-point.h"
@@ -58,6 +61,8 @@
 #include "tcp-option-sack.h"
 #include "tcp-congestion-ops.h"
 #include "tcp-recovery-ops.h"
+#include "tcp-loss-detection.h"
+#include "tcp-slow-start.h"
 #include "ns3/tcp-rate-ops.h"
 
 #include <math.h>
@@ -255,11 +260,14 @@ TcpSocketBase::TcpSocketBase (void)
   m_txBuffer->SetRWndCallback (MakeCallback (&TcpSocketBase::GetRWnd, this));
   m_tcb      = CreateObject<TcpSocketState> ();
   m_rateOps  = CreateObject <TcpRateLinux> ();
+  m_lossDetection = CreateObject<TcpClassicLossDetection> ();
+  m_slowStart = CreateObject<TcpClassicSlowStart> ();
 
   m_tcb->m_rxBuffer = CreateObject<TcpRxBuffer> ();
 
   m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
   m_pacingTimer.SetFunction (&TcpSocketBase::NotifyPacingPerformed, this);
+  InitTimers ();
 
   m_tcb->m_sendEmptyPacketCallback = MakeCallback (&TcpSocketBase::SendEmptyPacket, this);
 
@@ -380,10 +388,17 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
 
   m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
   m_pacingTimer.SetFunction (&TcpSocketBase::NotifyPacingPerformed, this);
+  InitTimers ();
+
+  if (sock.m_slowStart)
+    {
+      m_slowStart = sock.m_slowStart->Fork ();
+    }
 
   if (sock.m_congestionControl)
     {
       m_congestionControl = sock.m_congestionControl->Fork ();
+      m_congestionControl->SetSlowStart (m_slowStart);
       m_congestionControl->Init (m_tcb);
     }
 
@@ -392,6 +407,11 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
       m_recoveryOps = sock.m_recoveryOps->Fork ();
     }
 
+  if (sock.m_lossDetection)
+    {
+      m_lossDetection = sock.m_lossDetection->Fork ();
+    }
+
   m_rateOps = CreateObject <TcpRateLinux> ();
   if (m_tcb->m_sendEmptyPacketCallback.IsNull ())
     {
@@ -481,6 +501,29 @@ void
 TcpSocketBase::SetTcp (Ptr<TcpL4Protocol> tcp)
 {
   m_tcp = tcp;
+  InitTimers ();
+}
+
+void
+TcpSocketBase::InitTimers (void)
+{
+  m_retxEvent.SetFunction (&TcpSocketBase::RetxTimerExpired, this);
+  m_retxEvent.SetArguments (static_cast<uint8_t> (0));
+  m_lastAckEvent.SetFunction (&TcpSocketBase::LastAckTimeout, this);
+  m_delAckEvent.SetFunction (&TcpSocketBase::DelAckTimeout, this);
+  m_persistEvent.SetFunction (&TcpSocketBase::PersistTimeout, this);
+  m_timewaitEvent.SetFunction (&TcpSocketBase::CloseAndNotify, this);
+  m_reoTimeoutEvent.SetFunction (&TcpSocketBase::ReorderTimeout, this);
+  m_lossProbeEvent.SetFunction (&TcpSocketBase::SendLossProbe, this);
+
+  Ptr<TimerWheel> wheel = m_tcp != nullptr ? m_tcp->GetTimerWheel () : nullptr;
+  m_retxEvent.SetWheel (wheel);
+  m_lastAckEvent.SetWheel (wheel);
+  m_delAckEvent.SetWheel (wheel);
+  m_persistEvent.SetWheel (wheel);
+  m_timewaitEvent.SetWheel (wheel);
+  m_reoTimeoutEvent.SetWheel (wheel);
+  m_lossProbeEvent.SetWheel (wheel);
 }
 
 /* Set an RTT estimator with this socket */
@@ -1335,7 +1378,7 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
         }
 
       // Initialize cWnd and ssThresh
-      m_tcb->m_cWnd = GetInitialCwnd () * GetSegSize ();
+      m_tcb->m_cWnd = m_slowStart->GetInitialWindow (m_tcb);
       m_tcb->m_cWndInfl = m_tcb->m_cWnd;
       m_tcb->m_ssThresh = GetInitialSSThresh ();
 
@@ -1375,13 +1418,13 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
     { // Zero window: Enter persist state to send 1 byte to probe
       NS_LOG_LOGIC (this << " Enter zerowindow persist state");
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                    (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
       m_retxEvent.Cancel ();
       NS_LOG_LOGIC ("Schedule persist timeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_persistTimeout).GetSeconds ());
-      m_persistEvent = Simulator::Schedule (m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
-      NS_ASSERT (m_persistTimeout == Simulator::GetDelayLeft (m_persistEvent));
+      m_persistEvent.Schedule (m_persistTimeout);
+      NS_ASSERT (m_persistTimeout == m_persistEvent.GetDelayLeft ());
     }
 
   // TCP state machine code in different process functions
@@ -1612,7 +1655,7 @@ TcpSocketBase::EnterRecovery (uint32_t currentDelivered)
       m_txBuffer->AddRenoSack ();
       m_txBuffer->MarkHeadAsLost ();
     }
-  else
+  else if (!IsTimeBasedLossDetection ())
     {
       if (!m_txBuffer->IsLost (m_txBuffer->HeadSequence ()))
         {
@@ -1706,8 +1749,10 @@ TcpSocketBase::DupAck (uint32_t currentDelivered)
                        "Increase cwnd to " << m_tcb->m_cWnd);
         }
     }
-  else if (m_tcb->m_congState == TcpSocketState::CA_DISORDER)
+  else if (m_tcb->m_congState == TcpSocketState::CA_DISORDER && !IsTimeBasedLossDetection ())
     {
+      // With a time-based loss detection, the recovery is entered only when
+      // segments are marked lost (see EnterRecoveryOnLoss).
       // m_dupackCount should not exceed its threshold in CA_DISORDER state
       // when m_recoverActive has not been set. When recovery point
       // have been set after timeout, the sender could enter into CA_DISORDER
@@ -1761,6 +1806,68 @@ TcpSocketBase::DupAck (uint32_t currentDelivered)
     }
 }
 
+bool
+TcpSocketBase::IsTimeBasedLossDetection (void) const
+{
+  return m_sackEnabled && m_lossDetection->IsTimeBased ();
+}
+
+void
+TcpSocketBase::SegmentDelivered (TcpTxItem *item)
+{
+  // The rate estimator marks the item delivered, which the loss
+  // detection checks to skip a SACKed item acked again cumulatively
+  m_lossDetection->SegmentDelivered (m_tcb, item);
+  m_rateOps->SkbDelivered (item);
+}
+
+void
+TcpSocketBase::DetectLoss (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time timeout = m_lossDetection->DetectLoss (m_tcb, m_txBuffer);
+
+  if (timeout.IsStrictlyPositive ())
+    {
+      NS_LOG_LOGIC ("Loss detection timer expires in " << timeout.As (Time::MS));
+      m_reoTimeoutEvent.Schedule (timeout);
+    }
+  else
+    {
+      m_reoTimeoutEvent.Cancel ();
+    }
+}
+
+void
+TcpSocketBase::EnterRecoveryOnLoss (uint32_t currentDelivered)
+{
+  NS_LOG_FUNCTION (this << currentDelivered);
+  // Same conditions as the DupAck entry: no new recovery phase before
+  // HighACK reaches the RecoveryPoint (RFC 6675, section 5.1)
+  if (m_txBuffer->GetLost () > 0
+      && (m_tcb->m_congState == TcpSocketState::CA_OPEN
+          || m_tcb->m_congState == TcpSocketState::CA_DISORDER)
+      && ((m_highRxAckMark >= m_recover) || (!m_recoverActive)))
+    {
+      EnterRecovery (currentDelivered);
+      NS_ASSERT (m_tcb->m_congState == TcpSocketState::CA_RECOVERY);
+    }
+}
+
+void
+TcpSocketBase::ReorderTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_state == CLOSED || m_state == TIME_WAIT)
+    {
+      return;
+    }
+
+  DetectLoss ();
+  EnterRecoveryOnLoss (0);
+  SendPendingData (m_connected);
+}
+
 /* Process the newly received ACK */
 void
 TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
@@ -1808,7 +1915,7 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
         }
     }
 
-  m_txBuffer->DiscardUpTo (ackNumber, MakeCallback (&TcpRateOps::SkbDelivered, m_rateOps));
+  m_txBuffer->DiscardUpTo (ackNumber, MakeCallback (&TcpSocketBase::SegmentDelivered, this));
 
   uint32_t currentDelivered = static_cast<uint32_t> (m_rateOps->GetConnectionRate ().m_delivered - previousDelivered);
 
@@ -1845,6 +1952,12 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       m_tcb->m_ecnState = TcpSocketState::ECN_IDLE;
     }
 
+  // Time-based loss detection works on the updated scoreboard
+  if (IsTimeBasedLossDetection ())
+    {
+      DetectLoss ();
+    }
+
   // Update bytes in flight before processing the ACK for proper calculation of congestion window
   NS_LOG_INFO ("Update bytes in flight before processing the ACK.");
   BytesInFlight ();
@@ -1854,6 +1967,24 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
   ProcessAck (ackNumber, (bytesSacked > 0), currentDelivered, oldHeadSequence);
   m_tcb->m_isRetransDataAcked = false;
 
+  if (IsTimeBasedLossDetection ())
+    {
+      EnterRecoveryOnLoss (currentDelivered);
+    }
+
+  // RFC 8985, section 7.4: a probe retransmission acked with later data
+  // repaired a loss, which calls for a congestion window reduction
+  bool isPureDupAck = (ackNumber == oldHeadSequence) && (bytesSacked == 0);
+  if (m_lossDetection->ProcessProbeAck (ackNumber, isPureDupAck)
+      && m_tcb->m_congState == TcpSocketState::CA_OPEN
+      && !m_congestionControl->HasCongControl ())
+    {
+      m_tcb->m_ssThresh = m_congestionControl->GetSsThresh (m_tcb, BytesInFlight ());
+      m_tcb->m_cWnd = m_tcb->m_ssThresh.Get ();
+      m_tcb->m_cWndInfl = m_tcb->m_cWnd;
+      NS_LOG_INFO ("Loss repaired by a tail loss probe; reduce cwnd to " << m_tcb->m_cWnd);
+    }
+
   if (m_congestionControl->HasCongControl ())
     {
       uint32_t currentLost = m_txBuffer->GetLost ();
@@ -1874,6 +2005,7 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 
   // RFC 6675, Section 5, point (C), try to send more data. NB: (C) is implemented
   // inside SendPendingData
+  ScheduleLossProbe ();
   SendPendingData (m_connected);
 }
 
@@ -2156,6 +2288,8 @@ TcpSocketBase::ProcessAck(const SequenceNumber32 &ackNumber, bool scoreboardUpda
             }
           if (m_tcb->m_congState == TcpSocketState::CA_OPEN)
             {
+              m_slowStart->PktsAcked (m_tcb, segsAcked, m_tcb->m_lastRtt,
+                                      m_rateOps->GetConnectionRate ());
               m_congestionControl->IncreaseWindow (m_tcb, segsAcked);
 
               m_tcb->m_cWndInfl = m_tcb->m_cWnd;
@@ -2624,7 +2758,7 @@ TcpSocketBase::DoPeerClose (void)
       m_dataRetrCount = m_dataRetries; // prevent endless FINs
       NS_LOG_LOGIC ("TcpSocketBase " << this << " scheduling LATO1");
       Time lastRto = m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation () * 4);
-      m_lastAckEvent = Simulator::Schedule (lastRto, &TcpSocketBase::LastAckTimeout, this);
+      m_lastAckEvent.Schedule (lastRto);
     }
 }
 
@@ -2640,7 +2774,7 @@ TcpSocketBase::Destroy (void)
       m_tcp->RemoveSocket (this);
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -2656,7 +2790,7 @@ TcpSocketBase::Destroy6 (void)
       m_tcp->RemoveSocket (this);
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -2784,7 +2918,8 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
       NS_LOG_LOGIC ("Schedule retransmission timeout at time "
                     << Simulator::Now ().GetSeconds () << " to expire at time "
                     << (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+      m_retxEvent.SetArguments (flags);
+      m_retxEvent.Schedule (m_rto);
     }
 }
 
@@ -3054,6 +3189,21 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
   NS_ASSERT (isRetransmission || ((m_highRxAckMark + SequenceNumber32 (m_rWnd)) >= (seq + SequenceNumber32 (maxSize))));
 
   if (IsPacingEnabled ())
+    {
+      // Counterpart of sk_pacing_rate, for queue discs pacing the flow
+      p->AddPacketTag (PacingRateTag (m_tcb->m_pacingRate));
+    }
+
+  if (IsPacingEnabled () && m_tcb->m_edtPacing)
+    {
+      // Earliest departure time model: the segment leaves now, stamped with
+      // the time at which the queue disc may release it
+      Time departure = std::max (m_tcb->m_departureTime, Simulator::Now ());
+      p->AddPacketTag (DepartureTimeTag (departure));
+      m_tcb->m_departureTime = departure + m_tcb->m_pacingRate.Get ().CalculateBytesTxTime (sz);
+      NS_LOG_DEBUG ("Departure time " << departure << " next " << m_tcb->m_departureTime);
+    }
+  else if (IsPacingEnabled ())
     {
       NS_LOG_INFO ("Pacing is enabled");
       if (m_pacingTimer.IsExpired ())
@@ -3089,6 +3239,11 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
 
   AddSocketTags (p);
 
+  if (sz > m_tcb->m_segmentSize)
+    {
+      p->AddPacketTag (GsoTag (m_tcb->m_segmentSize, (sz + m_tcb->m_segmentSize - 1) / m_tcb->m_segmentSize));
+    }
+
   if (m_closeOnEmpty && (remainingData == 0))
     {
       flags |= TcpHeader::FIN;
@@ -3127,7 +3282,8 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       NS_LOG_LOGIC (this << " SendDataPacket Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds () );
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      m_retxEvent.SetArguments (static_cast<uint8_t> (0));
+      m_retxEvent.Schedule (m_rto);
     }
 
   m_txTrace (p, header, this);
@@ -3218,7 +3374,22 @@ TcpSocketBase::SendPendingData (bool withAck)
   // else branch to control silly window syndrome and Nagle)
   while (availableWindow > 0)
     {
-      if (IsPacingEnabled ())
+      if (IsPacingEnabled () && m_tcb->m_edtPacing)
+        {
+          // Stop once the departure time runs past the horizon; one timer
+          // covers the whole horizon instead of one per segment
+          Time horizon = Simulator::Now () + m_tcb->m_edtHorizon;
+          if (m_tcb->m_departureTime > horizon)
+            {
+              if (!m_pacingTimer.IsRunning ())
+                {
+                  m_pacingTimer.Schedule (m_tcb->m_departureTime - horizon);
+                }
+              NS_LOG_INFO ("Departure time beyond the horizon " << m_tcb->m_departureTime);
+              break;
+            }
+        }
+      else if (IsPacingEnabled ())
         {
           NS_LOG_INFO ("Pacing is enabled");
           if (m_pacingTimer.IsRunning ())
@@ -3282,6 +3453,18 @@ TcpSocketBase::SendPendingData (bool withAck)
           uint32_t maxSizeToSend = static_cast<uint32_t> (nextHigh - next);
           s = std::min (s, maxSizeToSend);
 
+          // Unsent data may leave as one GSO super-segment; retransmissions
+          // always go out one segment at a time
+          if (m_tcb->m_gsoMaxSegs > 1 && m_endPoint != nullptr
+              && next == m_tcb->m_highTxMark && s == m_tcb->m_segmentSize)
+            {
+              int32_t rWndLeft = (m_highRxAckMark.Get () + SequenceNumber32 (m_rWnd.Get ())) - next;
+              uint32_t gsoSize = std::min (availableWindow, GsoSizeGoal ());
+              gsoSize = std::min (gsoSize, static_cast<uint32_t> (std::max (rWndLeft, 0)));
+              gsoSize -= gsoSize % m_tcb->m_segmentSize;
+              s = std::max (s, gsoSize);
+            }
+
           // (C.2) If any of the data octets sent in (C.1) are below HighData,
           //       HighRxt MUST be set to the highest sequence number of the
           //       retransmitted segment unless NextSeg () rule (4) was
@@ -3313,7 +3496,7 @@ TcpSocketBase::SendPendingData (bool withAck)
                         " size " << sz);
           m_tcb->m_nextTxSequence += sz;
           ++nPacketsSent;
-          if (IsPacingEnabled ())
+          if (IsPacingEnabled () && !m_tcb->m_edtPacing)
             {
               NS_LOG_INFO ("Pacing is enabled");
               if (m_pacingTimer.IsExpired ())
@@ -3349,6 +3532,7 @@ TcpSocketBase::SendPendingData (bool withAck)
         }
 
       NS_LOG_DEBUG ("SendPendingData sent " << nPacketsSent << " segments");
+      ScheduleLossProbe ();
     }
   else
     {
@@ -3512,10 +3696,9 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
       else if (m_delAckEvent.IsExpired ())
         {
           m_congestionControl->CwndEvent (m_tcb, TcpSocketState::CA_EVENT_DELAYED_ACK);
-          m_delAckEvent = Simulator::Schedule (m_delAckTimeout,
-                                               &TcpSocketBase::DelAckTimeout, this);
+          m_delAckEvent.Schedule (m_delAckTimeout);
           NS_LOG_LOGIC (this << " scheduled delayed ACK at " <<
-                        (Simulator::Now () + Simulator::GetDelayLeft (m_delAckEvent)).GetSeconds ());
+                        (Simulator::Now () + m_delAckEvent.GetDelayLeft ()).GetSeconds ());
         }
     }
 }
@@ -3572,6 +3755,7 @@ TcpSocketBase::EstimateRtt (const TcpHeader& tcpHeader)
       // RFC 6298, clause 2.4
       m_rto = Max (m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation () * 4), m_minRto);
       m_tcb->m_lastRtt = m_rtt->GetEstimate ();
+      m_tcb->m_srtt = m_rtt->GetEstimate ();
       m_tcb->m_minRtt = std::min (m_tcb->m_lastRtt.Get (), m_tcb->m_minRtt);
       NS_LOG_INFO (this << m_tcb->m_lastRtt << m_tcb->m_minRtt);
     }
@@ -3590,9 +3774,8 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
 
   if (m_state != SYN_RCVD && resetRTO)
     { // Set RTO unless the ACK is received in SYN_RCVD state
-      NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+      NS_LOG_LOGIC (this << " Restarted ReTxTimeout event which was set to expire at " <<
+                    (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
       // On receiving a "New" ack we restart retransmission timer .. RFC 6298
       // RFC 6298, clause 2.4
       m_rto = Max (m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation () * 4), m_minRto);
@@ -3600,7 +3783,8 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
       NS_LOG_LOGIC (this << " Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      m_retxEvent.SetArguments (static_cast<uint8_t> (0));
+      m_retxEvent.Schedule (m_rto);
     }
 
   // Note the highest ACK and tell app to send more
@@ -3618,12 +3802,26 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
   if (m_txBuffer->Size () == 0 && m_state != FIN_WAIT_1 && m_state != CLOSING)
     { // No retransmit timer if no data to retransmit
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                    (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
       m_retxEvent.Cancel ();
     }
 }
 
 // Retransmit timeout
+void
+TcpSocketBase::RetxTimerExpired (uint8_t flags)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (flags));
+  if (flags != 0)
+    {
+      SendEmptyPacket (flags);
+    }
+  else
+    {
+      ReTxTimeout ();
+    }
+}
+
 void
 TcpSocketBase::ReTxTimeout ()
 {
@@ -3685,6 +3883,8 @@ TcpSocketBase::ReTxTimeout ()
 
   // Reset dupAckCount
   m_dupAckCount = 0;
+  m_reoTimeoutEvent.Cancel ();
+  m_lossProbeEvent.Cancel ();
   if (!m_sackEnabled)
     {
       m_txBuffer->ResetRenoSack ();
@@ -3753,6 +3953,77 @@ TcpSocketBase::ReTxTimeout ()
                  ") there is more than one segment (" << m_tcb->m_segmentSize << ")");
 }
 
+void
+TcpSocketBase::ScheduleLossProbe (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // RFC 8985, section 7.2: only in the Open state of a SACK connection
+  // which has data in flight
+  Time pto = Time::Max ();
+  uint32_t bytesInFlight = BytesInFlight ();
+  if (m_sackEnabled && m_tcb->m_congState == TcpSocketState::CA_OPEN
+      && (m_state == ESTABLISHED || m_state == CLOSE_WAIT) && bytesInFlight > 0)
+    {
+      pto = m_lossDetection->GetProbeTimeout (m_tcb, bytesInFlight);
+    }
+  // The RTO takes over if it expires first
+  if (pto == Time::Max ()
+      || (m_retxEvent.IsRunning () && pto >= m_retxEvent.GetDelayLeft ()))
+    {
+      m_lossProbeEvent.Cancel ();
+      return;
+    }
+  // Segments sent back to back would re-arm the timer at the same deadline
+  if (m_lossProbeEvent.IsRunning () && m_lossProbeEvent.GetDelayLeft () == pto)
+    {
+      return;
+    }
+  NS_LOG_LOGIC ("Tail loss probe in " << pto.As (Time::MS));
+  m_lossProbeEvent.Schedule (pto);
+}
+
+void
+TcpSocketBase::SendLossProbe (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_tcb->m_congState != TcpSocketState::CA_OPEN
+      || (m_state != ESTABLISHED && m_state != CLOSE_WAIT)
+      || m_txBuffer->HeadSequence () >= m_tcb->m_highTxMark)
+    {
+      return;
+    }
+
+  // RFC 8985, section 7.3: send a new segment if the receiver window allows
+  bool isRetrans = false;
+  if (m_tcb->m_nextTxSequence == m_tcb->m_highTxMark
+      && m_txBuffer->SizeFromSequence (m_tcb->m_nextTxSequence) > 0
+      && UnAckDataCount () + m_tcb->m_segmentSize <= m_rWnd)
+    {
+      uint32_t sz = SendDataPacket (m_tcb->m_nextTxSequence, m_tcb->m_segmentSize, m_connected);
+      m_tcb->m_nextTxSequence += sz;
+    }
+  else if (m_txBuffer->GetSacked () == 0)
+    {
+      // ... otherwise retransmit the last segment sent
+      SequenceNumber32 highTxMark = m_tcb->m_highTxMark;
+      uint32_t outstanding = highTxMark - m_txBuffer->HeadSequence ();
+      SequenceNumber32 seq = highTxMark - std::min (outstanding, m_tcb->m_segmentSize);
+      SendDataPacket (seq, m_tcb->m_segmentSize, true);
+      isRetrans = true;
+    }
+  else
+    {
+      return;
+    }
+  NS_LOG_INFO ("Sent a tail loss probe, retransmission: " << isRetrans);
+  m_lossDetection->ProbeSent (m_tcb->m_highTxMark, isRetrans);
+
+  // Restart the RTO from the probe
+  m_retxEvent.SetArguments (static_cast<uint8_t> (0));
+  m_retxEvent.Schedule (m_rto);
+}
+
 void
 TcpSocketBase::DelAckTimeout (void)
 {
@@ -3788,7 +4059,7 @@ TcpSocketBase::LastAckTimeout (void)
       SendEmptyPacket (TcpHeader::FIN | TcpHeader::ACK);
       NS_LOG_LOGIC ("TcpSocketBase " << this << " rescheduling LATO1");
       Time lastRto = m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation () * 4);
-      m_lastAckEvent = Simulator::Schedule (lastRto, &TcpSocketBase::LastAckTimeout, this);
+      m_lastAckEvent.Schedule (lastRto);
     }
 }
 
@@ -3844,7 +4115,7 @@ TcpSocketBase::PersistTimeout ()
   NS_LOG_LOGIC ("Schedule persist timeout at time "
                 << Simulator::Now ().GetSeconds () << " to expire at time "
                 << (Simulator::Now () + m_persistTimeout).GetSeconds ());
-  m_persistEvent = Simulator::Schedule (m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
+  m_persistEvent.Schedule (m_persistTimeout);
 }
 
 void
@@ -3886,6 +4157,8 @@ void
 TcpSocketBase::CancelAllTimers ()
 {
   m_retxEvent.Cancel ();
+  m_reoTimeoutEvent.Cancel ();
+  m_lossProbeEvent.Cancel ();
   m_persistEvent.Cancel ();
   m_delAckEvent.Cancel ();
   m_lastAckEvent.Cancel ();
@@ -3911,8 +4184,7 @@ TcpSocketBase::TimeWait ()
     }
   // Move from TIME_WAIT to CLOSED after 2*MSL. Max segment lifetime is 2 min
   // according to RFC793, p.28
-  m_timewaitEvent = Simulator::Schedule (Seconds (2 * m_msl),
-                                         &TcpSocketBase::CloseAndNotify, this);
+  m_timewaitEvent.Schedule (Seconds (2 * m_msl));
 }
 
 /* Below are the attribute get/set functions */
@@ -4165,7 +4437,7 @@ TcpSocketBase::ProcessOptionSack (const Ptr<const TcpOption> option)
   NS_LOG_FUNCTION (this << option);
 
   Ptr<const TcpOptionSack> s = DynamicCast<const TcpOptionSack> (option);
-  return m_txBuffer->Update (s->GetSackList (), MakeCallback (&TcpRateOps::SkbDelivered, m_rateOps));
+  return m_txBuffer->Update (s->GetSackList (), MakeCallback (&TcpSocketBase::SegmentDelivered, this));
 }
 
 void
@@ -4420,6 +4692,7 @@ TcpSocketBase::SetCongestionControlAlgorithm (Ptr<TcpCongestionOps> algo)
 {
   NS_LOG_FUNCTION (this << algo);
   m_congestionControl = algo;
+  m_congestionControl->SetSlowStart (m_slowStart);
   m_congestionControl->Init (m_tcb);
 }
 
@@ -4430,6 +4703,25 @@ TcpSocketBase::SetRecoveryAlgorithm (Ptr<TcpRecoveryOps> recovery)
   m_recoveryOps = recovery;
 }
 
+void
+TcpSocketBase::SetLossDetectionAlgorithm (Ptr<TcpLossDetection> lossDetection)
+{
+  NS_LOG_FUNCTION (this << lossDetection);
+  m_lossDetection = lossDetection;
+  m_txBuffer->SetDupThreshLossDetection (!m_lossDetection->IsTimeBased ());
+}
+
+void
+TcpSocketBase::SetSlowStartAlgorithm (Ptr<TcpSlowStart> slowStart)
+{
+  NS_LOG_FUNCTION (this << slowStart);
+  m_slowStart = slowStart;
+  if (m_congestionControl)
+    {
+      m_congestionControl->SetSlowStart (m_slowStart);
+    }
+}
+
 Ptr<TcpSocketBase>
 TcpSocketBase::Fork (void)
 {
@@ -4524,6 +4816,26 @@ TcpSocketBase::UpdatePacingRate (void)
     }
 }
 
+uint32_t
+TcpSocketBase::GsoSegsGoal (Ptr<const TcpSocketState> tcb, bool paced, uint32_t minSegs)
+{
+  uint32_t mss = tcb->m_segmentSize;
+  // The IPv4 total length field bounds the super-segment
+  uint32_t segs = std::min (tcb->m_gsoMaxSegs, (65535U - 20 - 60) / mss);
+  if (paced)
+    {
+      uint64_t bytes = tcb->m_pacingRate.Get ().GetBitRate () / 8 / 1000;
+      segs = std::min<uint64_t> (segs, std::max<uint64_t> (bytes / mss, minSegs));
+    }
+  return std::max<uint32_t> (segs, 1);
+}
+
+uint32_t
+TcpSocketBase::GsoSizeGoal (void) const
+{
+  return GsoSegsGoal (m_tcb, IsPacingEnabled (), 2) * m_tcb->m_segmentSize;
+}
+
 void
 TcpSocketBase::SetPacingStatus (bool pacing)
 {
@@ -28,6 +28,7 @@
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/timer.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/sequence-number.h"
 #include "ns3/data-rate.h"
 #include "ns3/node.h"
@@ -43,6 +44,9 @@ class TcpL4Protocol;
 class TcpHeader;
 class TcpCongestionOps;
 class TcpRecoveryOps;
+class TcpLossDetection;
+class TcpSlowStart;
+class TcpTxItem;
 class RttEstimator;
 class TcpRxBuffer;
 class TcpTxBuffer;
@@ -453,6 +457,22 @@ public:
    */
   void SetRecoveryAlgorithm (Ptr<TcpRecoveryOps> recovery);
 
+  /**
+   * \brief Install a loss detection algorithm on this socket
+   *
+   * \param lossDetection Algorithm to be installed
+   */
+  void SetLossDetectionAlgorithm (Ptr<TcpLossDetection> lossDetection);
+
+  /**
+   * \brief Install a slow start algorithm on this socket
+   *
+   * The algorithm is also handed to the congestion control.
+   *
+   * \param slowStart Algorithm to be installed
+   */
+  void SetSlowStartAlgorithm (Ptr<TcpSlowStart> slowStart);
+
   /**
    * \brief Mark ECT(0) codepoint
    *
@@ -603,6 +623,22 @@ public:
   typedef void (* TcpTxRxTracedCallback)(const Ptr<const Packet> packet, const TcpHeader& header,
                                          const Ptr<const TcpSocketBase> socket);
 
+  /**
+   * \brief Return the number of segments of the largest super-segment
+   *
+   * Counterpart of Linux tcp_tso_autosize (): the IPv4 total length field
+   * and the GSO limit of the socket bound the super-segment, and a paced
+   * flow keeps about 1 ms worth of data per super-segment, but no less
+   * than minSegs segments.  Congestion controls budgeting for the GSO
+   * super-segments call it too.
+   *
+   * \param tcb the socket state
+   * \param paced true if the flow is paced
+   * \param minSegs the least number of segments of a paced super-segment
+   * \return number of segments, at least 1
+   */
+  static uint32_t GsoSegsGoal (Ptr<const TcpSocketState> tcb, bool paced, uint32_t minSegs);
+
 protected:
   // Implementing ns3::TcpSocket -- Attribute get/set
   // inherited, no need to doc
@@ -853,6 +889,12 @@ protected:
    */
   void CancelAllTimers (void);
 
+  /**
+   * \brief Bind the timers to this socket, and put them in the timer
+   * wheel of m_tcp, if any
+   */
+  void InitTimers (void);
+
   /**
    * \brief Move from CLOSING or FIN_WAIT_2 to TIME_WAIT state
    */
@@ -956,6 +998,16 @@ protected:
    */
   virtual uint32_t AvailableWindow (void) const;
 
+  /**
+   * \brief Return the largest super-segment to hand down when GSO is on
+   *
+   * Like Linux tcp_tso_autosize (), a paced flow keeps about 1 ms worth of
+   * data per super-segment, so that GSO does not defeat pacing at low rates.
+   *
+   * \return size in bytes, a multiple of the segment size
+   */
+  uint32_t GsoSizeGoal (void) const;
+
   /**
    * \brief The amount of Rx window announced to the peer
    * \param scale indicate if the window should be scaled. True for
@@ -1058,11 +1110,64 @@ protected:
    */
   void EnterRecovery (uint32_t currentDelivered);
 
+  /**
+   * \brief Is the loss detection time-based on this connection?
+   *
+   * Time-based loss detection (e.g., RACK) requires SACK; without it the
+   * socket falls back to counting duplicate ACKs.
+   * \return true if segments are marked lost by the loss detection algorithm only
+   */
+  bool IsTimeBasedLossDetection (void) const;
+
+  /**
+   * \brief Inform the rate and loss detection algorithms of a (S)ACKed segment
+   *
+   * \param item the segment delivered
+   */
+  void SegmentDelivered (TcpTxItem *item);
+
+  /**
+   * \brief Run the loss detection algorithm and (re)schedule its timer
+   */
+  void DetectLoss (void);
+
+  /**
+   * \brief Enter the CA_RECOVERY if the loss detection marked segments as lost
+   *
+   * \param currentDelivered Currently (S)ACKed bytes
+   */
+  void EnterRecoveryOnLoss (uint32_t currentDelivered);
+
+  /**
+   * \brief The timer of the loss detection algorithm expired
+   */
+  void ReorderTimeout (void);
+
+  /**
+   * \brief Schedule a tail loss probe, if the loss detection algorithm wants one
+   */
+  void ScheduleLossProbe (void);
+
+  /**
+   * \brief Send a tail loss probe: a new segment, or the last one sent
+   */
+  void SendLossProbe (void);
+
   /**
    * \brief An RTO event happened
    */
   virtual void ReTxTimeout (void);
 
+  /**
+   * \brief The retransmission timer expired
+   *
+   * The timer guards either data, or a SYN or FIN sent by
+   * SendEmptyPacket (); its argument tells which.
+   *
+   * \param flags flags of the SYN or FIN to send again, or 0 for an RTO
+   */
+  void RetxTimerExpired (uint8_t flags);
+
   /**
    * \brief Action upon delay ACK timeout, i.e. send an ACK
    */
@@ -1243,12 +1348,14 @@ protected:
   SequenceNumber32 GetHighRxAck (void) const;
 
 protected:
-  // Counters and events
-  EventId           m_retxEvent     {}; //!< Retransmission event
-  EventId           m_lastAckEvent  {}; //!< Last ACK timeout event
-  EventId           m_delAckEvent   {}; //!< Delayed ACK timeout event
-  EventId           m_persistEvent  {}; //!< Persist event: Send 1 byte to probe for a non-zero Rx window
-  EventId           m_timewaitEvent {}; //!< TIME_WAIT expiration event: Move this socket to CLOSED state
+  // Counters and timers; the timers are kept in the TimerWheel of m_tcp
+  WheelTimer        m_retxEvent;        //!< Retransmission timer, see RetxTimerExpired ()
+  WheelTimer        m_lastAckEvent;     //!< Last ACK timer
+  WheelTimer        m_delAckEvent;      //!< Delayed ACK timer
+  WheelTimer        m_persistEvent;     //!< Persist timer: Send 1 byte to probe for a non-zero Rx window
+  WheelTimer        m_timewaitEvent;    //!< TIME_WAIT expiration timer: Move this socket to CLOSED state
+  WheelTimer        m_reoTimeoutEvent;  //!< Loss detection (RACK reordering) timer
+  WheelTimer        m_lossProbeEvent;   //!< Tail loss probe timer
 
   // ACK management
   uint32_t          m_dupAckCount {0};     //!< Dupack counter
@@ -1329,6 +1436,8 @@ protected:
   Ptr<TcpSocketState>    m_tcb;               //!< Congestion control information
   Ptr<TcpCongestionOps>  m_congestionControl; //!< Congestion control
   Ptr<TcpRecoveryOps>    m_recoveryOps;       //!< Recovery Algorithm
+  Ptr<TcpLossDetection>  m_lossDetection;     //!< Loss detection algorithm
+  Ptr<TcpSlowStart>      m_slowStart;         //!< Slow start algorithm
   Ptr<TcpRateOps>        m_rateOps;           //!< Rate operations
 
   // Guesses over the other connection end
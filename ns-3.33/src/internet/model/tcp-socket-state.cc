@@ -48,6 +48,22 @@ TcpSocketState::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&TcpSocketState::m_paceInitialWindow),
                    MakeBooleanChecker ())
+    .AddAttribute ("EnableEdtPacing", "Pace by stamping each segment with its "
+                   "earliest departure time, to be enforced by an EDT-aware "
+                   "queue disc, instead of scheduling a timer per segment",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketState::m_edtPacing),
+                   MakeBooleanChecker ())
+    .AddAttribute ("EdtHorizon", "With EDT pacing, the amount of time the "
+                   "departure time of the next segment may run ahead of now",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&TcpSocketState::m_edtHorizon),
+                   MakeTimeChecker ())
+    .AddAttribute ("GsoMaxSegments", "Maximum number of segments sent as one "
+                   "segmentation offload super-segment (1 disables GSO)",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TcpSocketState::m_gsoMaxSegs),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddTraceSource ("PacingRate",
                      "The current TCP pacing rate",
                      MakeTraceSourceAccessor (&TcpSocketState::m_pacingRate),
@@ -112,9 +128,14 @@ TcpSocketState::TcpSocketState (const TcpSocketState &other)
     m_pacingSsRatio (other.m_pacingSsRatio),
     m_pacingCaRatio (other.m_pacingCaRatio),
     m_paceInitialWindow (other.m_paceInitialWindow),
+    m_edtPacing (other.m_edtPacing),
+    m_edtHorizon (other.m_edtHorizon),
+    m_departureTime (other.m_departureTime),
+    m_gsoMaxSegs (other.m_gsoMaxSegs),
     m_minRtt (other.m_minRtt),
     m_bytesInFlight (other.m_bytesInFlight),
     m_lastRtt (other.m_lastRtt),
+    m_srtt (other.m_srtt),
     m_ecnMode (other.m_ecnMode),
     m_useEcn (other.m_useEcn)
 {
@@ -191,11 +191,18 @@ public:
   uint16_t               m_pacingSsRatio {0};        //!< SS pacing ratio
   uint16_t               m_pacingCaRatio {0};        //!< CA pacing ratio
   bool                   m_paceInitialWindow {false}; //!< Enable/Disable pacing for the initial window
+  bool                   m_edtPacing {false};        //!< Pace by stamping departure times instead of a timer
+  Time                   m_edtHorizon {0};           //!< How far ahead of now departure times may be stamped
+  Time                   m_departureTime {0};        //!< Earliest departure time of the next segment (EDT pacing)
+
+  // Segmentation offload
+  uint32_t               m_gsoMaxSegs {1};           //!< Max segments in a GSO super-segment, 1 disables GSO
 
   Time                   m_minRtt  {Time::Max ()};   //!< Minimum RTT observed throughout the connection
 
   TracedValue<uint32_t>  m_bytesInFlight {0};        //!< Bytes in flight
   TracedValue<Time>      m_lastRtt {Seconds (0.0)};  //!< Last RTT sample collected
+  Time                   m_srtt {Seconds (0.0)};     //!< Smoothed RTT, as estimated by the RttEstimator
 
   Ptr<TcpRxBuffer>       m_rxBuffer;                 //!< Rx buffer (reordering buffer)
 
@@ -136,6 +136,18 @@ TcpTxBuffer::SetDupAckThresh (uint32_t dupAckThresh)
   m_dupAckThresh = dupAckThresh;
 }
 
+uint32_t
+TcpTxBuffer::GetDupAckThresh (void) const
+{
+  return m_dupAckThresh;
+}
+
+void
+TcpTxBuffer::SetDupThreshLossDetection (bool enabled)
+{
+  m_dupThreshLossDetection = enabled;
+}
+
 void
 TcpTxBuffer::SetSegmentSize (uint32_t segmentSize)
 {
@@ -270,6 +282,7 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
     }
 
   outItem->m_lastSent = Simulator::Now ();
+  TsortedAppend (outItem);
   NS_ASSERT_MSG (outItem->m_startSeq >= m_firstByteSeq,
                  "Returning an item " << *outItem << " with SND.UNA as " <<
                  m_firstByteSeq);
@@ -378,7 +391,7 @@ TcpTxBuffer::FindHighestSacked () const
 
 
 void
-TcpTxBuffer::SplitItems (TcpTxItem *t1, TcpTxItem *t2, uint32_t size) const
+TcpTxBuffer::SplitItems (TcpTxItem *t1, TcpTxItem *t2, uint32_t size)
 {
   NS_ASSERT (t1 != nullptr && t2 != nullptr);
   NS_LOG_FUNCTION (this << *t2 << size);
@@ -392,6 +405,14 @@ TcpTxBuffer::SplitItems (TcpTxItem *t1, TcpTxItem *t2, uint32_t size) const
   t1->m_retrans = t2->m_retrans;
   t1->m_lost = t2->m_lost;
 
+  if (t2->m_tsorted)
+    {
+      // The first part was sent together with the second one; keep it just
+      // before in the time-ordered list
+      t1->m_tsortedIt = m_tsortedList.insert (t2->m_tsortedIt, t1);
+      t1->m_tsorted = true;
+    }
+
   t2->m_startSeq += size;
 
   NS_LOG_INFO ("Split of size " << size << " result: t1 " << *t1 << " t2 " << *t2);
@@ -400,7 +421,7 @@ TcpTxBuffer::SplitItems (TcpTxItem *t1, TcpTxItem *t2, uint32_t size) const
 TcpTxItem*
 TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listStartFrom,
                                 uint32_t numBytes, const SequenceNumber32 &seq,
-                                bool *listEdited) const
+                                bool *listEdited)
 {
   NS_LOG_FUNCTION (this << numBytes << seq);
 
@@ -588,7 +609,7 @@ static bool AreEquals (const bool &first, const bool &second)
 }
 
 void
-TcpTxBuffer::MergeItems (TcpTxItem *t1, TcpTxItem *t2) const
+TcpTxBuffer::MergeItems (TcpTxItem *t1, TcpTxItem *t2)
 {
   NS_ASSERT (t1 != nullptr && t2 != nullptr);
   NS_LOG_FUNCTION (this << *t1 << *t2);
@@ -606,19 +627,27 @@ TcpTxBuffer::MergeItems (TcpTxItem *t1, TcpTxItem *t2) const
     {
       if (t1->m_retrans)
         {
-          TcpTxBuffer *self = const_cast<TcpTxBuffer*> (this);
-          self->m_retrans -= t1->m_packet->GetSize ();
+          m_retrans -= t1->m_packet->GetSize ();
           t1->m_retrans = false;
         }
       else
         {
           NS_ASSERT (t2->m_retrans);
-          TcpTxBuffer *self = const_cast<TcpTxBuffer*> (this);
-          self->m_retrans -= t2->m_packet->GetSize ();
+          m_retrans -= t2->m_packet->GetSize ();
           t2->m_retrans = false;
         }
     }
 
+  // t2 is going to be deleted: the merged item takes the place of the most
+  // recently sent one in the time-ordered list
+  if (t2->m_tsorted && (!t1->m_tsorted || t1->m_lastSent < t2->m_lastSent))
+    {
+      TsortedRemove (t1);
+      t1->m_tsortedIt = m_tsortedList.insert (t2->m_tsortedIt, t1);
+      t1->m_tsorted = true;
+    }
+  TsortedRemove (t2);
+
   if (t1->m_lastSent < t2->m_lastSent)
     {
       t1->m_lastSent = t2->m_lastSent;
@@ -712,6 +741,7 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
           m_firstByteSeq += pktSize;
 
           RemoveFromCounts (item, pktSize);
+          TsortedRemove (item);
 
           i = m_sentList.erase (i);
           NS_LOG_INFO ("Removed " << *item << " lost: " << m_lostOut <<
@@ -834,6 +864,7 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list,
 
                   (*item_it)->m_sacked = true;
                   m_sackedOut += (*item_it)->m_packet->GetSize ();
+                  TsortedRemove (*item_it);
                   bytesSacked += (*item_it)->m_packet->GetSize ();
 
                   if (m_highestSack.first == m_sentList.end()
@@ -870,7 +901,10 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list,
   if (bytesSacked > 0)
     {
       NS_ASSERT_MSG (m_highestSack.first != m_sentList.end(), "Buffer status: " << *this);
-      UpdateLostCount ();
+      if (m_dupThreshLossDetection)
+        {
+          UpdateLostCount ();
+        }
     }
 
   NS_ASSERT ((*(m_sentList.begin ()))->m_sacked == false);
@@ -912,6 +946,7 @@ TcpTxBuffer::UpdateLostCount ()
             {
               item->m_lost = true;
               m_lostOut += item->m_packet->GetSize ();
+              TsortedRemove (item);
             }
         }
       beginOfCurrentPacket -= item->m_packet->GetSize ();
@@ -924,6 +959,7 @@ TcpTxBuffer::UpdateLostCount ()
         {
           item->m_lost = true;
           m_lostOut += item->m_packet->GetSize ();
+          TsortedRemove (item);
         }
     }
   NS_LOG_INFO ("Status after the update: " << *this);
@@ -1250,6 +1286,7 @@ TcpTxBuffer::ResetSentList ()
     {
       item = m_sentList.back ();
       item->m_retrans = item->m_sacked = item->m_lost = false;
+      TsortedRemove (item);
       m_appList.push_front (item);
       m_sentList.pop_back ();
     }
@@ -1275,6 +1312,7 @@ TcpTxBuffer::ResetLastSegmentSent ()
         {
           m_retrans -= item->m_packet->GetSize ();
         }
+      TsortedRemove (item);
       m_appList.insert (m_appList.begin (), item);
     }
   ConsistencyCheck ();
@@ -1320,7 +1358,10 @@ TcpTxBuffer::SetSentListLost (bool resetSack)
         }
 
       (*it)->m_retrans = false;
+      (*it)->m_tsorted = false;
     }
+  // Every segment is now either lost or sacked
+  m_tsortedList.clear ();
 
   NS_LOG_INFO ("Set sent list lost, status: " << *this);
   NS_ASSERT_MSG (m_sentSize >= m_sackedOut + m_lostOut, *this);
@@ -1383,10 +1424,55 @@ TcpTxBuffer::MarkHeadAsLost ()
           m_sentList.front()->m_lost = true;
           m_lostOut += m_sentList.front ()->m_packet->GetSize ();
         }
+      TsortedRemove (m_sentList.front ());
+    }
+  ConsistencyCheck ();
+}
+
+const std::list<TcpTxItem *> &
+TcpTxBuffer::GetTimeOrderedSentList (void) const
+{
+  return m_tsortedList;
+}
+
+void
+TcpTxBuffer::MarkAsLost (TcpTxItem *item)
+{
+  NS_LOG_FUNCTION (this << *item);
+  NS_ASSERT (!item->m_sacked);
+
+  if (item->m_retrans)
+    {
+      item->m_retrans = false;
+      m_retrans -= item->m_packet->GetSize ();
+    }
+  if (!item->m_lost)
+    {
+      item->m_lost = true;
+      m_lostOut += item->m_packet->GetSize ();
     }
+  TsortedRemove (item);
   ConsistencyCheck ();
 }
 
+void
+TcpTxBuffer::TsortedAppend (TcpTxItem *item)
+{
+  TsortedRemove (item);
+  item->m_tsortedIt = m_tsortedList.insert (m_tsortedList.end (), item);
+  item->m_tsorted = true;
+}
+
+void
+TcpTxBuffer::TsortedRemove (TcpTxItem *item)
+{
+  if (item->m_tsorted)
+    {
+      m_tsortedList.erase (item->m_tsortedIt);
+      item->m_tsorted = false;
+    }
+}
+
 void
 TcpTxBuffer::AddRenoSack (void)
 {
@@ -1417,6 +1503,7 @@ TcpTxBuffer::AddRenoSack (void)
     {
       (*it)->m_sacked = true;
       m_sackedOut += (*it)->m_packet->GetSize ();
+      TsortedRemove (*it);
       m_highestSack = std::make_pair (it, (*it)->m_startSeq);
       NS_LOG_INFO ("Added a Reno SACK, status: " << *this);
     }
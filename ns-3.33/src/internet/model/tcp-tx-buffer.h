@@ -114,6 +114,19 @@ class Packet;
  * connection, the TcpSocketImplementation should provide hints through
  * the MarkHeadAsLost and AddRenoSack methods.
  *
+ * Time-ordered sent list
+ * ----------------------
+ *
+ * Besides the sent list, ordered by sequence number, the class keeps the
+ * segments in flight (neither sacked nor lost, or lost and retransmitted)
+ * ordered by their last transmission time, as the tsorted_sent_queue of Linux.
+ * A segment is moved to the tail of this list each time it is (re)transmitted,
+ * and removed when it is sacked, acked or marked as lost. Time-based loss
+ * detection (e.g., RACK) walks this list from the head and stops at the first
+ * segment sent too recently to be lost, instead of scanning the sent list.
+ * When such a detection is in use, the RFC 6675 marking can be disabled
+ * through SetDupThreshLossDetection.
+ *
  * \see BytesInFlight
  * \see Size
  * \see SizeFromSequence
@@ -190,6 +203,21 @@ public:
    */
   void SetDupAckThresh (uint32_t dupAckThresh);
 
+  /**
+   * \brief Get the DupAckThresh
+   * \return the threshold
+   */
+  uint32_t GetDupAckThresh (void) const;
+
+  /**
+   * \brief Enable or disable the RFC 6675 marking of lost segments
+   *
+   * When enabled (the default), a segment is marked as lost as soon as
+   * DupAckThresh segments above it are sacked (see UpdateLostCount).
+   * \param enabled whether the marking is enabled
+   */
+  void SetDupThreshLossDetection (bool enabled);
+
   /**
    * \brief Set the segment size
    * \param segmentSize the segment size
@@ -380,6 +408,26 @@ public:
    */
   void MarkHeadAsLost ();
 
+  /**
+   * \brief Get the segments in flight, ordered by last transmission time
+   *
+   * The head of the list is the segment transmitted the longest time ago.
+   * Please do not delete the items, nor modify them other than through
+   * MarkAsLost.
+   * \return the time-ordered sent list
+   */
+  const std::list<TcpTxItem *> & GetTimeOrderedSentList (void) const;
+
+  /**
+   * \brief Mark a segment in flight as lost
+   *
+   * A retransmitted segment loses its retransmitted flag, so it can be
+   * retransmitted again. The segment is removed from the time-ordered sent
+   * list.
+   * \param item the segment, taken from the time-ordered sent list
+   */
+  void MarkAsLost (TcpTxItem *item);
+
   /**
    * \brief Emulate SACKs for SACKless connection: account for a new dupack.
    *
@@ -434,6 +482,20 @@ private:
    */
   void UpdateLostCount ();
 
+  /**
+   * \brief Append an item to the tail of the time-ordered sent list
+   *
+   * If the item is already in the list, it is moved to the tail.
+   * \param item the item just (re)transmitted
+   */
+  void TsortedAppend (TcpTxItem *item);
+
+  /**
+   * \brief Remove an item from the time-ordered sent list, if present
+   * \param item the item
+   */
+  void TsortedRemove (TcpTxItem *item);
+
   /**
    * \brief Remove the size specified from the lostOut, retrans, sacked count
    *
@@ -562,7 +624,7 @@ private:
    */
   TcpTxItem* GetPacketFromList (PacketList &list, const SequenceNumber32 &startingSeq,
                                 uint32_t numBytes, const SequenceNumber32 &requestedSeq,
-                                bool *listEdited = nullptr) const;
+                                bool *listEdited = nullptr);
 
   /**
    * \brief Merge two TcpTxItem
@@ -574,7 +636,7 @@ private:
    * \param t1 first item
    * \param t2 second item
    */
-  void MergeItems (TcpTxItem *t1, TcpTxItem *t2) const;
+  void MergeItems (TcpTxItem *t1, TcpTxItem *t2);
 
   /**
    * \brief Split one TcpTxItem
@@ -586,7 +648,7 @@ private:
    * \param t2 second item
    * \param size Size to split
    */
-  void SplitItems (TcpTxItem *t1, TcpTxItem *t2, uint32_t size) const;
+  void SplitItems (TcpTxItem *t1, TcpTxItem *t2, uint32_t size);
 
   /**
    * \brief Check if the values of sacked, lost, retrans, are in sync
@@ -603,6 +665,7 @@ private:
 
   PacketList m_appList;  //!< Buffer for application data
   PacketList m_sentList; //!< Buffer for sent (but not acked) data
+  PacketList m_tsortedList; //!< Segments in flight, by last transmission time
   uint32_t m_maxBuffer;  //!< Max number of data bytes in buffer (SND.WND)
   uint32_t m_size;       //!< Size of all data in this buffer
   uint32_t m_sentSize;   //!< Size of sent (and not discarded) segments
@@ -619,6 +682,7 @@ private:
   uint32_t m_segmentSize {0}; //!< Segment size from TcpSocketBase
   bool     m_renoSack {false}; //!< Indicates if AddRenoSack was called
   bool     m_sackEnabled {true}; //!< Indicates if SACK is enabled on this connection
+  bool     m_dupThreshLossDetection {true}; //!< Indicates if UpdateLostCount marks lost segments
 
   static Callback<void, TcpTxItem *> m_nullCb; //!< Null callback for an item
 };
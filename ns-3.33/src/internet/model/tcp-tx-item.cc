@@ -76,6 +76,12 @@ TcpTxItem::IsRetrans (void) const
   return m_retrans;
 }
 
+const SequenceNumber32 &
+TcpTxItem::GetStartSeq (void) const
+{
+  return m_startSeq;
+}
+
 Ptr<Packet>
 TcpTxItem::GetPacketCopy (void) const
 {
@@ -100,5 +106,11 @@ TcpTxItem::GetRateInformation (void)
   return m_rateInfo;
 }
 
+const TcpTxItem::RateInformation &
+TcpTxItem::GetRateInformation (void) const
+{
+  return m_rateInfo;
+}
+
 
 } // namespace ns3
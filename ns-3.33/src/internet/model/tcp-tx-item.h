@@ -19,6 +19,7 @@
 #ifndef TCP_TX_ITEM_H
 #define TCP_TX_ITEM_H
 
+#include <list>
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
 #include "ns3/sequence-number.h"
@@ -60,6 +61,12 @@ public:
    */
   bool IsRetrans (void) const;
 
+  /**
+   * \brief Get the sequence number of the first byte of the item
+   * \return the start sequence number (valid only if transmitted)
+   */
+  const SequenceNumber32 & GetStartSeq (void) const;
+
   /**
    * \brief Get a copy of the Packet underlying this item
    * \return a copy of the Packet
@@ -99,6 +106,13 @@ public:
    */
   RateInformation & GetRateInformation (void);
 
+  /**
+   * \brief Get the Rate Information of this item
+   *
+   * \return A const reference to the rate information.
+   */
+  const RateInformation & GetRateInformation (void) const;
+
   bool m_retrans       {false};      //!< Indicates if the segment is retransmitted
 
 private:
@@ -113,6 +127,9 @@ private:
   bool m_sacked        {false};      //!< Indicates if the segment has been SACKed
 
   RateInformation m_rateInfo;        //!< Rate information of the item
+
+  std::list<TcpTxItem *>::iterator m_tsortedIt; //!< Position in the time-ordered sent list
+  bool m_tsorted       {false};      //!< Indicates if the item is in the time-ordered sent list
 };
 
 } //namespace ns3
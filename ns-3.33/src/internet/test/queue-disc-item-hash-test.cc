@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/hash.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/ipv6-queue-disc-item.h"
+#include "ns3/tcp-header.h"
+#include "ns3/udp-header.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief Check the 5-tuple hash of the IPv4 and IPv6 queue disc items
+ */
+class QueueDiscItemHashTestCase : public TestCase
+{
+public:
+  QueueDiscItemHashTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+QueueDiscItemHashTestCase::QueueDiscItemHashTestCase ()
+  : TestCase ("Check the 5-tuple hash of the queue disc items")
+{
+}
+
+void
+QueueDiscItemHashTestCase::DoRun ()
+{
+  Ipv4Address src ("10.1.1.1");
+  Ipv4Address dst ("10.1.2.1");
+  const uint32_t perturbation = 0x12345678;
+
+  // The reference: the 5-tuple and the perturbation, hashed by murmur3
+  uint8_t buf[17];
+  src.Serialize (buf);
+  dst.Serialize (buf + 4);
+  buf[8] = 6;
+  buf[9] = 49153 >> 8;
+  buf[10] = 49153 & 0xff;
+  buf[11] = 5000 >> 8;
+  buf[12] = 5000 & 0xff;
+  buf[13] = (perturbation >> 24) & 0xff;
+  buf[14] = (perturbation >> 16) & 0xff;
+  buf[15] = (perturbation >> 8) & 0xff;
+  buf[16] = perturbation & 0xff;
+  uint32_t expected = Hash32 ((char*) buf, 17);
+
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (src);
+  ipHeader.SetDestination (dst);
+  ipHeader.SetProtocol (6);
+  TcpHeader tcpHeader;
+  tcpHeader.SetSourcePort (49153);
+  tcpHeader.SetDestinationPort (5000);
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddHeader (tcpHeader);
+  Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem> (p, Address (), 0x0800, ipHeader);
+  NS_TEST_EXPECT_MSG_EQ (item->Hash (perturbation), expected, "Wrong hash of the TCP 5-tuple");
+  NS_TEST_EXPECT_MSG_EQ (item->Hash (perturbation), expected, "Wrong cached hash");
+  NS_TEST_EXPECT_MSG_NE (item->Hash (0), expected, "The perturbation is not taken into account");
+
+  // The ports of UDP are at the same place
+  ipHeader.SetProtocol (17);
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (49153);
+  udpHeader.SetDestinationPort (5000);
+  p = Create<Packet> (100);
+  p->AddHeader (udpHeader);
+  item = Create<Ipv4QueueDiscItem> (p, Address (), 0x0800, ipHeader);
+  buf[8] = 17;
+  NS_TEST_EXPECT_MSG_EQ (item->Hash (perturbation), Hash32 ((char*) buf, 17), "Wrong hash of the UDP 5-tuple");
+
+  // The items of both families come from the same pool
+  Ipv4QueueDiscItem *released = PeekPointer (item);
+  item = 0;
+  Ipv6Header ipv6Header;
+  ipv6Header.SetSourceAddress (Ipv6Address ("2001:1::1"));
+  ipv6Header.SetDestinationAddress (Ipv6Address ("2001:2::1"));
+  ipv6Header.SetNextHeader (6);
+  p = Create<Packet> (100);
+  p->AddHeader (tcpHeader);
+  Ptr<Ipv6QueueDiscItem> item6 = Create<Ipv6QueueDiscItem> (p, Address (), 0x86DD, ipv6Header);
+  NS_TEST_EXPECT_MSG_EQ ((void *) PeekPointer (item6), (void *) released, "Released item not reused");
+  NS_TEST_EXPECT_MSG_EQ (item6->Hash (perturbation), item6->Hash (perturbation), "Unstable hash");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief the TestSuite for the queue disc item hash test case
+ */
+class QueueDiscItemHashTestSuite : public TestSuite
+{
+public:
+  QueueDiscItemHashTestSuite ()
+    : TestSuite ("queue-disc-item-hash", UNIT)
+  {
+    AddTestCase (new QueueDiscItemHashTestCase, TestCase::QUICK);
+  }
+};
+static QueueDiscItemHashTestSuite g_queueDiscItemHashTestSuite;
@@ -0,0 +1,261 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/replication-runner.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/error-model.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-bbr.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace ns3;
+
+namespace {
+
+/** Bytes the sender has to send. */
+const uint32_t TOTAL_BYTES = 1000000;
+
+/** State of one BBR transfer. */
+struct BbrTransfer : public SimpleRefCount<BbrTransfer>
+{
+  BbrTransfer () : sent (0), received (0) {}
+  uint32_t sent;       //!< Bytes given to the sender socket
+  uint32_t received;   //!< Bytes read by the receiver
+  Time done;           //!< Time of the last byte received
+};
+
+/**
+ * Fill the send buffer of the sender.
+ * \param transfer The transfer.
+ * \param socket The sender socket.
+ * \param available The free space of the send buffer.
+ */
+void
+Fill (Ptr<BbrTransfer> transfer, Ptr<Socket> socket, uint32_t available)
+{
+  while (transfer->sent < TOTAL_BYTES && socket->GetTxAvailable () > 0)
+    {
+      uint32_t size = std::min (socket->GetTxAvailable (), TOTAL_BYTES - transfer->sent);
+      int sent = socket->Send (Create<Packet> (size));
+      if (sent <= 0)
+        {
+          break;
+        }
+      transfer->sent += sent;
+    }
+}
+
+/**
+ * Start sending once connected.
+ * \param transfer The transfer.
+ * \param socket The sender socket.
+ */
+void
+Connected (Ptr<BbrTransfer> transfer, Ptr<Socket> socket)
+{
+  Fill (transfer, socket, socket->GetTxAvailable ());
+}
+
+/**
+ * Read the bytes received.
+ * \param transfer The transfer.
+ * \param socket The receiver socket.
+ */
+void
+Receive (Ptr<BbrTransfer> transfer, Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      transfer->received += packet->GetSize ();
+    }
+  transfer->done = Simulator::Now ();
+}
+
+/**
+ * Accept a connection.
+ * \param transfer The transfer.
+ * \param socket The new socket.
+ * \param from The address of the sender.
+ */
+void
+Accept (Ptr<BbrTransfer> transfer, Ptr<Socket> socket, const Address &from)
+{
+  socket->SetRecvCallback (MakeBoundCallback (&Receive, transfer));
+}
+
+/**
+ * Record the results of a transfer.
+ * \param transfer The transfer.
+ * \param result The result row.
+ */
+void
+Collect (Ptr<BbrTransfer> transfer, ReplicationResult &result)
+{
+  // Exact values: a double would be rounded to six digits
+  result.Set ("received", std::to_string (transfer->received));
+  result.Set ("done", std::to_string (transfer->done.GetNanoSeconds ()));
+}
+
+/**
+ * Build a BBR transfer over a lossy link.
+ *
+ * The transfer ends well before the simulation: the completion time
+ * depends on every loss and on every random draw of TcpBbr.
+ *
+ * The automatic stream numbering of a replication starts at 0, while
+ * the one of the main thread starts from where the process is: every
+ * random variable gets an explicit stream.
+ * \param i The replication index.
+ * \returns The collector of the transfer.
+ */
+ReplicationRunner::CollectCallback
+Setup (uint32_t i)
+{
+  Ptr<BbrTransfer> transfer = Create<BbrTransfer> ();
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  internet.AssignStreams (nodes, 0);
+
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (10)));
+  SimpleNetDeviceHelper devices;
+  devices.SetNetDevicePointToPointMode (true);
+  devices.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  NetDeviceContainer net = devices.Install (nodes, channel);
+  Ptr<RateErrorModel> loss = CreateObject<RateErrorModel> ();
+  loss->SetAttribute ("ErrorRate", DoubleValue (0.01));
+  loss->SetAttribute ("ErrorUnit", StringValue ("ERROR_UNIT_PACKET"));
+  loss->AssignStreams (100);
+  net.Get (1)->SetAttribute ("ReceiveErrorModel", PointerValue (loss));
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (net);
+
+  Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (1), TcpSocketFactory::GetTypeId ());
+  sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), 4477));
+  sink->Listen ();
+  sink->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                           MakeBoundCallback (&Accept, transfer));
+
+  Ptr<TcpBbr> bbr = CreateObject<TcpBbr> ();
+  bbr->AssignStreams (200);
+  Ptr<TcpSocketBase> sender = DynamicCast<TcpSocketBase> (
+      Socket::CreateSocket (nodes.Get (0), TcpSocketFactory::GetTypeId ()));
+  sender->SetPacingStatus (true);
+  sender->SetCongestionControlAlgorithm (bbr);
+  sender->SetSendCallback (MakeBoundCallback (&Fill, transfer));
+  sender->SetConnectCallback (MakeBoundCallback (&Connected, transfer),
+                              MakeNullCallback<void, Ptr<Socket> > ());
+  sender->Bind ();
+  // The nodes are initialized when the simulation starts
+  Simulator::ScheduleWithContext (nodes.Get (0)->GetId (), Seconds (0.1), &Socket::Connect,
+                                  sender, InetSocketAddress (interfaces.GetAddress (1), 4477));
+
+  Simulator::Stop (Seconds (10));
+  return MakeBoundCallback (&Collect, transfer);
+}
+
+} // unnamed namespace
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that a replication of a TcpBbr transfer draws the same
+ * numbers as a standalone simulation with the same run number.
+ */
+class TcpBbrReplicationTestCase : public TestCase
+{
+public:
+  TcpBbrReplicationTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpBbrReplicationTestCase::TcpBbrReplicationTestCase ()
+  : TestCase ("Check a TcpBbr replication against a standalone run")
+{
+}
+
+void
+TcpBbrReplicationTestCase::DoRun (void)
+{
+  const uint32_t n = 2;
+  const uint64_t firstRun = 3;
+  ReplicationRunner runner;
+  runner.SetThreads (2);
+  runner.SetFirstRun (firstRun);
+  runner.Run (n, MakeCallback (&Setup));
+
+  uint64_t mainRun = RngSeedManager::GetRun ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      RngSeedManager::SetRun (firstRun + i);
+      ReplicationRunner::CollectCallback collect = Setup (i);
+      Simulator::Run ();
+      ReplicationResult standalone;
+      collect (standalone);
+      Simulator::Destroy ();
+      NS_TEST_EXPECT_MSG_EQ (standalone.Get ("received"), std::to_string (TOTAL_BYTES),
+                             "Transfer " << i << " not completed");
+      NS_TEST_EXPECT_MSG_EQ (runner.GetResult (i).Get ("received"), standalone.Get ("received"),
+                             "Replication " << i << " differs from the standalone run");
+      NS_TEST_EXPECT_MSG_EQ (runner.GetResult (i).Get ("done"), standalone.Get ("done"),
+                             "Replication " << i << " differs from the standalone run");
+    }
+  RngSeedManager::SetRun (mainRun);
+  NS_TEST_EXPECT_MSG_NE (runner.GetResult (0).Get ("done"), runner.GetResult (1).Get ("done"),
+                         "The run number does not change the transfer");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TestSuite for the replications of TcpBbr transfers
+ */
+class TcpBbrReplicationTestSuite : public TestSuite
+{
+public:
+  TcpBbrReplicationTestSuite ()
+    : TestSuite ("tcp-bbr-replication", UNIT)
+  {
+    AddTestCase (new TcpBbrReplicationTestCase, TestCase::QUICK);
+  }
+};
+
+static TcpBbrReplicationTestSuite g_tcpBbrReplicationTestSuite;
@@ -0,0 +1,248 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/log.h"
+#include "ns3/gso-tag.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/uinteger.h"
+#include "tcp-general-test.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpGsoTestSuite");
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief Check the split of a TCP super-segment into wire segments
+ */
+class TcpGsoSegmentTestCase : public TestCase
+{
+public:
+  TcpGsoSegmentTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpGsoSegmentTestCase::TcpGsoSegmentTestCase ()
+  : TestCase ("TcpL4Protocol GSO segmentation")
+{
+}
+
+void
+TcpGsoSegmentTestCase::DoRun ()
+{
+  // TcpGeneralTest enables the metadata: it must be on before any packet
+  Packet::EnablePrinting ();
+
+  // Registers the IPv4 segmentation function
+  Ptr<TcpL4Protocol> tcp = CreateObject<TcpL4Protocol> ();
+
+  const uint32_t mss = 500;
+  const uint32_t payload = 3 * mss + 100;
+  Ptr<Packet> p = Create<Packet> (payload);
+
+  TcpHeader tcpHeader;
+  tcpHeader.SetSequenceNumber (SequenceNumber32 (1000));
+  tcpHeader.SetAckNumber (SequenceNumber32 (7));
+  tcpHeader.SetFlags (TcpHeader::ACK | TcpHeader::FIN);
+  p->AddHeader (tcpHeader);
+
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("10.1.1.1"));
+  ipHeader.SetDestination (Ipv4Address ("10.1.2.1"));
+  ipHeader.SetProtocol (TcpL4Protocol::PROT_NUMBER);
+  ipHeader.SetPayloadSize (p->GetSize ());
+  p->AddHeader (ipHeader);
+  p->AddPacketTag (GsoTag (mss));
+
+  std::list<Ptr<Packet> > segments;
+  bool ok = GsoSegmentation::Segment (p, Ipv4L3Protocol::PROT_NUMBER, segments);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Super-segment not split");
+  NS_TEST_ASSERT_MSG_EQ (segments.size (), 4, "Wrong number of wire segments");
+
+  uint32_t offset = 0;
+  uint32_t index = 0;
+  for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); ++it, ++index)
+    {
+      Ptr<Packet> segment = (*it)->Copy ();
+      GsoTag tag;
+      NS_TEST_ASSERT_MSG_EQ (segment->PeekPacketTag (tag), false, "Wire segment still tagged");
+
+      Ipv4Header ip;
+      segment->RemoveHeader (ip);
+      NS_TEST_ASSERT_MSG_EQ (ip.GetPayloadSize (), segment->GetSize (), "Wrong IP payload size");
+      TcpHeader header;
+      segment->RemoveHeader (header);
+      uint32_t expected = index < 3 ? mss : 100;
+      NS_TEST_ASSERT_MSG_EQ (segment->GetSize (), expected, "Wrong segment payload");
+      NS_TEST_ASSERT_MSG_EQ (header.GetSequenceNumber (), SequenceNumber32 (1000 + offset),
+                             "Wrong sequence number");
+      NS_TEST_ASSERT_MSG_EQ (header.GetAckNumber (), SequenceNumber32 (7), "Wrong ack number");
+      bool fin = (header.GetFlags () & TcpHeader::FIN) != 0;
+      NS_TEST_ASSERT_MSG_EQ (fin, (index == 3), "FIN must be on the last segment only");
+      offset += segment->GetSize ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (offset, payload, "Payload bytes lost in segmentation");
+
+  // A packet without the tag is left alone
+  segments.clear ();
+  Ptr<Packet> plain = Create<Packet> (100);
+  ok = GsoSegmentation::Segment (plain, Ipv4L3Protocol::PROT_NUMBER, segments);
+  NS_TEST_ASSERT_MSG_EQ (ok, false, "Untagged packet segmented");
+  NS_TEST_ASSERT_MSG_EQ (segments.size (), 0, "Untagged packet segmented");
+
+  tcp->Dispose ();
+}
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief Check the wire segments of a GSO sender
+ *
+ * The SimpleNetDevice has no GSO support, so IPv4 splits the
+ * super-segments in software: every packet leaving the sender must fit
+ * the MTU, carry a full segment (but the last of a burst) and take its
+ * own IPv4 identification, numbered one after the other.
+ */
+class TcpGsoWireTestCase : public TcpGeneralTest
+{
+public:
+  TcpGsoWireTestCase ();
+
+protected:
+  virtual void ConfigureEnvironment (void);
+  virtual void ConfigureProperties (void);
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void FinalChecks (void);
+
+  /**
+   * \brief Trace of the packets sent by the sender IPv4 stack
+   * \param p the packet, with its IPv4 header
+   * \param ipv4 the IPv4 stack
+   * \param interface the output interface
+   */
+  void IpTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+
+  bool m_traced {false};      //!< IPv4 trace connected
+  uint32_t m_superSegs {0};   //!< Super-segments sent by TCP
+  uint32_t m_wireSegs {0};    //!< Data segments put on the wire
+  uint32_t m_wireBytes {0};   //!< Payload bytes put on the wire
+  uint32_t m_lastId {0};      //!< Identification of the last packet
+  bool m_first {true};        //!< No packet seen yet
+};
+
+TcpGsoWireTestCase::TcpGsoWireTestCase ()
+  : TcpGeneralTest ("TcpSocketBase GSO wire segments")
+{
+}
+
+void
+TcpGsoWireTestCase::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktSize (4000);
+  SetAppPktCount (4);
+  SetAppPktInterval (MilliSeconds (100));
+}
+
+void
+TcpGsoWireTestCase::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, 10);
+  GetTcb (SENDER)->m_gsoMaxSegs = 8;
+}
+
+void
+TcpGsoWireTestCase::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (!m_traced)
+    {
+      // The socket node is known only once the sockets exist
+      Ptr<Ipv4L3Protocol> ipv4 = GetSenderSocket ()->GetNode ()->GetObject<Ipv4L3Protocol> ();
+      ipv4->TraceConnectWithoutContext ("Tx", MakeCallback (&TcpGsoWireTestCase::IpTx, this));
+      m_traced = true;
+    }
+  if (who == SENDER && p->GetSize () > GetSegSize (SENDER))
+    {
+      ++m_superSegs;
+    }
+}
+
+void
+TcpGsoWireTestCase::IpTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (p->GetSize (), GetMtu (), "Packet larger than the MTU");
+  GsoTag tag;
+  NS_TEST_ASSERT_MSG_EQ (p->PeekPacketTag (tag), false, "GSO packet reached the wire");
+
+  Ptr<Packet> copy = p->Copy ();
+  Ipv4Header ip;
+  copy->RemoveHeader (ip);
+  if (!m_first)
+    {
+      NS_TEST_ASSERT_MSG_EQ (ip.GetIdentification (), static_cast<uint16_t> (m_lastId + 1),
+                             "IPv4 identifications not consecutive");
+    }
+  m_first = false;
+  m_lastId = ip.GetIdentification ();
+
+  TcpHeader header;
+  copy->RemoveHeader (header);
+  if (copy->GetSize () > 0)
+    {
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (copy->GetSize (), GetSegSize (SENDER), "Segment above the MSS");
+      ++m_wireSegs;
+      m_wireBytes += copy->GetSize ();
+    }
+}
+
+void
+TcpGsoWireTestCase::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_GT (m_superSegs, 0, "TCP never sent a super-segment");
+  NS_TEST_ASSERT_MSG_EQ (m_wireBytes, GetPktSize () * GetPktCount (), "Wrong bytes on the wire");
+  uint32_t minSegs = (m_wireBytes + GetSegSize (SENDER) - 1) / GetSegSize (SENDER);
+  NS_TEST_ASSERT_MSG_EQ (m_wireSegs, minSegs, "Wire segments not full-sized");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief the TestSuite for the TCP GSO test case
+ */
+class TcpGsoTestSuite : public TestSuite
+{
+public:
+  TcpGsoTestSuite ()
+    : TestSuite ("tcp-gso", UNIT)
+  {
+    AddTestCase (new TcpGsoSegmentTestCase, TestCase::QUICK);
+    AddTestCase (new TcpGsoWireTestCase, TestCase::QUICK);
+  }
+};
+static TcpGsoTestSuite g_tcpGsoTestSuite;
@@ -24,6 +24,8 @@
 #include "ns3/tcp-header.h"
 #include "ns3/buffer.h"
 #include "ns3/tcp-option-rfc793.h"
+#include "ns3/tcp-option-ts.h"
+#include "ns3/tcp-option-winscale.h"
 
 using namespace ns3;
 
@@ -420,6 +422,100 @@ TcpHeaderFlagsToString::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (str, target, "str " << str <<  " does not equal target " << target);
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP header in place serialization and option cache test.
+ */
+class TcpHeaderFastPathTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param name Test description.
+   */
+  TcpHeaderFastPathTestCase (std::string name);
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpHeaderFastPathTestCase::TcpHeaderFastPathTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+TcpHeaderFastPathTestCase::DoRun (void)
+{
+  TcpHeader header;
+  header.SetSourcePort (0x1234);
+  header.SetDestinationPort (0x5678);
+  header.SetSequenceNumber (SequenceNumber32 (0x01020304));
+  header.SetAckNumber (SequenceNumber32 (0x05060708));
+  header.SetFlags (TcpHeader::ACK | TcpHeader::PSH);
+  header.SetWindowSize (0x9abc);
+
+  Buffer buffer;
+  buffer.AddAtStart (header.GetSerializedSize ());
+  header.Serialize (buffer.Begin ());
+  const uint8_t expected[20] = { 0x12, 0x34, 0x56, 0x78, 0x01, 0x02, 0x03, 0x04,
+                                 0x05, 0x06, 0x07, 0x08, 0x50, 0x18, 0x9a, 0xbc,
+                                 0x00, 0x00, 0x00, 0x00 };
+  uint8_t bytes[20];
+  buffer.CopyData (bytes, 20);
+  for (uint32_t i = 0; i < 20; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (bytes[i]), static_cast<uint32_t> (expected[i]),
+                             "Wrong byte " << i << " of the serialized header");
+    }
+
+  // The header overlaps the virtual zero area: the per byte path is used
+  Buffer partial (6);
+  partial.AddAtStart (14);
+  partial.Begin ().Write (expected, 14);
+  TcpHeader copy;
+  NS_TEST_ASSERT_MSG_EQ (copy.Deserialize (partial.Begin ()), 20, "Wrong header size");
+  NS_TEST_ASSERT_MSG_EQ (copy.GetSequenceNumber (), header.GetSequenceNumber (), "Wrong sequence number");
+  NS_TEST_ASSERT_MSG_EQ (copy.GetAckNumber (), header.GetAckNumber (), "Wrong ack number");
+  NS_TEST_ASSERT_MSG_EQ (copy.GetWindowSize (), 0, "Window not read from the zero area");
+
+  // Headers with different options parsed in turn must not share options
+  TcpHeader withTs = header;
+  Ptr<TcpOptionTS> ts = CreateObject<TcpOptionTS> ();
+  ts->SetTimestamp (1000);
+  ts->SetEcho (500);
+  withTs.AppendOption (ts);
+  TcpHeader withWs = header;
+  Ptr<TcpOptionWinScale> ws = CreateObject<TcpOptionWinScale> ();
+  ws->SetScale (7);
+  withWs.AppendOption (ws);
+
+  Buffer tsBuffer;
+  tsBuffer.AddAtStart (withTs.GetSerializedSize ());
+  withTs.Serialize (tsBuffer.Begin ());
+  Buffer wsBuffer;
+  wsBuffer.AddAtStart (withWs.GetSerializedSize ());
+  withWs.Serialize (wsBuffer.Begin ());
+
+  for (uint32_t round = 0; round < 2; ++round)
+    {
+      copy.Deserialize (tsBuffer.Begin ());
+      NS_TEST_ASSERT_MSG_EQ (copy.HasOption (TcpOption::TS), true, "Timestamp option lost");
+      NS_TEST_ASSERT_MSG_EQ (copy.HasOption (TcpOption::WINSCALE), false, "Unexpected window scale option");
+      Ptr<const TcpOptionTS> readTs = DynamicCast<const TcpOptionTS> (copy.GetOption (TcpOption::TS));
+      NS_TEST_ASSERT_MSG_EQ (readTs->GetTimestamp (), 1000, "Wrong timestamp");
+      NS_TEST_ASSERT_MSG_EQ (readTs->GetEcho (), 500, "Wrong echo");
+      NS_TEST_ASSERT_MSG_EQ (copy.GetSerializedSize (), withTs.GetSerializedSize (), "Wrong header size");
+
+      copy.Deserialize (wsBuffer.Begin ());
+      NS_TEST_ASSERT_MSG_EQ (copy.HasOption (TcpOption::WINSCALE), true, "Window scale option lost");
+      NS_TEST_ASSERT_MSG_EQ (copy.HasOption (TcpOption::TS), false, "Unexpected timestamp option");
+      Ptr<const TcpOptionWinScale> readWs = DynamicCast<const TcpOptionWinScale> (copy.GetOption (TcpOption::WINSCALE));
+      NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (readWs->GetScale ()), 7, "Wrong scale");
+    }
+}
 
 /**
  * \ingroup internet-test
@@ -436,6 +532,7 @@ public:
     AddTestCase (new TcpHeaderGetSetTestCase ("GetSet test cases"), TestCase::QUICK);
     AddTestCase (new TcpHeaderWithRFC793OptionTestCase ("Test for options in RFC 793"), TestCase::QUICK);
     AddTestCase (new TcpHeaderFlagsToString ("Test flags to string function"), TestCase::QUICK);
+    AddTestCase (new TcpHeaderFastPathTestCase ("Test in place serialization and option cache"), TestCase::QUICK);
   }
 
 };
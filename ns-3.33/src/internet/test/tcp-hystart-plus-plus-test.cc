@@ -0,0 +1,261 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/tcp-hystart-plus-plus.h"
+#include "ns3/tcp-linux-reno.h"
+#include "ns3/tcp-socket-state.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpHyStartPlusPlusTestSuite");
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief Base class feeding HyStart++ with ACKs
+ */
+class TcpHyStartPlusPlusTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param desc test description
+   */
+  TcpHyStartPlusPlusTestCase (const std::string &desc);
+
+protected:
+  /**
+   * \brief Create the algorithm and the congestion state
+   */
+  void Setup (void);
+  /**
+   * \brief Receive an ACK for one segment
+   * \param rtt RTT sample of the ACK
+   * \param sentDelivered delivered count when the segment was sent
+   */
+  void Ack (const Time &rtt, uint64_t sentDelivered);
+  /**
+   * \brief Receive the ACKs of a round
+   * \param rtt RTT sample of the ACKs
+   * \param count number of ACKs
+   */
+  void Round (const Time &rtt, uint32_t count);
+
+  Ptr<TcpSocketState> m_tcb;            //!< Congestion state
+  Ptr<TcpHyStartPlusPlus> m_hystart;    //!< Algorithm under test
+  TcpRateOps::TcpRateConnection m_rc;   //!< Connection rate counters
+};
+
+TcpHyStartPlusPlusTestCase::TcpHyStartPlusPlusTestCase (const std::string &desc)
+  : TestCase (desc)
+{
+}
+
+void
+TcpHyStartPlusPlusTestCase::Setup (void)
+{
+  m_tcb = CreateObject<TcpSocketState> ();
+  m_tcb->m_segmentSize = 1000;
+  m_tcb->m_cWnd = 10000;
+  m_tcb->m_ssThresh = UINT32_MAX;
+  m_hystart = CreateObject<TcpHyStartPlusPlus> ();
+}
+
+void
+TcpHyStartPlusPlusTestCase::Ack (const Time &rtt, uint64_t sentDelivered)
+{
+  m_rc.m_delivered += m_tcb->m_segmentSize;
+  m_rc.m_txItemDelivered = sentDelivered;
+  m_hystart->PktsAcked (m_tcb, 1, rtt, m_rc);
+}
+
+void
+TcpHyStartPlusPlusTestCase::Round (const Time &rtt, uint32_t count)
+{
+  // Every segment acked in the round was sent after the previous round ended
+  uint64_t sentDelivered = m_rc.m_delivered;
+  for (uint32_t i = 0; i < count; ++i)
+    {
+      Ack (rtt, sentDelivered);
+    }
+}
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief HyStart++ enters CSS on an RTT increase, then leaves slow start
+ */
+class TcpHyStartPlusPlusExitTest : public TcpHyStartPlusPlusTestCase
+{
+public:
+  TcpHyStartPlusPlusExitTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpHyStartPlusPlusExitTest::TcpHyStartPlusPlusExitTest ()
+  : TcpHyStartPlusPlusTestCase ("HyStart++ CSS and slow start exit")
+{
+}
+
+void
+TcpHyStartPlusPlusExitTest::DoRun (void)
+{
+  Setup ();
+
+  Round (MilliSeconds (100), 10);
+  // Threshold is 100/8 = 12.5 ms
+  Round (MilliSeconds (105), 10);
+  NS_TEST_ASSERT_MSG_EQ (m_hystart->InCss (), false, "RTT increase below threshold");
+
+  // Growth limited per ACK when not paced
+  NS_TEST_EXPECT_MSG_EQ (m_hystart->GetCwndIncrease (m_tcb, 20), 8000, "AckLimit not applied");
+  m_tcb->m_pacing = true;
+  NS_TEST_EXPECT_MSG_EQ (m_hystart->GetCwndIncrease (m_tcb, 20), 20000, "AckLimit applied when paced");
+  m_tcb->m_pacing = false;
+
+  // Threshold is 105/8 = 13.125 ms; the check needs NRttSample samples
+  Round (MilliSeconds (120), 7);
+  NS_TEST_ASSERT_MSG_EQ (m_hystart->InCss (), false, "CSS entered with too few samples");
+  Ack (MilliSeconds (120), m_rc.m_delivered - 7 * m_tcb->m_segmentSize);
+  NS_TEST_ASSERT_MSG_EQ (m_hystart->InCss (), true, "CSS not entered");
+
+  // In CSS, the window grows a quarter as fast
+  NS_TEST_EXPECT_MSG_EQ (m_hystart->GetCwndIncrease (m_tcb, 4), 1000, "Wrong CSS growth");
+  NS_TEST_EXPECT_MSG_EQ (m_hystart->GetCwndIncrease (m_tcb, 1), 250, "Wrong CSS growth");
+  Ptr<TcpLinuxReno> reno = CreateObject<TcpLinuxReno> ();
+  reno->SetSlowStart (m_hystart);
+  reno->IncreaseWindow (m_tcb, 8);
+  NS_TEST_EXPECT_MSG_EQ (m_tcb->m_cWnd.Get (), 12000, "TcpLinuxReno does not delegate to HyStart++");
+
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      Round (MilliSeconds (120), 10);
+      NS_TEST_ASSERT_MSG_EQ (m_hystart->IsDone (), false, "Slow start ended too early");
+    }
+  Round (MilliSeconds (120), 10);
+  NS_TEST_ASSERT_MSG_EQ (m_hystart->IsDone (), true, "Slow start not ended after CssRounds");
+  NS_TEST_EXPECT_MSG_EQ (m_tcb->m_ssThresh.Get (), m_tcb->m_cWnd.Get (), "ssThresh not set to cWnd");
+  NS_TEST_EXPECT_MSG_EQ (m_hystart->GetCwndIncrease (m_tcb, 20), 20000, "Classic growth once done");
+}
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief A spurious CSS entry resumes slow start, a loss ends HyStart++
+ */
+class TcpHyStartPlusPlusSpuriousTest : public TcpHyStartPlusPlusTestCase
+{
+public:
+  TcpHyStartPlusPlusSpuriousTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpHyStartPlusPlusSpuriousTest::TcpHyStartPlusPlusSpuriousTest ()
+  : TcpHyStartPlusPlusTestCase ("HyStart++ spurious CSS and loss")
+{
+}
+
+void
+TcpHyStartPlusPlusSpuriousTest::DoRun (void)
+{
+  Setup ();
+
+  Round (MilliSeconds (20), 10);
+  // Threshold is the 4 ms lower bound
+  Round (MilliSeconds (23), 10);
+  NS_TEST_ASSERT_MSG_EQ (m_hystart->InCss (), false, "RTT increase below threshold");
+  Round (MilliSeconds (28), 10);
+  NS_TEST_ASSERT_MSG_EQ (m_hystart->InCss (), true, "CSS not entered");
+
+  Round (MilliSeconds (25), 10);
+  NS_TEST_ASSERT_MSG_EQ (m_hystart->InCss (), false, "Slow start not resumed");
+  NS_TEST_EXPECT_MSG_EQ (m_hystart->GetCwndIncrease (m_tcb, 4), 4000, "Wrong slow start growth");
+
+  m_tcb->m_ssThresh = 8000;
+  Round (MilliSeconds (25), 1);
+  NS_TEST_ASSERT_MSG_EQ (m_hystart->IsDone (), true, "HyStart++ must stop after a loss");
+  NS_TEST_EXPECT_MSG_EQ (m_tcb->m_ssThresh.Get (), 8000, "ssThresh changed after a loss");
+}
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief The initial window, with and without the RFC 6928 byte limit
+ */
+class TcpInitialWindowTest : public TestCase
+{
+public:
+  TcpInitialWindowTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpInitialWindowTest::TcpInitialWindowTest ()
+  : TestCase ("Slow start initial window")
+{
+}
+
+void
+TcpInitialWindowTest::DoRun (void)
+{
+  Ptr<TcpSocketState> tcb = CreateObject<TcpSocketState> ();
+  tcb->m_initialCWnd = 10;
+  tcb->m_segmentSize = 9000;
+  Ptr<TcpSlowStart> slowStart = CreateObject<TcpClassicSlowStart> ();
+  NS_TEST_EXPECT_MSG_EQ (slowStart->GetInitialWindow (tcb), 90000, "Wrong initial window");
+
+  slowStart->SetAttribute ("LimitInitialWindow", BooleanValue (true));
+  NS_TEST_EXPECT_MSG_EQ (slowStart->GetInitialWindow (tcb), 18000, "Two segments at least");
+  tcb->m_segmentSize = 1460;
+  NS_TEST_EXPECT_MSG_EQ (slowStart->GetInitialWindow (tcb), 14600, "Wrong IW10");
+  tcb->m_segmentSize = 1500;
+  NS_TEST_EXPECT_MSG_EQ (slowStart->GetInitialWindow (tcb), 14600, "Byte limit not applied");
+  tcb->m_initialCWnd = 20;
+  NS_TEST_EXPECT_MSG_EQ (slowStart->GetInitialWindow (tcb), 29200, "Byte limit not scaled");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief the TestSuite for the HyStart++ test cases
+ */
+class TcpHyStartPlusPlusTestSuite : public TestSuite
+{
+public:
+  TcpHyStartPlusPlusTestSuite ()
+    : TestSuite ("tcp-hystart-plus-plus", UNIT)
+  {
+    AddTestCase (new TcpHyStartPlusPlusExitTest, TestCase::QUICK);
+    AddTestCase (new TcpHyStartPlusPlusSpuriousTest, TestCase::QUICK);
+    AddTestCase (new TcpInitialWindowTest, TestCase::QUICK);
+  }
+};
+
+static TcpHyStartPlusPlusTestSuite g_tcpHyStartPlusPlusTestSuite; //!< Static variable for test initialization
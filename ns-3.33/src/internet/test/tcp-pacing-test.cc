@@ -22,6 +22,11 @@
 #include "ns3/simple-channel.h"
 #include "ns3/config.h"
 #include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/departure-time-tag.h"
 #include "tcp-general-test.h"
 
 using namespace ns3;
@@ -353,6 +358,110 @@ TcpPacingTest::NormalClose (SocketWho who)
     }
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Test that FqQueueDisc honours the departure times of TCP
+ *
+ * The sender paces by earliest departure time and its device has an
+ * FqQueueDisc: segments stamped ahead of time must be held until their
+ * departure time, and none may leave the queue disc earlier.
+ */
+class TcpEdtFqTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor.
+   * \param desc The test description.
+   */
+  TcpEdtFqTest (const std::string &desc);
+
+protected:
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+  virtual void FinalChecks ();
+
+private:
+  /**
+   * \brief Trace of the packets leaving the queue disc of the sender
+   * \param item the packet
+   */
+  void Dequeue (Ptr<const QueueDiscItem> item);
+
+  uint32_t m_stamped {0};  //!< Stamped packets dequeued
+  uint32_t m_held {0};     //!< Stamped packets held by the queue disc
+};
+
+TcpEdtFqTest::TcpEdtFqTest (const std::string &desc)
+  : TcpGeneralTest (desc)
+{
+}
+
+void
+TcpEdtFqTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktSize (1000);
+  SetAppPktCount (40);
+  SetAppPktInterval (Time (0));
+  SetPropagationDelay (MilliSeconds (1));
+  SetTransmitStart (Seconds (1));
+  SetMTU (1500);
+}
+
+void
+TcpEdtFqTest::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetSegmentSize (SENDER, 1000);
+  SetSegmentSize (RECEIVER, 1000);
+  SetInitialCwnd (SENDER, 10);
+  SetPacingStatus (SENDER, true);
+  SetPaceInitialWindow (SENDER, true);
+  GetTcb (SENDER)->m_edtPacing = true;
+
+  Ptr<Node> node = GetSenderSocket ()->GetNode ();
+  Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer> ();
+  for (uint32_t i = 0; i < node->GetNDevices (); i++)
+    {
+      Ptr<SimpleNetDevice> dev = DynamicCast<SimpleNetDevice> (node->GetDevice (i));
+      if (dev == 0)
+        {
+          continue;
+        }
+      tc->DeleteRootQueueDiscOnDevice (dev);
+      TrafficControlHelper tch;
+      tch.SetRootQueueDisc ("ns3::FqQueueDisc");
+      QueueDiscContainer qdiscs = tch.Install (dev);
+      qdiscs.Get (0)->TraceConnectWithoutContext ("Dequeue", MakeCallback (&TcpEdtFqTest::Dequeue, this));
+    }
+}
+
+void
+TcpEdtFqTest::Dequeue (Ptr<const QueueDiscItem> item)
+{
+  DepartureTimeTag tag;
+  if (!item->GetPacket ()->PeekPacketTag (tag))
+    {
+      return;
+    }
+  m_stamped++;
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (tag.GetDepartureTime (), Simulator::Now (),
+                               "Packet left before its departure time");
+  if (tag.GetDepartureTime () > item->GetTimeStamp ())
+    {
+      m_held++;
+    }
+}
+
+void
+TcpEdtFqTest::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_EQ (m_stamped, GetPktCount (), "Every data segment should be stamped");
+  NS_TEST_ASSERT_MSG_GT (m_held, 0, "No segment was stamped ahead of time");
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -407,6 +516,8 @@ public:
     ssThresh = 40;
     numPackets = 60;
     AddTestCase (new TcpPacingTest (segmentSize, packetSize, numPackets, pacingSsRatio, pacingCaRatio, ssThresh, paceInitialWindow, delAckMaxCount, tid, description), TestCase::QUICK);
+
+    AddTestCase (new TcpEdtFqTest ("Pacing case 7: earliest departure time, honoured by FqQueueDisc"), TestCase::QUICK);
   }
 };
 
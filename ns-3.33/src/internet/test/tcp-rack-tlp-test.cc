@@ -0,0 +1,494 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-rack-tlp.h"
+#include "ns3/tcp-rate-ops.h"
+#include "ns3/tcp-socket-state.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "tcp-general-test.h"
+#include "tcp-error-model.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpRackTlpTestSuite");
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief Check the RACK loss marking and its reordering timer
+ *
+ * Five segments are sent 1 ms apart, with a minimum and smoothed RTT of
+ * 10 ms. When the fourth one is sacked, the first one is lost; the second
+ * and third ones are lost only after the reordering timer expires.
+ */
+class TcpRackLossTestCase : public TestCase
+{
+public:
+  TcpRackLossTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Send the next new segment
+   */
+  void SendSegment (void);
+  /**
+   * \brief SACK the fourth segment and check the losses
+   */
+  void SackFourth (void);
+  /**
+   * \brief Check the losses after the reordering timer
+   */
+  void ReorderTimeout (void);
+  /**
+   * \brief Segment (s)acked callback
+   * \param item the segment
+   */
+  void Delivered (TcpTxItem *item);
+  /**
+   * \brief Receiver window callback
+   * \return the receiver window
+   */
+  uint32_t GetRWnd (void) const;
+
+  Ptr<TcpTxBuffer> m_txBuffer;  //!< Transmission buffer
+  Ptr<TcpSocketState> m_tcb;    //!< Congestion state
+  Ptr<TcpRateOps> m_rate;       //!< Rate estimator, marking delivered segments
+  Ptr<TcpRackTlp> m_rack;       //!< Algorithm under test
+  SequenceNumber32 m_next {1};  //!< Next sequence to send
+  Time m_timeout;               //!< Last timeout returned by DetectLoss
+};
+
+TcpRackLossTestCase::TcpRackLossTestCase ()
+  : TestCase ("RACK marks lost segments by time")
+{
+}
+
+uint32_t
+TcpRackLossTestCase::GetRWnd (void) const
+{
+  return 100000;
+}
+
+void
+TcpRackLossTestCase::Delivered (TcpTxItem *item)
+{
+  m_rack->SegmentDelivered (m_tcb, item);
+  m_rate->SkbDelivered (item);
+}
+
+void
+TcpRackLossTestCase::SendSegment (void)
+{
+  m_rate->SkbSent (m_txBuffer->CopyFromSequence (1000, m_next), false);
+  m_next += 1000;
+}
+
+void
+TcpRackLossTestCase::SackFourth (void)
+{
+  Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack> ();
+  sack->AddSackBlock (TcpOptionSack::SackBlock (SequenceNumber32 (3001), SequenceNumber32 (4001)));
+  m_txBuffer->Update (sack->GetSackList (), MakeCallback (&TcpRackLossTestCase::Delivered, this));
+  NS_TEST_EXPECT_MSG_EQ (m_txBuffer->GetTimeOrderedSentList ().size (), 4, "Sacked segment still in flight");
+
+  // The fourth segment was delivered after 11 ms; reordering window is
+  // 2.5 ms. The first one was sent 14 ms ago, so it is lost.
+  m_timeout = m_rack->DetectLoss (m_tcb, m_txBuffer);
+  NS_TEST_EXPECT_MSG_EQ (m_txBuffer->GetLost (), 1000, "First segment not lost");
+  NS_TEST_EXPECT_MSG_EQ (m_txBuffer->IsLost (SequenceNumber32 (1)), true, "First segment not lost");
+  NS_TEST_EXPECT_MSG_EQ (m_timeout, MicroSeconds (1500), "Wrong reordering timeout");
+  NS_TEST_EXPECT_MSG_EQ (m_txBuffer->GetTimeOrderedSentList ().size (), 3, "Lost segment still in flight");
+  NS_TEST_EXPECT_MSG_EQ (m_txBuffer->GetTimeOrderedSentList ().front ()->GetStartSeq (),
+                         SequenceNumber32 (1001), "Wrong head of the time-ordered list");
+  Simulator::Schedule (m_timeout, &TcpRackLossTestCase::ReorderTimeout, this);
+}
+
+void
+TcpRackLossTestCase::ReorderTimeout (void)
+{
+  m_timeout = m_rack->DetectLoss (m_tcb, m_txBuffer);
+  NS_TEST_EXPECT_MSG_EQ (m_txBuffer->GetLost (), 3000, "Second and third segments not lost");
+  NS_TEST_EXPECT_MSG_EQ (m_timeout, Time (0), "No timer needed anymore");
+  // Only the last segment, sent after the sacked one, is in flight
+  NS_TEST_EXPECT_MSG_EQ (m_txBuffer->GetTimeOrderedSentList ().size (), 1, "Wrong segments in flight");
+  NS_TEST_EXPECT_MSG_EQ (m_txBuffer->GetTimeOrderedSentList ().front ()->GetStartSeq (),
+                         SequenceNumber32 (4001), "Wrong segment in flight");
+
+  // The retransmission of the first segment goes at the tail of the list
+  m_txBuffer->CopyFromSequence (1000, SequenceNumber32 (1));
+  NS_TEST_EXPECT_MSG_EQ (m_txBuffer->GetTimeOrderedSentList ().back ()->GetStartSeq (),
+                         SequenceNumber32 (1), "Retransmission not at the tail");
+  NS_TEST_EXPECT_MSG_EQ (m_txBuffer->BytesInFlight (), 2000, "Wrong bytes in flight");
+}
+
+void
+TcpRackLossTestCase::DoRun ()
+{
+  m_txBuffer = CreateObject<TcpTxBuffer> ();
+  m_txBuffer->SetRWndCallback (MakeCallback (&TcpRackLossTestCase::GetRWnd, this));
+  m_txBuffer->SetHeadSequence (SequenceNumber32 (1));
+  m_txBuffer->SetSegmentSize (1000);
+  m_txBuffer->SetDupAckThresh (3);
+  m_txBuffer->SetDupThreshLossDetection (false);
+  m_txBuffer->Add (Create<Packet> (10000));
+
+  m_tcb = CreateObject<TcpSocketState> ();
+  m_tcb->m_segmentSize = 1000;
+  m_tcb->m_minRtt = MilliSeconds (10);
+  m_tcb->m_srtt = MilliSeconds (10);
+  m_rate = CreateObject<TcpRateLinux> ();
+  m_rack = CreateObject<TcpRackTlp> ();
+
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      Simulator::Schedule (MilliSeconds (i), &TcpRackLossTestCase::SendSegment, this);
+    }
+  Simulator::Schedule (MilliSeconds (14), &TcpRackLossTestCase::SackFourth, this);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief Check the RACK reordering window
+ *
+ * The window is zero once DupAckThresh segments are sacked, until a
+ * segment is delivered below the highest delivered one. A sacked segment
+ * acked again cumulatively is not taken for a reordered one.
+ */
+class TcpRackReorderingTestCase : public TestCase
+{
+public:
+  TcpRackReorderingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Segment (s)acked callback
+   * \param item the segment
+   */
+  void Delivered (TcpTxItem *item);
+
+  Ptr<TcpSocketState> m_tcb;    //!< Congestion state
+  Ptr<TcpRateOps> m_rate;       //!< Rate estimator, marking delivered segments
+  Ptr<TcpRackTlp> m_rack;       //!< Algorithm under test
+};
+
+TcpRackReorderingTestCase::TcpRackReorderingTestCase ()
+  : TestCase ("RACK reordering window")
+{
+}
+
+void
+TcpRackReorderingTestCase::Delivered (TcpTxItem *item)
+{
+  m_rack->SegmentDelivered (m_tcb, item);
+  m_rate->SkbDelivered (item);
+}
+
+void
+TcpRackReorderingTestCase::DoRun ()
+{
+  m_tcb = CreateObject<TcpSocketState> ();
+  m_tcb->m_segmentSize = 1000;
+  m_tcb->m_minRtt = MilliSeconds (10);
+  m_tcb->m_srtt = MilliSeconds (20);
+  m_rate = CreateObject<TcpRateLinux> ();
+  m_rack = CreateObject<TcpRackTlp> ();
+
+  Ptr<TcpTxBuffer> txBuffer = CreateObject<TcpTxBuffer> ();
+  txBuffer->SetHeadSequence (SequenceNumber32 (1));
+  txBuffer->SetSegmentSize (1000);
+  txBuffer->SetDupAckThresh (3);
+  txBuffer->SetDupThreshLossDetection (false);
+  txBuffer->Add (Create<Packet> (5000));
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      m_rate->SkbSent (txBuffer->CopyFromSequence (1000, SequenceNumber32 (1 + i * 1000)), false);
+    }
+
+  NS_TEST_EXPECT_MSG_EQ (m_rack->GetReorderingWindow (m_tcb, txBuffer), MicroSeconds (2500),
+                         "Wrong initial reordering window");
+
+  Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack> ();
+  sack->AddSackBlock (TcpOptionSack::SackBlock (SequenceNumber32 (2001), SequenceNumber32 (5001)));
+  txBuffer->Update (sack->GetSackList (), MakeCallback (&TcpRackReorderingTestCase::Delivered, this));
+  m_rack->DetectLoss (m_tcb, txBuffer);
+  NS_TEST_EXPECT_MSG_EQ (m_rack->GetReorderingWindow (m_tcb, txBuffer), Time (0),
+                         "DupAckThresh segments sacked, window must be zero");
+
+  m_tcb->m_congState = TcpSocketState::CA_RECOVERY;
+  NS_TEST_EXPECT_MSG_EQ (m_rack->GetReorderingWindow (m_tcb, txBuffer), Time (0),
+                         "In recovery, window must be zero");
+
+  // The first segment was not lost but reordered
+  txBuffer->DiscardUpTo (SequenceNumber32 (1001), MakeCallback (&TcpRackReorderingTestCase::Delivered, this));
+  NS_TEST_EXPECT_MSG_EQ (m_rack->GetReorderingWindow (m_tcb, txBuffer), MicroSeconds (2500),
+                         "Reordering seen, window must be a quarter of the min RTT");
+
+  m_tcb->m_minRtt = MilliSeconds (100);
+  NS_TEST_EXPECT_MSG_EQ (m_rack->GetReorderingWindow (m_tcb, txBuffer), MilliSeconds (20),
+                         "Window must be capped by the smoothed RTT");
+
+  // The first segment is lost and retransmitted, the second and third
+  // ones are sacked: the ACK of the retransmission covers the sacked
+  // segments again, which were not reordered
+  m_tcb->m_minRtt = MilliSeconds (10);
+  m_rack = CreateObject<TcpRackTlp> ();
+  txBuffer = CreateObject<TcpTxBuffer> ();
+  txBuffer->SetHeadSequence (SequenceNumber32 (1));
+  txBuffer->SetSegmentSize (1000);
+  txBuffer->SetDupAckThresh (3);
+  txBuffer->SetDupThreshLossDetection (false);
+  txBuffer->Add (Create<Packet> (3000));
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      m_rate->SkbSent (txBuffer->CopyFromSequence (1000, SequenceNumber32 (1 + i * 1000)), false);
+    }
+  sack = CreateObject<TcpOptionSack> ();
+  sack->AddSackBlock (TcpOptionSack::SackBlock (SequenceNumber32 (1001), SequenceNumber32 (3001)));
+  txBuffer->Update (sack->GetSackList (), MakeCallback (&TcpRackReorderingTestCase::Delivered, this));
+  m_rack->DetectLoss (m_tcb, txBuffer);
+  NS_TEST_EXPECT_MSG_EQ (txBuffer->IsLost (SequenceNumber32 (1)), true, "First segment not lost");
+  m_rate->SkbSent (txBuffer->CopyFromSequence (1000, SequenceNumber32 (1)), false);
+  txBuffer->DiscardUpTo (SequenceNumber32 (3001), MakeCallback (&TcpRackReorderingTestCase::Delivered, this));
+  NS_TEST_EXPECT_MSG_EQ (m_rack->GetReorderingWindow (m_tcb, txBuffer), Time (0),
+                         "Sacked segments acked again must not count as reordered");
+}
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief Check the tail loss probe timeout and the probe ACK processing
+ */
+class TcpTlpTestCase : public TestCase
+{
+public:
+  TcpTlpTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpTlpTestCase::TcpTlpTestCase ()
+  : TestCase ("TLP timeout and probe ACK")
+{
+}
+
+void
+TcpTlpTestCase::DoRun ()
+{
+  Ptr<TcpSocketState> tcb = CreateObject<TcpSocketState> ();
+  tcb->m_segmentSize = 1000;
+  Ptr<TcpRackTlp> rack = CreateObject<TcpRackTlp> ();
+
+  NS_TEST_EXPECT_MSG_EQ (rack->GetProbeTimeout (tcb, 3000), Seconds (1), "No RTT sample, PTO must be 1 s");
+  tcb->m_srtt = MilliSeconds (10);
+  NS_TEST_EXPECT_MSG_EQ (rack->GetProbeTimeout (tcb, 3000), MilliSeconds (20), "PTO must be two SRTT");
+  NS_TEST_EXPECT_MSG_EQ (rack->GetProbeTimeout (tcb, 1000), MilliSeconds (220),
+                         "With one segment in flight, PTO must include the delayed ACK");
+
+  // A new data probe does not tell anything about losses
+  rack->ProbeSent (SequenceNumber32 (5001), false);
+  NS_TEST_EXPECT_MSG_EQ (rack->GetProbeTimeout (tcb, 3000), Time::Max (), "Probe outstanding");
+  NS_TEST_EXPECT_MSG_EQ (rack->ProcessProbeAck (SequenceNumber32 (4001), false), false, "Probe not acked");
+  NS_TEST_EXPECT_MSG_EQ (rack->GetProbeTimeout (tcb, 3000), Time::Max (), "Probe outstanding");
+  NS_TEST_EXPECT_MSG_EQ (rack->ProcessProbeAck (SequenceNumber32 (6001), false), false, "New data probe");
+  NS_TEST_EXPECT_MSG_EQ (rack->GetProbeTimeout (tcb, 3000), MilliSeconds (20), "Probe acked");
+
+  // A retransmission probe, duplicated at the receiver
+  rack->ProbeSent (SequenceNumber32 (6001), true);
+  NS_TEST_EXPECT_MSG_EQ (rack->ProcessProbeAck (SequenceNumber32 (6001), true), false, "Duplicated probe");
+  NS_TEST_EXPECT_MSG_EQ (rack->GetProbeTimeout (tcb, 3000), MilliSeconds (20), "Probe acked");
+
+  // A retransmission probe which repaired a loss
+  rack->ProbeSent (SequenceNumber32 (6001), true);
+  NS_TEST_EXPECT_MSG_EQ (rack->ProcessProbeAck (SequenceNumber32 (7001), false), true, "Loss repaired");
+
+  rack->SetAttribute ("EnableTlp", BooleanValue (false));
+  NS_TEST_EXPECT_MSG_EQ (rack->GetProbeTimeout (tcb, 3000), Time::Max (), "TLP disabled");
+}
+
+/**
+ * \ingroup internet-tests
+ * \ingroup tests
+ *
+ * \brief Check RACK on a connection losing one segment
+ *
+ * The receiver drops the third segment of a flight of ten. Without the
+ * duplicate ACK threshold, only RACK can mark it lost: the sender must
+ * retransmit it once, in fast recovery rather than after an RTO, and must
+ * not take the sacked segments acked again by the cumulative ACK of the
+ * retransmission for reordered ones.
+ */
+class TcpRackLossEndToEndTest : public TcpGeneralTest
+{
+public:
+  TcpRackLossEndToEndTest ();
+
+protected:
+  virtual void ConfigureEnvironment (void);
+  virtual void ConfigureProperties (void);
+  virtual Ptr<ErrorModel> CreateReceiverErrorModel (void);
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void CongStateTrace (const TcpSocketState::TcpCongState_t oldValue,
+                               const TcpSocketState::TcpCongState_t newValue);
+  virtual void AfterRTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who);
+  virtual void FinalChecks (void);
+
+private:
+  /**
+   * \brief Drop callback of the error model
+   * \param ipH the IPv4 header
+   * \param tcpH the TCP header
+   * \param p the packet
+   */
+  void PktDropped (const Ipv4Header &ipH, const TcpHeader& tcpH, Ptr<const Packet> p);
+
+  SequenceNumber32 m_seqToKill {1001}; //!< Sequence of the dropped segment
+  Ptr<TcpRackTlp> m_rack;              //!< Loss detection of the sender
+  uint32_t m_dropped {0};              //!< Segments dropped
+  uint32_t m_sent {0};                 //!< Transmissions of the dropped segment
+  bool m_recovery {false};             //!< Fast recovery entered
+  bool m_rto {false};                  //!< RTO expired
+};
+
+TcpRackLossEndToEndTest::TcpRackLossEndToEndTest ()
+  : TcpGeneralTest ("RACK marks a lost segment end to end")
+{
+}
+
+void
+TcpRackLossEndToEndTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (20);
+  SetAppPktInterval (Time (0));
+  SetPropagationDelay (MilliSeconds (50));
+}
+
+void
+TcpRackLossEndToEndTest::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, 10);
+}
+
+Ptr<ErrorModel>
+TcpRackLossEndToEndTest::CreateReceiverErrorModel ()
+{
+  Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel> ();
+  errorModel->AddSeqToKill (m_seqToKill);
+  errorModel->SetDropCallback (MakeCallback (&TcpRackLossEndToEndTest::PktDropped, this));
+  return errorModel;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpRackLossEndToEndTest::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  m_rack = CreateObject<TcpRackTlp> ();
+  m_rack->SetAttribute ("EnableTlp", BooleanValue (false));
+  socket->SetLossDetectionAlgorithm (m_rack);
+  socket->SetAttribute ("MinRto", TimeValue (Seconds (10)));
+  return socket;
+}
+
+void
+TcpRackLossEndToEndTest::PktDropped (const Ipv4Header &ipH, const TcpHeader& tcpH, Ptr<const Packet> p)
+{
+  m_dropped++;
+}
+
+void
+TcpRackLossEndToEndTest::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == SENDER && p->GetSize () > 0 && h.GetSequenceNumber () == m_seqToKill)
+    {
+      m_sent++;
+    }
+}
+
+void
+TcpRackLossEndToEndTest::CongStateTrace (const TcpSocketState::TcpCongState_t oldValue,
+                                         const TcpSocketState::TcpCongState_t newValue)
+{
+  if (newValue == TcpSocketState::CA_RECOVERY)
+    {
+      m_recovery = true;
+    }
+}
+
+void
+TcpRackLossEndToEndTest::AfterRTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+  if (who == SENDER)
+    {
+      m_rto = true;
+    }
+}
+
+void
+TcpRackLossEndToEndTest::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_EQ (m_dropped, 1, "The segment was not dropped");
+  NS_TEST_ASSERT_MSG_EQ (m_sent, 2, "The lost segment must be retransmitted once");
+  NS_TEST_ASSERT_MSG_EQ (m_recovery, true, "RACK did not start fast recovery");
+  NS_TEST_ASSERT_MSG_EQ (m_rto, false, "The loss was repaired by an RTO");
+
+  // In recovery, the reordering window is zero unless reordering was seen
+  Ptr<TcpSocketState> tcb = CopyObject<TcpSocketState> (GetTcb (SENDER));
+  tcb->m_congState = TcpSocketState::CA_RECOVERY;
+  NS_TEST_ASSERT_MSG_EQ (m_rack->GetReorderingWindow (tcb, GetTxBuffer (SENDER)), Time (0),
+                         "Sacked segments acked again were taken for reordered ones");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief the TestSuite for the RACK-TLP test cases
+ */
+class TcpRackTlpTestSuite : public TestSuite
+{
+public:
+  TcpRackTlpTestSuite ()
+    : TestSuite ("tcp-rack-tlp", UNIT)
+  {
+    // TcpGeneralTest enables the packet metadata, before any packet exists
+    AddTestCase (new TcpRackLossEndToEndTest, TestCase::QUICK);
+    AddTestCase (new TcpRackLossTestCase, TestCase::QUICK);
+    AddTestCase (new TcpRackReorderingTestCase, TestCase::QUICK);
+    AddTestCase (new TcpTlpTestCase, TestCase::QUICK);
+  }
+};
+
+static TcpRackTlpTestSuite g_tcpRackTlpTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,364 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/global-value.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/object-factory.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/error-model.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-bbr.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+namespace {
+
+/** Bytes the sender has to send. */
+const uint32_t TOTAL_BYTES = 500000;
+
+/** State of one transfer. */
+struct StructuredTransfer : public SimpleRefCount<StructuredTransfer>
+{
+  StructuredTransfer () : sent (0), received (0) {}
+  uint32_t sent;                   //!< Bytes given to the sender socket
+  uint32_t received;               //!< Bytes read by the receiver
+  std::vector<std::string> trace;  //!< The packets sent by the IPv4 layers
+};
+
+/**
+ * Fill the send buffer of the sender.
+ * \param transfer The transfer.
+ * \param socket The sender socket.
+ * \param available The free space of the send buffer.
+ */
+void
+Fill (Ptr<StructuredTransfer> transfer, Ptr<Socket> socket, uint32_t available)
+{
+  while (transfer->sent < TOTAL_BYTES && socket->GetTxAvailable () > 0)
+    {
+      uint32_t size = std::min (socket->GetTxAvailable (), TOTAL_BYTES - transfer->sent);
+      int sent = socket->Send (Create<Packet> (size));
+      if (sent <= 0)
+        {
+          break;
+        }
+      transfer->sent += sent;
+    }
+}
+
+/**
+ * Start sending once connected.
+ * \param transfer The transfer.
+ * \param socket The sender socket.
+ */
+void
+Connected (Ptr<StructuredTransfer> transfer, Ptr<Socket> socket)
+{
+  Fill (transfer, socket, socket->GetTxAvailable ());
+}
+
+/**
+ * Read the bytes received.
+ * \param transfer The transfer.
+ * \param socket The receiver socket.
+ */
+void
+Receive (Ptr<StructuredTransfer> transfer, Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      transfer->received += packet->GetSize ();
+    }
+}
+
+/**
+ * Accept a connection.
+ * \param transfer The transfer.
+ * \param socket The new socket.
+ * \param from The address of the sender.
+ */
+void
+Accept (Ptr<StructuredTransfer> transfer, Ptr<Socket> socket, const Address &from)
+{
+  socket->SetRecvCallback (MakeBoundCallback (&Receive, transfer));
+}
+
+/**
+ * Record the time and the bytes of a packet sent by an IPv4 layer.
+ * \param transfer The transfer.
+ * \param p The packet, with its IPv4 header.
+ * \param ipv4 The IPv4 layer.
+ * \param interface The output interface.
+ */
+void
+IpTx (Ptr<StructuredTransfer> transfer, Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  std::vector<uint8_t> bytes (p->GetSize ());
+  p->CopyData (bytes.data (), bytes.size ());
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (std::vector<uint8_t>::const_iterator i = bytes.begin (); i != bytes.end (); ++i)
+    {
+      hash = (hash ^ *i) * 16777619u;
+    }
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetNanoSeconds () << " " << Simulator::GetContext ()
+      << " " << bytes.size () << " " << hash;
+  transfer->trace.push_back (oss.str ());
+}
+
+/**
+ * Run a transfer over a lossy link.
+ * \param congestion The TypeId name of the congestion control.
+ * \param structured Carry the TCP/IP headers as objects.
+ * \returns The transfer.
+ */
+Ptr<StructuredTransfer>
+RunTransfer (std::string congestion, bool structured)
+{
+  if (structured)
+    {
+      Packet::EnableStructuredHeaders ();
+    }
+  Ptr<StructuredTransfer> transfer = Create<StructuredTransfer> ();
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  internet.AssignStreams (nodes, 0);
+
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (10)));
+  SimpleNetDeviceHelper devices;
+  devices.SetNetDevicePointToPointMode (true);
+  devices.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  NetDeviceContainer net = devices.Install (nodes, channel);
+  Ptr<RateErrorModel> loss = CreateObject<RateErrorModel> ();
+  loss->SetAttribute ("ErrorRate", DoubleValue (0.01));
+  loss->SetAttribute ("ErrorUnit", StringValue ("ERROR_UNIT_PACKET"));
+  loss->AssignStreams (100);
+  net.Get (1)->SetAttribute ("ReceiveErrorModel", PointerValue (loss));
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (net);
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      nodes.Get (i)->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext (
+        "Tx", MakeBoundCallback (&IpTx, transfer));
+    }
+
+  Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (1), TcpSocketFactory::GetTypeId ());
+  sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), 4477));
+  sink->Listen ();
+  sink->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                           MakeBoundCallback (&Accept, transfer));
+
+  ObjectFactory factory;
+  factory.SetTypeId (congestion);
+  Ptr<TcpCongestionOps> cc = factory.Create<TcpCongestionOps> ();
+  Ptr<TcpSocketBase> sender = DynamicCast<TcpSocketBase> (
+      Socket::CreateSocket (nodes.Get (0), TcpSocketFactory::GetTypeId ()));
+  Ptr<TcpBbr> bbr = DynamicCast<TcpBbr> (cc);
+  if (bbr)
+    {
+      bbr->AssignStreams (200);
+      sender->SetPacingStatus (true);
+    }
+  sender->SetCongestionControlAlgorithm (cc);
+  sender->SetSendCallback (MakeBoundCallback (&Fill, transfer));
+  sender->SetConnectCallback (MakeBoundCallback (&Connected, transfer),
+                              MakeNullCallback<void, Ptr<Socket> > ());
+  sender->Bind ();
+  // The nodes are initialized when the simulation starts
+  Simulator::ScheduleWithContext (nodes.Get (0)->GetId (), Seconds (0.1), &Socket::Connect,
+                                  sender, InetSocketAddress (interfaces.GetAddress (1), 4477));
+
+  // The transfer ends well before: the device queues are empty
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Packet::DisableStructuredHeaders ();
+  return transfer;
+}
+
+} // unnamed namespace
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the packets on the wire are the same whether the
+ * TCP/IP headers are carried serialized or as objects.
+ */
+class TcpStructuredHeadersTraceTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param congestion The TypeId name of the congestion control.
+   * \param checksum Enable the checksums.
+   */
+  TcpStructuredHeadersTraceTestCase (std::string congestion, bool checksum);
+
+private:
+  virtual void DoRun (void);
+
+  std::string m_congestion; //!< The TypeId name of the congestion control
+  bool m_checksum;          //!< Enable the checksums
+};
+
+TcpStructuredHeadersTraceTestCase::TcpStructuredHeadersTraceTestCase (std::string congestion,
+                                                                      bool checksum)
+  : TestCase ("Structured headers trace of " + congestion
+              + (checksum ? " with checksums" : "")),
+    m_congestion (congestion),
+    m_checksum (checksum)
+{
+}
+
+void
+TcpStructuredHeadersTraceTestCase::DoRun (void)
+{
+  if (m_checksum)
+    {
+      GlobalValue::Bind ("ChecksumEnabled", BooleanValue (true));
+    }
+  Ptr<StructuredTransfer> serialized = RunTransfer (m_congestion, false);
+  Ptr<StructuredTransfer> structured = RunTransfer (m_congestion, true);
+  GlobalValue::Bind ("ChecksumEnabled", BooleanValue (false));
+
+  NS_TEST_ASSERT_MSG_EQ (serialized->received, TOTAL_BYTES, "Transfer not completed");
+  NS_TEST_ASSERT_MSG_EQ (structured->received, TOTAL_BYTES, "Transfer not completed");
+  NS_TEST_ASSERT_MSG_EQ (structured->trace.size (), serialized->trace.size (),
+                         "Not the same number of packets");
+  for (uint32_t i = 0; i < serialized->trace.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (structured->trace[i], serialized->trace[i],
+                             "Packet " << i << " differs");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that a receiver verifying the checksums reads the
+ * structured headers from the bytes.
+ */
+class TcpStructuredHeadersChecksumTestCase : public TestCase
+{
+public:
+  TcpStructuredHeadersChecksumTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpStructuredHeadersChecksumTestCase::TcpStructuredHeadersChecksumTestCase ()
+  : TestCase ("Structured headers checksum verification")
+{
+}
+
+void
+TcpStructuredHeadersChecksumTestCase::DoRun (void)
+{
+  Packet::EnableStructuredHeaders ();
+  Ipv4Address source ("10.1.1.1");
+  Ipv4Address destination ("10.1.1.2");
+
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      bool withChecksum = (i == 1);
+      Ptr<Packet> p = Create<Packet> (100);
+      TcpHeader tcp;
+      tcp.SetSourcePort (49153);
+      tcp.SetDestinationPort (4477);
+      Ipv4Header ip;
+      ip.SetSource (source);
+      ip.SetDestination (destination);
+      ip.SetProtocol (TcpL4Protocol::PROT_NUMBER);
+      ip.SetPayloadSize (p->GetSize () + tcp.GetSerializedSize ());
+      if (withChecksum)
+        {
+          tcp.EnableChecksums ();
+          tcp.InitializeChecksum (source, destination, TcpL4Protocol::PROT_NUMBER);
+          ip.EnableChecksum ();
+        }
+      p->AddHeader (tcp);
+      p->AddHeader (ip);
+
+      // Without a checksum on the sender, the bytes carry a null one
+      Ipv4Header ipRx;
+      ipRx.EnableChecksum ();
+      p->RemoveHeader (ipRx);
+      NS_TEST_EXPECT_MSG_EQ (ipRx.IsChecksumOk (), withChecksum,
+                             "IPv4 checksum not verified on the bytes");
+      TcpHeader tcpRx;
+      tcpRx.EnableChecksums ();
+      tcpRx.InitializeChecksum (source, destination, TcpL4Protocol::PROT_NUMBER);
+      p->PeekHeader (tcpRx);
+      NS_TEST_EXPECT_MSG_EQ (tcpRx.IsChecksumOk (), withChecksum,
+                             "TCP checksum not verified on the bytes");
+      NS_TEST_EXPECT_MSG_EQ (tcpRx.GetDestinationPort (), 4477, "Wrong TCP header");
+    }
+
+  Packet::DisableStructuredHeaders ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TestSuite for the TCP/IP headers carried as objects
+ */
+class TcpStructuredHeadersTestSuite : public TestSuite
+{
+public:
+  TcpStructuredHeadersTestSuite ()
+    : TestSuite ("tcp-structured-headers", UNIT)
+  {
+    AddTestCase (new TcpStructuredHeadersChecksumTestCase, TestCase::QUICK);
+    AddTestCase (new TcpStructuredHeadersTraceTestCase ("ns3::TcpCubic", false), TestCase::QUICK);
+    AddTestCase (new TcpStructuredHeadersTraceTestCase ("ns3::TcpBbr", false), TestCase::QUICK);
+    AddTestCase (new TcpStructuredHeadersTraceTestCase ("ns3::TcpBbr", true), TestCase::QUICK);
+  }
+};
+
+static TcpStructuredHeadersTestSuite g_tcpStructuredHeadersTestSuite;
@@ -0,0 +1,230 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup mpi
+ *
+ * The dumbbell of simple-distributed, but split by
+ * PointToPointGraphPartitioner on any number of ranks instead of by
+ * hand:
+ *
+ * n0 ---------|                       |---------- n6
+ *             |                       |
+ * n1 -------\ |                       | /------- n7
+ *            n4 -------- 5ms -------- n5
+ * n2 -------/ |                       | \------- n8
+ *             |                       |
+ * n3 ---------|          2ms          |---------- n9
+ *
+ * With two ranks the bottleneck link is cut, and the lookahead is 5ms;
+ * with more, leaf links are cut as well.  Each left leaf sends one
+ * packet to the right leaf facing it, e.g.
+ *
+ * \code
+ *   mpiexec -np 3 ./waf --run "simple-distributed-partitioned --leaves=8"
+ * \endcode
+ */
+
+#include "mpi-test-fixtures.h"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-graph-partitioner.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-nix-vector-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/on-off-helper.h"
+#include "ns3/packet-sink-helper.h"
+
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SimpleDistributedPartitioned");
+
+int
+main (int argc, char *argv[])
+{
+  bool nix = true;
+  bool nullmsg = false;
+  bool testing = false;
+  bool verbose = false;
+  uint32_t leaves = 4;
+
+  // Parse command line
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nix", "Enable the use of nix-vector or global routing", nix);
+  cmd.AddValue ("nullmsg", "Enable the use of null-message synchronization", nullmsg);
+  cmd.AddValue ("leaves", "Number of leaf nodes on each side", leaves);
+  cmd.AddValue ("verbose", "verbose output", verbose);
+  cmd.AddValue ("test", "Enable regression test output", testing);
+  cmd.Parse (argc, argv);
+
+  // Distributed simulation setup; by default use granted time window algorithm.
+  if (nullmsg)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::NullMessageSimulatorImpl"));
+    }
+  else
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::DistributedSimulatorImpl"));
+    }
+
+  // Enable parallel simulator with the command line arguments
+  MpiInterface::Enable (&argc, &argv);
+
+  SinkTracer::Init ();
+
+  if (verbose)
+    {
+      LogComponentEnable ("PacketSink", (LogLevel)(LOG_LEVEL_INFO | LOG_PREFIX_NODE | LOG_PREFIX_TIME));
+    }
+
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  uint32_t systemCount = MpiInterface::GetSize ();
+
+  Config::SetDefault ("ns3::OnOffApplication::PacketSize", UintegerValue (512));
+  Config::SetDefault ("ns3::OnOffApplication::DataRate", StringValue ("1Mbps"));
+  Config::SetDefault ("ns3::OnOffApplication::MaxBytes", UintegerValue (512));
+
+  // Describe the topology: the routers carry the traffic of all the
+  // leaves, and have one device per leaf
+  PointToPointGraphPartitioner graph;
+  uint32_t leftRouter = graph.AddNode (leaves + 1);
+  uint32_t rightRouter = graph.AddNode (leaves + 1);
+  uint32_t routerLinkIndex = graph.AddLink (leftRouter, rightRouter, MilliSeconds (5), leaves);
+  std::vector<uint32_t> leftLeaves;
+  std::vector<uint32_t> rightLeaves;
+  std::vector<uint32_t> leftLinks;
+  std::vector<uint32_t> rightLinks;
+  for (uint32_t i = 0; i < leaves; ++i)
+    {
+      leftLeaves.push_back (graph.AddNode ());
+      leftLinks.push_back (graph.AddLink (leftLeaves[i], leftRouter, MilliSeconds (2)));
+      rightLeaves.push_back (graph.AddNode ());
+      rightLinks.push_back (graph.AddLink (rightLeaves[i], rightRouter, MilliSeconds (2)));
+    }
+
+  // Split it, and build the nodes on their ranks
+  uint32_t partitions = graph.Partition (systemCount);
+  if (systemId == 0)
+    {
+      std::cout << graph.GetNNodes () << " nodes on " << partitions << " of " << systemCount
+                << " ranks, " << graph.GetCutLinkCount () << " remote links, lookahead "
+                << graph.GetLookahead ().As (Time::MS) << std::endl;
+    }
+  NodeContainer nodes = graph.CreateNodes ();
+
+  PointToPointHelper routerLink;
+  routerLink.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+
+  PointToPointHelper leafLink;
+  leafLink.SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+
+  NetDeviceContainer routerDevices = graph.InstallLink (routerLinkIndex, routerLink, nodes);
+  std::vector<NetDeviceContainer> leftDevices;
+  std::vector<NetDeviceContainer> rightDevices;
+  for (uint32_t i = 0; i < leaves; ++i)
+    {
+      leftDevices.push_back (graph.InstallLink (leftLinks[i], leafLink, nodes));
+      rightDevices.push_back (graph.InstallLink (rightLinks[i], leafLink, nodes));
+    }
+
+  InternetStackHelper stack;
+  if (nix)
+    {
+      Ipv4NixVectorHelper nixRouting;
+      stack.SetRoutingHelper (nixRouting); // has effect on the next Install ()
+    }
+
+  stack.InstallAll ();
+
+  Ipv4AddressHelper routerAddress;
+  routerAddress.SetBase ("10.2.1.0", "255.255.255.0");
+  routerAddress.Assign (routerDevices);
+
+  Ipv4AddressHelper leftAddress;
+  leftAddress.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4AddressHelper rightAddress;
+  rightAddress.SetBase ("10.3.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer rightLeafInterfaces;
+  for (uint32_t i = 0; i < leaves; ++i)
+    {
+      leftAddress.Assign (leftDevices[i]);
+      leftAddress.NewNetwork ();
+      rightLeafInterfaces.Add (rightAddress.Assign (rightDevices[i]).Get (0));
+      rightAddress.NewNetwork ();
+    }
+
+  if (!nix)
+    {
+      Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+    }
+
+  // Install the applications of the leaves of this rank only
+  uint16_t port = 50000;
+  Address sinkLocalAddress (InetSocketAddress (Ipv4Address::GetAny (), port));
+  PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", sinkLocalAddress);
+  OnOffHelper clientHelper ("ns3::UdpSocketFactory", Address ());
+  clientHelper.SetAttribute
+    ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+  clientHelper.SetAttribute
+    ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+  for (uint32_t i = 0; i < leaves; ++i)
+    {
+      Ptr<Node> sink = nodes.Get (rightLeaves[i]);
+      if (sink->GetSystemId () == systemId)
+        {
+          ApplicationContainer sinkApp = sinkHelper.Install (sink);
+          if (testing)
+            {
+              sinkApp.Get (0)->TraceConnectWithoutContext ("RxWithAddresses", MakeCallback (&SinkTracer::SinkTrace));
+            }
+          sinkApp.Start (Seconds (1.0));
+          sinkApp.Stop (Seconds (5));
+        }
+
+      Ptr<Node> client = nodes.Get (leftLeaves[i]);
+      if (client->GetSystemId () == systemId)
+        {
+          AddressValue remoteAddress
+            (InetSocketAddress (rightLeafInterfaces.GetAddress (i), port));
+          clientHelper.SetAttribute ("Remote", remoteAddress);
+          ApplicationContainer clientApp = clientHelper.Install (client);
+          clientApp.Start (Seconds (1.0));
+          clientApp.Stop (Seconds (5));
+        }
+    }
+
+  Simulator::Stop (Seconds (5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  if (testing)
+    {
+      SinkTracer::Verify (leaves);
+    }
+
+  // Exit the MPI execution environment
+  MpiInterface::Disable ();
+  return 0;
+}
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/ring-queue.h"
+
+/**
+ * \file
+ * \ingroup network
+ * Per packet cost of the device queues.
+ *
+ * Each queue, a DropTailQueue keeping its packets in a list and a
+ * RingQueue keeping them in a ring buffer, runs the same two patterns:
+ * "steady" enqueues and dequeues one packet at a time over a standing
+ * backlog of the given depth, as a device queue does while it drains at
+ * the link rate; "burst" fills the queue to the depth and empties it.
+ *
+ * \code
+ *   ./waf --run "bench-queue --packets=10000000"
+ * \endcode
+ */
+
+using namespace ns3;
+
+/**
+ * Print one result line.
+ * \param name the queue and the pattern
+ * \param depth the backlog
+ * \param seconds the elapsed time
+ * \param packets the number of packets enqueued and dequeued
+ * \param sink the accumulated results, printed so they are not optimized out
+ */
+static void
+Report (std::string name, uint32_t depth, double seconds, uint32_t packets, uint64_t sink)
+{
+  std::cout << std::left << std::setw (24) << name
+            << std::right << std::setw (8) << depth
+            << std::setw (12) << seconds
+            << std::setw (12) << (seconds * 1e9 / packets)
+            << std::setw (16) << sink << std::endl;
+}
+
+/**
+ * Run the two patterns on one queue.
+ * \param name the name of the queue
+ * \param queue the queue, limited to the depth
+ * \param pool the packets to enqueue
+ * \param depth the backlog
+ * \param packets the number of packets of each pattern
+ */
+static void
+Run (std::string name, Ptr<Queue<Packet> > queue, std::vector<Ptr<Packet> > const &pool,
+     uint32_t depth, uint32_t packets)
+{
+  SystemWallClockMs time;
+  uint64_t sink = 0;
+  uint32_t n = pool.size ();
+
+  for (uint32_t i = 0; i + 1 < depth; ++i)
+    {
+      queue->Enqueue (pool[i % n]);
+    }
+  time.Start ();
+  for (uint32_t i = 0; i < packets; ++i)
+    {
+      queue->Enqueue (pool[i % n]);
+      sink += queue->Dequeue ()->GetSize ();
+    }
+  Report (name + " steady", depth, time.End () / 1000.0, packets, sink);
+  queue->Flush ();
+
+  sink = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < packets; i += depth)
+    {
+      for (uint32_t j = 0; j < depth; ++j)
+        {
+          queue->Enqueue (pool[(i + j) % n]);
+        }
+      while (!queue->IsEmpty ())
+        {
+          sink += queue->Dequeue ()->GetSize ();
+        }
+    }
+  Report (name + " burst", depth, time.End () / 1000.0, packets, sink);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t packets = 1000000;
+  std::string depths = "1,16,100,1000";
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Compare the per packet cost of the device queues.");
+  cmd.AddValue ("packets", "number of packets per queue and pattern", packets);
+  cmd.AddValue ("depths", "comma separated backlogs, in packets", depths);
+  cmd.Parse (argc, argv);
+
+  std::vector<Ptr<Packet> > pool;
+  for (uint32_t i = 0; i < 4096; ++i)
+    {
+      pool.push_back (Create<Packet> (1448 + i % 64));
+    }
+
+  std::cout << std::left << std::setw (24) << "Queue"
+            << std::right << std::setw (8) << "Depth"
+            << std::setw (12) << "Run (s)"
+            << std::setw (12) << "ns/packet"
+            << std::setw (16) << "checksum" << std::endl;
+  std::cout << std::fixed << std::setprecision (3);
+
+  std::istringstream list (depths);
+  std::string item;
+  while (std::getline (list, item, ','))
+    {
+      uint32_t depth = std::max (std::stoul (item), 1UL);
+      QueueSize maxSize (QueueSizeUnit::PACKETS, depth);
+
+      Ptr<Queue<Packet> > dropTail = CreateObject<DropTailQueue<Packet> > ();
+      dropTail->SetMaxSize (maxSize);
+      Run ("DropTailQueue", dropTail, pool, depth, packets);
+
+      Ptr<Queue<Packet> > ring = CreateObject<RingQueue<Packet> > ();
+      ring->SetMaxSize (maxSize);
+      Run ("RingQueue", ring, pool, depth, packets);
+    }
+  return 0;
+}
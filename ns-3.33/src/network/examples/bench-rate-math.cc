@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/data-rate.h"
+#include "ns3/rate-math.h"
+
+/**
+ * \file
+ * \ingroup network
+ * Per call cost of the rate arithmetic.
+ *
+ * Each variant computes the same quantities over the same random inputs:
+ * the transmission time of a packet, a bandwidth-delay product and a
+ * gain applied to a rate.  The "double" rows use the former code paths
+ * (int64x64_t division and double arithmetic), the "fixed" rows the
+ * RateMath helpers and the "reciprocal" row a RateReciprocal precomputed
+ * for the link rate.
+ *
+ * \code
+ *   ./waf --run "bench-rate-math --calls=10000000"
+ * \endcode
+ */
+
+using namespace ns3;
+
+/** Inputs of one call */
+struct RateSample
+{
+  uint32_t bytes;    //!< Packet size
+  uint64_t bps;      //!< Rate
+  Time rtt;          //!< Interval
+  double gain;       //!< Gain
+  uint32_t units;    //!< Gain, in 1/256
+};
+
+/**
+ * Print one result line.
+ * \param name the variant
+ * \param seconds the elapsed time
+ * \param calls the number of calls
+ * \param sink the accumulated results, printed so they are not optimized out
+ */
+static void
+Report (std::string name, double seconds, uint32_t calls, int64_t sink)
+{
+  std::cout << std::left << std::setw (24) << name
+            << std::right << std::setw (12) << seconds
+            << std::setw (12) << (seconds * 1e9 / calls)
+            << std::setw (24) << sink << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t calls = 1000000;
+  uint32_t samples = 4096;
+  uint64_t linkRate = 10000000000ULL;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Compare the per call cost of the rate arithmetic.");
+  cmd.AddValue ("calls", "number of calls per variant", calls);
+  cmd.AddValue ("samples", "number of distinct random inputs", samples);
+  cmd.AddValue ("rate", "link rate of the reciprocal, in bit/s", linkRate);
+  cmd.Parse (argc, argv);
+
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  std::vector<RateSample> inputs (samples);
+  for (uint32_t i = 0; i < samples; ++i)
+    {
+      inputs[i].bytes = rng->GetInteger (40, 65535);
+      inputs[i].bps = static_cast<uint64_t> (rng->GetValue (1e6, 1e11));
+      inputs[i].rtt = NanoSeconds (rng->GetInteger (1000000, 500000000));
+      inputs[i].gain = rng->GetValue (0.5, 3);
+      inputs[i].units = RateMath::GainToUnits (inputs[i].gain);
+    }
+
+  // Before Simulator::Run, each Time built is recorded in case the
+  // resolution changes; an empty run ends that bookkeeping.
+  Simulator::Run ();
+
+  std::cout << std::left << std::setw (24) << "Variant"
+            << std::right << std::setw (12) << "Run (s)"
+            << std::setw (12) << "ns/call"
+            << std::setw (24) << "checksum" << std::endl;
+  std::cout << std::fixed << std::setprecision (3);
+
+  SystemWallClockMs time;
+  int64_t sink = 0;
+
+  time.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      const RateSample &s = inputs[i % samples];
+      sink += DataRate (s.bps).CalculateBytesTxTime (s.bytes).GetTimeStep ();
+    }
+  Report ("txtime fixed", time.End () / 1000.0, calls, sink);
+
+  sink = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      const RateSample &s = inputs[i % samples];
+      sink += (Seconds (s.bytes * 8) / s.bps).GetTimeStep ();
+    }
+  Report ("txtime double", time.End () / 1000.0, calls, sink);
+
+  RateReciprocal reciprocal (linkRate);
+  sink = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      sink += reciprocal.TxTime (inputs[i % samples].bytes).GetTimeStep ();
+    }
+  Report ("txtime reciprocal", time.End () / 1000.0, calls, sink);
+
+  sink = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      const RateSample &s = inputs[i % samples];
+      sink += static_cast<int64_t> (DataRate (s.bps) * s.rtt * s.gain / 8.0);
+    }
+  Report ("bdp double", time.End () / 1000.0, calls, sink);
+
+  sink = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      const RateSample &s = inputs[i % samples];
+      sink += RateMath::ApplyGain (RateMath::Bytes (s.bps, s.rtt), s.units);
+    }
+  Report ("bdp fixed", time.End () / 1000.0, calls, sink);
+
+  sink = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      const RateSample &s = inputs[i % samples];
+      sink += static_cast<int64_t> (s.bytes * 8000.0 / s.rtt.GetMilliSeconds ());
+    }
+  Report ("rate double", time.End () / 1000.0, calls, sink);
+
+  sink = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      const RateSample &s = inputs[i % samples];
+      sink += RateMath::Rate (s.bytes, s.rtt);
+    }
+  Report ("rate fixed", time.End () / 1000.0, calls, sink);
+
+  sink = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      const RateSample &s = inputs[i % samples];
+      sink += static_cast<int64_t> (s.gain * s.bps * 99 / 100);
+    }
+  Report ("gain double", time.End () / 1000.0, calls, sink);
+
+  sink = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      const RateSample &s = inputs[i % samples];
+      sink += RateMath::ApplyGain (s.bps, s.units) / 100 * 99;
+    }
+  Report ("gain fixed", time.End () / 1000.0, calls, sink);
+  Simulator::Destroy ();
+  return 0;
+}
@@ -26,6 +26,7 @@
 #include "ns3/ptr.h"
 #include "ns3/node.h"
 #include "ns3/names.h"
+#include "ns3/pointer.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
 
@@ -54,8 +55,28 @@ PcapHelper::CreateFile (
   int32_t     tzCorrection)
 {
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
+  return CreateFile (filename, filemode, dataLinkType, 0, snapLen, tzCorrection);
+}
+
+Ptr<PcapFileWrapper>
+PcapHelper::CreateFile (
+  std::string filename, 
+  std::ios::openmode filemode,
+  DataLinkType dataLinkType,
+  Ptr<PcapCaptureFilter> filter,
+  uint32_t    snapLen, 
+  int32_t     tzCorrection)
+{
+  NS_LOG_FUNCTION (filename << filemode << dataLinkType << filter << snapLen << tzCorrection);
 
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  //
+  // The filter may lower the snap length of the file: set it before Init.
+  //
+  if (filter != 0)
+    {
+      file->SetAttribute ("CaptureFilter", PointerValue (filter));
+    }
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -441,6 +462,18 @@ PcapHelperForDevice::EnablePcapAll (std::string prefix, bool promiscuous)
   EnablePcap (prefix, NodeContainer::GetGlobal (), promiscuous);
 }
 
+void
+PcapHelperForDevice::SetCaptureFilter (Ptr<PcapCaptureFilter> filter)
+{
+  m_captureFilter = filter;
+}
+
+Ptr<PcapCaptureFilter>
+PcapHelperForDevice::GetCaptureFilter (void) const
+{
+  return m_captureFilter;
+}
+
 void 
 PcapHelperForDevice::EnablePcap (std::string prefix, uint32_t nodeid, uint32_t deviceid, bool promiscuous)
 {
@@ -109,6 +109,24 @@ public:
                                    DataLinkType dataLinkType,
                                    uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
                                    int32_t tzCorrection = 0);
+  /**
+   * @brief Create and initialize a pcap file which keeps only the packets
+   * selected by a capture filter.
+   *
+   * @param filename file name
+   * @param filemode file mode
+   * @param dataLinkType data link type of packet data
+   * @param filter the capture filter, 0 to write all the packets
+   * @param snapLen maximum length of packet data stored in records
+   * @param tzCorrection time zone correction to be applied to timestamps of packets
+   * @returns a smart pointer to the Pcap file
+   */
+  Ptr<PcapFileWrapper> CreateFile (std::string filename,
+                                   std::ios::openmode filemode,
+                                   DataLinkType dataLinkType,
+                                   Ptr<PcapCaptureFilter> filter,
+                                   uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
+                                   int32_t tzCorrection = 0);
   /**
    * @brief Hook a trace source to the default trace sink
    * 
@@ -632,6 +650,29 @@ public:
    * @param promiscuous If true capture all possible packets available at the device.
    */
   void EnablePcapAll (std::string prefix, bool promiscuous = false);
+
+  /**
+   * @brief Select the packets written to the pcap files enabled afterwards.
+   *
+   * The filter is checked before a packet is written, so that the packets
+   * left out cost little more than a look at their headers.  The device
+   * helpers apply it by passing GetCaptureFilter to PcapHelper::CreateFile.
+   *
+   * @param filter the capture filter, 0 to write all the packets
+   */
+  void SetCaptureFilter (Ptr<PcapCaptureFilter> filter);
+
+  /**
+   * @brief Get the filter of the pcap files enabled from now on.
+   *
+   * The device helpers pass it to PcapHelper::CreateFile.
+   *
+   * @returns the capture filter, 0 if all the packets are written
+   */
+  Ptr<PcapCaptureFilter> GetCaptureFilter (void) const;
+
+private:
+  Ptr<PcapCaptureFilter> m_captureFilter; //!< Filter of the pcap files enabled
 };
 
 /**
@@ -20,6 +20,7 @@
 #include "buffer.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/unused.h"
 
 #define LOG_INTERNAL_STATE(y)                                                                    \
   NS_LOG_LOGIC (y << "start="<<m_start<<", end="<<m_end<<", zero start="<<m_zeroAreaStart<<              \
@@ -50,7 +51,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
-uint32_t Buffer::g_recommendedStart = 0;
+thread_local uint32_t Buffer::g_recommendedStart = 0;
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -60,6 +61,13 @@ uint32_t Buffer::g_recommendedStart = 0;
  *  - initialized means that the free list exists and is valid
  *  - destroyed means that the static destructors of this compilation unit
  *    have run so, the free list has been cleared from its content
+ * There is one free list per thread; the destructor of the thread's
+ * g_localStaticDestructor clears it when the thread exits.  A thread
+ * may recycle data created by another one, so either Create or Recycle
+ * can move the list out of the un-initialized state.
+ * The free list is an array of FREE_LIST_CLASSES lists, one per size
+ * class, so that the data keep the size requested by Create and small
+ * buffers are not served by the large ones of the GSO packets.
  * The key is that in destroyed state, we are careful not re-create it
  * which is a typical weakness of lazy evaluation schemes which use 
  * '0' as a special value to indicate both un-initialized and destroyed.
@@ -75,43 +83,59 @@ uint32_t Buffer::g_recommendedStart = 0;
 #define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
 #define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
 #define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
-struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
+thread_local Buffer::FreeList *Buffer::g_freeList = 0;
+thread_local struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
 
 Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
 {
   NS_LOG_FUNCTION (this);
   if (IS_INITIALIZED (g_freeList))
     {
-      for (Buffer::FreeList::iterator i = g_freeList->begin ();
-           i != g_freeList->end (); i++)
+      for (uint32_t k = 0; k < FREE_LIST_CLASSES; k++)
         {
-          Buffer::Deallocate (*i);
+          for (Buffer::FreeList::iterator i = g_freeList[k].begin ();
+               i != g_freeList[k].end (); i++)
+            {
+              Buffer::Deallocate (*i);
+            }
         }
-      delete g_freeList;
+      delete [] g_freeList;
       g_freeList = DESTROYED;
     }
 }
 
+uint32_t
+Buffer::GetSizeClass (uint32_t size)
+{
+  uint32_t k = 0;
+  while (k + 1 < FREE_LIST_CLASSES && (size >> (FREE_LIST_MIN_SHIFT + k + 1)) != 0)
+    {
+      k++;
+    }
+  return k;
+}
+
 void
 Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
-  g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
-  if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
-      g_freeList->size () > 1000)
+  if (IS_UNINITIALIZED (g_freeList))
+    {
+      // the data was created by another thread
+      g_freeList = new Buffer::FreeList [FREE_LIST_CLASSES];
+      NS_UNUSED (&g_localStaticDestructor);
+    }
+  /* feed into the free list of its size class */
+  if (IS_DESTROYED (g_freeList) ||
+      g_freeList[GetSizeClass (data->m_size)].size () >= FREE_LIST_SIZE)
     {
       Buffer::Deallocate (data);
     }
   else
     {
       NS_ASSERT (IS_INITIALIZED (g_freeList));
-      g_freeList->push_back (data);
+      g_freeList[GetSizeClass (data->m_size)].push_back (data);
     }
 }
 
@@ -122,20 +146,23 @@ Buffer::Create (uint32_t dataSize)
   /* try to find a buffer correctly sized. */
   if (IS_UNINITIALIZED (g_freeList))
     {
-      g_freeList = new Buffer::FreeList ();
+      g_freeList = new Buffer::FreeList [FREE_LIST_CLASSES];
+      // make sure the destructor of this thread's list is registered
+      NS_UNUSED (&g_localStaticDestructor);
     }
   else if (IS_INITIALIZED (g_freeList))
     {
-      while (!g_freeList->empty ()) 
+      /* the classes above the one of dataSize only hold larger data */
+      for (uint32_t k = GetSizeClass (dataSize); k < FREE_LIST_CLASSES; k++)
         {
-          struct Buffer::Data *data = g_freeList->back ();
-          g_freeList->pop_back ();
-          if (data->m_size >= dataSize) 
+          Buffer::FreeList &list = g_freeList[k];
+          if (!list.empty () && list.back ()->m_size >= dataSize)
             {
+              struct Buffer::Data *data = list.back ();
+              list.pop_back ();
               data->m_count = 1;
               return data;
             }
-          Buffer::Deallocate (data);
         }
     }
   struct Buffer::Data *data = Buffer::Allocate (dataSize);
@@ -244,7 +271,8 @@ void
 Buffer::Initialize (uint32_t zeroSize)
 {
   NS_LOG_FUNCTION (this << zeroSize);
-  m_data = Buffer::Create (0);
+  // reserve the header room the previous buffers ended up needing
+  m_data = Buffer::Create (g_recommendedStart);
   m_start = std::min (m_data->m_size, g_recommendedStart);
   m_maxZeroAreaStart = m_start;
   m_zeroAreaStart = m_start;
@@ -396,23 +424,61 @@ Buffer::AddAtEnd (uint32_t end)
   NS_ASSERT (CheckInternalState ());
 }
 
+void
+Buffer::Unshare (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t internalSize = GetInternalSize ();
+  struct Buffer::Data *newData = Buffer::Create (internalSize);
+  memcpy (newData->m_data, m_data->m_data + m_start, internalSize);
+  m_data->m_count--;
+  if (m_data->m_count == 0)
+    {
+      Buffer::Recycle (m_data);
+    }
+  m_data = newData;
+
+  int32_t delta = -m_start;
+  m_zeroAreaStart += delta;
+  m_zeroAreaEnd += delta;
+  m_end += delta;
+  m_start += delta;
+
+  // update dirty area
+  m_data->m_dirtyStart = m_start;
+  m_data->m_dirtyEnd = m_end;
+  NS_ASSERT (CheckInternalState ());
+}
+
 void
 Buffer::AddAtEnd (const Buffer &o)
 {
   NS_LOG_FUNCTION (this << &o);
-  if (m_data->m_count == 1 &&
-      m_end == m_zeroAreaEnd &&
-      m_end == m_data->m_dirtyEnd &&
+  if (&o == this)
+    {
+      Buffer tmp = o;
+      AddAtEnd (tmp);
+      return;
+    }
+  uint32_t zeroSize = m_zeroAreaEnd - m_zeroAreaStart;
+  uint32_t oZeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
+  if (m_end == m_zeroAreaEnd &&
       o.m_start == o.m_zeroAreaStart &&
-      o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
+      oZeroSize > 0)
     {
       /**
        * This is an optimization which kicks in when
        * we attempt to aggregate two buffers which contain
-       * adjacent zero areas.
+       * adjacent zero areas.  Growing the zero area of a
+       * shared buffer could expose bytes written by its
+       * other users, so these get a copy of the (small)
+       * non-zero part first.
        */
-      uint32_t zeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
-      m_zeroAreaEnd += zeroSize;
+      if (m_data->m_count != 1 || m_end != m_data->m_dirtyEnd)
+        {
+          Unshare ();
+        }
+      m_zeroAreaEnd += oZeroSize;
       m_end = m_zeroAreaEnd;
       m_data->m_dirtyEnd = m_zeroAreaEnd;
       uint32_t endData = o.m_end - o.m_zeroAreaEnd;
@@ -426,12 +492,55 @@ Buffer::AddAtEnd (const Buffer &o)
       return;
     }
 
-  *this = CreateFullCopy ();
-  AddAtEnd (o.GetSize ());
-  Buffer::Iterator destStart = End ();
-  destStart.Prev (o.GetSize ());
-  destStart.Write (o.Begin (), o.End ());
-  NS_ASSERT (CheckInternalState ());
+  if (oZeroSize == 0)
+    {
+      /* o is made of real bytes only: append them after our
+       * end data, keeping our zero area virtual.
+       */
+      uint32_t oSize = o.GetSize ();
+      const uint8_t *oData = o.m_data->m_data + o.m_start;
+      if (o.m_data == m_data)
+        {
+          Unshare ();
+        }
+      AddAtEnd (oSize);
+      Buffer::Iterator dst = End ();
+      dst.Prev (oSize);
+      dst.Write (oData, oSize);
+      NS_ASSERT (CheckInternalState ());
+      return;
+    }
+
+  if (zeroSize == 0)
+    {
+      /* we are made of real bytes only: prepend them to o,
+       * keeping the zero area of o virtual.
+       */
+      uint32_t size = GetSize ();
+      Buffer tmp = o;
+      if (tmp.m_data == m_data)
+        {
+          tmp.Unshare ();
+        }
+      tmp.AddAtStart (size);
+      tmp.Begin ().Write (m_data->m_data + m_start, size);
+      *this = tmp;
+      NS_ASSERT (CheckInternalState ());
+      return;
+    }
+
+  /* real bytes separate the zero areas: turn the smaller
+   * one into real bytes and use one of the cases above.
+   */
+  if (oZeroSize < zeroSize)
+    {
+      AddAtEnd (o.CreateFullCopy ());
+    }
+  else
+    {
+      *this = CreateFullCopy ();
+      AddAtEnd (o);
+    }
 }
 
 void 
@@ -843,25 +952,36 @@ Buffer::Iterator::Write (Iterator start, Iterator end)
   uint32_t size = end.m_current - start.m_current;
   NS_ASSERT_MSG (CheckNoZero (m_current, m_current + size),
                  GetWriteErrorMessage ());
+  // the written range lies entirely before or after our zero area
+  uint8_t *to;
+  if (m_current <= m_zeroStart)
+    {
+      to = &m_data[m_current];
+    }
+  else
+    {
+      to = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
+    }
   if (start.m_current <= start.m_zeroStart)
     {
       uint32_t toCopy = std::min (size, start.m_zeroStart - start.m_current);
-      memcpy (&m_data[m_current], &start.m_data[start.m_current], toCopy);
+      memcpy (to, &start.m_data[start.m_current], toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   if (start.m_current <= start.m_zeroEnd)
     {
       uint32_t toCopy = std::min (size, start.m_zeroEnd - start.m_current);
-      memset (&m_data[m_current], 0, toCopy);
+      memset (to, 0, toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   uint32_t toCopy = std::min (size, start.m_dataEnd - start.m_current);
   uint8_t *from = &start.m_data[start.m_current - (start.m_zeroEnd-start.m_zeroStart)];
-  uint8_t *to = &m_data[m_current];
   memcpy (to, from, toCopy);
   m_current += toCopy;
 }
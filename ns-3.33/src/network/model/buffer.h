@@ -381,6 +381,18 @@ public:
      */
     uint32_t GetRemainingSize (void) const;
 
+    /**
+     * \param size the number of bytes needed
+     * \returns the address of the next size bytes, or zero if they
+     *     are not all stored contiguously in memory (they overlap the
+     *     virtual zero area) or go past the end of the buffer.
+     *
+     * The iterator is not moved.  Fixed size headers use this to read
+     * or write all their fields in place, and fall back to the per
+     * byte accessors when zero is returned.
+     */
+    inline uint8_t *PeekContiguous (uint32_t size) const;
+
 private:
     /// Friend class
     friend class Buffer;
@@ -692,6 +704,13 @@ private:
    * \returns a copy of the buffer
    */
   Buffer CreateFullCopy (void) const;
+  /**
+   * \brief Give the buffer a private copy of its data
+   *
+   * Only the bytes stored before and after the zero area are copied;
+   * the zero area stays virtual.
+   */
+  void Unshare (void);
 
   /**
    * \brief Transform a "Virtual byte buffer" into a "Real byte buffer"
@@ -765,9 +784,10 @@ private:
   /**
    * location in a newly-allocated buffer where you should start
    * writing data. i.e., m_start should be initialized to this 
-   * value.
+   * value.  Kept per thread, like the free list below, so that
+   * simulations running on several threads do not share it.
    */
-  static uint32_t g_recommendedStart;
+  static thread_local uint32_t g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -791,6 +811,18 @@ private:
   uint32_t m_end;
 
 #ifdef BUFFER_FREE_LIST
+  /**
+   * \brief Get the free list of a buffer data size
+   *
+   * The size class k holds the data of 2^(k+FREE_LIST_MIN_SHIFT) to
+   * 2^(k+FREE_LIST_MIN_SHIFT+1)-1 bytes; the first and the last
+   * classes also hold the smaller and the larger data.
+   *
+   * \param size the storage size
+   * \returns the size class of the storage
+   */
+  static uint32_t GetSizeClass (uint32_t size);
+
   /// Container for buffer data
   typedef std::vector<struct Buffer::Data*> FreeList;
   /// Local static destructor structure
@@ -798,9 +830,11 @@ private:
   {
     ~LocalStaticDestructor ();
   };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+  static const uint32_t FREE_LIST_CLASSES = 12;   //!< Number of size classes
+  static const uint32_t FREE_LIST_MIN_SHIFT = 6;  //!< Log2 of the smallest class size
+  static const uint32_t FREE_LIST_SIZE = 1000;    //!< Largest number of data per class
+  static thread_local FreeList *g_freeList; //!< Buffer data containers, one per size class
+  static thread_local struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
 #endif
 };
 
@@ -994,6 +1028,20 @@ Buffer::Iterator::ReadNtohU32 (void)
   return retval;
 }
 
+uint8_t *
+Buffer::Iterator::PeekContiguous (uint32_t size) const
+{
+  if (m_current + size <= m_zeroStart)
+    {
+      return &m_data[m_current];
+    }
+  else if (m_current >= m_zeroEnd && m_current + size <= m_dataEnd)
+    {
+      return &m_data[m_current - (m_zeroEnd - m_zeroStart)];
+    }
+  return 0;
+}
+
 uint8_t
 Buffer::Iterator::PeekU8 (void)
 {
@@ -19,6 +19,7 @@
  */
 #include "byte-tag-list.h"
 #include "ns3/log.h"
+#include "ns3/per-thread-pool.h"
 #include <vector>
 #include <cstring>
 #include <limits>
@@ -46,30 +47,9 @@ struct ByteTagListData {
 };
 
 #ifdef USE_FREE_LIST
-/**
- * \ingroup packet
- *
- * \brief Container class for struct ByteTagListData
- *
- * Internal use only.
- */
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
-{
-public:
-  ~ByteTagListDataFreeList ();
-} g_freeList; //!< Container for struct ByteTagListData
-static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
-
-ByteTagListDataFreeList::~ByteTagListDataFreeList ()
-{
-  NS_LOG_FUNCTION (this);
-  for (ByteTagListDataFreeList::iterator i = begin ();
-       i != end (); i++)
-    {
-      uint8_t *buffer = (uint8_t *)(*i);
-      delete [] buffer;
-    }
-}
+/// Container for struct ByteTagListData
+typedef PerThreadPool<struct ByteTagListData, FREE_LIST_SIZE> ByteTagListDataPool;
+static thread_local uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
 #endif /* USE_FREE_LIST */
 
 ByteTagList::Iterator::Item::Item (TagBuffer buf_)
@@ -345,22 +325,19 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  while (!g_freeList.empty ())
+  struct ByteTagListData *data;
+  while ((data = ByteTagListDataPool::Pop ()) != 0)
     {
-      struct ByteTagListData *data = g_freeList.back ();
-      g_freeList.pop_back ();
-      NS_ASSERT (data != 0);
       if (data->size >= size)
         {
           data->count = 1;
           data->dirty = 0;
           return data;
         }
-      uint8_t *buffer = (uint8_t *)data;
-      delete [] buffer;
+      ::operator delete (data);
     }
-  uint8_t *buffer = new uint8_t [std::max (size, g_maxSize) + sizeof (struct ByteTagListData) - 4];
-  struct ByteTagListData *data = (struct ByteTagListData *)buffer;
+  void *buffer = ::operator new (std::max (size, g_maxSize) + sizeof (struct ByteTagListData) - 4);
+  data = (struct ByteTagListData *)buffer;
   data->count = 1;
   data->size = size;
   data->dirty = 0;
@@ -379,15 +356,9 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
   data->count--;
   if (data->count == 0)
     {
-      if (g_freeList.size () > FREE_LIST_SIZE ||
-          data->size < g_maxSize)
-        {
-          uint8_t *buffer = (uint8_t *)data;
-          delete [] buffer;
-        }
-      else
+      if (data->size < g_maxSize || !ByteTagListDataPool::Push (data))
         {
-          g_freeList.push_back (data);
+          ::operator delete (data);
         }
     }
 }
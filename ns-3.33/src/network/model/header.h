@@ -113,6 +113,38 @@ public:
  */
 std::ostream & operator << (std::ostream &os, const Header &header);
 
+/**
+ * \ingroup packet
+ *
+ * \brief Whether a Packet may carry headers of type T unserialized.
+ *
+ * When Packet::EnableStructuredHeaders has been called, a header of a
+ * type for which this trait is true is kept by the packet as a copy of
+ * the object, and is only serialized when the bytes of the packet are
+ * needed.  Specialize it with a true value, next to the header class,
+ * for headers whose copy carries the same information as their bytes.
+ *
+ * The copy carries the header as it was sent, so a header which
+ * verifies a checksum on reception must be read from the bytes: the
+ * specialization also defines NeedsBytes, which tells whether the
+ * header to read requests such a verification.
+ *
+ * \tparam T \explicit the header class
+ */
+template <typename T>
+struct IsStructuredHeader
+{
+  static const bool value = false; //!< T headers are always serialized
+  /**
+   * \param header the header to read
+   * \returns true if the header must be deserialized from the bytes
+   */
+  static bool NeedsBytes (const T &header)
+  {
+    return true;
+  }
+};
+
 } // namespace ns3
 
 #endif /* HEADER_H */
@@ -359,6 +359,15 @@ public:
    */
   virtual bool SupportsSendFrom (void) const = 0;
 
+  /**
+   * \return true if this interface splits the packets carrying a GsoTag
+   * into wire segments, false otherwise.
+   *
+   * The network layer splits the super-segments itself before handing
+   * them to a device which does not.  The default is false.
+   */
+  virtual bool SupportsGso (void) const;
+
 };
 
 } // namespace ns3
@@ -20,6 +20,7 @@
  */
 
 #include "ns3/simulator.h"
+#include "ns3/replication-context.h"
 #include "ns3/object-vector.h"
 #include "ns3/config.h"
 #include "ns3/log.h"
@@ -131,13 +132,15 @@ NodeListPriv::DoGet (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   static Ptr<NodeListPriv> ptr = 0;
-  if (ptr == 0)
+  static thread_local Ptr<NodeListPriv> replicationPtr = 0;
+  Ptr<NodeListPriv> *pptr = ReplicationContext::IsActive () ? &replicationPtr : &ptr;
+  if (*pptr == 0)
     {
-      ptr = CreateObject<NodeListPriv> ();
-      Config::RegisterRootNamespaceObject (ptr);
+      *pptr = CreateObject<NodeListPriv> ();
+      Config::RegisterRootNamespaceObject (*pptr);
       Simulator::ScheduleDestroy (&NodeListPriv::Delete);
     }
-  return &ptr;
+  return pptr;
 }
 void 
 NodeListPriv::Delete (void)
@@ -43,14 +43,60 @@ PacketTagList::CreateTagData (size_t dataSize)
                  << " exceeds maximum "
                  << std::numeric_limits<decltype(TagData::size)>::max () );
 
-  void * p = std::malloc (sizeof (TagData) + dataSize - 1);
-  // The matching frees are in RemoveAll and RemoveWriter
+  void * p;
+  if (dataSize > POOLED_TAG_SIZE)
+    {
+      p = ::operator new (sizeof (TagData) + dataSize - 1);
+    }
+  else if ((p = TagDataPool::Pop ()) == 0)
+    {
+      p = ::operator new (sizeof (TagData) + POOLED_TAG_SIZE - 1);
+    }
+  // The matching releases are in RemoveAll and RemoveWriter
 
   TagData * tag = new (p) TagData;
   tag->size = dataSize;
   return tag;
 }
 
+void
+PacketTagList::FreeTagData (TagData * tag)
+{
+  bool pooled = tag->size <= POOLED_TAG_SIZE;
+  tag->~TagData ();
+  if (!pooled || !TagDataPool::Push (tag))
+    {
+      ::operator delete (tag);
+    }
+}
+
+uint32_t
+PacketTagList::FindInline (TypeId tid) const
+{
+  uint16_t uid = tid.GetUid ();
+  uint32_t offset = 0;
+  while (offset < m_inlineUsed)
+    {
+      uint16_t cur;
+      std::memcpy (&cur, m_inline + offset, 2);
+      if (cur == uid)
+        {
+          return offset;
+        }
+      offset += INLINE_TAG_HEADER + m_inline[offset + 2];
+    }
+  return m_inlineUsed;
+}
+
+void
+PacketTagList::RemoveInline (uint32_t offset)
+{
+  uint32_t recordSize = INLINE_TAG_HEADER + m_inline[offset + 2];
+  std::memmove (m_inline + offset, m_inline + offset + recordSize,
+                m_inlineUsed - offset - recordSize);
+  m_inlineUsed -= recordSize;
+}
+
 bool
 PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 {
@@ -175,6 +221,14 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 bool
 PacketTagList::Remove (Tag & tag)
 {
+  uint32_t offset = FindInline (tag.GetInstanceTypeId ());
+  if (offset < m_inlineUsed)
+    {
+      uint8_t *data = m_inline + offset + INLINE_TAG_HEADER;
+      tag.Deserialize (TagBuffer (data, data + m_inline[offset + 2]));
+      RemoveInline (offset);
+      return true;
+    }
   return COWTraverse (tag, &PacketTagList::RemoveWriter);
 }
 
@@ -194,8 +248,7 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
   if (preMerge)
     {
       // found tid before first merge, so delete cur
-      cur->~TagData ();
-      std::free (cur);
+      FreeTagData (cur);
     }
   else
     {
@@ -214,6 +267,22 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
 bool
 PacketTagList::Replace (Tag & tag)
 {
+  uint32_t offset = FindInline (tag.GetInstanceTypeId ());
+  if (offset < m_inlineUsed)
+    {
+      uint32_t size = tag.GetSerializedSize ();
+      if (size == m_inline[offset + 2])
+        {
+          uint8_t *data = m_inline + offset + INLINE_TAG_HEADER;
+          tag.Serialize (TagBuffer (data, data + size));
+        }
+      else
+        {
+          RemoveInline (offset);
+          Add (tag);
+        }
+      return true;
+    }
   bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
   if (!found)
     {
@@ -261,11 +330,27 @@ PacketTagList::Add (const Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   // ensure this id was not yet added
+  NS_ASSERT_MSG (FindInline (tag.GetInstanceTypeId ()) == m_inlineUsed,
+                 "Error: cannot add the same kind of tag twice.");
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
       NS_ASSERT_MSG (cur->tid != tag.GetInstanceTypeId (),
                      "Error: cannot add the same kind of tag twice.");
     }
+  uint32_t size = tag.GetSerializedSize ();
+  if (size <= MAX_INLINE_TAG_SIZE
+      && m_inlineUsed + INLINE_TAG_HEADER + size <= INLINE_SIZE)
+    {
+      PacketTagList *self = const_cast<PacketTagList *> (this);
+      uint8_t *record = self->m_inline + m_inlineUsed;
+      uint16_t uid = tag.GetInstanceTypeId ().GetUid ();
+      std::memcpy (record, &uid, 2);
+      record[2] = size;
+      uint8_t *data = record + INLINE_TAG_HEADER;
+      tag.Serialize (TagBuffer (data, data + size));
+      self->m_inlineUsed += INLINE_TAG_HEADER + size;
+      return;
+    }
   struct TagData * head = CreateTagData (tag.GetSerializedSize ());
   head->count = 1;
   head->next = 0;
@@ -281,6 +366,14 @@ PacketTagList::Peek (Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
+  uint32_t offset = FindInline (tid);
+  if (offset < m_inlineUsed)
+    {
+      const uint8_t *data = m_inline + offset + INLINE_TAG_HEADER;
+      tag.Deserialize (TagBuffer (const_cast<uint8_t *> (data),
+                                  const_cast<uint8_t *> (data) + m_inline[offset + 2]));
+      return true;
+    }
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
       if (cur->tid == tid)
@@ -309,6 +402,17 @@ PacketTagList::GetSerializedSize (void) const
 
   size = 4; // numberOfTags
 
+  uint32_t offset = 0;
+  TypeId tid;
+  const uint8_t *data;
+  uint32_t dataSize;
+  while (NextInline (offset, tid, data, dataSize))
+    {
+      size += 4; // tag size
+      size += (sizeof (TypeId::hash_t)+3) & (~3); // TypeId hash
+      size += (dataSize+3) & (~3); // tag data
+    }
+
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
       size += 4; // TagData -> size
@@ -325,6 +429,62 @@ PacketTagList::GetSerializedSize (void) const
   return size;
 }
 
+/**
+ * Serialize one tag for PacketTagList::Serialize.
+ *
+ * \param [in,out] p The write position, advanced past the tag.
+ * \param [in,out] size The bytes written so far.
+ * \param [in] maxSize The size of the buffer.
+ * \param [in] tid The type of the tag.
+ * \param [in] data The serialized tag.
+ * \param [in] dataSize The size of the serialized tag.
+ * \returns False if the buffer is too small.
+ */
+static bool
+SerializeTag (uint32_t *&p, uint32_t &size, uint32_t maxSize,
+              TypeId tid, const uint8_t *data, uint32_t dataSize)
+{
+  if (size + 4 <= maxSize)
+    {
+      *p++ = dataSize;
+      size += 4;
+    }
+  else
+    {
+      return false;
+    }
+
+  NS_LOG_INFO("Serializing tag id " << tid);
+
+  // ensure size is multiple of 4 bytes for 4 byte boundaries
+  uint32_t hashSize = (sizeof (TypeId::hash_t)+3) & (~3);
+  if (size + hashSize <= maxSize)
+    {
+      TypeId::hash_t hash = tid.GetHash ();
+      memcpy (p, &hash, sizeof (TypeId::hash_t));
+      p += hashSize / 4;
+      size += hashSize;
+    }
+  else
+    {
+      return false;
+    }
+
+  // ensure size is multiple of 4 bytes for 4 byte boundaries
+  uint32_t tagWordSize = (dataSize+3) & (~3);
+  if (size + tagWordSize <= maxSize)
+    {
+      memcpy (p, data, dataSize);
+      size += tagWordSize;
+      p += tagWordSize / 4;
+    }
+  else
+    {
+      return false;
+    }
+  return true;
+}
+
 uint32_t
 PacketTagList::Serialize (uint32_t* buffer, uint32_t maxSize) const
 {
@@ -346,47 +506,25 @@ PacketTagList::Serialize (uint32_t* buffer, uint32_t maxSize) const
       return 0;
     }
 
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  uint32_t offset = 0;
+  TypeId tid;
+  const uint8_t *data;
+  uint32_t dataSize;
+  while (NextInline (offset, tid, data, dataSize))
     {
-      if (size + 4 <= maxSize)
-        {
-          *p++ = cur->size;
-          size += 4;
-        }
-      else
+      if (!SerializeTag (p, size, maxSize, tid, data, dataSize))
         {
           return 0;
         }
+      (*numberOfTags)++;
+    }
 
-      NS_LOG_INFO("Serializing tag id " << cur->tid);
-
-      // ensure size is multiple of 4 bytes for 4 byte boundaries
-      uint32_t hashSize = (sizeof (TypeId::hash_t)+3) & (~3);
-      if (size + hashSize <= maxSize)
-        {
-          TypeId::hash_t tid = cur->tid.GetHash ();
-          memcpy (p, &tid, sizeof (TypeId::hash_t));
-          p += hashSize / 4;
-          size += hashSize;
-        }
-      else
-        {
-          return 0;
-        }
-
-      // ensure size is multiple of 4 bytes for 4 byte boundaries
-      uint32_t tagWordSize = (cur->size+3) & (~3);
-      if (size + tagWordSize <= maxSize)
-        {
-          memcpy (p, cur->data, cur->size);
-          size += tagWordSize;
-          p += tagWordSize / 4;
-        }
-      else
+  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+    {
+      if (!SerializeTag (p, size, maxSize, cur->tid, cur->data, cur->size))
         {
           return 0;
         }
-
       (*numberOfTags)++;
     }
 
@@ -26,8 +26,10 @@
 */
 
 #include <stdint.h>
+#include <cstring>
 #include <ostream>
 #include "ns3/type-id.h"
+#include "ns3/per-thread-pool.h"
 
 namespace ns3 {
 
@@ -119,6 +121,18 @@ class Tag;
  *       The portion of the list between the first branch and the target is
  *       shared. This portion is copied before the #Remove or #Replace is
  *       performed.
+ *
+ * \par <b> Inline tags </b>
+ *
+ *   - Small tags (at most #MAX_INLINE_TAG_SIZE bytes) are not put in the
+ *     tree but serialized into a fixed area of #INLINE_SIZE bytes inside
+ *     the PacketTagList itself, as records made of the TypeId uid (two
+ *     bytes), the tag size (one byte) and the tag data.  Adding, peeking
+ *     and removing the usual socket and flow tags therefore never
+ *     allocates, and copies of the list copy the records.
+ *
+ *   - Tags which are larger, or which do not fit in the area any more,
+ *     spill into the tree described above.
  */
 class PacketTagList 
 {
@@ -147,6 +161,23 @@ public:
     uint8_t data[1];            /**< Serialization buffer */
   };  /* struct TagData */
 
+  /**
+   * Tags serialized in at most this many bytes, i.e. almost all of
+   * them, are stored in fixed-size blocks recycled through a
+   * PerThreadPool.
+   */
+  static const uint32_t POOLED_TAG_SIZE = 24;
+  /** Largest number of released TagData blocks kept by each thread. */
+  static const uint32_t MAX_POOLED_TAGS = 1000;
+  /** Released TagData blocks of POOLED_TAG_SIZE bytes of data. */
+  typedef PerThreadPool<TagData, MAX_POOLED_TAGS> TagDataPool;
+  /** Bytes of tag records stored inside the PacketTagList. */
+  static const uint32_t INLINE_SIZE = 64;
+  /** Tags serialized in at most this many bytes may be stored inline. */
+  static const uint32_t MAX_INLINE_TAG_SIZE = 32;
+  /** Bytes of each inline record preceding the tag data. */
+  static const uint32_t INLINE_TAG_HEADER = 3;
+
   /**
    * Create a new PacketTagList.
    */
@@ -215,8 +246,26 @@ public:
   inline void RemoveAll (void);
   /**
    * \returns pointer to head of tag list
+   *
+   * The tags stored inline are not part of this list, see #NextInline.
    */
   const struct PacketTagList::TagData *Head (void) const;
+  /**
+   * Read an inline tag record.
+   *
+   * \param [in,out] offset The offset of the record, zero for the first
+   *        one.  Advanced to the next record.
+   * \param [out] tid The type of the tag.
+   * \param [out] data The serialized tag.
+   * \param [out] size The size of the serialized tag.
+   * \returns False if there is no record at \pname{offset}.
+   */
+  inline bool NextInline (uint32_t &offset, TypeId &tid,
+                          const uint8_t *&data, uint32_t &size) const;
+  /**
+   * \returns the number of bytes used by the inline tag records
+   */
+  inline uint32_t GetInlineSize (void) const;
   /**
    * Returns number of bytes required for packet serialization.
    *
@@ -252,6 +301,13 @@ private:
    */
   static
   TagData * CreateTagData (size_t dataSize);
+  /**
+   * Destroy and release a TagData struct created by CreateTagData.
+   *
+   * \param [in] tag The TagData to release.
+   */
+  static
+  void FreeTagData (TagData * tag);
   
   /**
    * Typedef of method function pointer for copy-on-write operations
@@ -301,11 +357,26 @@ private:
    */
   bool ReplaceWriter (Tag & tag, bool preMerge,
                       struct TagData * cur, struct TagData ** prevNext);
+  /**
+   * Find an inline tag record.
+   *
+   * \param [in] tid The tag type to find.
+   * \returns The offset of the record, or #m_inlineUsed if not found.
+   */
+  uint32_t FindInline (TypeId tid) const;
+  /**
+   * Remove an inline tag record.
+   *
+   * \param [in] offset The offset of the record.
+   */
+  void RemoveInline (uint32_t offset);
 
   /**
    * Pointer to first \ref TagData on the list
    */
   struct TagData *m_next;
+  uint8_t m_inlineUsed;              //!< Bytes used in m_inline
+  uint8_t m_inline[INLINE_SIZE];     //!< Inline tag records
 };
 
 } // namespace ns3
@@ -317,13 +388,16 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_next (),
+    m_inlineUsed (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_next (o.m_next),
+    m_inlineUsed (o.m_inlineUsed)
 {
+  std::memcpy (m_inline, o.m_inline, m_inlineUsed);
   if (m_next != 0)
     {
       m_next->count++;
@@ -334,16 +408,21 @@ PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (this == &o)
     {
       return *this;
     }
-  RemoveAll ();
-  m_next = o.m_next;
-  if (m_next != 0) 
+  if (m_next != o.m_next)
     {
-      m_next->count++;
+      RemoveAll ();
+      m_next = o.m_next;
+      if (m_next != 0)
+        {
+          m_next->count++;
+        }
     }
+  m_inlineUsed = o.m_inlineUsed;
+  std::memcpy (m_inline, o.m_inline, m_inlineUsed);
   return *this;
 }
 
@@ -365,17 +444,40 @@ PacketTagList::RemoveAll (void)
         }
       if (prev != 0) 
         {
-          prev->~TagData ();
-          std::free (prev);
+          FreeTagData (prev);
         }
       prev = cur;
     }
   if (prev != 0) 
     {
-      prev->~TagData ();
-      std::free (prev);
+      FreeTagData (prev);
     }
   m_next = 0;
+  m_inlineUsed = 0;
+}
+
+uint32_t
+PacketTagList::GetInlineSize (void) const
+{
+  return m_inlineUsed;
+}
+
+bool
+PacketTagList::NextInline (uint32_t &offset, TypeId &tid,
+                           const uint8_t *&data, uint32_t &size) const
+{
+  if (offset >= m_inlineUsed)
+    {
+      return false;
+    }
+  const uint8_t *record = m_inline + offset;
+  uint16_t uid;
+  std::memcpy (&uid, record, 2);
+  tid.SetUid (uid);
+  size = record[2];
+  data = record + INLINE_TAG_HEADER;
+  offset += INLINE_TAG_HEADER + size;
+  return true;
 }
 
 } // namespace ns3
@@ -21,6 +21,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/per-thread-pool.h"
 #include <string>
 #include <cstdarg>
 
@@ -28,7 +29,34 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
-uint32_t Packet::m_globalUid = 0;
+std::atomic<uint32_t> Packet::m_globalUid (0);
+bool Packet::m_structuredHeaders = false;
+
+/// Released Packet objects
+typedef PerThreadPool<Packet, Packet::MAX_POOLED_PACKETS> PacketPool;
+
+void *
+Packet::operator new (std::size_t size)
+{
+  if (size == sizeof (Packet))
+    {
+      Packet *p = PacketPool::Pop ();
+      if (p != 0)
+        {
+          return p;
+        }
+    }
+  return ::operator new (size);
+}
+
+void
+Packet::operator delete (void *p, std::size_t size)
+{
+  if (size != sizeof (Packet) || !PacketPool::Push (static_cast<Packet *> (p)))
+    {
+      ::operator delete (p);
+    }
+}
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -81,39 +109,50 @@ ByteTagIterator::ByteTagIterator (ByteTagList::Iterator i)
 }
 
 
-PacketTagIterator::PacketTagIterator (const struct PacketTagList::TagData *head)
-  : m_current (head)
+PacketTagIterator::PacketTagIterator (const PacketTagList *list)
+  : m_list (list),
+    m_inlineOffset (0),
+    m_current (list->Head ())
 {
 }
 bool
 PacketTagIterator::HasNext (void) const
 {
-  return m_current != 0;
+  return m_inlineOffset < m_list->GetInlineSize () || m_current != 0;
 }
 PacketTagIterator::Item
 PacketTagIterator::Next (void)
 {
   NS_ASSERT (HasNext ());
+  TypeId tid;
+  const uint8_t *data;
+  uint32_t size;
+  if (m_list->NextInline (m_inlineOffset, tid, data, size))
+    {
+      return PacketTagIterator::Item (tid, data, size);
+    }
   const struct PacketTagList::TagData *prev = m_current;
   m_current = m_current->next;
-  return PacketTagIterator::Item (prev);
+  return PacketTagIterator::Item (prev->tid, prev->data, prev->size);
 }
 
-PacketTagIterator::Item::Item (const struct PacketTagList::TagData *data)
-  : m_data (data)
+PacketTagIterator::Item::Item (TypeId tid, const uint8_t *data, uint32_t size)
+  : m_tid (tid),
+    m_data (data),
+    m_size (size)
 {
 }
 TypeId
 PacketTagIterator::Item::GetTypeId (void) const
 {
-  return m_data->tid;
+  return m_tid;
 }
 void
 PacketTagIterator::Item::GetTag (Tag &tag) const
 {
-  NS_ASSERT (tag.GetInstanceTypeId () == m_data->tid);
-  tag.Deserialize (TagBuffer ((uint8_t*)m_data->data,
-                              (uint8_t*)m_data->data + m_data->size));
+  NS_ASSERT (tag.GetInstanceTypeId () == m_tid);
+  tag.Deserialize (TagBuffer ((uint8_t*)m_data,
+                              (uint8_t*)m_data + m_size));
 }
 
 
@@ -136,20 +175,27 @@ Packet::Packet ()
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
-    m_nixVector (0)
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++, 0),
+    m_nixVector (0),
+    m_nHeaders (0),
+    m_headersSize (0)
 {
-  m_globalUid++;
 }
 
 Packet::Packet (const Packet &o)
   : m_buffer (o.m_buffer),
     m_byteTagList (o.m_byteTagList),
     m_packetTagList (o.m_packetTagList),
-    m_metadata (o.m_metadata)
+    m_metadata (o.m_metadata),
+    m_nHeaders (o.m_nHeaders),
+    m_headersSize (o.m_headersSize)
 {
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy ()
     : m_nixVector = 0;
+  for (uint32_t i = 0; i < m_nHeaders; ++i)
+    {
+      m_headers[i] = o.m_headers[i];
+    }
 }
 
 Packet &
@@ -165,6 +211,12 @@ Packet::operator = (const Packet &o)
   m_metadata = o.m_metadata;
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy () 
     : m_nixVector = 0;
+  for (uint32_t i = 0; i < MAX_STRUCTURED_HEADERS; ++i)
+    {
+      m_headers[i] = o.m_headers[i];
+    }
+  m_nHeaders = o.m_nHeaders;
+  m_headersSize = o.m_headersSize;
   return *this;
 }
 
@@ -178,17 +230,20 @@ Packet::Packet (uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
-    m_nixVector (0)
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++, size),
+    m_nixVector (0),
+    m_nHeaders (0),
+    m_headersSize (0)
 {
-  m_globalUid++;
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
     m_byteTagList (),
     m_packetTagList (),
     m_metadata (0,0),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_nHeaders (0),
+    m_headersSize (0)
 {
   NS_ASSERT (magic);
   Deserialize (buffer, size);
@@ -204,10 +259,11 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
-    m_nixVector (0)
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++, size),
+    m_nixVector (0),
+    m_nHeaders (0),
+    m_headersSize (0)
 {
-  m_globalUid++;
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
@@ -219,7 +275,9 @@ Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList,
     m_byteTagList (byteTagList),
     m_packetTagList (packetTagList),
     m_metadata (metadata),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_nHeaders (0),
+    m_headersSize (0)
 {
 }
 
@@ -227,11 +285,12 @@ Ptr<Packet>
 Packet::CreateFragment (uint32_t start, uint32_t length) const
 {
   NS_LOG_FUNCTION (this << start << length);
-  Buffer buffer = m_buffer.CreateFragment (start, length);
+  Buffer flat = GetFlatBuffer ();
+  Buffer buffer = flat.CreateFragment (start, length);
   ByteTagList byteTagList = m_byteTagList;
   byteTagList.Adjust (-start);
-  NS_ASSERT (m_buffer.GetSize () >= start + length);
-  uint32_t end = m_buffer.GetSize () - (start + length);
+  NS_ASSERT (flat.GetSize () >= start + length);
+  uint32_t end = flat.GetSize () - (start + length);
   PacketMetadata metadata = m_metadata.CreateFragment (start, end);
   // again, call the constructor directly rather than
   // through Create because it is private.
@@ -252,11 +311,57 @@ Packet::GetNixVector (void) const
   return m_nixVector;
 } 
 
+void
+Packet::PushHeader (Ptr<const StructuredHeaderEntry> entry)
+{
+  const Header &header = entry->GetHeader ();
+  uint32_t size = entry->GetSize ();
+  NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
+  m_byteTagList.Adjust (size);
+  m_byteTagList.AddAtStart (size);
+  m_metadata.AddHeader (header, size);
+  m_headers[m_nHeaders++] = entry;
+  m_headersSize += size;
+}
+uint32_t
+Packet::PopHeader (void)
+{
+  NS_ASSERT (m_nHeaders != 0);
+  Ptr<const StructuredHeaderEntry> entry = m_headers[--m_nHeaders];
+  m_headers[m_nHeaders] = 0;
+  const Header &header = entry->GetHeader ();
+  uint32_t size = entry->GetSize ();
+  NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
+  m_headersSize -= size;
+  m_byteTagList.Adjust (-size);
+  m_metadata.RemoveHeader (header, size);
+  return size;
+}
+void
+Packet::SerializeHeaders (Buffer &buffer) const
+{
+  // the first entry is the innermost header: checksums computed by
+  // Serialize cover the bytes behind the header
+  for (uint32_t i = 0; i < m_nHeaders; ++i)
+    {
+      buffer.AddAtStart (m_headers[i]->GetSize ());
+      m_headers[i]->GetHeader ().Serialize (buffer.Begin ());
+    }
+}
+Buffer
+Packet::GetFlatBuffer (void) const
+{
+  Buffer buffer = m_buffer;
+  SerializeHeaders (buffer);
+  return buffer;
+}
+
 void
 Packet::AddHeader (const Header &header)
 {
   uint32_t size = header.GetSerializedSize ();
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
+  Materialize ();
   m_buffer.AddAtStart (size);
   m_byteTagList.Adjust (size);
   m_byteTagList.AddAtStart (size);
@@ -266,6 +371,7 @@ Packet::AddHeader (const Header &header)
 uint32_t
 Packet::RemoveHeader (Header &header, uint32_t size)
 {
+  Materialize ();
   Buffer::Iterator end;
   end = m_buffer.Begin ();
   end.Next (size);
@@ -279,6 +385,7 @@ Packet::RemoveHeader (Header &header, uint32_t size)
 uint32_t
 Packet::RemoveHeader (Header &header)
 {
+  Materialize ();
   uint32_t deserialized = header.Deserialize (m_buffer.Begin ());
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << deserialized);
   m_buffer.RemoveAtStart (deserialized);
@@ -289,6 +396,11 @@ Packet::RemoveHeader (Header &header)
 uint32_t
 Packet::PeekHeader (Header &header) const
 {
+  if (m_nHeaders != 0)
+    {
+      Buffer flat = GetFlatBuffer ();
+      return header.Deserialize (flat.Begin ());
+    }
   uint32_t deserialized = header.Deserialize (m_buffer.Begin ());
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << deserialized);
   return deserialized;
@@ -296,10 +408,11 @@ Packet::PeekHeader (Header &header) const
 uint32_t
 Packet::PeekHeader (Header &header, uint32_t size) const
 {
+  Buffer flat = m_nHeaders != 0 ? GetFlatBuffer () : m_buffer;
   Buffer::Iterator end;
-  end = m_buffer.Begin ();
+  end = flat.Begin ();
   end.Next (size);
-  uint32_t deserialized = header.Deserialize (m_buffer.Begin (), end);
+  uint32_t deserialized = header.Deserialize (flat.Begin (), end);
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << deserialized);
   return deserialized;
 }
@@ -308,6 +421,7 @@ Packet::AddTrailer (const Trailer &trailer)
 {
   uint32_t size = trailer.GetSerializedSize ();
   NS_LOG_FUNCTION (this << trailer.GetInstanceTypeId ().GetName () << size);
+  Materialize ();
   m_byteTagList.AddAtEnd (GetSize ());
   m_buffer.AddAtEnd (size);
   Buffer::Iterator end = m_buffer.End ();
@@ -317,6 +431,7 @@ Packet::AddTrailer (const Trailer &trailer)
 uint32_t
 Packet::RemoveTrailer (Trailer &trailer)
 {
+  Materialize ();
   uint32_t deserialized = trailer.Deserialize (m_buffer.End ());
   NS_LOG_FUNCTION (this << trailer.GetInstanceTypeId ().GetName () << deserialized);
   m_buffer.RemoveAtEnd (deserialized);
@@ -335,18 +450,20 @@ void
 Packet::AddAtEnd (Ptr<const Packet> packet)
 {
   NS_LOG_FUNCTION (this << packet << packet->GetSize ());
+  Materialize ();
   m_byteTagList.AddAtEnd (GetSize ());
   ByteTagList copy = packet->m_byteTagList;
   copy.AddAtStart (0);
   copy.Adjust (GetSize ());
   m_byteTagList.Add (copy);
-  m_buffer.AddAtEnd (packet->m_buffer);
+  m_buffer.AddAtEnd (packet->m_nHeaders != 0 ? packet->GetFlatBuffer () : packet->m_buffer);
   m_metadata.AddAtEnd (packet->m_metadata);
 }
 void
 Packet::AddPaddingAtEnd (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  Materialize ();
   m_byteTagList.AddAtEnd (GetSize ());
   m_buffer.AddAtEnd (size);
   m_metadata.AddPaddingAtEnd (size);
@@ -355,6 +472,7 @@ void
 Packet::RemoveAtEnd (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  Materialize ();
   m_buffer.RemoveAtEnd (size);
   m_metadata.RemoveAtEnd (size);
 }
@@ -362,6 +480,7 @@ void
 Packet::RemoveAtStart (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  Materialize ();
   m_buffer.RemoveAtStart (size);
   m_byteTagList.Adjust (-size);
   m_metadata.RemoveAtStart (size);
@@ -377,12 +496,20 @@ Packet::RemoveAllByteTags (void)
 uint32_t 
 Packet::CopyData (uint8_t *buffer, uint32_t size) const
 {
+  if (m_nHeaders != 0)
+    {
+      return GetFlatBuffer ().CopyData (buffer, size);
+    }
   return m_buffer.CopyData (buffer, size);
 }
 
 void
 Packet::CopyData (std::ostream *os, uint32_t size) const
 {
+  if (m_nHeaders != 0)
+    {
+      return GetFlatBuffer ().CopyData (os, size);
+    }
   return m_buffer.CopyData (os, size);
 }
 
@@ -433,7 +560,7 @@ Packet::ToString() const
 void 
 Packet::Print (std::ostream &os) const
 {
-  PacketMetadata::ItemIterator i = m_metadata.BeginItem (m_buffer);
+  PacketMetadata::ItemIterator i = m_metadata.BeginItem (GetFlatBuffer ());
   while (i.HasNext ())
     {
       PacketMetadata::Item item = i.Next ();
@@ -565,7 +692,7 @@ Packet::Print (std::ostream &os) const
 PacketMetadata::ItemIterator 
 Packet::BeginItem (void) const
 {
-  return m_metadata.BeginItem (m_buffer);
+  return m_metadata.BeginItem (GetFlatBuffer ());
 }
 
 void
@@ -582,6 +709,20 @@ Packet::EnableChecking (void)
   PacketMetadata::EnableChecking ();
 }
 
+void
+Packet::EnableStructuredHeaders (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_structuredHeaders = true;
+}
+
+void
+Packet::DisableStructuredHeaders (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_structuredHeaders = false;
+}
+
 uint32_t Packet::GetSerializedSize (void) const
 {
   uint32_t size = 0;
@@ -626,7 +767,7 @@ uint32_t Packet::GetSerializedSize (void) const
 
   // increment total size by size of buffer 
   // ensuring 4-byte boundary
-  size += ((m_buffer.GetSerializedSize () + 3) & (~3));
+  size += ((GetFlatBuffer ().GetSerializedSize () + 3) & (~3));
 
   // add 4-bytes for entry of total length of buffer 
   size += 4;
@@ -772,7 +913,8 @@ Packet::Serialize (uint8_t* buffer, uint32_t maxSize) const
     }
 
   // Serialize the packet contents
-  uint32_t bufSize = m_buffer.GetSerializedSize ();
+  Buffer flat = GetFlatBuffer ();
+  uint32_t bufSize = flat.GetSerializedSize ();
   if (size + bufSize <= maxSize)
     {
       // put the total length of the buffer in the
@@ -781,7 +923,7 @@ Packet::Serialize (uint8_t* buffer, uint32_t maxSize) const
       *p++ = bufSize + 4;
 
       // serialize the buffer
-      uint32_t serialized = m_buffer.Serialize (reinterpret_cast<uint8_t *> (p), bufSize);
+      uint32_t serialized = flat.Serialize (reinterpret_cast<uint8_t *> (p), bufSize);
       if (!serialized)
         {
           return 0;
@@ -1013,7 +1155,7 @@ Packet::PrintPacketTags (std::ostream &os) const
 PacketTagIterator 
 Packet::GetPacketTagIterator (void) const
 {
-  return PacketTagIterator (m_packetTagList.Head ());
+  return PacketTagIterator (&m_packetTagList);
 }
 
 std::ostream& operator<< (std::ostream& os, const Packet &packet)
@@ -21,6 +21,9 @@
 #define PACKET_H
 
 #include <stdint.h>
+#include <cstddef>
+#include <atomic>
+#include <type_traits>
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -39,6 +42,69 @@ namespace ns3 {
 
 // Forward declaration
 class Address;
+
+/**
+ * \ingroup packet
+ *
+ * \brief A header held by a Packet as an object rather than as bytes.
+ *
+ * See Packet::EnableStructuredHeaders.  Entries are never modified
+ * once created, so copies of a packet share them.
+ */
+class StructuredHeaderEntry : public SimpleRefCount<StructuredHeaderEntry>
+{
+public:
+  /**
+   * \param size the serialized size of the header
+   */
+  StructuredHeaderEntry (uint32_t size)
+    : m_size (size)
+  {
+  }
+  virtual ~StructuredHeaderEntry ()
+  {
+  }
+  /**
+   * \returns the header
+   */
+  virtual const Header & GetHeader (void) const = 0;
+  /**
+   * \returns the serialized size of the header
+   */
+  uint32_t GetSize (void) const
+  {
+    return m_size;
+  }
+private:
+  uint32_t m_size; //!< serialized size of the header
+};
+
+/**
+ * \ingroup packet
+ *
+ * \brief The StructuredHeaderEntry of a header of type T.
+ *
+ * \tparam T \explicit the header class
+ */
+template <typename T>
+class StructuredHeaderItem : public StructuredHeaderEntry
+{
+public:
+  /**
+   * \param header the header to copy
+   * \param size the serialized size of the header
+   */
+  StructuredHeaderItem (const T &header, uint32_t size)
+    : StructuredHeaderEntry (size),
+      m_header (header)
+  {
+  }
+  virtual const Header & GetHeader (void) const
+  {
+    return m_header;
+  }
+  T m_header; //!< the copy of the header
+};
   
 /**
  * \ingroup network
@@ -155,10 +221,14 @@ private:
     friend class PacketTagIterator;
     /**
      * Constructor
-     * \param data the data to copy.
+     * \param tid the type of the tag.
+     * \param data the serialized tag.
+     * \param size the size of the serialized tag.
      */
-    Item (const struct PacketTagList::TagData *data);
-    const struct PacketTagList::TagData *m_data; //!< the tag data
+    Item (TypeId tid, const uint8_t *data, uint32_t size);
+    TypeId m_tid;          //!< the type of the tag
+    const uint8_t *m_data; //!< the serialized tag
+    uint32_t m_size;       //!< the size of the serialized tag
   };
   /**
    * \returns true if calling Next is safe, false otherwise.
@@ -173,9 +243,11 @@ private:
   friend class Packet;
   /**
    * Constructor
-   * \param head head of the items
+   * \param list the tags of the packet
    */
-  PacketTagIterator (const struct PacketTagList::TagData *head);
+  PacketTagIterator (const PacketTagList *list);
+  const PacketTagList *m_list;    //!< the tags of the packet
+  uint32_t m_inlineOffset;        //!< position over the tags stored inline
   const struct PacketTagList::TagData *m_current;  //!< actual position over the set of tags in a packet
 };
 
@@ -356,6 +428,48 @@ public:
    * \returns the number of bytes read from the packet.
    */
   uint32_t PeekHeader (Header &header, uint32_t size) const;
+  /**
+   * \brief Add a header which may be kept unserialized.
+   *
+   * Used for the header types for which IsStructuredHeader is true.
+   * When structured headers are enabled, the packet keeps a copy of
+   * the header and serializes it only when its bytes are needed.
+   * Otherwise, the header is serialized as by AddHeader (const Header &).
+   *
+   * \tparam T \deduced the header class
+   * \param header a reference to the header to add to this packet.
+   */
+  template <typename T>
+  typename std::enable_if<IsStructuredHeader<T>::value>::type
+  AddHeader (const T &header);
+  /**
+   * \brief Remove a header which may be kept unserialized.
+   *
+   * If the first header of the packet is a copy of a T header, it is
+   * assigned to \p header, unless \p header verifies a checksum (see
+   * IsStructuredHeader).  Otherwise the header is deserialized.
+   *
+   * \tparam T \deduced the header class
+   * \param header a reference to the header to remove from the packet.
+   * \returns the number of bytes removed from the packet.
+   */
+  template <typename T>
+  typename std::enable_if<IsStructuredHeader<T>::value, uint32_t>::type
+  RemoveHeader (T &header);
+  /**
+   * \brief Read a header which may be kept unserialized.
+   *
+   * If the first header of the packet is a copy of a T header, it is
+   * assigned to \p header, unless \p header verifies a checksum (see
+   * IsStructuredHeader).  Otherwise the header is deserialized.
+   *
+   * \tparam T \deduced the header class
+   * \param header a reference to the header to read from the packet.
+   * \returns the number of bytes read from the packet.
+   */
+  template <typename T>
+  typename std::enable_if<IsStructuredHeader<T>::value, uint32_t>::type
+  PeekHeader (T &header) const;
   /**
    * \brief Add trailer to this packet.
    *
@@ -530,6 +644,48 @@ public:
    * errors will be detected and will abort the program.
    */
   static void EnableChecking (void);
+  /**
+   * \brief Keep headers as objects instead of bytes.
+   *
+   * The headers for which IsStructuredHeader is true are then copied in
+   * a small stack at the front of the packet instead of being
+   * serialized, and the next node gets them back by a copy instead of
+   * parsing them.  The bytes of the headers are produced only when they
+   * are needed: by CopyData, CreateFragment, Print, the Packet
+   * serialization, or when another header or trailer is added or
+   * removed.  The contents of the packets, hence the results, are the
+   * same in both modes; only pcap traces and checksums cost more since
+   * each of them serializes the headers.
+   *
+   * Call it during the simulation setup, before any packet is created.
+   */
+  static void EnableStructuredHeaders (void);
+  /**
+   * \brief Serialize all headers, which is the default.
+   */
+  static void DisableStructuredHeaders (void);
+
+  /**
+   * \brief Allocate a packet from the packet pool.
+   *
+   * Packets are created and released for every segment sent, so the
+   * released Packet objects are kept in a PerThreadPool, up to
+   * MAX_POOLED_PACKETS of them, and reused by the next allocations.
+   *
+   * \param [in] size The size of the object.
+   * \returns Storage for the packet.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * \brief Return a packet to the packet pool.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the object.
+   */
+  static void operator delete (void *p, std::size_t size);
+
+  /** Largest number of released packets kept by each thread. */
+  static const uint32_t MAX_POOLED_PACKETS = 1000;
 
   /**
    * \brief Returns number of bytes required for packet
@@ -779,6 +935,33 @@ private:
    */
   uint32_t Deserialize (uint8_t const*buffer, uint32_t size);
 
+  /**
+   * \brief Push a header copy on the structured header stack.
+   * \param entry the copy of the header
+   */
+  void PushHeader (Ptr<const StructuredHeaderEntry> entry);
+  /**
+   * \brief Pop the first structured header.
+   * \returns the serialized size of the header
+   */
+  uint32_t PopHeader (void);
+  /**
+   * \brief Serialize the structured headers into a buffer.
+   * \param buffer the buffer, which the headers are added to the front of
+   */
+  void SerializeHeaders (Buffer &buffer) const;
+  /**
+   * \returns the buffer with the structured headers serialized
+   */
+  Buffer GetFlatBuffer (void) const;
+  /**
+   * \brief Serialize the structured headers into the packet buffer.
+   */
+  inline void Materialize (void);
+
+  /** Number of headers a packet can hold unserialized */
+  static const uint32_t MAX_STRUCTURED_HEADERS = 4;
+
   Buffer m_buffer;                //!< the packet buffer (it's actual contents)
   ByteTagList m_byteTagList;      //!< the ByteTag list
   PacketTagList m_packetTagList;  //!< the packet's Tag list
@@ -787,7 +970,13 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  /// Structured headers in front of m_buffer, the first one innermost
+  Ptr<const StructuredHeaderEntry> m_headers[MAX_STRUCTURED_HEADERS];
+  uint32_t m_nHeaders;            //!< Number of structured headers
+  uint32_t m_headersSize;         //!< Serialized size of the structured headers
+
+  static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+  static bool m_structuredHeaders; //!< Keep headers as objects when possible
 };
 
 /**
@@ -851,7 +1040,68 @@ namespace ns3 {
 uint32_t 
 Packet::GetSize (void) const
 {
-  return m_buffer.GetSize ();
+  return m_buffer.GetSize () + m_headersSize;
+}
+
+void
+Packet::Materialize (void)
+{
+  if (m_nHeaders != 0)
+    {
+      SerializeHeaders (m_buffer);
+      for (uint32_t i = 0; i < m_nHeaders; ++i)
+        {
+          m_headers[i] = 0;
+        }
+      m_nHeaders = 0;
+      m_headersSize = 0;
+    }
+}
+
+template <typename T>
+typename std::enable_if<IsStructuredHeader<T>::value>::type
+Packet::AddHeader (const T &header)
+{
+  if (!m_structuredHeaders || m_nHeaders == MAX_STRUCTURED_HEADERS)
+    {
+      AddHeader (static_cast<const Header &> (header));
+      return;
+    }
+  PushHeader (Ptr<const StructuredHeaderEntry> (new StructuredHeaderItem<T> (header, header.GetSerializedSize ()), false));
+}
+
+template <typename T>
+typename std::enable_if<IsStructuredHeader<T>::value, uint32_t>::type
+Packet::RemoveHeader (T &header)
+{
+  if (m_nHeaders != 0 && !IsStructuredHeader<T>::NeedsBytes (header))
+    {
+      const StructuredHeaderItem<T> *item =
+        dynamic_cast<const StructuredHeaderItem<T> *> (PeekPointer (m_headers[m_nHeaders - 1]));
+      if (item != 0)
+        {
+          header = item->m_header;
+          return PopHeader ();
+        }
+    }
+  return RemoveHeader (static_cast<Header &> (header));
+}
+
+template <typename T>
+typename std::enable_if<IsStructuredHeader<T>::value, uint32_t>::type
+Packet::PeekHeader (T &header) const
+{
+  if (m_nHeaders != 0 && !IsStructuredHeader<T>::NeedsBytes (header))
+    {
+      const StructuredHeaderItem<T> *item =
+        dynamic_cast<const StructuredHeaderItem<T> *> (PeekPointer (m_headers[m_nHeaders - 1]));
+      if (item != 0)
+        {
+          header = item->m_header;
+          return item->GetSize ();
+        }
+    }
+  return PeekHeader (static_cast<Header &> (header));
 }
 
 } // namespace ns3
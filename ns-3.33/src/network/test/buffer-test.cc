@@ -387,6 +387,52 @@ BufferTest::DoRun (void)
   val2 <<= 8;
   val2 |= i.ReadU8 ();
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
+
+  // Concatenations keep the zero areas virtual.  The serialized
+  // size covers the 12 byte header and the real bytes only.
+  buffer = Buffer (1000);
+  buffer.AddAtStart (2);
+  i = buffer.Begin ();
+  i.WriteU8 (0x1);
+  i.WriteU8 (0x2);
+  Buffer shared = buffer;
+  buffer.AddAtEnd (Buffer (1000));
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSize (), 2002, "zero area not appended");
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSerializedSize (), 16, "zero area copied");
+  NS_TEST_ASSERT_MSG_EQ (shared.GetSize (), 1002, "shared buffer modified");
+  Buffer real;
+  real.AddAtStart (3);
+  i = real.Begin ();
+  i.WriteU8 (0x3);
+  i.WriteU8 (0x4);
+  i.WriteU8 (0x5);
+  buffer.AddAtEnd (real);
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSize (), 2005, "real bytes not appended");
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSerializedSize (), 20, "zero area copied");
+  frag0 = buffer.CreateFragment (0, 500);
+  frag1 = buffer.CreateFragment (500, 1505);
+  frag0.AddAtEnd (frag1);
+  NS_TEST_ASSERT_MSG_EQ (frag0.GetSize (), 2005, "fragments not merged");
+  NS_TEST_ASSERT_MSG_EQ (frag0.GetSerializedSize (), 20, "zero area copied");
+  i = frag0.Begin ();
+  NS_TEST_ASSERT_MSG_EQ (i.ReadU8 (), 0x1, "bad merged byte");
+  NS_TEST_ASSERT_MSG_EQ (i.ReadU8 (), 0x2, "bad merged byte");
+  i = frag0.End ();
+  i.Prev (3);
+  NS_TEST_ASSERT_MSG_EQ (i.ReadU8 (), 0x3, "bad merged byte");
+  NS_TEST_ASSERT_MSG_EQ (i.ReadU8 (), 0x4, "bad merged byte");
+  NS_TEST_ASSERT_MSG_EQ (i.ReadU8 (), 0x5, "bad merged byte");
+  real.AddAtEnd (Buffer (1000));
+  NS_TEST_ASSERT_MSG_EQ (real.GetSize (), 1003, "zero area not appended");
+  NS_TEST_ASSERT_MSG_EQ (real.GetSerializedSize (), 16, "zero area copied");
+  i = real.Begin ();
+  NS_TEST_ASSERT_MSG_EQ (i.ReadU8 (), 0x3, "bad prepended byte");
+  frag0.AddAtEnd (frag0);
+  NS_TEST_ASSERT_MSG_EQ (frag0.GetSize (), 4010, "self append");
+  i = frag0.End ();
+  i.Prev (2006);
+  NS_TEST_ASSERT_MSG_EQ (i.ReadU8 (), 0x5, "bad self appended byte");
+  NS_TEST_ASSERT_MSG_EQ (i.ReadU8 (), 0x1, "bad self appended byte");
 }
 
 /**
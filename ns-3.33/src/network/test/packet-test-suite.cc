@@ -887,6 +887,11 @@ private:
   void CheckRefList (const PacketTagList & ref,
                      const char * msg,
                      int miss = 0);
+  /**
+   * Checks copy, removal and replacement of the test tags
+   * \param ref Reference holding the test tags
+   */
+  void CheckOperations (const PacketTagList & ref);
 
   /**
    * Prints the remove time
@@ -1008,21 +1013,10 @@ PacketTagListTest::AddRemoveTime (const bool verbose /* = false */)
 }
 
 void
-PacketTagListTest::DoRun (void)
+PacketTagListTest::CheckOperations (const PacketTagList & ref)
 {
-  std::cout << GetName () << "begin" << std::endl;
-
   MAKE_TEST_TAGS ;
-  
-  PacketTagList ref;  // empty list
-  ref.Add (t1);       // last
-  ref.Add (t2);       // post merge
-  ref.Add (t3);       // merge successor
-  ref.Add (t4);       // merge
-  ref.Add (t5);       // merge precursor
-  ref.Add (t6);       // pre-merge
-  ref.Add (t7);       // first
-  
+
   { // Peek
     std::cout << GetName () << "check Peek (missing tag) returns false"
               << std::endl;
@@ -1108,7 +1102,80 @@ PacketTagListTest::DoRun (void)
     ReplaceCheck (6);
     ReplaceCheck (7);
   }
+}
+
+void
+PacketTagListTest::DoRun (void)
+{
+  std::cout << GetName () << "begin" << std::endl;
+
+  MAKE_TEST_TAGS ;
   
+  PacketTagList ref;  // empty list
+  ref.Add (t1);       // last
+  ref.Add (t2);       // post merge
+  ref.Add (t3);       // merge successor
+  ref.Add (t4);       // merge
+  ref.Add (t5);       // merge precursor
+  ref.Add (t6);       // pre-merge
+  ref.Add (t7);       // first
+
+  std::cout << GetName () << "check tags stored inline" << std::endl;
+  CheckOperations (ref);
+
+  // Fill the inline area, so that the test tags go to the shared tree
+  PacketTagList spilled;
+  spilled.Add (ATestTag<30> ());
+  spilled.Add (ATestTag<26> ());
+  NS_TEST_EXPECT_MSG_EQ (spilled.GetInlineSize (), PacketTagList::INLINE_SIZE,
+                         "inline area not filled");
+  spilled.Add (t1);
+  spilled.Add (t2);
+  spilled.Add (t3);
+  spilled.Add (t4);
+  spilled.Add (t5);
+  spilled.Add (t6);
+  spilled.Add (t7);
+  NS_TEST_EXPECT_MSG_EQ (spilled.GetInlineSize (), PacketTagList::INLINE_SIZE,
+                         "test tag stored inline");
+
+  std::cout << GetName () << "check tags spilled from the inline area" << std::endl;
+  CheckOperations (spilled);
+
+  { // Inline and spilled tags together
+    std::cout << GetName () << "check iteration over inline and spilled tags"
+              << std::endl;
+    Ptr<Packet> p = Create<Packet> (10);
+    p->AddPacketTag (ATestTag<30> ());
+    p->AddPacketTag (ATestTag<26> ());
+    p->AddPacketTag (t1);
+    p->AddPacketTag (ALargeTestTag ());
+    int count = 0;
+    PacketTagIterator i = p->GetPacketTagIterator ();
+    while (i.HasNext ())
+      {
+        PacketTagIterator::Item item = i.Next ();
+        if (item.GetTypeId () == ATestTag<1>::GetTypeId ())
+          {
+            ATestTag<1> t;
+            item.GetTag (t);
+            NS_TEST_EXPECT_MSG_EQ (t.GetData (), 1, "iterated tag value");
+            NS_TEST_EXPECT_MSG_EQ (t.m_error, false, "iterated tag data");
+          }
+        ++count;
+      }
+    NS_TEST_EXPECT_MSG_EQ (count, 4, "iterated tags");
+
+    // Replacing an inline tag rewrites it in place
+    ATestTag<30> filler (5);
+    p->ReplacePacketTag (filler);
+    filler.m_data = 0;
+    NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (filler), true, "replaced tag");
+    NS_TEST_EXPECT_MSG_EQ (filler.GetData (), 5, "replaced tag value");
+    p->RemoveAllPacketTags ();
+    NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (t1), false, "removed tags");
+  }
+
   { // Timing
     std::cout << GetName () << "add+remove timing" << std::endl;
     int flm = std::numeric_limits<int>::max ();
@@ -1150,6 +1217,202 @@ PacketTagListTest::DoRun (void)
     
 }
 
+namespace {
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test header which packets may carry unserialized
+ *
+ * \note Class internal to packet-test-suite.cc
+ */
+class AStructuredHeader : public Header
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("anon::AStructuredHeader")
+      .SetParent<Header> ()
+      .SetGroupName ("Network")
+      .HideFromDocumentation ()
+      .AddConstructor<AStructuredHeader> ()
+    ;
+    return tid;
+  }
+  virtual TypeId GetInstanceTypeId (void) const {
+    return GetTypeId ();
+  }
+  virtual uint32_t GetSerializedSize (void) const {
+    return 4;
+  }
+  virtual void Serialize (Buffer::Iterator iter) const {
+    iter.WriteHtonU32 (m_value);
+  }
+  virtual uint32_t Deserialize (Buffer::Iterator iter) {
+    m_value = iter.ReadNtohU32 ();
+    ++m_deserialized;
+    return 4;
+  }
+  virtual void Print (std::ostream &os) const {
+  }
+  /**
+   * Constructor
+   * \param value The value of the header
+   */
+  AStructuredHeader (uint32_t value = 0)
+    : m_value (value), m_verify (false) {}
+
+  uint32_t m_value;             //!< Value of the header
+  bool m_verify;                //!< Read from the bytes, as to verify a checksum
+  static uint32_t m_deserialized; //!< Number of Deserialize calls
+};
+
+uint32_t AStructuredHeader::m_deserialized = 0;
+
+} // anonymous namespace
+
+namespace ns3 {
+
+/// AStructuredHeader may be carried unserialized
+template <>
+struct IsStructuredHeader<AStructuredHeader>
+{
+  static const bool value = true; //!< AStructuredHeader is structured
+  /**
+   * \param header the header to read
+   * \returns true if the header is to be read from the bytes
+   */
+  static bool NeedsBytes (const AStructuredHeader &header)
+  {
+    return header.m_verify;
+  }
+};
+
+} // namespace ns3
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packets carrying headers unserialized.
+ */
+class PacketStructuredHeaderTest : public TestCase
+{
+public:
+  PacketStructuredHeaderTest ();
+private:
+  void DoRun (void);
+  /**
+   * Checks the bytes of a packet
+   * \param p The packet
+   * \param expected The expected bytes
+   * \param size The number of expected bytes
+   */
+  void CheckBytes (Ptr<const Packet> p, const uint8_t *expected, uint32_t size);
+  /**
+   * Checks the only byte tag of a packet
+   * \param p The packet
+   * \param start The expected start of the tag
+   * \param end The expected end of the tag
+   */
+  void CheckTag (Ptr<const Packet> p, uint32_t start, uint32_t end);
+};
+
+PacketStructuredHeaderTest::PacketStructuredHeaderTest ()
+  : TestCase ("Packet with structured headers")
+{
+}
+
+void
+PacketStructuredHeaderTest::CheckBytes (Ptr<const Packet> p, const uint8_t *expected, uint32_t size)
+{
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), size, "Wrong packet size");
+  uint8_t bytes[16];
+  NS_TEST_ASSERT_MSG_EQ (p->CopyData (bytes, size), size, "Wrong number of bytes copied");
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (static_cast<uint32_t> (bytes[i]), static_cast<uint32_t> (expected[i]),
+                             "Wrong byte " << i);
+    }
+}
+
+void
+PacketStructuredHeaderTest::CheckTag (Ptr<const Packet> p, uint32_t start, uint32_t end)
+{
+  ByteTagIterator i = p->GetByteTagIterator ();
+  NS_TEST_ASSERT_MSG_EQ (i.HasNext (), true, "Tag lost");
+  ByteTagIterator::Item item = i.Next ();
+  NS_TEST_EXPECT_MSG_EQ (item.GetStart (), start, "Wrong tag start");
+  NS_TEST_EXPECT_MSG_EQ (item.GetEnd (), end, "Wrong tag end");
+  NS_TEST_EXPECT_MSG_EQ (i.HasNext (), false, "Unexpected tag");
+}
+
+void
+PacketStructuredHeaderTest::DoRun (void)
+{
+  Packet::EnableStructuredHeaders ();
+  const uint8_t expected[] = { 3, 3, 3, 0x01, 0x02, 0x03, 0x04, 'h', 'e', 'l', 'l', 'o' };
+
+  Ptr<Packet> p = Create<Packet> (reinterpret_cast<const uint8_t*> ("hello"), 5);
+  p->AddHeader (AStructuredHeader (0x01020304));
+  CheckBytes (p, expected + 3, 9);
+
+  // A copy gets the header back without parsing it
+  AStructuredHeader::m_deserialized = 0;
+  Ptr<Packet> copy = p->Copy ();
+  AStructuredHeader header;
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekHeader (header), 4, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 0x01020304, "Wrong peeked value");
+  header.m_value = 0;
+  NS_TEST_EXPECT_MSG_EQ (copy->RemoveHeader (header), 4, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 0x01020304, "Wrong removed value");
+  NS_TEST_EXPECT_MSG_EQ (AStructuredHeader::m_deserialized, 0, "Header parsed");
+  CheckBytes (copy, expected + 7, 5);
+  CheckBytes (p, expected + 3, 9);
+
+  // A header verifying a checksum is read from the bytes
+  copy = p->Copy ();
+  AStructuredHeader verified;
+  verified.m_verify = true;
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekHeader (verified), 4, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (AStructuredHeader::m_deserialized, 1, "Peeked header not parsed");
+  verified.m_value = 0;
+  NS_TEST_EXPECT_MSG_EQ (copy->RemoveHeader (verified), 4, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (verified.m_value, 0x01020304, "Wrong removed value");
+  NS_TEST_EXPECT_MSG_EQ (AStructuredHeader::m_deserialized, 2, "Removed header not parsed");
+  CheckBytes (copy, expected + 7, 5);
+  AStructuredHeader::m_deserialized = 0;
+
+  // A serialized header on top serializes the one below
+  p->AddHeader (ATestHeader<3> ());
+  CheckBytes (p, expected, 12);
+  ATestHeader<3> top;
+  p->RemoveHeader (top);
+  NS_TEST_EXPECT_MSG_EQ (top.m_error, false, "Wrong serialized header");
+  header.m_value = 0;
+  p->RemoveHeader (header);
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 0x01020304, "Wrong deserialized value");
+  NS_TEST_EXPECT_MSG_EQ (AStructuredHeader::m_deserialized, 1, "Header not parsed");
+  CheckBytes (p, expected + 7, 5);
+
+  // Byte tags and fragments see the same bytes as with serialized headers
+  p->AddByteTag (ATestTag<1> ());
+  p->AddHeader (AStructuredHeader (0x01020304));
+  CheckTag (p, 4, 9);
+  Ptr<Packet> fragment = p->CreateFragment (2, 4);
+  CheckBytes (fragment, expected + 5, 4);
+  p->RemoveAtStart (2);
+  CheckBytes (p, expected + 5, 7);
+  CheckTag (p, 2, 7);
+
+  Packet::DisableStructuredHeaders ();
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1167,6 +1430,7 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketStructuredHeaderTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,226 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/pcap-capture-filter.h"
+#include "ns3/pcap-file-wrapper.h"
+#include "ns3/trace-helper.h"
+
+using namespace ns3;
+
+/// PPP frames, as written by the point to point devices
+static const uint32_t DLT_PPP = 9;
+/// TCP protocol number
+static const uint8_t TCP = 6;
+
+/**
+ * \param src the source address
+ * \param dst the destination address
+ * \param srcPort the TCP source port
+ * \param dstPort the TCP destination port
+ * \param payload the payload bytes
+ * \returns a PPP frame carrying an IPv4 TCP segment
+ */
+static std::vector<uint8_t>
+MakeFrame (Ipv4Address src, Ipv4Address dst, uint16_t srcPort, uint16_t dstPort, uint32_t payload = 100)
+{
+  std::vector<uint8_t> frame (2 + 20 + 20 + payload, 0);
+  frame[1] = 0x21;                        // PPP IPv4
+  uint8_t *ip = &frame[2];
+  ip[0] = 0x45;
+  ip[9] = TCP;
+  src.Serialize (ip + 12);
+  dst.Serialize (ip + 16);
+  uint8_t *tcp = ip + 20;
+  tcp[0] = srcPort >> 8;
+  tcp[1] = srcPort & 0xff;
+  tcp[2] = dstPort >> 8;
+  tcp[3] = dstPort & 0xff;
+  return frame;
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the selection of the packets by PcapCaptureFilter
+ */
+class PcapCaptureFilterTestCase : public TestCase
+{
+public:
+  PcapCaptureFilterTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapCaptureFilterTestCase::PcapCaptureFilterTestCase ()
+  : TestCase ("Check the selection of packets by flow, flow sampling and time")
+{
+}
+
+void
+PcapCaptureFilterTestCase::DoRun (void)
+{
+  Ipv4Address a ("10.1.1.1");
+  Ipv4Address b ("10.1.2.1");
+  Ipv4Address c ("10.1.3.1");
+  std::vector<uint8_t> ab = MakeFrame (a, b, 49153, 5000);
+  std::vector<uint8_t> ba = MakeFrame (b, a, 5000, 49153);
+  std::vector<uint8_t> cb = MakeFrame (c, b, 49153, 5000);
+
+  Ptr<PcapCaptureFilter> filter = CreateObject<PcapCaptureFilter> ();
+  NS_TEST_EXPECT_MSG_EQ (filter->IsFlowFiltered (), false, "No flow selection set");
+  NS_TEST_EXPECT_MSG_EQ (filter->IsFlowCaptured (DLT_PPP, &ab[0], ab.size ()), true, "Empty filter must capture");
+  NS_TEST_EXPECT_MSG_EQ (filter->IsCapturedAt (Seconds (100)), true, "Empty filter must capture");
+
+  // A flow matches both directions, and nothing else
+  filter->AddFlow (a, Ipv4Address::GetAny (), TCP, 0, 5000);
+  NS_TEST_EXPECT_MSG_EQ (filter->IsFlowCaptured (DLT_PPP, &ab[0], ab.size ()), true, "Data of the flow");
+  NS_TEST_EXPECT_MSG_EQ (filter->IsFlowCaptured (DLT_PPP, &ba[0], ba.size ()), true, "ACKs of the flow");
+  NS_TEST_EXPECT_MSG_EQ (filter->IsFlowCaptured (DLT_PPP, &cb[0], cb.size ()), false, "Other flow");
+  // The headers are enough
+  NS_TEST_EXPECT_MSG_EQ (filter->IsFlowCaptured (DLT_PPP, &ab[0], 2 + 20 + 4), true, "Headers only");
+  std::vector<uint8_t> ipv6 (ab);
+  ipv6[1] = 0x57;                         // PPP IPv6
+  NS_TEST_EXPECT_MSG_EQ (filter->IsFlowCaptured (DLT_PPP, &ipv6[0], ipv6.size ()), false, "Not IPv4");
+
+  // Both directions of a flow are sampled alike, about one flow in k
+  Ptr<PcapCaptureFilter> sampler = CreateObject<PcapCaptureFilter> ();
+  const uint32_t k = 8;
+  sampler->SetFlowSampling (k);
+  uint32_t sampled = 0;
+  const uint32_t flows = 4000;
+  for (uint32_t i = 0; i < flows; ++i)
+    {
+      uint16_t port = 1024 + i;
+      std::vector<uint8_t> data = MakeFrame (a, b, port, 5000);
+      std::vector<uint8_t> ack = MakeFrame (b, a, 5000, port);
+      bool captured = sampler->IsFlowCaptured (DLT_PPP, &data[0], data.size ());
+      NS_TEST_ASSERT_MSG_EQ (sampler->IsFlowCaptured (DLT_PPP, &ack[0], ack.size ()), captured,
+                             "Directions of a flow sampled differently");
+      sampled += captured;
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (sampled, flows / k, flows / k / 4, "Wrong sampling ratio");
+
+  // Time windows
+  Ptr<PcapCaptureFilter> windows = CreateObject<PcapCaptureFilter> ();
+  windows->AddTimeWindow (Seconds (1), Seconds (2));
+  windows->AddTimeWindow (Seconds (5), Seconds (6));
+  NS_TEST_EXPECT_MSG_EQ (windows->IsCapturedAt (Seconds (0.5)), false, "Before the windows");
+  NS_TEST_EXPECT_MSG_EQ (windows->IsCapturedAt (Seconds (1)), true, "Start of a window");
+  NS_TEST_EXPECT_MSG_EQ (windows->IsCapturedAt (Seconds (2)), false, "End of a window");
+  NS_TEST_EXPECT_MSG_EQ (windows->IsCapturedAt (Seconds (5.5)), true, "In a window");
+  NS_TEST_EXPECT_MSG_EQ (windows->IsFlowFiltered (), false, "Windows do not read the frame");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that PcapFileWrapper writes the selected packets only
+ */
+class PcapFileWrapperFilterTestCase : public TestCase
+{
+public:
+  PcapFileWrapperFilterTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapFileWrapperFilterTestCase::PcapFileWrapperFilterTestCase ()
+  : TestCase ("Check that a filtered pcap file holds the selected headers")
+{
+}
+
+void
+PcapFileWrapperFilterTestCase::DoRun (void)
+{
+  Ipv4Address a ("10.1.1.1");
+  Ipv4Address b ("10.1.2.1");
+  Ipv4Address c ("10.1.3.1");
+  std::vector<uint8_t> ab = MakeFrame (a, b, 49153, 5000, 1400);
+  std::vector<uint8_t> cb = MakeFrame (c, b, 49153, 5000, 1400);
+
+  Ptr<PcapCaptureFilter> filter = CreateObject<PcapCaptureFilter> ();
+  const uint32_t snapLen = 2 + 20 + 20;
+  filter->SetSnapLength (snapLen);
+  filter->AddFlow (a, b);
+  filter->AddTimeWindow (Seconds (1), Seconds (2));
+
+  std::string filename = CreateTempDirFilename ("filtered.pcap");
+  PcapHelper pcapHelper;
+  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, PcapHelper::DLT_PPP, filter);
+  NS_TEST_EXPECT_MSG_EQ (file->GetSnapLen (), snapLen, "Snap length of the filter not applied");
+
+  // The filter is given to this file only
+  Ptr<PcapFileWrapper> other = CreateObject<PcapFileWrapper> ();
+  PointerValue otherFilter;
+  other->GetAttribute ("CaptureFilter", otherFilter);
+  NS_TEST_EXPECT_MSG_EQ (otherFilter.Get<PcapCaptureFilter> (), 0, "Filter leaked to another file");
+
+  // Packets of the flow in the window, out of it, and of another flow
+  file->Write (Seconds (1.5), Create<Packet> (&ab[0], ab.size ()));
+  file->Write (Seconds (3), Create<Packet> (&ab[0], ab.size ()));
+  file->Write (Seconds (1.5), Create<Packet> (&cb[0], cb.size ()));
+  file->Write (Seconds (1.6), &ab[0], ab.size ());
+  file->Close ();
+
+  PcapFile in;
+  in.Open (filename, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (in.Fail (), false, "Open (" << filename << ") returns error");
+  uint32_t records = 0;
+  while (true)
+    {
+      uint8_t data[snapLen];
+      uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+      in.Read (data, snapLen, tsSec, tsUsec, inclLen, origLen, readLen);
+      if (in.Eof ())
+        {
+          break;
+        }
+      NS_TEST_EXPECT_MSG_EQ (inclLen, snapLen, "Packet not truncated");
+      NS_TEST_EXPECT_MSG_EQ (origLen, ab.size (), "Wrong packet length");
+      NS_TEST_EXPECT_MSG_EQ (tsSec, 1, "Packet out of the window");
+      ++records;
+    }
+  NS_TEST_EXPECT_MSG_EQ (records, 2, "Wrong number of captured packets");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PcapCaptureFilter TestSuite
+ */
+class PcapCaptureFilterTestSuite : public TestSuite
+{
+public:
+  PcapCaptureFilterTestSuite ()
+    : TestSuite ("pcap-capture-filter", UNIT)
+  {
+    AddTestCase (new PcapCaptureFilterTestCase, TestCase::QUICK);
+    AddTestCase (new PcapFileWrapperFilterTestCase, TestCase::QUICK);
+  }
+};
+
+static PcapCaptureFilterTestSuite g_pcapCaptureFilterTestSuite; //!< Static variable for test initialization
@@ -1144,6 +1144,117 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that files written by a background
+ * thread hold the same records.
+ */
+class AsyncWriteTestCase : public TestCase
+{
+public:
+  AsyncWriteTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+AsyncWriteTestCase::AsyncWriteTestCase ()
+  : TestCase ("Check that PcapFile::OpenAsync writes the same records")
+{
+}
+
+void
+AsyncWriteTestCase::DoRun (void)
+{
+  //
+  // Write the known packets synchronously and in the background
+  //
+  std::string filename = CreateTempDirFilename ("sync.pcap");
+  std::string filename2 = CreateTempDirFilename ("async.pcap");
+  PcapFile f;
+
+  for (int async = 0; async < 2; ++async)
+    {
+      if (async)
+        {
+          f.OpenAsync (filename2, AsyncFileBuf::NONE);
+        }
+      else
+        {
+          f.Open (filename, std::ios::out);
+        }
+      NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open returns error");
+      f.Init (1, N_PACKET_BYTES);
+      for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+        {
+          PacketEntry const & p = knownPackets[i];
+          f.Write (p.tsSec, p.tsUsec, (uint8_t const *)p.data, p.origLen);
+          NS_TEST_EXPECT_MSG_EQ (f.Fail (), false, "Write must not fail");
+        }
+      f.Close ();
+    }
+
+  uint32_t sec (0), usec (0), packets (0);
+  bool diff = PcapFile::Diff (filename, filename2, sec, usec, packets);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "PcapDiff(sync, async) must be false");
+  NS_TEST_EXPECT_MSG_EQ (packets, N_KNOWN_PACKETS, "Records lost");
+
+  //
+  // Write many more bytes than the ring holds, and read them back
+  //
+  const uint32_t nRecords = 20000;
+  const uint32_t recordSize = 1500;
+  std::vector<uint8_t> data (recordSize);
+  f.OpenAsync (filename2, AsyncFileBuf::NONE);
+  f.Init (1, recordSize);
+  for (uint32_t i = 0; i < nRecords; ++i)
+    {
+      data[0] = i & 0xff;
+      f.Write (i, 0, &data[0], recordSize);
+    }
+  f.Close ();
+
+  f.Open (filename2, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename2 << ", \"std::ios::in\") returns error");
+  uint32_t records = 0;
+  while (true)
+    {
+      uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+      f.Read (&data[0], recordSize, tsSec, tsUsec, inclLen, origLen, readLen);
+      if (f.Eof ())
+        {
+          break;
+        }
+      NS_TEST_ASSERT_MSG_EQ (tsSec, records, "Records out of order");
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t)data[0], (records & 0xff), "Bad record data");
+      NS_TEST_ASSERT_MSG_EQ (readLen, recordSize, "Bad record length");
+      ++records;
+    }
+  f.Close ();
+  NS_TEST_EXPECT_MSG_EQ (records, nRecords, "Records lost");
+
+  //
+  // Compressed files start with the gzip magic number
+  //
+  if (AsyncFileBuf::IsSupported (AsyncFileBuf::GZIP))
+    {
+      std::string filename3 = CreateTempDirFilename ("async.pcap.gz");
+      PcapFile g;
+      g.OpenAsync (filename3, AsyncFileBuf::GZIP);
+      NS_TEST_ASSERT_MSG_EQ (g.Fail (), false, "OpenAsync (" << filename3 << ") returns error");
+      g.Init (1, recordSize);
+      g.Write (0, 0, &data[0], recordSize);
+      g.Close ();
+      std::ifstream gz (filename3.c_str (), std::ios::binary);
+      uint8_t magic[2] = { 0, 0 };
+      gz.read ((char *)magic, 2);
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)magic[0], 0x1f, "Not a gzip file");
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)magic[1], 0x8b, "Not a gzip file");
+    }
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1167,6 +1278,7 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new AsyncWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
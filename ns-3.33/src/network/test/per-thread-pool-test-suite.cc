@@ -0,0 +1,244 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/test.h"
+#include "ns3/per-thread-pool.h"
+#include "ns3/packet.h"
+
+#include <thread>
+
+using namespace ns3;
+
+namespace {
+
+/** A pooled block. */
+struct PoolTestBlock
+{
+  uint8_t data[32]; //!< Payload
+};
+
+/** Largest number of blocks in the test pool. */
+const uint32_t POOL_TEST_SIZE = 4;
+
+/** The pool under test. */
+typedef PerThreadPool<PoolTestBlock, POOL_TEST_SIZE> TestPool;
+
+/**
+ * \returns A new block, allocated as the pool expects.
+ */
+PoolTestBlock *
+NewBlock (void)
+{
+  return static_cast<PoolTestBlock *> (::operator new (sizeof (PoolTestBlock)));
+}
+
+/** What the pool of a thread did once its free list was destroyed. */
+struct ExitResult
+{
+  bool pushed;     //!< Push was accepted
+  bool popped;     //!< Pop returned a block
+  uint32_t size;   //!< GetSize
+};
+
+ExitResult g_exitResult; //!< Result of the last exiting thread
+
+/**
+ * A thread_local object constructed before the free list of the pool,
+ * hence destroyed after it, like the packets still held by the static
+ * objects of the main thread.
+ */
+struct LateRelease
+{
+  ~LateRelease ()
+  {
+    PoolTestBlock *block = NewBlock ();
+    g_exitResult.pushed = TestPool::Push (block);
+    if (!g_exitResult.pushed)
+      {
+        ::operator delete (block);
+      }
+    PoolTestBlock *popped = TestPool::Pop ();
+    g_exitResult.popped = popped != 0;
+    g_exitResult.size = TestPool::GetSize ();
+  }
+  bool used {false}; //!< Force the construction
+};
+
+/** Body of the thread of PerThreadPoolExitTestCase. */
+void
+ExitThread (void)
+{
+  static thread_local LateRelease late;
+  late.used = true;
+  TestPool::Push (NewBlock ());
+  TestPool::Push (NewBlock ());
+}
+
+} // unnamed namespace
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the released blocks are reused, in last in first
+ * out order, and that the pools of the threads are separate.
+ */
+class PerThreadPoolReuseTestCase : public TestCase
+{
+public:
+  PerThreadPoolReuseTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PerThreadPoolReuseTestCase::PerThreadPoolReuseTestCase ()
+  : TestCase ("Check the reuse of the released blocks")
+{
+}
+
+void
+PerThreadPoolReuseTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (TestPool::GetSize (), 0, "The pool starts empty");
+  NS_TEST_EXPECT_MSG_EQ (TestPool::Pop (), 0, "Empty pool returned a block");
+
+  PoolTestBlock *a = NewBlock ();
+  PoolTestBlock *b = NewBlock ();
+  NS_TEST_EXPECT_MSG_EQ (TestPool::Push (a), true, "Block refused");
+  NS_TEST_EXPECT_MSG_EQ (TestPool::Push (b), true, "Block refused");
+  NS_TEST_EXPECT_MSG_EQ (TestPool::GetSize (), 2, "Wrong pool size");
+
+  // Another thread has its own, empty, pool
+  uint32_t otherSize = 1;
+  PoolTestBlock *otherPop = b;
+  std::thread other ([&otherSize, &otherPop] ()
+    {
+      otherSize = TestPool::GetSize ();
+      otherPop = TestPool::Pop ();
+    });
+  other.join ();
+  NS_TEST_EXPECT_MSG_EQ (otherSize, 0, "The pools of the threads are shared");
+  NS_TEST_EXPECT_MSG_EQ (otherPop, 0, "The pools of the threads are shared");
+
+  NS_TEST_EXPECT_MSG_EQ (TestPool::Pop (), b, "The last block released is not reused first");
+  NS_TEST_EXPECT_MSG_EQ (TestPool::Pop (), a, "Block not reused");
+  NS_TEST_EXPECT_MSG_EQ (TestPool::Pop (), 0, "Block reused twice");
+  ::operator delete (a);
+  ::operator delete (b);
+
+  // The packet pool gives back the storage of the last packet released
+  Ptr<Packet> p = Create<Packet> (100);
+  Packet *storage = PeekPointer (p);
+  p = 0;
+  p = Create<Packet> (200);
+  NS_TEST_EXPECT_MSG_EQ (PeekPointer (p), storage, "Packet storage not reused");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the pool keeps at most N blocks.
+ */
+class PerThreadPoolCapTestCase : public TestCase
+{
+public:
+  PerThreadPoolCapTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PerThreadPoolCapTestCase::PerThreadPoolCapTestCase ()
+  : TestCase ("Check the size limit of the pool")
+{
+}
+
+void
+PerThreadPoolCapTestCase::DoRun (void)
+{
+  for (uint32_t i = 0; i < POOL_TEST_SIZE; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (TestPool::Push (NewBlock ()), true, "Block " << i << " refused");
+    }
+  NS_TEST_EXPECT_MSG_EQ (TestPool::GetSize (), POOL_TEST_SIZE, "Wrong pool size");
+
+  PoolTestBlock *extra = NewBlock ();
+  NS_TEST_EXPECT_MSG_EQ (TestPool::Push (extra), false, "Full pool took a block");
+  ::operator delete (extra);
+  NS_TEST_EXPECT_MSG_EQ (TestPool::GetSize (), POOL_TEST_SIZE, "Full pool grew");
+
+  PoolTestBlock *block;
+  while ((block = TestPool::Pop ()) != 0)
+    {
+      ::operator delete (block);
+    }
+  NS_TEST_EXPECT_MSG_EQ (TestPool::GetSize (), 0, "Pool not drained");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the pool of an exiting thread refuses the blocks
+ * released after its free list is destroyed.
+ */
+class PerThreadPoolExitTestCase : public TestCase
+{
+public:
+  PerThreadPoolExitTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PerThreadPoolExitTestCase::PerThreadPoolExitTestCase ()
+  : TestCase ("Check the pool of an exiting thread")
+{
+}
+
+void
+PerThreadPoolExitTestCase::DoRun (void)
+{
+  g_exitResult.pushed = true;
+  g_exitResult.popped = true;
+  g_exitResult.size = 1;
+  std::thread thread (&ExitThread);
+  thread.join ();
+  NS_TEST_EXPECT_MSG_EQ (g_exitResult.pushed, false, "Destroyed pool took a block");
+  NS_TEST_EXPECT_MSG_EQ (g_exitResult.popped, false, "Destroyed pool returned a block");
+  NS_TEST_EXPECT_MSG_EQ (g_exitResult.size, 0, "Destroyed pool not empty");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PerThreadPool TestSuite
+ */
+class PerThreadPoolTestSuite : public TestSuite
+{
+public:
+  PerThreadPoolTestSuite ()
+    : TestSuite ("per-thread-pool", UNIT)
+  {
+    AddTestCase (new PerThreadPoolReuseTestCase (), TestCase::QUICK);
+    AddTestCase (new PerThreadPoolCapTestCase (), TestCase::QUICK);
+    AddTestCase (new PerThreadPoolExitTestCase (), TestCase::QUICK);
+  }
+};
+
+static PerThreadPoolTestSuite g_perThreadPoolTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/rate-math.h"
+#include "ns3/data-rate.h"
+#include "ns3/random-variable-stream.h"
+
+#include <cmath>
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * Draw a value whose logarithm is uniform, to cover all the magnitudes.
+ * \param rng The random variable.
+ * \param max The largest value.
+ * \returns A value in [1, max].
+ */
+uint64_t
+DrawLog (Ptr<UniformRandomVariable> rng, double max)
+{
+  double value = std::exp (rng->GetValue (0, std::log (max)));
+  return std::max<uint64_t> (1, static_cast<uint64_t> (value));
+}
+
+} // unnamed namespace
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Compare the integer helpers with the double and int64x64_t
+ * arithmetic they replace, on random rates, sizes and intervals.
+ */
+class RateMathPropertyTestCase : public TestCase
+{
+public:
+  RateMathPropertyTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RateMathPropertyTestCase::RateMathPropertyTestCase ()
+  : TestCase ("Check the fixed point rate helpers against the double path")
+{
+}
+
+void
+RateMathPropertyTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      uint64_t bps = DrawLog (rng, 4e11);
+      uint64_t bytes = DrawLog (rng, 1e7);
+      Time interval = Time (static_cast<int64_t> (DrawLog (rng, 1e12)));
+
+      // The transmission time used to be computed through int64x64_t
+      Time expected = Seconds (bytes * 8) / bps;
+      NS_TEST_ASSERT_MSG_EQ (RateMath::TxTime (bytes, bps), expected,
+                             "TxTime of " << bytes << " bytes at " << bps << " bit/s");
+
+      // Time::GetSeconds () is itself inexact for intervals of a few ns
+      double rate = bytes * 8.0 * RateMath::TicksPerSecond () / interval.GetTimeStep ();
+      NS_TEST_ASSERT_MSG_EQ_TOL (static_cast<double> (RateMath::Rate (bytes, interval)),
+                                 rate, (1 + rate * 1e-12),
+                                 "Rate of " << bytes << " bytes over " << interval);
+
+      double carried = DataRate (bps) * interval / 8;
+      NS_TEST_ASSERT_MSG_EQ_TOL (static_cast<double> (RateMath::Bytes (bps, interval)),
+                                 carried, (1 + carried * 1e-12),
+                                 "Bytes at " << bps << " bit/s over " << interval);
+
+      double gain = rng->GetValue (0, 4);
+      uint32_t units = RateMath::GainToUnits (gain);
+      double scaled = bps * (units / 256.0);
+      NS_TEST_ASSERT_MSG_EQ_TOL (static_cast<double> (RateMath::ApplyGain (bps, units)),
+                                 scaled, (1 + scaled * 1e-12), "Gain of " << gain);
+      units = RateMath::GainToUnits (gain, RateMath::FINE_GAIN_SCALE);
+      scaled = bps * (units / 1024.0);
+      NS_TEST_ASSERT_MSG_EQ_TOL (static_cast<double> (RateMath::ApplyGain (bps, units, RateMath::FINE_GAIN_SCALE)),
+                                 scaled, (1 + scaled * 1e-12), "Fine gain of " << gain);
+    }
+
+  // The gains of Linux BBR
+  NS_TEST_ASSERT_MSG_EQ (RateMath::GainToUnits (2.885), 739, "High gain");
+  NS_TEST_ASSERT_MSG_EQ (RateMath::GainToUnits (1.25), 320, "Probe gain");
+  NS_TEST_ASSERT_MSG_EQ (RateMath::GainToUnits (0.75), 192, "Drain gain");
+  NS_TEST_ASSERT_MSG_EQ (RateMath::ApplyGain (1000000, RateMath::BBR_UNIT), 1000000, "Unit gain");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the precomputed reciprocal of a rate gives exactly
+ * the transmission time of the division.
+ */
+class RateReciprocalTestCase : public TestCase
+{
+public:
+  RateReciprocalTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check a rate on the usual sizes and around the exactness bound.
+   * \param bps The rate.
+   */
+  void CheckRate (uint64_t bps);
+};
+
+RateReciprocalTestCase::RateReciprocalTestCase ()
+  : TestCase ("Check the transmission times of a precomputed reciprocal")
+{
+}
+
+void
+RateReciprocalTestCase::CheckRate (uint64_t bps)
+{
+  RateReciprocal reciprocal (bps);
+  NS_TEST_ASSERT_MSG_EQ (reciprocal.GetBitRate (), bps, "Wrong rate");
+  for (uint64_t bytes = 0; bytes <= 1600; bytes++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (reciprocal.TxTime (bytes), RateMath::TxTime (bytes, bps),
+                             bytes << " bytes at " << bps << " bit/s");
+    }
+  const uint64_t large[] = { 65535, 65536, 1 << 20, 1 << 24, (1 << 29) - 1, 1 << 29,
+                             (1 << 29) + 1, 1ULL << 32, 1ULL << 40 };
+  for (uint32_t i = 0; i < sizeof (large) / sizeof (large[0]); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (reciprocal.TxTime (large[i]), RateMath::TxTime (large[i], bps),
+                             large[i] << " bytes at " << bps << " bit/s");
+    }
+}
+
+void
+RateReciprocalTestCase::DoRun (void)
+{
+  const uint64_t rates[] = { 1, 3, 7, 56000, 1000000, 1500000, 12000000, 100000000,
+                             999999937, 1000000000, 10000000000ULL, 25000000000ULL,
+                             40000000000ULL, 100000000000ULL, 400000000000ULL,
+                             (1ULL << 40) - 1, 1ULL << 40 };
+  for (uint32_t i = 0; i < sizeof (rates) / sizeof (rates[0]); i++)
+    {
+      CheckRate (rates[i]);
+    }
+
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (2);
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      uint64_t bps = DrawLog (rng, 1e12);
+      RateReciprocal reciprocal (bps);
+      for (uint32_t j = 0; j < 20; j++)
+        {
+          uint64_t bytes = DrawLog (rng, 1e9);
+          NS_TEST_ASSERT_MSG_EQ (reciprocal.TxTime (bytes), RateMath::TxTime (bytes, bps),
+                                 bytes << " bytes at " << bps << " bit/s");
+        }
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief The fixed point rate helpers TestSuite.
+ */
+class RateMathTestSuite : public TestSuite
+{
+public:
+  RateMathTestSuite ()
+    : TestSuite ("rate-math", UNIT)
+  {
+    AddTestCase (new RateMathPropertyTestCase, TestCase::QUICK);
+    AddTestCase (new RateReciprocalTestCase, TestCase::QUICK);
+  }
+};
+
+static RateMathTestSuite g_rateMathTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2007 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/test.h"
+#include "ns3/ring-queue.h"
+#include "ns3/string.h"
+#include "ns3/object-factory.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * RingQueue unit tests with a limit in packets.
+ */
+class RingQueueTestCase : public TestCase
+{
+public:
+  RingQueueTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Count a packet dropped
+   * \param p the packet
+   */
+  void Drop (Ptr<const Packet> p);
+
+  uint32_t m_drops; //!< Number of packets dropped
+};
+
+RingQueueTestCase::RingQueueTestCase ()
+  : TestCase ("Sanity check on the ring queue implementation"),
+    m_drops (0)
+{
+}
+
+void
+RingQueueTestCase::Drop (Ptr<const Packet> p)
+{
+  m_drops++;
+}
+
+void
+RingQueueTestCase::DoRun (void)
+{
+  Ptr<RingQueue<Packet> > queue = CreateObject<RingQueue<Packet> > ();
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("MaxSize", StringValue ("3p")), true,
+                         "Verify that we can actually set the attribute");
+  queue->TraceConnectWithoutContext ("Drop", MakeCallback (&RingQueueTestCase::Drop, this));
+
+  Ptr<Packet> p1, p2, p3, p4;
+  p1 = Create<Packet> ();
+  p2 = Create<Packet> ();
+  p3 = Create<Packet> ();
+  p4 = Create<Packet> ();
+
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 0, "There should be no packets in there");
+  queue->Enqueue (p1);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 1, "There should be one packet in there");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetCapacity (), 4, "The ring should hold MaxSize rounded up");
+  queue->Enqueue (p2);
+  queue->Enqueue (p3);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 3, "There should be three packets in there");
+  NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (p4), false, "The fourth packet should be dropped");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 3, "There should be still three packets in there");
+  NS_TEST_EXPECT_MSG_EQ (m_drops, 1, "The drop should be traced");
+  NS_TEST_EXPECT_MSG_EQ (queue->Peek ()->GetUid (), p1->GetUid (), "Peek the first packet");
+
+  // Wrap around the ring several times
+  std::vector<Ptr<Packet> > sent;
+  sent.push_back (p1);
+  sent.push_back (p2);
+  sent.push_back (p3);
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      Ptr<Packet> packet = queue->Dequeue ();
+      NS_TEST_EXPECT_MSG_EQ (packet->GetUid (), sent[i]->GetUid (), "Packets out of order");
+      sent.push_back (Create<Packet> ());
+      NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (sent.back ()), true, "There should be room");
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetCapacity (), 4, "The ring should not grow");
+
+  Ptr<Packet> packet = queue->Remove ();
+  NS_TEST_EXPECT_MSG_EQ (packet->GetUid (), sent[10]->GetUid (), "Remove the first packet");
+  NS_TEST_EXPECT_MSG_EQ (m_drops, 2, "The removal should be traced as a drop");
+  queue->Flush ();
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 0, "There should be no packets in there");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "There should be no bytes in there");
+  packet = queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_EQ ((packet == 0), true, "There are really no packets in there");
+  NS_TEST_EXPECT_MSG_EQ ((queue->Peek () == 0), true, "There are really no packets in there");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * RingQueue unit tests with a limit in bytes.
+ */
+class RingQueueBytesTestCase : public TestCase
+{
+public:
+  RingQueueBytesTestCase ();
+  virtual void DoRun (void);
+};
+
+RingQueueBytesTestCase::RingQueueBytesTestCase ()
+  : TestCase ("Check the byte limit and the growth of the ring queue")
+{
+}
+
+void
+RingQueueBytesTestCase::DoRun (void)
+{
+  Ptr<RingQueue<Packet> > queue = CreateObjectWithAttributes<RingQueue<Packet> > (
+      "MaxSize", StringValue ("1000B"), "Capacity", UintegerValue (3));
+
+  // Small packets need more slots than the ring starts with
+  std::vector<Ptr<Packet> > sent;
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      sent.push_back (Create<Packet> (100));
+      NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (sent.back ()), true, "There should be room");
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetCapacity (), 16, "The ring should have doubled twice");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 1000, "The bytes should be counted");
+  NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (Create<Packet> (1)), false, "The byte limit is reached");
+
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      Ptr<Packet> packet = queue->Dequeue ();
+      NS_TEST_EXPECT_MSG_EQ (packet->GetUid (), sent[i]->GetUid (), "Packets out of order");
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "There should be no bytes in there");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalReceivedPackets (), 10, "Wrong number of packets received");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPacketsBeforeEnqueue (), 1, "Wrong number of drops");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Ring Queue TestSuite
+ */
+class RingQueueTestSuite : public TestSuite
+{
+public:
+  RingQueueTestSuite ()
+    : TestSuite ("ring-queue", UNIT)
+  {
+    AddTestCase (new RingQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new RingQueueBytesTestCase (), TestCase::QUICK);
+  }
+};
+
+static RingQueueTestSuite g_ringQueueTestSuite; //!< Static variable for test initialization
@@ -107,6 +107,39 @@ DataRateTestCase1::DoRun ()
     }
 }
 
+class DataRateTestCase2 : public DataRateTestCase
+{
+public:
+  DataRateTestCase2 ();
+
+private:
+  virtual void DoRun (void);
+};
+
+DataRateTestCase2::DataRateTestCase2 ()
+    : DataRateTestCase ("Test the integer operations on DataRate")
+{
+}
+
+void
+DataRateTestCase2::DoRun ()
+{
+  // Evaluated at compile time
+  constexpr DataRate link (10000000);
+  static_assert (link.Scale (5, 4).GetBitRate () == 12500000, "Scale by 5/4");
+  static_assert (Min (link, DataRate (1000)) == DataRate (1000), "Min");
+  static_assert (Max (link, DataRate (1000)) == link, "Max");
+  static_assert (link > DataRate () && link != DataRate (), "Comparison");
+
+  // A gain of 2.885 in BBR units, applied to a rate close to 2^64
+  DataRate high (0xffffffffffffffffULL / 739 * 256);
+  uint64_t expected = static_cast<uint64_t> ((static_cast<long double> (high.GetBitRate ()) * 739) / 256);
+  NS_TEST_EXPECT_MSG_EQ_TOL (high.Scale (739, 256).GetBitRate (), expected, 2,
+                             "Scale overflowed");
+  NS_TEST_EXPECT_MSG_EQ (DataRate (99).Scale (1, 100).GetBitRate (), 0, "Scale must round down");
+  NS_TEST_EXPECT_MSG_EQ (DataRate (1001).Scale (99, 100).GetBitRate (), 990, "Scale must round down");
+}
+
 class DataRateTestSuite : public TestSuite
 {
 public:
@@ -116,6 +149,7 @@ public:
 DataRateTestSuite::DataRateTestSuite () : TestSuite ("data-rate", UNIT)
 {
   AddTestCase (new DataRateTestCase1 (), TestCase::QUICK);
+  AddTestCase (new DataRateTestCase2 (), TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,357 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include "async-file-buf.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef NS3_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief The thread writing the blocks of all the open AsyncFileBuf.
+ *
+ * It is started with the first buffer and sleeps while no buffer is
+ * open.  The buffers only take its mutex to open and close; handing
+ * over a block is lock-free and the thread looks again for blocks at
+ * least every millisecond, so a lost wake-up only delays it.
+ */
+class AsyncFileWriterThread
+{
+public:
+  /**
+   * \returns the writer
+   */
+  static AsyncFileWriterThread &Get (void)
+  {
+    static AsyncFileWriterThread writer;
+    return writer;
+  }
+  /**
+   * \brief Start writing the blocks of a buffer
+   * \param buf the buffer
+   */
+  void Add (AsyncFileBuf *buf)
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_bufs.push_back (buf);
+    if (!m_thread.joinable ())
+      {
+        m_thread = std::thread (&AsyncFileWriterThread::Run, this);
+      }
+    m_wake.notify_one ();
+  }
+  /**
+   * \brief Stop writing the blocks of a buffer
+   * \param buf the buffer, without pending blocks
+   */
+  void Remove (AsyncFileBuf *buf)
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_bufs.erase (std::remove (m_bufs.begin (), m_bufs.end (), buf), m_bufs.end ());
+  }
+  /**
+   * \brief Tell the thread that a block is ready
+   */
+  void Wake (void)
+  {
+    m_wake.notify_one ();
+  }
+
+private:
+  AsyncFileWriterThread ()
+    : m_stop (false)
+  {
+  }
+  ~AsyncFileWriterThread ()
+  {
+    {
+      std::unique_lock<std::mutex> lock (m_mutex);
+      m_stop = true;
+      m_wake.notify_one ();
+    }
+    if (m_thread.joinable ())
+      {
+        m_thread.join ();
+      }
+  }
+  /**
+   * \brief Write blocks until the end of the program
+   */
+  void Run (void)
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    while (!m_stop)
+      {
+        bool wrote = false;
+        for (std::vector<AsyncFileBuf *>::iterator i = m_bufs.begin (); i != m_bufs.end (); ++i)
+          {
+            while ((*i)->WritePending ())
+              {
+                wrote = true;
+              }
+          }
+        if (m_bufs.empty ())
+          {
+            m_wake.wait (lock);
+          }
+        else if (!wrote)
+          {
+            m_wake.wait_for (lock, std::chrono::milliseconds (1));
+          }
+      }
+  }
+
+  std::mutex m_mutex;                  //!< Protects m_bufs and m_stop
+  std::condition_variable m_wake;      //!< Signals new blocks
+  std::vector<AsyncFileBuf *> m_bufs;  //!< Open buffers
+  bool m_stop;                         //!< The program ends
+  std::thread m_thread;                //!< The writing thread
+};
+
+AsyncFileBuf::AsyncFileBuf ()
+  : m_file (0),
+    m_submitted (0),
+    m_gzFile (0),
+    m_block (0),
+    m_ringHead (0),
+    m_ringTail (0),
+    m_spareHead (0),
+    m_spareTail (0)
+{
+}
+
+AsyncFileBuf::~AsyncFileBuf ()
+{
+  Close ();
+}
+
+bool
+AsyncFileBuf::IsSupported (Compression compression)
+{
+#ifdef NS3_ZLIB
+  return true;
+#else
+  return compression == NONE;
+#endif
+}
+
+bool
+AsyncFileBuf::Open (std::string const &filename, Compression compression)
+{
+  Close ();
+  if (!IsSupported (compression))
+    {
+      return false;
+    }
+  if (compression == GZIP)
+    {
+#ifdef NS3_ZLIB
+      gzFile gz = gzopen (filename.c_str (), "wb");
+      if (gz == 0)
+        {
+          return false;
+        }
+      gzbuffer (gz, BLOCK_SIZE);
+      m_gzFile = gz;
+#endif
+    }
+  else
+    {
+      m_file = std::fopen (filename.c_str (), "wb");
+      if (m_file == 0)
+        {
+          return false;
+        }
+      std::setvbuf (m_file, 0, _IONBF, 0);
+    }
+  m_submitted = 0;
+  m_block = new char[BLOCK_SIZE];
+  setp (m_block, m_block + BLOCK_SIZE);
+  AsyncFileWriterThread::Get ().Add (this);
+  return true;
+}
+
+bool
+AsyncFileBuf::IsOpen (void) const
+{
+  return m_block != 0;
+}
+
+void
+AsyncFileBuf::Close (void)
+{
+  if (!IsOpen ())
+    {
+      return;
+    }
+  Submit ();
+  // Wait for the background thread to write everything
+  while (m_ringHead.load (std::memory_order_acquire)
+         != m_ringTail.load (std::memory_order_relaxed))
+    {
+      AsyncFileWriterThread::Get ().Wake ();
+      std::this_thread::yield ();
+    }
+  AsyncFileWriterThread::Get ().Remove (this);
+  if (m_file != 0)
+    {
+      std::fclose (m_file);
+      m_file = 0;
+    }
+#ifdef NS3_ZLIB
+  if (m_gzFile != 0)
+    {
+      gzclose (static_cast<gzFile> (m_gzFile));
+      m_gzFile = 0;
+    }
+#endif
+  delete [] m_block;
+  m_block = 0;
+  setp (0, 0);
+  while (m_spareHead.load () != m_spareTail.load ())
+    {
+      delete [] m_spare[m_spareHead.load () % (2 * RING_SIZE)];
+      m_spareHead++;
+    }
+}
+
+AsyncFileBuf::int_type
+AsyncFileBuf::overflow (int_type c)
+{
+  if (!IsOpen ())
+    {
+      return traits_type::eof ();
+    }
+  Submit ();
+  if (!traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      *pptr () = traits_type::to_char_type (c);
+      pbump (1);
+    }
+  return traits_type::not_eof (c);
+}
+
+int
+AsyncFileBuf::sync (void)
+{
+  // The bytes are written out when the block is full or on Close:
+  // handing over partial blocks on every flush would defeat the
+  // batching.
+  return IsOpen () ? 0 : -1;
+}
+
+AsyncFileBuf::pos_type
+AsyncFileBuf::seekoff (off_type off, std::ios_base::seekdir dir,
+                       std::ios_base::openmode which)
+{
+  pos_type current = m_submitted + (pptr () - pbase ());
+  if (!IsOpen () || (which & std::ios_base::out) == 0)
+    {
+      return pos_type (off_type (-1));
+    }
+  if ((dir == std::ios_base::cur && off == 0)
+      || (dir == std::ios_base::beg && off == off_type (current)))
+    {
+      return current;
+    }
+  return pos_type (off_type (-1));
+}
+
+AsyncFileBuf::pos_type
+AsyncFileBuf::seekpos (pos_type pos, std::ios_base::openmode which)
+{
+  return seekoff (off_type (pos), std::ios_base::beg, which);
+}
+
+void
+AsyncFileBuf::Submit (void)
+{
+  uint32_t size = pptr () - pbase ();
+  if (size == 0)
+    {
+      return;
+    }
+  m_submitted += size;
+  uint32_t tail = m_ringTail.load (std::memory_order_relaxed);
+  while (tail - m_ringHead.load (std::memory_order_acquire) == RING_SIZE)
+    {
+      // The background thread is behind: wait for a free slot
+      AsyncFileWriterThread::Get ().Wake ();
+      std::this_thread::yield ();
+    }
+  m_ring[tail % RING_SIZE] = m_block;
+  m_ringSize[tail % RING_SIZE] = size;
+  m_ringTail.store (tail + 1, std::memory_order_release);
+  AsyncFileWriterThread::Get ().Wake ();
+
+  uint32_t spareHead = m_spareHead.load (std::memory_order_relaxed);
+  if (spareHead != m_spareTail.load (std::memory_order_acquire))
+    {
+      m_block = m_spare[spareHead % (2 * RING_SIZE)];
+      m_spareHead.store (spareHead + 1, std::memory_order_release);
+    }
+  else
+    {
+      m_block = new char[BLOCK_SIZE];
+    }
+  setp (m_block, m_block + BLOCK_SIZE);
+}
+
+bool
+AsyncFileBuf::WritePending (void)
+{
+  uint32_t head = m_ringHead.load (std::memory_order_relaxed);
+  if (head == m_ringTail.load (std::memory_order_acquire))
+    {
+      return false;
+    }
+  char *block = m_ring[head % RING_SIZE];
+  uint32_t size = m_ringSize[head % RING_SIZE];
+  if (m_file != 0)
+    {
+      std::fwrite (block, 1, size, m_file);
+    }
+#ifdef NS3_ZLIB
+  if (m_gzFile != 0)
+    {
+      gzwrite (static_cast<gzFile> (m_gzFile), block, size);
+    }
+#endif
+  // Every block handed back has a spare slot: at most RING_SIZE + 1
+  // blocks exist, and all of them may be spare while Submit () swaps
+  // the block being filled.
+  uint32_t spareTail = m_spareTail.load (std::memory_order_relaxed);
+  m_spare[spareTail % (2 * RING_SIZE)] = block;
+  m_spareTail.store (spareTail + 1, std::memory_order_release);
+  m_ringHead.store (head + 1, std::memory_order_release);
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef ASYNC_FILE_BUF_H
+#define ASYNC_FILE_BUF_H
+
+#include <atomic>
+#include <cstdio>
+#include <stdint.h>
+#include <streambuf>
+#include <string>
+
+//
+// Like pcap-file.h, this file is used as part of the ns-3 test framework,
+// so it must not depend on ns-3 specific constructs.
+//
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Output stream buffer whose bytes are written to a file by a
+ * background thread.
+ *
+ * The writing thread fills blocks of BLOCK_SIZE bytes.  A full block is
+ * handed over through a lock-free single-producer, single-consumer ring
+ * to a thread shared by all the open AsyncFileBuf, which writes it with
+ * one call, optionally through gzip compression.  The writing thread
+ * only waits when the writer falls behind by RING_SIZE blocks.
+ *
+ * The file is written sequentially: seeking is only possible to the
+ * current position, which is what PcapFile::Init () does.
+ *
+ * A stream buffer must be used by one thread at a time.
+ */
+class AsyncFileBuf : public std::streambuf
+{
+public:
+  /** Compression of the written file */
+  enum Compression
+  {
+    NONE,   //!< Plain file
+    GZIP    //!< gzip file, as read by wireshark and zcat
+  };
+
+  /** Bytes handed over to the background thread at once */
+  static const uint32_t BLOCK_SIZE = 256 * 1024;
+  /** Blocks which may wait for the background thread */
+  static const uint32_t RING_SIZE = 8;
+
+  AsyncFileBuf ();
+  virtual ~AsyncFileBuf ();
+
+  /**
+   * \brief Check for compression support
+   * \param compression the compression
+   * \returns true if files can be written with this compression
+   */
+  static bool IsSupported (Compression compression);
+
+  /**
+   * \brief Create the file, truncating an existing one
+   * \param filename the name of the file
+   * \param compression the compression of the file
+   * \returns false if the file cannot be created
+   */
+  bool Open (std::string const &filename, Compression compression);
+  /**
+   * \returns true if the file is open
+   */
+  bool IsOpen (void) const;
+  /**
+   * \brief Write out all the bytes and close the file.
+   *
+   * Waits for the background thread to write the pending blocks.
+   */
+  void Close (void);
+
+protected:
+  virtual int_type overflow (int_type c);
+  virtual int sync (void);
+  virtual pos_type seekoff (off_type off, std::ios_base::seekdir dir,
+                            std::ios_base::openmode which);
+  virtual pos_type seekpos (pos_type pos, std::ios_base::openmode which);
+
+private:
+  /// Background thread writing the blocks of all the open buffers
+  friend class AsyncFileWriterThread;
+
+  /**
+   * \brief Hand the current block over to the background thread and
+   * start a new one.
+   */
+  void Submit (void);
+  /**
+   * \brief Write the blocks handed over, in the background thread
+   * \returns true if a block was written
+   */
+  bool WritePending (void);
+
+  FILE *m_file;                        //!< Plain file
+  uint64_t m_submitted;                //!< Bytes handed over so far
+  void *m_gzFile;                      //!< gzip file
+  char *m_block;                       //!< Block being filled
+  char *m_ring[RING_SIZE];             //!< Full blocks
+  uint32_t m_ringSize[RING_SIZE];      //!< Bytes in the full blocks
+  std::atomic<uint32_t> m_ringHead;    //!< Next block to write
+  std::atomic<uint32_t> m_ringTail;    //!< Next free slot
+  char *m_spare[2 * RING_SIZE];        //!< Written blocks, for reuse
+  std::atomic<uint32_t> m_spareHead;   //!< Next block to reuse
+  std::atomic<uint32_t> m_spareTail;   //!< Next free slot
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_BUF_H */
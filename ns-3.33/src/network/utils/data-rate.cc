@@ -19,6 +19,7 @@
 //
 
 #include "data-rate.h"
+#include "rate-math.h"
 #include "ns3/nstime.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
@@ -184,64 +185,10 @@ DataRate::DoParse (const std::string s, uint64_t *v)
   return true;
 }
 
-DataRate::DataRate ()
-  : m_bps (0)
-{
-  NS_LOG_FUNCTION (this);
-}
-
-DataRate::DataRate(uint64_t bps)
-  : m_bps (bps)
-{
-  NS_LOG_FUNCTION (this << bps);
-}
-
-bool DataRate::operator < (const DataRate& rhs) const
-{
-  return m_bps<rhs.m_bps;
-}
-
-bool DataRate::operator <= (const DataRate& rhs) const
-{
-  return m_bps<=rhs.m_bps;
-}
-
-bool DataRate::operator >  (const DataRate& rhs) const
-{
-  return m_bps>rhs.m_bps;
-}
-
-bool DataRate::operator >= (const DataRate& rhs) const
-{
-  return m_bps>=rhs.m_bps;
-}
-
-bool DataRate::operator == (const DataRate& rhs) const
-{
-  return m_bps==rhs.m_bps;
-}
-
-bool DataRate::operator != (const DataRate& rhs) const
-{
-  return m_bps!=rhs.m_bps;
-}
-
-Time DataRate::CalculateBytesTxTime (uint32_t bytes) const
-{
-  NS_LOG_FUNCTION (this << bytes);
-  return Seconds (bytes * 8) / m_bps;
-}
-
 Time DataRate::CalculateBitsTxTime (uint32_t bits) const
 {
   NS_LOG_FUNCTION (this << bits);
-  return Seconds (bits) / m_bps;
-}
-
-uint64_t DataRate::GetBitRate () const
-{
-  NS_LOG_FUNCTION (this);
-  return m_bps;
+  return Time (static_cast<int64_t> (RateMath::MulDiv (bits, RateMath::TicksPerSecond (), m_bps)));
 }
 
 DataRate::DataRate (std::string rate)
@@ -24,7 +24,9 @@
 #include <string>
 #include <iostream>
 #include <stdint.h>
+#include <type_traits>
 #include "ns3/nstime.h"
+#include "ns3/rate-math.h"
 #include "ns3/attribute.h"
 #include "ns3/attribute-helper.h"
 #include "ns3/deprecated.h"
@@ -50,6 +52,14 @@ namespace ns3 {
  * This class also supports the regular comparison operators \c <, \c >,
  * \c <=, \c >=, \c ==, and \c !=
  *
+ * A DataRate is a single integer number of bit/s: it is trivially
+ * copyable, and the constructors, comparisons, Scale (), Min () and
+ * Max () are constexpr integer operations, e.g.
+ * \code
+ *   constexpr DataRate link (10000000);
+ *   constexpr DataRate probe = link.Scale (5, 4);   // 12.5 Mbit/s
+ * \endcode
+ *
  * Data rate specifiers consist of
  * * A numeric value,
  * * An optional multiplier prefix and
@@ -88,7 +98,10 @@ namespace ns3 {
 class DataRate
 {
 public:
-  DataRate ();
+  constexpr DataRate ()
+    : m_bps (0)
+  {
+  }
   /**
    * \brief Integer constructor
    *
@@ -97,7 +110,10 @@ public:
    * non-trivial bitrate available.
    * \param bps bit/s value
    */
-  DataRate (uint64_t bps);
+  constexpr DataRate (uint64_t bps)
+    : m_bps (bps)
+  {
+  }
   /**
    * \brief String constructor
    *
@@ -123,42 +139,74 @@ public:
    *
    * \param rhs the datarate to compare to this datarate
    */  
-  bool operator <  (const DataRate& rhs) const;
+  constexpr bool operator <  (const DataRate& rhs) const
+  {
+    return m_bps < rhs.m_bps;
+  }
 
   /**
    * \return true if this rate is less than or equal to rhs
    *
    * \param rhs the datarate to compare to this datarate
    */ 
-  bool operator <= (const DataRate& rhs) const;
+  constexpr bool operator <= (const DataRate& rhs) const
+  {
+    return m_bps <= rhs.m_bps;
+  }
   
   /**
    * \return true if this rate is greater than rhs
    *
    * \param rhs the datarate to compare to this datarate
    */   
-  bool operator >  (const DataRate& rhs) const;
+  constexpr bool operator >  (const DataRate& rhs) const
+  {
+    return m_bps > rhs.m_bps;
+  }
   
   /**
    * \return true if this rate is greater than or equal to rhs
    *
    * \param rhs the datarate to compare to this datarate
    */   
-  bool operator >= (const DataRate& rhs) const;
+  constexpr bool operator >= (const DataRate& rhs) const
+  {
+    return m_bps >= rhs.m_bps;
+  }
   
   /**
    * \return true if this rate is equal to rhs
    *
    * \param rhs the datarate to compare to this datarate
    */   
-  bool operator == (const DataRate& rhs) const;
+  constexpr bool operator == (const DataRate& rhs) const
+  {
+    return m_bps == rhs.m_bps;
+  }
   
   /**
    * \return true if this rate is not equal to rhs
    *
    * \param rhs the datarate to compare to this datarate
    */   
-  bool operator != (const DataRate& rhs) const;
+  constexpr bool operator != (const DataRate& rhs) const
+  {
+    return m_bps != rhs.m_bps;
+  }
+
+  /**
+   * \brief Scale by a rational gain
+   *
+   * The product is computed without a 64 bit overflow as long as the
+   * result itself fits, e.g. a gain in BBR units is Scale (gain, 256).
+   * \param num the gain numerator
+   * \param den the gain denominator, not zero
+   * \return this rate times num / den, rounded down
+   */
+  constexpr DataRate Scale (uint32_t num, uint32_t den) const
+  {
+    return DataRate (m_bps / den * num + m_bps % den * num / den);
+  }
 
   /**
    * \brief Calculate transmission time
@@ -167,7 +215,10 @@ public:
    * \param bytes The number of bytes (not bits) for which to calculate
    * \return The transmission time for the number of bytes specified
    */
-  Time CalculateBytesTxTime (uint32_t bytes) const;
+  Time CalculateBytesTxTime (uint32_t bytes) const
+  {
+    return RateMath::TxTime (bytes, m_bps);
+  }
 
   /**
    * \brief Calculate transmission time
@@ -182,7 +233,10 @@ public:
    * Get the underlying bitrate
    * \return The underlying bitrate in bits per second
    */
-  uint64_t GetBitRate () const;
+  constexpr uint64_t GetBitRate () const
+  {
+    return m_bps;
+  }
 
 private:
 
@@ -217,6 +271,35 @@ private:
  */
 std::ostream &operator << (std::ostream &os, const DataRate &rate);
 
+/**
+ * \ingroup datarate
+ * \brief Minimum of two data rates
+ * \param [in] lhs The first rate
+ * \param [in] rhs The second rate
+ * \returns The lower rate
+ */
+inline constexpr DataRate
+Min (const DataRate &lhs, const DataRate &rhs)
+{
+  return lhs < rhs ? lhs : rhs;
+}
+/**
+ * \ingroup datarate
+ * \brief Maximum of two data rates
+ * \param [in] lhs The first rate
+ * \param [in] rhs The second rate
+ * \returns The higher rate
+ */
+inline constexpr DataRate
+Max (const DataRate &lhs, const DataRate &rhs)
+{
+  return lhs < rhs ? rhs : lhs;
+}
+
+// Kept in the filters and traced values of the congestion controls
+static_assert (sizeof (DataRate) == sizeof (uint64_t), "DataRate must stay a single uint64_t");
+static_assert (std::is_trivially_copyable<DataRate>::value, "DataRate must stay trivially copyable");
+
 /**
  * \brief Stream extraction operator.
  *
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include "departure-time-tag.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (DepartureTimeTag);
+
+TypeId
+DepartureTimeTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DepartureTimeTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Network")
+    .AddConstructor<DepartureTimeTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+DepartureTimeTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+DepartureTimeTag::GetSerializedSize (void) const
+{
+  return 8;
+}
+
+void
+DepartureTimeTag::Serialize (TagBuffer buf) const
+{
+  buf.WriteU64 (static_cast<uint64_t> (m_departure.GetTimeStep ()));
+}
+
+void
+DepartureTimeTag::Deserialize (TagBuffer buf)
+{
+  m_departure = TimeStep (buf.ReadU64 ());
+}
+
+void
+DepartureTimeTag::Print (std::ostream &os) const
+{
+  os << "Departure=" << m_departure;
+}
+
+DepartureTimeTag::DepartureTimeTag ()
+  : Tag (),
+    m_departure (Time (0))
+{
+}
+
+DepartureTimeTag::DepartureTimeTag (Time departure)
+  : Tag (),
+    m_departure (departure)
+{
+}
+
+void
+DepartureTimeTag::SetDepartureTime (Time departure)
+{
+  m_departure = departure;
+}
+
+Time
+DepartureTimeTag::GetDepartureTime (void) const
+{
+  return m_departure;
+}
+
+} // namespace ns3
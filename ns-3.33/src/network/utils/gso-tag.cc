@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include <map>
+#include "gso-tag.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("GsoTag");
+
+NS_OBJECT_ENSURE_REGISTERED (GsoTag);
+
+TypeId
+GsoTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::GsoTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Network")
+    .AddConstructor<GsoTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+GsoTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+GsoTag::GetSerializedSize (void) const
+{
+  return 4;
+}
+
+void
+GsoTag::Serialize (TagBuffer buf) const
+{
+  buf.WriteU16 (m_segmentSize);
+  buf.WriteU16 (m_segments);
+}
+
+void
+GsoTag::Deserialize (TagBuffer buf)
+{
+  m_segmentSize = buf.ReadU16 ();
+  m_segments = buf.ReadU16 ();
+}
+
+void
+GsoTag::Print (std::ostream &os) const
+{
+  os << "GsoSegmentSize=" << m_segmentSize << " GsoSegments=" << m_segments;
+}
+
+GsoTag::GsoTag ()
+  : Tag (),
+    m_segmentSize (0),
+    m_segments (0)
+{
+}
+
+GsoTag::GsoTag (uint16_t segmentSize, uint16_t segments)
+  : Tag (),
+    m_segmentSize (segmentSize),
+    m_segments (segments)
+{
+}
+
+void
+GsoTag::SetSegmentSize (uint16_t segmentSize)
+{
+  m_segmentSize = segmentSize;
+}
+
+uint16_t
+GsoTag::GetSegmentSize (void) const
+{
+  return m_segmentSize;
+}
+
+void
+GsoTag::SetSegmentCount (uint16_t segments)
+{
+  m_segments = segments;
+}
+
+uint16_t
+GsoTag::GetSegmentCount (void) const
+{
+  return m_segments;
+}
+
+namespace {
+
+std::map<uint16_t, GsoSegmentation::SegmentCallback> &
+GetSegmenters (void)
+{
+  static std::map<uint16_t, GsoSegmentation::SegmentCallback> segmenters;
+  return segmenters;
+}
+
+} // unnamed namespace
+
+void
+GsoSegmentation::Register (uint16_t protocolNumber, SegmentCallback cb)
+{
+  NS_LOG_FUNCTION (protocolNumber);
+  GetSegmenters ()[protocolNumber] = cb;
+}
+
+bool
+GsoSegmentation::Segment (Ptr<Packet> packet, uint16_t protocolNumber,
+                          std::list<Ptr<Packet> > &segments)
+{
+  NS_LOG_FUNCTION (packet << protocolNumber);
+  GsoTag tag;
+  if (!packet->PeekPacketTag (tag))
+    {
+      return false;
+    }
+  std::map<uint16_t, SegmentCallback>::const_iterator it = GetSegmenters ().find (protocolNumber);
+  if (it == GetSegmenters ().end () || it->second.IsNull ())
+    {
+      NS_LOG_WARN ("No segmentation function for protocol " << protocolNumber);
+      return false;
+    }
+  segments = it->second (packet);
+  NS_LOG_LOGIC ("Split " << packet->GetSize () << " bytes into " << segments.size () << " segments");
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef GSO_TAG_H
+#define GSO_TAG_H
+
+#include <list>
+#include "ns3/tag.h"
+#include "ns3/packet.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Packet tag marking a generic segmentation offload super-segment.
+ *
+ * A transport protocol may hand down a single packet carrying several
+ * segments worth of payload.  The tag records the payload size of each
+ * wire segment and their number, like gso_size and gso_segs of a Linux
+ * skb; the packet is split by GsoSegmentation just before it is put on
+ * the wire.
+ */
+class GsoTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+  GsoTag ();
+  /**
+   * \brief Constructs a GsoTag with the given segment size
+   * \param segmentSize payload bytes carried by each wire segment
+   * \param segments number of wire segments, 0 if unknown
+   */
+  GsoTag (uint16_t segmentSize, uint16_t segments = 0);
+  /**
+   * \brief Set the payload size of each wire segment
+   * \param segmentSize payload bytes carried by each wire segment
+   */
+  void SetSegmentSize (uint16_t segmentSize);
+  /**
+   * \brief Get the payload size of each wire segment
+   * \returns payload bytes carried by each wire segment
+   */
+  uint16_t GetSegmentSize (void) const;
+  /**
+   * \brief Set the number of wire segments
+   * \param segments number of wire segments, 0 if unknown
+   */
+  void SetSegmentCount (uint16_t segments);
+  /**
+   * \brief Get the number of wire segments
+   * \returns number of wire segments, 0 if unknown
+   */
+  uint16_t GetSegmentCount (void) const;
+private:
+  uint16_t m_segmentSize; //!< Payload size of each wire segment
+  uint16_t m_segments;    //!< Number of wire segments
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief Registry of per-protocol segmentation functions.
+ *
+ * Protocol modules register a function that splits a super-segment
+ * (starting with their network header) into wire-sized packets.  Net
+ * devices call Segment () on packets carrying a GsoTag, so the devices
+ * do not need to know anything about the layers above them.
+ */
+class GsoSegmentation
+{
+public:
+  /**
+   * Callback splitting a super-segment into wire segments.  The packet
+   * starts with the network header of the registered protocol.
+   */
+  typedef Callback<std::list<Ptr<Packet> >, Ptr<Packet> > SegmentCallback;
+  /**
+   * \brief Register the segmentation function of a protocol
+   * \param protocolNumber the EtherType of the protocol
+   * \param cb the segmentation function
+   */
+  static void Register (uint16_t protocolNumber, SegmentCallback cb);
+  /**
+   * \brief Split a packet carrying a GsoTag into wire segments
+   * \param packet the packet, starting with the network header
+   * \param protocolNumber the EtherType of the packet
+   * \param segments filled with the wire segments, in order
+   * \returns false if the packet is not a super-segment or no function
+   *          is registered for the protocol; segments is left untouched
+   */
+  static bool Segment (Ptr<Packet> packet, uint16_t protocolNumber,
+                       std::list<Ptr<Packet> > &segments);
+};
+
+} // namespace ns3
+
+#endif /* GSO_TAG_H */
@@ -21,6 +21,8 @@
 #include "ns3/address.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/replication-context.h"
+#include "ns3/simulation-singleton.h"
 #include <iomanip>
 #include <iostream>
 #include <cstring>
@@ -29,6 +31,20 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Mac48Address");
 
+namespace {
+
+/**
+ * \ingroup address
+ * The addresses allocated by a replication.
+ */
+struct Mac48AllocationState
+{
+  Mac48AllocationState () : id (0) {}
+  uint64_t id; //!< The last allocated address
+};
+
+} // unnamed namespace
+
 ATTRIBUTE_HELPER_CPP (Mac48Address);
 
 #define ASCII_a (0x41)
@@ -135,8 +151,14 @@ Mac48Address
 Mac48Address::Allocate (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint64_t id = 0;
-  id++;
+  static uint64_t lastId = 0;
+  uint64_t *pid = &lastId;
+  if (ReplicationContext::IsActive ())
+    {
+      // Each replication allocates from the start, like a new process
+      pid = &SimulationSingleton<Mac48AllocationState>::Get ()->id;
+    }
+  uint64_t id = ++(*pid);
   Mac48Address address;
   address.m_address[0] = (id >> 40) & 0xff;
   address.m_address[1] = (id >> 32) & 0xff;
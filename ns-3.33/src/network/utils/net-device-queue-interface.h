@@ -131,6 +131,17 @@ public:
    */
   virtual void NotifyTransmittedBytes (uint32_t bytes);
 
+  /**
+   * \brief Let the netdevice report the transmitted bytes
+   * \param enable true if the netdevice calls NotifyTransmittedBytes
+   *
+   * By default, the bytes of a packet are reported to the queue limits when
+   * the packet is dequeued from the device queue.  A netdevice which holds
+   * the packet until the end of its transmission can report the bytes itself,
+   * so that the queue limits also account for the packet being transmitted.
+   */
+  void SetTransmittedBytesByDevice (bool enable);
+
   /**
    * \brief Reset queue limits state
    */
@@ -207,6 +218,7 @@ private:
   bool m_stoppedByDevice;         //!< True if the queue has been stopped by the device
   bool m_stoppedByQueueLimits;    //!< True if the queue has been stopped by a queue limits object
   Ptr<QueueLimits> m_queueLimits; //!< Queue limits object
+  bool m_txBytesByDevice;         //!< True if the netdevice reports the transmitted bytes
   WakeCallback m_wakeCallback;    //!< Wake callback
   Ptr<NetDevice> m_device;        //!< the netdevice aggregated to the NetDeviceQueueInterface
 
@@ -366,8 +378,11 @@ NetDeviceQueue::PacketDequeued (QueueType* queue, Ptr<const typename QueueType::
 {
   NS_LOG_FUNCTION (this << queue << item);
 
-  // Inform BQL
-  NotifyTransmittedBytes (item->GetSize ());
+  // Inform BQL, unless the device does at the end of the transmission
+  if (!m_txBytesByDevice)
+    {
+      NotifyTransmittedBytes (item->GetSize ());
+    }
 
   NS_ASSERT_MSG (m_device, "Aggregated NetDevice not set");
   Ptr<Packet> p = Create<Packet> (m_device->GetMtu ());
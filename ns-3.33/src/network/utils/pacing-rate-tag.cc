@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include "pacing-rate-tag.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (PacingRateTag);
+
+TypeId
+PacingRateTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PacingRateTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Network")
+    .AddConstructor<PacingRateTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+PacingRateTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+PacingRateTag::GetSerializedSize (void) const
+{
+  return 8;
+}
+
+void
+PacingRateTag::Serialize (TagBuffer buf) const
+{
+  buf.WriteU64 (m_rate.GetBitRate ());
+}
+
+void
+PacingRateTag::Deserialize (TagBuffer buf)
+{
+  m_rate = DataRate (buf.ReadU64 ());
+}
+
+void
+PacingRateTag::Print (std::ostream &os) const
+{
+  os << "PacingRate=" << m_rate;
+}
+
+PacingRateTag::PacingRateTag ()
+  : Tag (),
+    m_rate (0)
+{
+}
+
+PacingRateTag::PacingRateTag (DataRate rate)
+  : Tag (),
+    m_rate (rate)
+{
+}
+
+void
+PacingRateTag::SetPacingRate (DataRate rate)
+{
+  m_rate = rate;
+}
+
+DataRate
+PacingRateTag::GetPacingRate (void) const
+{
+  return m_rate;
+}
+
+} // namespace ns3
@@ -0,0 +1,266 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include <algorithm>
+#include <cstring>
+#include "ns3/log.h"
+#include "ns3/hash.h"
+#include "pcap-capture-filter.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapCaptureFilter");
+
+NS_OBJECT_ENSURE_REGISTERED (PcapCaptureFilter);
+
+namespace {
+
+// Values of PcapHelper::DataLinkType
+const uint32_t DLT_NULL = 0;
+const uint32_t DLT_EN10MB = 1;
+const uint32_t DLT_PPP = 9;
+const uint32_t DLT_RAW = 101;
+
+const uint16_t PPP_IPV4 = 0x0021;
+const uint16_t ETHERTYPE_IPV4 = 0x0800;
+const uint16_t ETHERTYPE_VLAN = 0x8100;
+const uint32_t AF_INET_FAMILY = 2;
+
+const uint8_t PROTOCOL_TCP = 6;
+const uint8_t PROTOCOL_UDP = 17;
+
+/**
+ * \param frame the first bytes of the frame
+ * \param size the number of bytes
+ * \param dataLinkType the data link type of the frame
+ * \returns the offset of the IPv4 header, or size if there is none
+ */
+uint32_t
+GetIpv4Offset (uint8_t const *frame, uint32_t size, uint32_t dataLinkType)
+{
+  switch (dataLinkType)
+    {
+    case DLT_PPP:
+      if (size >= 2 && ((frame[0] << 8) | frame[1]) == PPP_IPV4)
+        {
+          return 2;
+        }
+      break;
+    case DLT_EN10MB:
+      if (size >= 14)
+        {
+          uint16_t etherType = (frame[12] << 8) | frame[13];
+          if (etherType == ETHERTYPE_IPV4)
+            {
+              return 14;
+            }
+          if (etherType == ETHERTYPE_VLAN && size >= 18
+              && ((frame[16] << 8) | frame[17]) == ETHERTYPE_IPV4)
+            {
+              return 18;
+            }
+        }
+      break;
+    case DLT_RAW:
+      return 0;
+    case DLT_NULL:
+      // The family is in the byte order of the host which wrote the file
+      if (size >= 4 && (frame[0] == AF_INET_FAMILY || frame[3] == AF_INET_FAMILY))
+        {
+          return 4;
+        }
+      break;
+    default:
+      break;
+    }
+  return size;
+}
+
+} // unnamed namespace
+
+TypeId
+PcapCaptureFilter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PcapCaptureFilter")
+    .SetParent<Object> ()
+    .SetGroupName ("Network")
+    .AddConstructor<PcapCaptureFilter> ()
+  ;
+  return tid;
+}
+
+PcapCaptureFilter::PcapCaptureFilter ()
+  : m_snapLen (0),
+    m_sampling (1)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapCaptureFilter::~PcapCaptureFilter ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PcapCaptureFilter::SetSnapLength (uint32_t snapLen)
+{
+  NS_LOG_FUNCTION (this << snapLen);
+  m_snapLen = snapLen;
+}
+
+uint32_t
+PcapCaptureFilter::GetSnapLength (void) const
+{
+  return m_snapLen;
+}
+
+void
+PcapCaptureFilter::AddFlow (Ipv4Address src, Ipv4Address dst, uint8_t protocol,
+                            uint16_t srcPort, uint16_t dstPort)
+{
+  NS_LOG_FUNCTION (this << src << dst << +protocol << srcPort << dstPort);
+  Flow flow;
+  flow.src = src;
+  flow.dst = dst;
+  flow.protocol = protocol;
+  flow.srcPort = srcPort;
+  flow.dstPort = dstPort;
+  m_flows.push_back (flow);
+}
+
+void
+PcapCaptureFilter::SetFlowSampling (uint32_t k)
+{
+  NS_LOG_FUNCTION (this << k);
+  m_sampling = k == 0 ? 1 : k;
+}
+
+void
+PcapCaptureFilter::AddTimeWindow (Time start, Time stop)
+{
+  NS_LOG_FUNCTION (this << start << stop);
+  m_windows.push_back (std::make_pair (start, stop));
+}
+
+bool
+PcapCaptureFilter::IsCapturedAt (Time t) const
+{
+  if (m_windows.empty ())
+    {
+      return true;
+    }
+  for (std::vector<std::pair<Time, Time> >::const_iterator i = m_windows.begin (); i != m_windows.end (); ++i)
+    {
+      if (t >= i->first && t < i->second)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+PcapCaptureFilter::IsFlowFiltered (void) const
+{
+  return !m_flows.empty () || m_sampling > 1;
+}
+
+bool
+PcapCaptureFilter::Matches (Flow const &flow, Ipv4Address src, Ipv4Address dst, uint8_t protocol,
+                            uint16_t srcPort, uint16_t dstPort)
+{
+  return (flow.src.IsAny () || flow.src == src)
+         && (flow.dst.IsAny () || flow.dst == dst)
+         && (flow.protocol == 0 || flow.protocol == protocol)
+         && (flow.srcPort == 0 || flow.srcPort == srcPort)
+         && (flow.dstPort == 0 || flow.dstPort == dstPort);
+}
+
+bool
+PcapCaptureFilter::IsFlowCaptured (uint32_t dataLinkType, uint8_t const *frame, uint32_t size) const
+{
+  if (!IsFlowFiltered ())
+    {
+      return true;
+    }
+  uint32_t offset = GetIpv4Offset (frame, size, dataLinkType);
+  if (offset + 20 > size || (frame[offset] >> 4) != 4)
+    {
+      return false;
+    }
+  uint8_t const *ip = frame + offset;
+  uint32_t headerSize = (ip[0] & 0x0f) * 4;
+  uint8_t protocol = ip[9];
+  Ipv4Address src = Ipv4Address::Deserialize (ip + 12);
+  Ipv4Address dst = Ipv4Address::Deserialize (ip + 16);
+  uint16_t srcPort = 0;
+  uint16_t dstPort = 0;
+  bool firstFragment = (((ip[6] & 0x1f) << 8) | ip[7]) == 0;
+  if ((protocol == PROTOCOL_TCP || protocol == PROTOCOL_UDP)
+      && firstFragment && offset + headerSize + 4 <= size)
+    {
+      uint8_t const *ports = ip + headerSize;
+      srcPort = (ports[0] << 8) | ports[1];
+      dstPort = (ports[2] << 8) | ports[3];
+    }
+
+  if (!m_flows.empty ())
+    {
+      bool found = false;
+      for (std::vector<Flow>::const_iterator i = m_flows.begin (); i != m_flows.end () && !found; ++i)
+        {
+          found = Matches (*i, src, dst, protocol, srcPort, dstPort)
+            || Matches (*i, dst, src, protocol, dstPort, srcPort);
+        }
+      if (!found)
+        {
+          return false;
+        }
+    }
+
+  if (m_sampling > 1)
+    {
+      // Order the end points, so that both directions of a flow hash alike
+      uint8_t const *a = ip + 12;
+      uint8_t const *b = ip + 16;
+      uint16_t aPort = srcPort;
+      uint16_t bPort = dstPort;
+      if (std::memcmp (a, b, 4) > 0 || (std::memcmp (a, b, 4) == 0 && aPort > bPort))
+        {
+          std::swap (a, b);
+          std::swap (aPort, bPort);
+        }
+      char key[13];
+      std::memcpy (key, a, 4);
+      std::memcpy (key + 4, b, 4);
+      key[8] = aPort >> 8;
+      key[9] = aPort & 0xff;
+      key[10] = bPort >> 8;
+      key[11] = bPort & 0xff;
+      key[12] = protocol;
+      if (Hash32 (key, sizeof (key)) % m_sampling != 0)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+} // namespace ns3
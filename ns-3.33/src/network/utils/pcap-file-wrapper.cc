@@ -16,9 +16,13 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include "ns3/log.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "ns3/fatal-error.h"
+#include "ns3/pointer.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
 #include "pcap-file-wrapper.h"
@@ -46,6 +50,24 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("AsyncWrite",
+                   "Whether the file is written by a background thread",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asyncWrite),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Compression",
+                   "Compression of the file; a compressed file is always "
+                   "written by a background thread",
+                   EnumValue (AsyncFileBuf::NONE),
+                   MakeEnumAccessor (&PcapFileWrapper::m_compression),
+                   MakeEnumChecker (AsyncFileBuf::NONE, "None",
+                                    AsyncFileBuf::GZIP, "Gzip"))
+    .AddAttribute ("CaptureFilter",
+                   "Selection of the packets written to the file; "
+                   "all of them are written when not set",
+                   PointerValue (),
+                   MakePointerAccessor (&PcapFileWrapper::m_filter),
+                   MakePointerChecker<PcapCaptureFilter> ())
   ;
   return tid;
 }
@@ -93,6 +115,24 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  bool writeOnly = (mode & std::ios::out) && !(mode & std::ios::in);
+  if (writeOnly && (m_asyncWrite || m_compression != AsyncFileBuf::NONE))
+    {
+      if (!AsyncFileBuf::IsSupported (m_compression))
+        {
+          NS_FATAL_ERROR ("PcapFileWrapper::Open(): compression not supported by this build");
+        }
+      std::string name = filename;
+      const std::string suffix = ".gz";
+      if (m_compression == AsyncFileBuf::GZIP
+          && (name.size () < suffix.size ()
+              || name.compare (name.size () - suffix.size (), suffix.size (), suffix) != 0))
+        {
+          name += suffix;
+        }
+      m_file.OpenAsync (name, m_compression);
+      return;
+    }
   m_file.Open (filename, mode);
 }
 
@@ -105,6 +145,11 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
   // a snaplen, we use the one provided.
   //
   NS_LOG_FUNCTION (this << dataLinkType << snapLen << tzCorrection);
+  if (m_filter != 0 && m_filter->GetSnapLength () != 0)
+    {
+      uint32_t fileSnapLen = snapLen != std::numeric_limits<uint32_t>::max () ? snapLen : m_snapLen;
+      snapLen = std::min (fileSnapLen, m_filter->GetSnapLength ());
+    }
   if (snapLen != std::numeric_limits<uint32_t>::max ())
     {
       m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
@@ -119,6 +164,10 @@ void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_filter != 0 && !IsCaptured (t, 0, p))
+    {
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -139,6 +188,10 @@ void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_filter != 0 && !IsCaptured (t, &header, p))
+    {
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -159,6 +212,12 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_filter != 0
+      && (!m_filter->IsCapturedAt (t)
+          || !m_filter->IsFlowCaptured (m_file.GetDataLinkType (), buffer, length)))
+    {
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -175,6 +234,32 @@ PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
     }
 }
 
+bool
+PcapFileWrapper::IsCaptured (Time t, Header const *header, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << t << header << p);
+  if (!m_filter->IsCapturedAt (t))
+    {
+      return false;
+    }
+  if (!m_filter->IsFlowFiltered ())
+    {
+      return true;
+    }
+  // Only the headers are needed: the packet itself is not copied
+  uint8_t frame[PcapCaptureFilter::MAX_HEADER_BYTES];
+  uint32_t size = 0;
+  if (header != 0)
+    {
+      Buffer headerBuffer;
+      headerBuffer.AddAtStart (header->GetSerializedSize ());
+      header->Serialize (headerBuffer.Begin ());
+      size = headerBuffer.CopyData (frame, sizeof (frame));
+    }
+  size += p->CopyData (frame + size, sizeof (frame) - size);
+  return m_filter->IsFlowCaptured (m_file.GetDataLinkType (), frame, size);
+}
+
 Ptr<Packet> 
 PcapFileWrapper::Read (Time &t)
 {
@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcap-capture-filter.h"
 
 namespace ns3 {
 
@@ -66,6 +67,11 @@ public:
    * Create a new pcap file or open an existing pcap file.  Semantics are
    * similar to the stdc++ io stream classes.
    *
+   * With the AsyncWrite or Compression attributes, a file opened for
+   * writing only is written by a background thread, see
+   * PcapFile::OpenAsync.  A ".gz" suffix is added to the name of
+   * compressed files.
+   *
    * Since a pcap file is always a binary file, the file type is automatically 
    * selected as a binary file (fstream::binary is automatically ored with the mode
    * field).
@@ -97,6 +103,7 @@ public:
    *
    * \param snapLen An optional maximum size for packets written to the file.
    * Defaults to 65535.  If packets exceed this length they are truncated.
+   * The snap length of the capture filter, if any, applies as well.
    *
    * \param tzCorrection An integer describing the offset of your local
    * time zone from UTC/GMT.  For example, Pacific Standard Time in the US is
@@ -221,9 +228,25 @@ public:
   uint32_t GetDataLinkType (void);
 
 private:
+  /**
+   * \brief Check a packet against the capture filter.
+   *
+   * Only the first bytes of the frame are read, and only when the filter
+   * selects flows.
+   *
+   * \param t Packet timestamp as ns3::Time.
+   * \param header The Header prepended to the packet, or 0.
+   * \param p Packet to write to the pcap file.
+   * \returns true if the packet is to be written
+   */
+  bool IsCaptured (Time t, Header const *header, Ptr<const Packet> p);
+
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  bool     m_asyncWrite; //!< Write the file in a background thread
+  AsyncFileBuf::Compression m_compression; //!< Compression of the written file
+  Ptr<PcapCaptureFilter> m_filter; //!< Selection of the written packets
 };
 
 } // namespace ns3
@@ -49,6 +49,7 @@ const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pc
 
 PcapFile::PcapFile ()
   : m_file (),
+    m_asyncBuf (0),
     m_swapMode (false),
     m_nanosecMode (false)
 {
@@ -88,6 +89,15 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_asyncBuf != 0)
+    {
+      // Back to the (closed) file buffer of the stream
+      m_file.std::ios::rdbuf (m_file.rdbuf ());
+      m_asyncBuf->Close ();
+      delete m_asyncBuf;
+      m_asyncBuf = 0;
+      return;
+    }
   m_file.close ();
 }
 
@@ -341,6 +351,26 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
     }
 }
 
+void
+PcapFile::OpenAsync (std::string const &filename, AsyncFileBuf::Compression compression)
+{
+  NS_LOG_FUNCTION (this << filename << compression);
+  NS_ASSERT (!m_file.fail ());
+  NS_ASSERT (m_asyncBuf == 0);
+
+  m_filename = filename;
+  AsyncFileBuf *buf = new AsyncFileBuf;
+  if (!buf->Open (filename, compression))
+    {
+      delete buf;
+      m_file.setstate (std::ios::failbit);
+      return;
+    }
+  m_asyncBuf = buf;
+  // Every write to m_file now goes to the background thread
+  m_file.std::ios::rdbuf (m_asyncBuf);
+}
+
 void
 PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrection, bool swapMode, bool nanosecMode)
 {
@@ -25,6 +25,7 @@
 #include <fstream>
 #include <stdint.h>
 #include "ns3/ptr.h"
+#include "async-file-buf.h"
 
 namespace ns3 {
 
@@ -80,6 +81,19 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * Create a new pcap file written by a background thread.
+   *
+   * The records are batched in memory and written by the thread shared
+   * by all the files opened this way, see AsyncFileBuf.  The file can
+   * only be written.
+   *
+   * \param filename String containing the name of the file.
+   *
+   * \param compression the compression of the file.
+   */
+  void OpenAsync (std::string const &filename, AsyncFileBuf::Compression compression);
+
   /**
    * Close the underlying file.
    */
@@ -368,6 +382,7 @@ private:
 
   std::string    m_filename;    //!< file name
   std::fstream   m_file;        //!< file stream
+  AsyncFileBuf  *m_asyncBuf;    //!< buffer written by a background thread, if any
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
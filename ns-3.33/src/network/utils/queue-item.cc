@@ -21,11 +21,15 @@
 #include "queue-item.h"
 #include "ns3/packet.h"
 #include "ns3/log.h"
+#include "ns3/per-thread-pool.h"
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("QueueItem");
 
+/// Released QueueDiscItem objects, in blocks of POOLED_ITEM_SIZE bytes
+typedef PerThreadPool<QueueDiscItem, QueueDiscItem::MAX_POOLED_ITEMS> QueueDiscItemPool;
+
 QueueItem::QueueItem (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << p);
@@ -87,6 +91,43 @@ QueueDiscItem::~QueueDiscItem()
   NS_LOG_FUNCTION (this);
 }
 
+void *
+QueueDiscItem::operator new (std::size_t size)
+{
+  if (size > POOLED_ITEM_SIZE)
+    {
+      return ::operator new (size);
+    }
+  void *p = QueueDiscItemPool::Pop ();
+  if (p != 0)
+    {
+      return p;
+    }
+  return ::operator new (POOLED_ITEM_SIZE);
+}
+
+void
+QueueDiscItem::operator delete (void *p, std::size_t size)
+{
+  if (size > POOLED_ITEM_SIZE || !QueueDiscItemPool::Push (static_cast<QueueDiscItem *> (p)))
+    {
+      ::operator delete (p);
+    }
+}
+
+void
+QueueDiscItem::PeekPorts (Ptr<const Packet> p, uint16_t &srcPort, uint16_t &dstPort)
+{
+  uint8_t buf[4];
+  if (p->CopyData (buf, 4) < 4)
+    {
+      srcPort = dstPort = 0;
+      return;
+    }
+  srcPort = (buf[0] << 8) | buf[1];
+  dstPort = (buf[2] << 8) | buf[3];
+}
+
 Address
 QueueDiscItem::GetAddress (void) const
 {
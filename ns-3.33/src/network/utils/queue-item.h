@@ -24,6 +24,7 @@
 #include "ns3/simple-ref-count.h"
 #include <ns3/address.h>
 #include "ns3/nstime.h"
+#include <cstddef>
 
 namespace ns3 {
 
@@ -226,6 +227,45 @@ public:
    */
   virtual uint32_t Hash (uint32_t perturbation = 0) const;
 
+  /**
+   * \brief Allocate a queue disc item from the item pool.
+   *
+   * A queue disc item is created for every packet sent through the traffic
+   * control layer and released when the packet leaves the queue disc, so
+   * the storage of the released items is kept in a PerThreadPool, up to
+   * MAX_POOLED_ITEMS of them, and reused by the next allocations.
+   * The items of a subclass up to POOLED_ITEM_SIZE bytes are pooled.
+   *
+   * \param [in] size The size of the object.
+   * \returns Storage for the item.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * \brief Return a queue disc item to the item pool.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the object.
+   */
+  static void operator delete (void *p, std::size_t size);
+
+  /** Largest number of released items kept by each thread. */
+  static const uint32_t MAX_POOLED_ITEMS = 1000;
+  /** Size of the pooled blocks, enough for the IPv4 and IPv6 items. */
+  static const uint32_t POOLED_ITEM_SIZE = 256;
+
+protected:
+  /**
+   * \brief Read the transport ports at the front of the packet
+   *
+   * TCP, UDP, DCCP and SCTP all start with the source and destination
+   * ports, so four bytes are read instead of a whole header.
+   *
+   * \param [in] p The packet, starting with the transport header.
+   * \param [out] srcPort The source port, 0 if the packet is too short.
+   * \param [out] dstPort The destination port, 0 if the packet is too short.
+   */
+  static void PeekPorts (Ptr<const Packet> p, uint16_t &srcPort, uint16_t &dstPort);
+
 private:
   /**
    * \brief Default constructor
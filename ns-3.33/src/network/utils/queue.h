@@ -398,6 +398,32 @@ protected:
    */
   Ptr<const Item> DoPeek (ConstIterator pos) const;
 
+  /**
+   * \brief Check that an item fits in the queue before pushing it
+   * \param item the item to enqueue
+   * \return true if the item fits, false if it has been dropped.
+   *
+   * DoEnqueue, DoDequeue and DoRemove keep the items in a list.  A subclass
+   * storing the items elsewhere calls AdmitEnqueue, NotifyEnqueued and
+   * NotifyDequeued instead, so that the statistics and the trace sources
+   * are maintained alike.
+   */
+  bool AdmitEnqueue (Ptr<Item> item);
+
+  /**
+   * \brief Account for an item pushed in the queue
+   * \param item the item enqueued
+   */
+  void NotifyEnqueued (Ptr<Item> item);
+
+  /**
+   * \brief Account for an item pulled from the queue
+   * \param item the item dequeued
+   *
+   * An item pulled to be dropped is then passed to DropAfterDequeue.
+   */
+  void NotifyDequeued (Ptr<Item> item);
+
   /**
    * \brief Drop a packet before enqueue
    * \param item item that was dropped
@@ -483,24 +509,13 @@ Queue<Item>::DoEnqueue (ConstIterator pos, Ptr<Item> item)
 {
   NS_LOG_FUNCTION (this << item);
 
-  if (GetCurrentSize () + item > GetMaxSize ())
+  if (!AdmitEnqueue (item))
     {
-      NS_LOG_LOGIC ("Queue full -- dropping pkt");
-      DropBeforeEnqueue (item);
       return false;
     }
 
   m_packets.insert (pos, item);
-
-  uint32_t size = item->GetSize ();
-  m_nBytes += size;
-  m_nTotalReceivedBytes += size;
-
-  m_nPackets++;
-  m_nTotalReceivedPackets++;
-
-  NS_LOG_LOGIC ("m_traceEnqueue (p)");
-  m_traceEnqueue (item);
+  NotifyEnqueued (item);
 
   return true;
 }
@@ -522,14 +537,7 @@ Queue<Item>::DoDequeue (ConstIterator pos)
 
   if (item != 0)
     {
-      NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
-      NS_ASSERT (m_nPackets.Get () > 0);
-
-      m_nBytes -= item->GetSize ();
-      m_nPackets--;
-
-      NS_LOG_LOGIC ("m_traceDequeue (p)");
-      m_traceDequeue (item);
+      NotifyDequeued (item);
     }
   return item;
 }
@@ -551,21 +559,55 @@ Queue<Item>::DoRemove (ConstIterator pos)
 
   if (item != 0)
     {
-      NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
-      NS_ASSERT (m_nPackets.Get () > 0);
-
-      m_nBytes -= item->GetSize ();
-      m_nPackets--;
-
       // packets are first dequeued and then dropped
-      NS_LOG_LOGIC ("m_traceDequeue (p)");
-      m_traceDequeue (item);
-
+      NotifyDequeued (item);
       DropAfterDequeue (item);
     }
   return item;
 }
 
+template <typename Item>
+bool
+Queue<Item>::AdmitEnqueue (Ptr<Item> item)
+{
+  if (GetCurrentSize () + item > GetMaxSize ())
+    {
+      NS_LOG_LOGIC ("Queue full -- dropping pkt");
+      DropBeforeEnqueue (item);
+      return false;
+    }
+  return true;
+}
+
+template <typename Item>
+void
+Queue<Item>::NotifyEnqueued (Ptr<Item> item)
+{
+  uint32_t size = item->GetSize ();
+  m_nBytes += size;
+  m_nTotalReceivedBytes += size;
+
+  m_nPackets++;
+  m_nTotalReceivedPackets++;
+
+  NS_LOG_LOGIC ("m_traceEnqueue (p)");
+  m_traceEnqueue (item);
+}
+
+template <typename Item>
+void
+Queue<Item>::NotifyDequeued (Ptr<Item> item)
+{
+  NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
+  NS_ASSERT (m_nPackets.Get () > 0);
+
+  m_nBytes -= item->GetSize ();
+  m_nPackets--;
+
+  NS_LOG_LOGIC ("m_traceDequeue (p)");
+  m_traceDequeue (item);
+}
+
 template <typename Item>
 void
 Queue<Item>::Flush (void)
@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include "rate-math.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RateMath");
+
+namespace {
+
+/**
+ * \ingroup datarate
+ * Number of significant bits of a value.
+ * \param value the value
+ * \returns the position of the highest set bit, plus one
+ */
+uint32_t
+BitLength (uint64_t value)
+{
+  uint32_t length = 0;
+  while (value != 0)
+    {
+      value >>= 1;
+      length++;
+    }
+  return length;
+}
+
+} // unnamed namespace
+
+RateReciprocal::RateReciprocal ()
+  : m_bps (0),
+    m_multiplier (0),
+    m_shift (0),
+    m_maxBytes (0)
+{
+}
+
+RateReciprocal::RateReciprocal (uint64_t bps)
+  : RateReciprocal ()
+{
+  SetBitRate (bps);
+}
+
+void
+RateReciprocal::SetBitRate (uint64_t bps)
+{
+  NS_LOG_FUNCTION (this << bps);
+  NS_ASSERT_MSG (bps != 0, "No transmission time at a null rate");
+  m_bps = bps;
+#if defined (HAVE___UINT128_T)
+  // With k = 8 * ticks per second and 2^(l-1) <= bps < 2^l, the shift
+  // s = 62 + l - bitlength (k) keeps m = floor (2^s * k / bps) + 1 below
+  // 2^64.  For bytes <= 2^(s-l), bytes * m / 2^s exceeds bytes * k / bps
+  // by less than 1 / bps, which does not change the integer part.
+  uint64_t k = 8 * RateMath::TicksPerSecond ();
+  uint32_t l = BitLength (bps);
+  m_shift = 62 + l - BitLength (k);
+  m_multiplier = static_cast<uint64_t> (((static_cast<unsigned __int128> (k) << m_shift) / bps) + 1);
+  m_maxBytes = static_cast<uint64_t> (1) << (m_shift - l);
+  NS_LOG_LOGIC ("multiplier " << m_multiplier << " shift " << m_shift
+                              << " exact up to " << m_maxBytes << " bytes");
+#endif
+}
+
+} // namespace ns3
@@ -0,0 +1,312 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#ifndef RING_QUEUE_H
+#define RING_QUEUE_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "ns3/queue.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup queue
+ *
+ * \brief A FIFO packet queue keeping its items in a ring buffer
+ *
+ * It behaves like DropTailQueue: the items beyond MaxSize, counted in
+ * packets or in bytes, are dropped on enqueue, and the trace sources of
+ * Queue are called alike.  The items are kept in an array of a power of
+ * two slots indexed by masking free-running counters, so that enqueue
+ * and dequeue neither allocate nor free memory and consecutive items
+ * share cache lines.  The array is allocated on the first enqueue with
+ * Capacity slots and doubles when a queue limited in bytes needs more.
+ *
+ * The queue is meant for one simulation thread, as the other queues are:
+ * no atomic operation is involved.
+ */
+template <typename Item>
+class RingQueue : public Queue<Item>
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief RingQueue Constructor
+   *
+   * Creates a ring queue with a maximum size of 100 packets by default
+   */
+  RingQueue ();
+
+  virtual ~RingQueue ();
+
+  virtual bool Enqueue (Ptr<Item> item);
+  virtual Ptr<Item> Dequeue (void);
+  virtual Ptr<Item> Remove (void);
+  virtual Ptr<const Item> Peek (void) const;
+
+  /**
+   * \return the number of slots of the ring, 0 before the first enqueue
+   */
+  uint32_t GetCapacity (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  using Queue<Item>::AdmitEnqueue;
+  using Queue<Item>::NotifyEnqueued;
+  using Queue<Item>::NotifyDequeued;
+  using Queue<Item>::DropAfterDequeue;
+
+  /**
+   * \brief Pull the item at the head of the ring
+   * \return the item, 0 if the ring is empty
+   */
+  Ptr<Item> Pop (void);
+
+  /**
+   * \brief Allocate the ring, or double it keeping the items in order
+   */
+  void Grow (void);
+
+  std::vector<Ptr<Item> > m_ring;  //!< The slots, a power of two of them
+  uint32_t m_mask;                 //!< The number of slots minus one
+  uint32_t m_head;                 //!< Count of the items ever pulled
+  uint32_t m_tail;                 //!< Count of the items ever pushed
+  uint32_t m_capacity;             //!< The number of slots to start with
+
+  NS_LOG_TEMPLATE_DECLARE;     //!< redefinition of the log component
+};
+
+
+/**
+ * Implementation of the templates declared above.
+ */
+
+template <typename Item>
+TypeId
+RingQueue<Item>::GetTypeId (void)
+{
+  static TypeId tid = TypeId (("ns3::RingQueue<" + GetTypeParamName<RingQueue<Item> > () + ">").c_str ())
+    .SetParent<Queue<Item> > ()
+    .SetGroupName ("Network")
+    .template AddConstructor<RingQueue<Item> > ()
+    .AddAttribute ("MaxSize",
+                   "The max queue size",
+                   QueueSizeValue (QueueSize ("100p")),
+                   MakeQueueSizeAccessor (&QueueBase::SetMaxSize,
+                                          &QueueBase::GetMaxSize),
+                   MakeQueueSizeChecker ())
+    .AddAttribute ("Capacity",
+                   "The number of slots allocated on the first enqueue, rounded up "
+                   "to a power of two. With 0, the slots needed by a MaxSize in "
+                   "packets, or 128 for a MaxSize in bytes.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&RingQueue<Item>::m_capacity),
+                   MakeUintegerChecker<uint32_t> (0, 1u << 31))
+  ;
+  return tid;
+}
+
+template <typename Item>
+RingQueue<Item>::RingQueue () :
+  Queue<Item> (),
+  m_mask (0),
+  m_head (0),
+  m_tail (0),
+  m_capacity (0),
+  NS_LOG_TEMPLATE_DEFINE ("RingQueue")
+{
+  NS_LOG_FUNCTION (this);
+}
+
+template <typename Item>
+RingQueue<Item>::~RingQueue ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+template <typename Item>
+void
+RingQueue<Item>::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_ring.clear ();
+  m_mask = 0;
+  m_head = m_tail = 0;
+  Queue<Item>::DoDispose ();
+}
+
+template <typename Item>
+uint32_t
+RingQueue<Item>::GetCapacity (void) const
+{
+  return m_ring.size ();
+}
+
+template <typename Item>
+void
+RingQueue<Item>::Grow (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t slots;
+  if (!m_ring.empty ())
+    {
+      slots = 2 * m_ring.size ();
+    }
+  else if (m_capacity > 0)
+    {
+      slots = m_capacity;
+    }
+  else if (this->GetMaxSize ().GetUnit () == QueueSizeUnit::PACKETS)
+    {
+      slots = std::max<uint32_t> (this->GetMaxSize ().GetValue (), 1);
+    }
+  else
+    {
+      slots = 128;
+    }
+  uint32_t size = 1;
+  while (size < slots)
+    {
+      size <<= 1;
+    }
+
+  std::vector<Ptr<Item> > ring (size);
+  uint32_t n = m_tail - m_head;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      ring[i] = m_ring[(m_head + i) & m_mask];
+    }
+  m_ring.swap (ring);
+  m_mask = size - 1;
+  m_head = 0;
+  m_tail = n;
+  NS_LOG_LOGIC ("Ring of " << size << " slots");
+}
+
+template <typename Item>
+bool
+RingQueue<Item>::Enqueue (Ptr<Item> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  if (!AdmitEnqueue (item))
+    {
+      return false;
+    }
+  if (m_tail - m_head == m_ring.size ())
+    {
+      Grow ();
+    }
+  m_ring[m_tail & m_mask] = item;
+  m_tail++;
+  NotifyEnqueued (item);
+  return true;
+}
+
+template <typename Item>
+Ptr<Item>
+RingQueue<Item>::Pop (void)
+{
+  if (m_head == m_tail)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+  Ptr<Item> item;
+  std::swap (item, m_ring[m_head & m_mask]);
+  m_head++;
+  return item;
+}
+
+template <typename Item>
+Ptr<Item>
+RingQueue<Item>::Dequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<Item> item = Pop ();
+  if (item != 0)
+    {
+      NotifyDequeued (item);
+    }
+
+  NS_LOG_LOGIC ("Popped " << item);
+
+  return item;
+}
+
+template <typename Item>
+Ptr<Item>
+RingQueue<Item>::Remove (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<Item> item = Pop ();
+  if (item != 0)
+    {
+      // packets are first dequeued and then dropped
+      NotifyDequeued (item);
+      DropAfterDequeue (item);
+    }
+
+  NS_LOG_LOGIC ("Removed " << item);
+
+  return item;
+}
+
+template <typename Item>
+Ptr<const Item>
+RingQueue<Item>::Peek (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_head == m_tail)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+  return m_ring[m_head & m_mask];
+}
+
+// The following explicit template instantiation declarations prevent all the
+// translation units including this header file to implicitly instantiate the
+// RingQueue<Packet> class and the RingQueue<QueueDiscItem> class. The
+// unique instances of these classes are explicitly created through the macros
+// NS_OBJECT_TEMPLATE_CLASS_DEFINE (RingQueue,Packet) and
+// NS_OBJECT_TEMPLATE_CLASS_DEFINE (RingQueue,QueueDiscItem), which are included
+// in ring-queue.cc
+extern template class RingQueue<Packet>;
+extern template class RingQueue<QueueDiscItem>;
+
+} // namespace ns3
+
+#endif /* RING_QUEUE_H */
@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#ifndef UNALIGNED_ACCESS_H
+#define UNALIGNED_ACCESS_H
+
+#include <stdint.h>
+#include <cstring>
+
+/**
+ * \file
+ * \ingroup packet
+ * Loads and stores of network order integers at any address.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Network order loads and stores at unaligned addresses.
+ *
+ * Header fast paths use these helpers on the pointer returned by
+ * Buffer::Iterator::PeekContiguous: each field is read or written with
+ * one memory access and, on little endian hosts, one byte swap, instead
+ * of one access per byte.
+ */
+namespace UnalignedAccess {
+
+/**
+ * \brief Swap the bytes of a 16 bit network order value, if needed.
+ * \param v the value
+ * \returns the value in the other byte order
+ */
+inline uint16_t
+Swap16 (uint16_t v)
+{
+#if defined (__GNUC__) && defined (__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  return v;
+#elif defined (__GNUC__)
+  return __builtin_bswap16 (v);
+#else
+  return static_cast<uint16_t> ((v >> 8) | (v << 8));
+#endif
+}
+
+/**
+ * \brief Swap the bytes of a 32 bit network order value, if needed.
+ * \param v the value
+ * \returns the value in the other byte order
+ */
+inline uint32_t
+Swap32 (uint32_t v)
+{
+#if defined (__GNUC__) && defined (__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  return v;
+#elif defined (__GNUC__)
+  return __builtin_bswap32 (v);
+#else
+  return (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+#endif
+}
+
+/**
+ * \param p the address of two bytes in network order
+ * \returns the value in host order
+ */
+inline uint16_t
+LoadNtohU16 (const uint8_t *p)
+{
+  uint16_t v;
+  std::memcpy (&v, p, sizeof (v));
+  return Swap16 (v);
+}
+
+/**
+ * \param p the address of four bytes in network order
+ * \returns the value in host order
+ */
+inline uint32_t
+LoadNtohU32 (const uint8_t *p)
+{
+  uint32_t v;
+  std::memcpy (&v, p, sizeof (v));
+  return Swap32 (v);
+}
+
+/**
+ * \param p the address of two bytes
+ * \param v the value to store in network order
+ */
+inline void
+StoreHtonU16 (uint8_t *p, uint16_t v)
+{
+  v = Swap16 (v);
+  std::memcpy (p, &v, sizeof (v));
+}
+
+/**
+ * \param p the address of four bytes
+ * \param v the value to store in network order
+ */
+inline void
+StoreHtonU32 (uint8_t *p, uint32_t v)
+{
+  v = Swap32 (v);
+  std::memcpy (p, &v, sizeof (v));
+}
+
+} // namespace UnalignedAccess
+
+} // namespace ns3
+
+#endif /* UNALIGNED_ACCESS_H */
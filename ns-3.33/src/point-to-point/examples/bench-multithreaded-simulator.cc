@@ -0,0 +1,302 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-partition-helper.h"
+
+/**
+ * \file
+ * \ingroup point-to-point
+ * Compare the sequential simulator with MultithreadedSimulatorImpl.
+ *
+ * Bulk TCP flows cross either a dumbbell (hosts/2 senders on the left,
+ * hosts/2 receivers on the right, one bottleneck link) or a k-ary fat
+ * tree (k^3/4 hosts, each sending to the host "opposite" to it).  The
+ * topology is built again for each run, then partitioned with
+ * PointToPointPartitionHelper into one partition per thread, e.g.
+ *
+ * \code
+ *   ./waf --run "bench-multithreaded-simulator --hosts=64 --threads=1,2,4,8"
+ *   ./waf --run "bench-multithreaded-simulator --topology=fattree --k=4"
+ * \endcode
+ *
+ * The received bytes must be the same for all the runs: the partitions
+ * run the same events as the sequential simulator.  The speedup depends
+ * on the lookahead (the shortest cut link), since each window only
+ * holds the events of one lookahead.
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BenchMultithreadedSimulator");
+
+/** The result of one run. */
+struct BenchResult
+{
+  double wall;       //!< Wall clock time of Simulator::Run, in s
+  uint64_t events;   //!< Events executed
+  uint64_t windows;  //!< Windows of the parallel simulator
+  uint32_t partitions; //!< Partitions used
+  Time lookahead;    //!< Lookahead of the partitions
+  uint64_t rx;       //!< Bytes received by all the sinks
+};
+
+/**
+ * Install a bulk TCP flow.
+ * \param src the sender
+ * \param dst the receiver
+ * \param address the address of the receiver
+ * \param sinks the sink applications, updated
+ */
+void
+InstallFlow (Ptr<Node> src, Ptr<Node> dst, Ipv4Address address, ApplicationContainer &sinks)
+{
+  uint16_t port = 5000;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (address, port));
+  source.SetAttribute ("MaxBytes", UintegerValue (0));
+  source.Install (src);
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  sinks.Add (sink.Install (dst));
+}
+
+/**
+ * Build a dumbbell.
+ * \param hosts the number of hosts
+ * \param sinks filled with the sink applications
+ */
+void
+BuildDumbbell (uint32_t hosts, ApplicationContainer &sinks)
+{
+  NodeContainer routers;
+  routers.Create (2);
+  NodeContainer left;
+  left.Create (hosts / 2);
+  NodeContainer right;
+  right.Create (hosts / 2);
+  InternetStackHelper stack;
+  stack.InstallAll ();
+
+  PointToPointHelper access;
+  access.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  access.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  PointToPointHelper bottleneck;
+  bottleneck.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  bottleneck.SetChannelAttribute ("Delay", StringValue ("10ms"));
+
+  Ipv4AddressHelper address ("10.0.0.0", "255.255.255.0");
+  address.Assign (bottleneck.Install (routers));
+  std::vector<Ipv4Address> rightAddress;
+  for (uint32_t i = 0; i < hosts / 2; i++)
+    {
+      address.NewNetwork ();
+      address.Assign (access.Install (left.Get (i), routers.Get (0)));
+      address.NewNetwork ();
+      Ipv4InterfaceContainer interfaces = address.Assign (access.Install (right.Get (i), routers.Get (1)));
+      rightAddress.push_back (interfaces.GetAddress (0));
+    }
+  for (uint32_t i = 0; i < hosts / 2; i++)
+    {
+      InstallFlow (left.Get (i), right.Get (i), rightAddress[i], sinks);
+    }
+}
+
+/**
+ * Build a k-ary fat tree.
+ * \param k the number of ports of the switches, even
+ * \param sinks filled with the sink applications
+ */
+void
+BuildFatTree (uint32_t k, ApplicationContainer &sinks)
+{
+  uint32_t half = k / 2;
+  NodeContainer core;
+  core.Create (half * half);
+  NodeContainer aggregation;
+  aggregation.Create (k * half);
+  NodeContainer edge;
+  edge.Create (k * half);
+  NodeContainer hosts;
+  hosts.Create (k * half * half);
+  InternetStackHelper stack;
+  stack.InstallAll ();
+
+  PointToPointHelper link;
+  link.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  link.SetChannelAttribute ("Delay", StringValue ("50us"));
+  Ipv4AddressHelper address ("10.0.0.0", "255.255.255.252");
+  std::vector<Ipv4Address> hostAddress;
+  for (uint32_t pod = 0; pod < k; pod++)
+    {
+      for (uint32_t i = 0; i < half; i++)
+        {
+          Ptr<Node> agg = aggregation.Get (pod * half + i);
+          Ptr<Node> sw = edge.Get (pod * half + i);
+          for (uint32_t j = 0; j < half; j++)
+            {
+              address.Assign (link.Install (agg, core.Get (i * half + j)));
+              address.NewNetwork ();
+              address.Assign (link.Install (sw, aggregation.Get (pod * half + j)));
+              address.NewNetwork ();
+              Ipv4InterfaceContainer interfaces =
+                address.Assign (link.Install (hosts.Get ((pod * half + i) * half + j), sw));
+              address.NewNetwork ();
+              hostAddress.push_back (interfaces.GetAddress (0));
+            }
+        }
+    }
+  uint32_t n = hosts.GetN ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      uint32_t dst = (i + n / 2) % n;
+      InstallFlow (hosts.Get (i), hosts.Get (dst), hostAddress[dst], sinks);
+    }
+}
+
+/**
+ * Build the topology and run it.
+ * \param topology "dumbbell" or "fattree"
+ * \param size the number of hosts of the dumbbell, or k of the fat tree
+ * \param threads the number of threads, or 0 for the sequential simulator
+ * \param duration the simulated time
+ * \returns the result of the run
+ */
+BenchResult
+Run (std::string topology, uint32_t size, uint32_t threads, Time duration)
+{
+  BenchResult result;
+  GlobalValue::Bind ("SimulatorImplementationType",
+                     StringValue (threads == 0 ? "ns3::DefaultSimulatorImpl" : "ns3::MultithreadedSimulatorImpl"));
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+
+  ApplicationContainer sinks;
+  if (topology == "fattree")
+    {
+      BuildFatTree (size, sinks);
+    }
+  else
+    {
+      BuildDumbbell (size, sinks);
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  result.partitions = 1;
+  result.lookahead = Seconds (0);
+  if (impl != 0)
+    {
+      impl->SetAttribute ("ThreadCount", UintegerValue (threads));
+      PointToPointPartitionHelper partition;
+      result.partitions = partition.Install (threads);
+      result.lookahead = partition.GetLookahead ();
+    }
+
+  Simulator::Stop (duration);
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  result.wall = time.End () / 1000.0;
+  result.events = Simulator::GetEventCount ();
+  result.windows = impl != 0 ? impl->GetWindowCount () : 0;
+  result.rx = 0;
+  for (uint32_t i = 0; i < sinks.GetN (); i++)
+    {
+      result.rx += DynamicCast<PacketSink> (sinks.Get (i))->GetTotalRx ();
+    }
+  Simulator::Destroy ();
+  return result;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string topology = "dumbbell";
+  uint32_t hosts = 64;
+  uint32_t k = 4;
+  std::string threadList = "1,2,4";
+  double duration = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Compare the sequential simulator with MultithreadedSimulatorImpl.");
+  cmd.AddValue ("topology", "dumbbell or fattree", topology);
+  cmd.AddValue ("hosts", "number of hosts of the dumbbell", hosts);
+  cmd.AddValue ("k", "number of ports of the fat tree switches", k);
+  cmd.AddValue ("threads", "comma separated thread counts to run", threadList);
+  cmd.AddValue ("duration", "simulated time, in s", duration);
+  cmd.Parse (argc, argv);
+  NS_ABORT_MSG_IF (topology != "dumbbell" && topology != "fattree", "Unknown topology " << topology);
+  NS_ABORT_MSG_IF (topology == "fattree" && (k < 2 || k % 2 != 0), "k must be even");
+  uint32_t size = topology == "fattree" ? k : hosts;
+
+  Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue ("ns3::TcpNewReno"));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+
+  std::vector<uint32_t> threads;
+  threads.push_back (0);
+  std::istringstream list (threadList);
+  std::string item;
+  while (std::getline (list, item, ','))
+    {
+      threads.push_back (std::stoul (item));
+    }
+
+  std::cout << "topology: " << topology << " size: " << size
+            << " hardware threads: " << std::thread::hardware_concurrency () << std::endl;
+  std::cout << std::left << std::setw (12) << "Threads"
+            << std::right << std::setw (12) << "Parts"
+            << std::setw (14) << "Lookahead"
+            << std::setw (12) << "Run (s)"
+            << std::setw (12) << "Speedup"
+            << std::setw (12) << "Events"
+            << std::setw (12) << "Windows"
+            << std::setw (16) << "Rx bytes" << std::endl;
+  std::cout << std::fixed << std::setprecision (3);
+  double sequential = 0;
+  uint64_t expected = 0;
+  for (uint32_t i = 0; i < threads.size (); i++)
+    {
+      BenchResult r = Run (topology, size, threads[i], Seconds (duration));
+      if (threads[i] == 0)
+        {
+          sequential = r.wall;
+          expected = r.rx;
+        }
+      std::cout << std::left << std::setw (12) << (threads[i] == 0 ? std::string ("sequential") : std::to_string (threads[i]))
+                << std::right << std::setw (12) << r.partitions
+                << std::setw (14) << r.lookahead.As (Time::MS)
+                << std::setw (12) << r.wall
+                << std::setw (12) << (r.wall > 0 ? sequential / r.wall : 0)
+                << std::setw (12) << r.events
+                << std::setw (12) << r.windows
+                << std::setw (16) << r.rx
+                << (r.rx != expected ? "  MISMATCH" : "") << std::endl;
+    }
+  return 0;
+}
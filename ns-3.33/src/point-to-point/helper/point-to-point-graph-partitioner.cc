@@ -0,0 +1,366 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <map>
+
+#include "point-to-point-graph-partitioner.h"
+#include "point-to-point-helper.h"
+#include "ns3/node.h"
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PointToPointGraphPartitioner");
+
+namespace {
+
+/** Passes of the refinement of the cut. */
+const uint32_t REFINE_PASSES = 8;
+
+/**
+ * Find the group of a node, halving the path on the way.
+ * \param parent the union-find forest
+ * \param i the node index
+ * \returns the index of the representative of the group
+ */
+uint32_t
+Find (std::vector<uint32_t> &parent, uint32_t i)
+{
+  while (parent[i] != i)
+    {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+  return i;
+}
+
+} // unnamed namespace
+
+PointToPointGraphPartitioner::PointToPointGraphPartitioner ()
+  : m_imbalance (0.1),
+    m_lookahead (Seconds (0)),
+    m_cutLinks (0),
+    m_cutTraffic (0)
+{
+}
+
+uint32_t
+PointToPointGraphPartitioner::AddNode (uint32_t weight)
+{
+  NS_LOG_FUNCTION (this << weight);
+  m_weight.push_back (std::max (weight, 1u));
+  return m_weight.size () - 1;
+}
+
+uint32_t
+PointToPointGraphPartitioner::AddLink (uint32_t a, uint32_t b, Time delay, double traffic)
+{
+  NS_LOG_FUNCTION (this << a << b << delay << traffic);
+  NS_ABORT_MSG_IF (a >= m_weight.size () || b >= m_weight.size (), "Unknown node in link " << a << "-" << b);
+  NS_ABORT_MSG_IF (delay.IsStrictlyNegative (), "Negative link delay");
+  NS_ABORT_MSG_IF (traffic < 0, "Negative link traffic");
+  Link link;
+  link.a = a;
+  link.b = b;
+  link.delay = delay.GetTimeStep ();
+  link.traffic = traffic;
+  m_links.push_back (link);
+  return m_links.size () - 1;
+}
+
+void
+PointToPointGraphPartitioner::SetImbalance (double imbalance)
+{
+  NS_LOG_FUNCTION (this << imbalance);
+  NS_ABORT_MSG_IF (imbalance < 0, "Negative imbalance");
+  m_imbalance = imbalance;
+}
+
+uint32_t
+PointToPointGraphPartitioner::Partition (uint32_t partitions)
+{
+  NS_LOG_FUNCTION (this << partitions);
+  NS_ABORT_MSG_IF (partitions == 0, "At least one partition is needed");
+  uint32_t n = m_weight.size ();
+  m_partition.assign (n, 0);
+  m_lookahead = Seconds (0);
+  m_cutLinks = 0;
+  m_cutTraffic = 0;
+  if (n == 0)
+    {
+      return 0;
+    }
+
+  // Largest threshold leaving enough groups; the zero-delay links are
+  // never cut
+  std::vector<int64_t> thresholds;
+  for (std::vector<Link>::const_iterator l = m_links.begin (); l != m_links.end (); ++l)
+    {
+      if (l->delay > 0)
+        {
+          thresholds.push_back (l->delay);
+        }
+    }
+  std::sort (thresholds.begin (), thresholds.end (), std::greater<int64_t> ());
+  thresholds.erase (std::unique (thresholds.begin (), thresholds.end ()), thresholds.end ());
+  if (thresholds.empty ())
+    {
+      thresholds.push_back (1);
+    }
+  std::vector<uint32_t> parent (n);
+  for (std::vector<int64_t>::const_iterator t = thresholds.begin (); t != thresholds.end (); ++t)
+    {
+      uint32_t groups = n;
+      for (uint32_t i = 0; i < n; i++)
+        {
+          parent[i] = i;
+        }
+      for (std::vector<Link>::const_iterator l = m_links.begin (); l != m_links.end (); ++l)
+        {
+          if (l->delay >= *t)
+            {
+              continue;
+            }
+          uint32_t ra = Find (parent, l->a);
+          uint32_t rb = Find (parent, l->b);
+          if (ra != rb)
+            {
+              parent[rb] = ra;
+              groups--;
+            }
+        }
+      NS_LOG_LOGIC ("threshold " << TimeStep (*t) << ": " << groups << " groups");
+      if (groups >= partitions)
+        {
+          break;
+        }
+    }
+
+  // Number the groups in node order, and sum their weights and the
+  // traffic between them
+  std::vector<uint32_t> group (n);
+  std::vector<int> rootGroup (n, -1);
+  std::vector<uint64_t> groupWeight;
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      uint32_t r = Find (parent, i);
+      if (rootGroup[r] < 0)
+        {
+          rootGroup[r] = groupWeight.size ();
+          groupWeight.push_back (0);
+        }
+      group[i] = rootGroup[r];
+      groupWeight[group[i]] += m_weight[i];
+      total += m_weight[i];
+    }
+  uint32_t groups = groupWeight.size ();
+  std::vector<std::map<uint32_t, double> > adjacent (groups);
+  for (std::vector<Link>::const_iterator l = m_links.begin (); l != m_links.end (); ++l)
+    {
+      uint32_t ga = group[l->a];
+      uint32_t gb = group[l->b];
+      if (ga != gb)
+        {
+          adjacent[ga][gb] += l->traffic;
+          adjacent[gb][ga] += l->traffic;
+        }
+    }
+
+  // Deal the groups, in breadth first order, to the partitions: each
+  // group goes to the partition its middle falls in
+  std::vector<uint32_t> part (groups, 0);
+  std::vector<uint64_t> load (partitions, 0);
+  std::vector<bool> visited (groups, false);
+  uint64_t done = 0;
+  for (uint32_t start = 0; start < groups; start++)
+    {
+      if (visited[start])
+        {
+          continue;
+        }
+      std::deque<uint32_t> queue;
+      queue.push_back (start);
+      visited[start] = true;
+      while (!queue.empty ())
+        {
+          uint32_t g = queue.front ();
+          queue.pop_front ();
+          part[g] = std::min<uint64_t> (partitions - 1, (2 * done + groupWeight[g]) * partitions / (2 * total));
+          load[part[g]] += groupWeight[g];
+          done += groupWeight[g];
+          for (std::map<uint32_t, double>::const_iterator a = adjacent[g].begin (); a != adjacent[g].end (); ++a)
+            {
+              if (!visited[a->first])
+                {
+                  visited[a->first] = true;
+                  queue.push_back (a->first);
+                }
+            }
+        }
+    }
+
+  // Move the groups to the partition they exchange the most traffic
+  // with, within the load limit and without emptying a partition
+  uint64_t maxLoad = std::ceil (total * (1 + m_imbalance) / partitions);
+  bool moved = true;
+  for (uint32_t pass = 0; pass < REFINE_PASSES && moved; pass++)
+    {
+      moved = false;
+      for (uint32_t g = 0; g < groups; g++)
+        {
+          std::map<uint32_t, double> traffic;
+          for (std::map<uint32_t, double>::const_iterator a = adjacent[g].begin (); a != adjacent[g].end (); ++a)
+            {
+              traffic[part[a->first]] += a->second;
+            }
+          uint32_t from = part[g];
+          double stay = traffic[from];
+          uint32_t best = from;
+          double bestGain = 0;
+          for (std::map<uint32_t, double>::const_iterator t = traffic.begin (); t != traffic.end (); ++t)
+            {
+              if (t->first != from && t->second - stay > bestGain
+                  && load[t->first] + groupWeight[g] <= maxLoad && load[from] > groupWeight[g])
+                {
+                  best = t->first;
+                  bestGain = t->second - stay;
+                }
+            }
+          if (best != from)
+            {
+              NS_LOG_LOGIC ("move group " << g << " from " << from << " to " << best << ", gain " << bestGain);
+              load[from] -= groupWeight[g];
+              load[best] += groupWeight[g];
+              part[g] = best;
+              moved = true;
+            }
+        }
+    }
+
+  // Number the partitions in use from 0, in node order
+  std::vector<int> renumber (partitions, -1);
+  uint32_t used = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      uint32_t p = part[group[i]];
+      if (renumber[p] < 0)
+        {
+          renumber[p] = used++;
+        }
+      m_partition[i] = renumber[p];
+    }
+
+  int64_t lookahead = std::numeric_limits<int64_t>::max ();
+  for (std::vector<Link>::const_iterator l = m_links.begin (); l != m_links.end (); ++l)
+    {
+      if (m_partition[l->a] != m_partition[l->b])
+        {
+          NS_ASSERT (l->delay > 0);
+          m_cutLinks++;
+          m_cutTraffic += l->traffic;
+          lookahead = std::min (lookahead, l->delay);
+        }
+    }
+  if (m_cutLinks > 0)
+    {
+      m_lookahead = TimeStep (lookahead);
+    }
+  NS_LOG_INFO (n << " nodes in " << used << " partitions, " << m_cutLinks << " links cut, traffic " <<
+               m_cutTraffic << ", lookahead " << m_lookahead);
+  return used;
+}
+
+uint32_t
+PointToPointGraphPartitioner::GetNNodes (void) const
+{
+  return m_weight.size ();
+}
+
+uint32_t
+PointToPointGraphPartitioner::GetNLinks (void) const
+{
+  return m_links.size ();
+}
+
+uint32_t
+PointToPointGraphPartitioner::GetPartition (uint32_t node) const
+{
+  NS_ASSERT (node < m_weight.size ());
+  return node < m_partition.size () ? m_partition[node] : 0;
+}
+
+bool
+PointToPointGraphPartitioner::IsCut (uint32_t link) const
+{
+  NS_ASSERT (link < m_links.size ());
+  return GetPartition (m_links[link].a) != GetPartition (m_links[link].b);
+}
+
+Time
+PointToPointGraphPartitioner::GetLookahead (void) const
+{
+  return m_lookahead;
+}
+
+uint32_t
+PointToPointGraphPartitioner::GetCutLinkCount (void) const
+{
+  return m_cutLinks;
+}
+
+double
+PointToPointGraphPartitioner::GetCutTraffic (void) const
+{
+  return m_cutTraffic;
+}
+
+NodeContainer
+PointToPointGraphPartitioner::CreateNodes (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NodeContainer nodes;
+  for (uint32_t i = 0; i < m_weight.size (); i++)
+    {
+      nodes.Add (CreateObject<Node> (GetPartition (i)));
+    }
+  return nodes;
+}
+
+NetDeviceContainer
+PointToPointGraphPartitioner::InstallLink (uint32_t link, const PointToPointHelper &helper,
+                                           const NodeContainer &nodes) const
+{
+  NS_LOG_FUNCTION (this << link);
+  NS_ASSERT (link < m_links.size ());
+  const Link &l = m_links[link];
+  NS_ABORT_MSG_IF (l.a >= nodes.GetN () || l.b >= nodes.GetN (), "Node container smaller than the graph");
+  PointToPointHelper p2p = helper;
+  p2p.SetChannelAttribute ("Delay", TimeValue (TimeStep (l.delay)));
+  return p2p.Install (nodes.Get (l.a), nodes.Get (l.b));
+}
+
+} // namespace ns3
@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ * URL: https://github.com/SoonyangZhang/ns3-tcp-bbr
+*/
+#include <algorithm>
+#include <limits>
+#include <set>
+
+#include "point-to-point-partition-helper.h"
+#include "point-to-point-graph-partitioner.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PointToPointPartitionHelper");
+
+PointToPointPartitionHelper::PointToPointPartitionHelper ()
+  : m_lookahead (Seconds (0)),
+    m_cutLinks (0)
+{
+}
+
+uint32_t
+PointToPointPartitionHelper::Install (uint32_t partitions)
+{
+  return Install (NodeContainer::GetGlobal (), partitions);
+}
+
+uint32_t
+PointToPointPartitionHelper::Install (NodeContainer nodes, uint32_t partitions)
+{
+  NS_LOG_FUNCTION (this << partitions);
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  NS_ABORT_MSG_IF (impl == 0, "PointToPointPartitionHelper needs ns3::MultithreadedSimulatorImpl "
+                   "as SimulatorImplementationType");
+
+  // The nodes to partition, weighted by their number of devices
+  PointToPointGraphPartitioner graph;
+  uint32_t nNodes = NodeList::GetNNodes ();
+  std::vector<int> index (nNodes, -1);
+  std::vector<uint32_t> ids;
+  for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+    {
+      uint32_t id = (*i)->GetId ();
+      if (index[id] < 0)
+        {
+          index[id] = graph.AddNode ((*i)->GetNDevices ());
+          ids.push_back (id);
+        }
+    }
+
+  // All the point to point links, including those leaving the nodes
+  std::vector<Ptr<PointToPointChannel> > channels;
+  std::set<Ptr<PointToPointChannel> > seen;
+  for (uint32_t n = 0; n < nNodes; n++)
+    {
+      Ptr<Node> node = NodeList::GetNode (n);
+      for (uint32_t d = 0; d < node->GetNDevices (); d++)
+        {
+          Ptr<PointToPointChannel> channel =
+            DynamicCast<PointToPointChannel> (node->GetDevice (d)->GetChannel ());
+          if (channel == 0 || channel->GetNDevices () != 2 || !seen.insert (channel).second)
+            {
+              continue;
+            }
+          channels.push_back (channel);
+          int a = index[channel->GetDevice (0)->GetNode ()->GetId ()];
+          int b = index[channel->GetDevice (1)->GetNode ()->GetId ()];
+          if (a >= 0 && b >= 0)
+            {
+              TimeValue delay;
+              channel->GetAttribute ("Delay", delay);
+              graph.AddLink (a, b, delay.Get ());
+            }
+        }
+    }
+
+  // Configure the simulator and the channels
+  uint32_t used = graph.Partition (partitions);
+  for (uint32_t i = 0; i < ids.size (); i++)
+    {
+      impl->SetPartition (ids[i], graph.GetPartition (i));
+    }
+  m_partition.assign (nNodes, 0);
+  for (uint32_t n = 0; n < nNodes; n++)
+    {
+      m_partition[n] = impl->GetPartition (n);
+    }
+  m_cutLinks = 0;
+  int64_t lookahead = std::numeric_limits<int64_t>::max ();
+  for (std::vector<Ptr<PointToPointChannel> >::const_iterator c = channels.begin (); c != channels.end (); ++c)
+    {
+      uint32_t a = (*c)->GetDevice (0)->GetNode ()->GetId ();
+      uint32_t b = (*c)->GetDevice (1)->GetNode ()->GetId ();
+      bool cut = m_partition[a] != m_partition[b];
+      (*c)->SetCrossPartition (cut);
+      if (cut)
+        {
+          TimeValue delay;
+          (*c)->GetAttribute ("Delay", delay);
+          NS_ABORT_MSG_IF (!delay.Get ().IsStrictlyPositive (), "Link without delay between nodes " << a <<
+                           " and " << b << " of different partitions");
+          m_cutLinks++;
+          lookahead = std::min (lookahead, delay.Get ().GetTimeStep ());
+        }
+    }
+  m_lookahead = Seconds (0);
+  if (m_cutLinks > 0)
+    {
+      m_lookahead = TimeStep (lookahead);
+      impl->SetLookahead (m_lookahead);
+    }
+  NS_LOG_INFO (ids.size () << " nodes in " << used << " partitions, " << m_cutLinks <<
+               " links cut, lookahead " << m_lookahead);
+  return used;
+}
+
+uint32_t
+PointToPointPartitionHelper::GetPartition (Ptr<Node> node) const
+{
+  uint32_t id = node->GetId ();
+  return id < m_partition.size () ? m_partition[id] : 0;
+}
+
+Time
+PointToPointPartitionHelper::GetLookahead (void) const
+{
+  return m_lookahead;
+}
+
+uint32_t
+PointToPointPartitionHelper::GetCutLinkCount (void) const
+{
+  return m_cutLinks;
+}
+
+} // namespace ns3
@@ -22,6 +22,9 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/node.h"
+
+#include <vector>
 
 namespace ns3 {
 
@@ -57,7 +60,8 @@ PointToPointChannel::PointToPointChannel()
   :
     Channel (),
     m_delay (Seconds (0.)),
-    m_nDevices (0)
+    m_nDevices (0),
+    m_crossPartition (false)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -97,6 +101,22 @@ PointToPointChannel::TransmitStart (
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
+  if (m_crossPartition)
+    {
+      // Serialize the packet, as DistributedSimulatorImpl does between
+      // processes: the copy shares no buffer with the packets of this
+      // thread.  The receiving device is not referenced either, since
+      // its reference count belongs to the other thread.
+      uint32_t size = p->GetSerializedSize ();
+      std::vector<uint8_t> buffer (size);
+      p->Serialize (&buffer[0], size);
+      Ptr<Packet> copy = Create<Packet> (&buffer[0], size, true);
+      Simulator::ScheduleWithContext (m_link[wire].m_dstContext,
+                                      txTime + m_delay, &PointToPointNetDevice::Receive,
+                                      PeekPointer (m_link[wire].m_dst), copy);
+      return true;
+    }
+
   Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
                                   txTime + m_delay, &PointToPointNetDevice::Receive,
                                   m_link[wire].m_dst, p->Copy ());
@@ -146,6 +166,24 @@ PointToPointChannel::GetDestination (uint32_t i) const
   return m_link[i].m_dst;
 }
 
+void
+PointToPointChannel::SetCrossPartition (bool crossPartition)
+{
+  NS_LOG_FUNCTION (this << crossPartition);
+  NS_ASSERT (m_nDevices == N_DEVICES);
+  m_crossPartition = crossPartition;
+  for (std::size_t i = 0; i < N_DEVICES; i++)
+    {
+      m_link[i].m_dstContext = m_link[i].m_dst->GetNode ()->GetId ();
+    }
+}
+
+bool
+PointToPointChannel::IsCrossPartition (void) const
+{
+  return m_crossPartition;
+}
+
 bool
 PointToPointChannel::IsInitialized (void) const
 {
@@ -100,6 +100,24 @@ public:
    */
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
 
+  /**
+   * \brief Mark the channel as joining two partitions of a
+   * MultithreadedSimulatorImpl.
+   *
+   * The two devices then run on different threads: each packet is
+   * delivered as a private copy, which shares no data with the packet
+   * of the sender, and the TxRxPointToPoint trace is not fired, as it
+   * would hand the receiving device to the sending thread.
+   *
+   * \param crossPartition true if the devices are in different partitions
+   */
+  void SetCrossPartition (bool crossPartition);
+
+  /**
+   * \returns true if the devices of the channel are in different partitions
+   */
+  bool IsCrossPartition (void) const;
+
 protected:
   /**
    * \brief Get the delay associated with this channel
@@ -151,6 +169,7 @@ private:
 
   Time          m_delay;    //!< Propagation delay
   std::size_t        m_nDevices; //!< Devices of this channel
+  bool          m_crossPartition; //!< The devices run on different threads
 
   /**
    * The trace source for the packet transmission animation events that the 
@@ -194,11 +213,12 @@ public:
     /** \brief Create the link, it will be in INITIALIZING state
      *
      */
-    Link() : m_state (INITIALIZING), m_src (0), m_dst (0) {}
+    Link() : m_state (INITIALIZING), m_src (0), m_dst (0), m_dstContext (0) {}
 
     WireState                  m_state; //!< State of the link
     Ptr<PointToPointNetDevice> m_src;   //!< First NetDevice
     Ptr<PointToPointNetDevice> m_dst;   //!< Second NetDevice
+    uint32_t                   m_dstContext; //!< Node id of m_dst, for cross-partition links
   };
 
   Link    m_link[N_DEVICES]; //!< Link model
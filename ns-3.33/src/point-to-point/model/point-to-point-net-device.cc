@@ -25,6 +25,8 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
+#include "ns3/gso-tag.h"
+#include "ns3/net-device-queue-interface.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -177,7 +179,8 @@ PointToPointNetDevice::PointToPointNetDevice ()
     m_txMachineState (READY),
     m_channel (0),
     m_linkUp (false),
-    m_currentPkt (0)
+    m_currentPkt (0),
+    m_txQueueBytes (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -214,10 +217,28 @@ PointToPointNetDevice::DoDispose ()
   m_channel = 0;
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
+  m_gsoSegments.clear ();
   m_queue = 0;
+  m_txQueue = 0;
   NetDevice::DoDispose ();
 }
 
+void
+PointToPointNetDevice::NotifyNewAggregate (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_txQueue == 0)
+    {
+      Ptr<NetDeviceQueueInterface> ndqi = GetObject<NetDeviceQueueInterface> ();
+      if (ndqi != 0)
+        {
+          m_txQueue = ndqi->GetTxQueue (0);
+          m_txQueue->SetTransmittedBytesByDevice (true);
+        }
+    }
+  NetDevice::NotifyNewAggregate ();
+}
+
 void
 PointToPointNetDevice::SetDataRate (DataRate bps)
 {
@@ -248,7 +269,12 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   m_currentPkt = p;
   m_phyTxBeginTrace (m_currentPkt);
 
-  Time txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
+  // The rate may also be changed through the attribute
+  if (m_txTime.GetBitRate () != m_bps.GetBitRate ())
+    {
+      m_txTime.SetBitRate (m_bps.GetBitRate ());
+    }
+  Time txTime = m_txTime.TxTime (p->GetSize ());
   Time txCompleteTime = txTime + m_tInterframeGap;
 
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.As (Time::S));
@@ -281,7 +307,20 @@ PointToPointNetDevice::TransmitComplete (void)
   m_phyTxEndTrace (m_currentPkt);
   m_currentPkt = 0;
 
-  Ptr<Packet> p = m_queue->Dequeue ();
+  //
+  // Once the last wire segment of a queue item is out, its bytes leave the
+  // device for the queue limits, which may let the upper layers send again.
+  //
+  if (m_gsoSegments.empty ())
+    {
+      if (m_txQueue != 0)
+        {
+          m_txQueue->NotifyTransmittedBytes (m_txQueueBytes);
+        }
+      m_txQueueBytes = 0;
+    }
+
+  Ptr<Packet> p = DequeueForTransmit ();
   if (p == 0)
     {
       NS_LOG_LOGIC ("No pending packets in device queue after tx complete");
@@ -296,6 +335,54 @@ PointToPointNetDevice::TransmitComplete (void)
   TransmitStart (p);
 }
 
+Ptr<Packet>
+PointToPointNetDevice::DequeueForTransmit (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_gsoSegments.empty ())
+    {
+      Ptr<Packet> p = m_gsoSegments.front ();
+      m_gsoSegments.pop_front ();
+      return p;
+    }
+
+  Ptr<Packet> p = m_queue->Dequeue ();
+  if (p == 0)
+    {
+      return 0;
+    }
+  m_txQueueBytes += p->GetSize ();
+
+  GsoTag tag;
+  if (!p->PeekPacketTag (tag))
+    {
+      return p;
+    }
+
+  //
+  // A super-segment: strip the PPP header, let the protocol above split the
+  // payload and frame every segment again.
+  //
+  uint16_t protocol = 0;
+  Ptr<Packet> payload = p->Copy ();
+  ProcessHeader (payload, protocol);
+  std::list<Ptr<Packet> > segments;
+  if (!GsoSegmentation::Segment (payload, protocol, segments) || segments.empty ())
+    {
+      NS_LOG_WARN ("Unable to segment packet " << p->GetUid () << ", sending it as is");
+      return p;
+    }
+  for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); ++it)
+    {
+      AddHeader (*it, protocol);
+    }
+  m_gsoSegments.splice (m_gsoSegments.end (), segments);
+  p = m_gsoSegments.front ();
+  m_gsoSegments.pop_front ();
+  return p;
+}
+
 bool
 PointToPointNetDevice::Attach (Ptr<PointToPointChannel> ch)
 {
@@ -541,7 +628,7 @@ PointToPointNetDevice::Send (
       // 
       if (m_txMachineState == READY)
         {
-          packet = m_queue->Dequeue ();
+          packet = DequeueForTransmit ();
           m_snifferTrace (packet);
           m_promiscSnifferTrace (packet);
           bool ret = TransmitStart (packet);
@@ -605,6 +692,13 @@ PointToPointNetDevice::SupportsSendFrom (void) const
   return false;
 }
 
+bool
+PointToPointNetDevice::SupportsGso (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return true;
+}
+
 void
 PointToPointNetDevice::DoMpiReceive (Ptr<Packet> p)
 {
@@ -20,6 +20,7 @@
 #define POINT_TO_POINT_NET_DEVICE_H
 
 #include <cstring>
+#include <list>
 #include "ns3/address.h"
 #include "ns3/node.h"
 #include "ns3/net-device.h"
@@ -28,12 +29,14 @@
 #include "ns3/traced-callback.h"
 #include "ns3/nstime.h"
 #include "ns3/data-rate.h"
+#include "ns3/rate-math.h"
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
 
 namespace ns3 {
 
 template <typename Item> class Queue;
+class NetDeviceQueue;
 class PointToPointChannel;
 class ErrorModel;
 
@@ -189,6 +192,7 @@ public:
 
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
+  virtual bool SupportsGso (void) const;
 
 protected:
   /**
@@ -224,6 +228,12 @@ private:
    */
   virtual void DoDispose (void);
 
+  /**
+   * \brief Report the transmitted bytes to the NetDeviceQueueInterface,
+   * once it is aggregated.
+   */
+  virtual void NotifyNewAggregate (void);
+
 private:
 
   /**
@@ -275,6 +285,17 @@ private:
    */
   void TransmitComplete (void);
 
+  /**
+   * \brief Get the next packet to put on the wire
+   *
+   * Packets carrying a GsoTag are split into wire segments here, just
+   * before transmission.  The remaining segments are sent back to back
+   * before the next packet is pulled from the transmit queue.
+   *
+   * \returns the next packet to transmit, or 0 if there is none
+   */
+  Ptr<Packet> DequeueForTransmit (void);
+
   /**
    * \brief Make the link up and running
    *
@@ -301,6 +322,11 @@ private:
    */
   DataRate       m_bps;
 
+  /**
+   * Reciprocal of m_bps, refreshed when the rate changes
+   */
+  RateReciprocal m_txTime;
+
   /**
    * The interframe gap that the Net Device uses to throttle packet
    * transmission
@@ -457,6 +483,16 @@ private:
 
   Ptr<Packet> m_currentPkt; //!< Current packet processed
 
+  std::list<Ptr<Packet> > m_gsoSegments; //!< Wire segments left from the last super-segment
+
+  /**
+   * The transmission queue of the NetDeviceQueueInterface, if any.  The
+   * bytes of a queue item are reported to its queue limits at the end of
+   * the transmission of the item, not when the item is dequeued.
+   */
+  Ptr<NetDeviceQueue> m_txQueue;
+  uint32_t m_txQueueBytes; //!< Bytes of the queue item being transmitted
+
   /**
    * \brief PPP to Ethernet protocol number mapping
    * \param protocol A PPP protocol number
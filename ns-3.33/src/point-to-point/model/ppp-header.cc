@@ -21,6 +21,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/header.h"
+#include "ns3/unaligned-access.h"
 #include "ppp-header.h"
 
 namespace ns3 {
@@ -82,13 +83,29 @@ PppHeader::GetSerializedSize (void) const
 void
 PppHeader::Serialize (Buffer::Iterator start) const
 {
-  start.WriteHtonU16 (m_protocol);
+  uint8_t *buffer = start.PeekContiguous (2);
+  if (buffer != 0)
+    {
+      UnalignedAccess::StoreHtonU16 (buffer, m_protocol);
+    }
+  else
+    {
+      start.WriteHtonU16 (m_protocol);
+    }
 }
 
 uint32_t
 PppHeader::Deserialize (Buffer::Iterator start)
 {
-  m_protocol = start.ReadNtohU16 ();
+  const uint8_t *buffer = start.PeekContiguous (2);
+  if (buffer != 0)
+    {
+      m_protocol = UnalignedAccess::LoadNtohU16 (buffer);
+    }
+  else
+    {
+      m_protocol = start.ReadNtohU16 ();
+    }
   return GetSerializedSize ();
 }
 
@@ -105,6 +105,24 @@ private:
   uint16_t m_protocol;
 };
 
+/**
+ * \brief Packets may carry a PppHeader unserialized.
+ * \sa Packet::EnableStructuredHeaders
+ */
+template <>
+struct IsStructuredHeader<PppHeader>
+{
+  static const bool value = true; //!< PppHeader is structured
+  /**
+   * \param header the header to read
+   * \returns false: a PppHeader has no checksum
+   */
+  static bool NeedsBytes (const PppHeader &header)
+  {
+    return false;
+  }
+};
+
 } // namespace ns3
 
 
@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-graph-partitioner.h"
+
+using namespace ns3;
+
+/**
+ * \brief Check that the partitioner keeps the short links and cuts the
+ * longest one.
+ *
+ * n0 -1ms- n1 -1ms- n2 -10ms- n3 -1ms- n4 -1ms- n5
+ */
+class PointToPointGraphLookaheadTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointGraphLookaheadTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PointToPointGraphLookaheadTest::PointToPointGraphLookaheadTest ()
+  : TestCase ("Cut the longest link")
+{
+}
+
+void
+PointToPointGraphLookaheadTest::DoRun (void)
+{
+  PointToPointGraphPartitioner graph;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      graph.AddNode ();
+    }
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      graph.AddLink (i, i + 1, MilliSeconds (i == 2 ? 10 : 1));
+    }
+  NS_TEST_ASSERT_MSG_EQ (graph.Partition (2), 2, "Wrong number of partitions");
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (graph.GetPartition (i), (i < 3 ? 0 : 1), "Wrong partition of node " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (graph.GetCutLinkCount (), 1, "Wrong number of cut links");
+  NS_TEST_ASSERT_MSG_EQ (graph.IsCut (2), true, "The long link is not cut");
+  NS_TEST_ASSERT_MSG_EQ (graph.GetLookahead (), MilliSeconds (10), "Wrong lookahead");
+
+  // Three partitions need a short link to be cut as well
+  NS_TEST_ASSERT_MSG_EQ (graph.Partition (3), 3, "Wrong number of partitions");
+  NS_TEST_ASSERT_MSG_EQ (graph.GetLookahead (), MilliSeconds (1), "Wrong lookahead");
+  NS_TEST_ASSERT_MSG_EQ (graph.GetCutLinkCount (), 2, "Wrong number of cut links");
+
+  // A graph cannot be cut in more pieces than it has nodes
+  NS_TEST_ASSERT_MSG_EQ (graph.Partition (8), 6, "Wrong number of partitions");
+}
+
+/**
+ * \brief Check that the partitioner moves the border nodes to lower the
+ * traffic across the cut, and keeps the partitions balanced.
+ *
+ * A ring n0-n1-n2-n3-n0 of equal delays where n1-n2 and n3-n0 carry
+ * most of the traffic, and a line of eight nodes.
+ */
+class PointToPointGraphTrafficTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointGraphTrafficTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PointToPointGraphTrafficTest::PointToPointGraphTrafficTest ()
+  : TestCase ("Lower the traffic across the cut")
+{
+}
+
+void
+PointToPointGraphTrafficTest::DoRun (void)
+{
+  PointToPointGraphPartitioner ring;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      ring.AddNode ();
+    }
+  ring.AddLink (0, 1, MilliSeconds (5), 1);
+  ring.AddLink (1, 2, MilliSeconds (5), 100);
+  ring.AddLink (2, 3, MilliSeconds (5), 1);
+  ring.AddLink (3, 0, MilliSeconds (5), 100);
+  NS_TEST_ASSERT_MSG_EQ (ring.Partition (2), 2, "Wrong number of partitions");
+  NS_TEST_ASSERT_MSG_EQ (ring.GetPartition (0), ring.GetPartition (3), "Busy link n3-n0 cut");
+  NS_TEST_ASSERT_MSG_EQ (ring.GetPartition (1), ring.GetPartition (2), "Busy link n1-n2 cut");
+  NS_TEST_ASSERT_MSG_EQ (ring.GetCutTraffic (), 2, "Wrong traffic across the cut");
+
+  PointToPointGraphPartitioner line;
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      line.AddNode ();
+    }
+  for (uint32_t i = 0; i < 7; i++)
+    {
+      line.AddLink (i, i + 1, MilliSeconds (1));
+    }
+  NS_TEST_ASSERT_MSG_EQ (line.Partition (4), 4, "Wrong number of partitions");
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (line.GetPartition (i), i / 2, "Unbalanced partitions");
+    }
+  NS_TEST_ASSERT_MSG_EQ (line.GetCutLinkCount (), 3, "Wrong number of cut links");
+}
+
+/**
+ * \brief Check the nodes and links built from a partitioned graph.
+ */
+class PointToPointGraphInstallTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointGraphInstallTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PointToPointGraphInstallTest::PointToPointGraphInstallTest ()
+  : TestCase ("Create the nodes with their partition as system id")
+{
+}
+
+void
+PointToPointGraphInstallTest::DoRun (void)
+{
+  PointToPointGraphPartitioner graph;
+  uint32_t a = graph.AddNode ();
+  uint32_t b = graph.AddNode ();
+  uint32_t c = graph.AddNode ();
+  graph.AddLink (a, b, MicroSeconds (100));
+  uint32_t slow = graph.AddLink (b, c, MilliSeconds (20));
+  graph.Partition (2);
+
+  NodeContainer nodes = graph.CreateNodes ();
+  NS_TEST_ASSERT_MSG_EQ (nodes.GetN (), 3, "Wrong number of nodes");
+  NS_TEST_ASSERT_MSG_EQ (nodes.Get (a)->GetSystemId (), 0, "Wrong system id");
+  NS_TEST_ASSERT_MSG_EQ (nodes.Get (b)->GetSystemId (), 0, "Wrong system id");
+  NS_TEST_ASSERT_MSG_EQ (nodes.Get (c)->GetSystemId (), 1, "Wrong system id");
+
+  PointToPointHelper p2p;
+  NetDeviceContainer devices = graph.InstallLink (slow, p2p, nodes);
+  NS_TEST_ASSERT_MSG_EQ (devices.Get (0)->GetNode (), nodes.Get (b), "Wrong first end");
+  NS_TEST_ASSERT_MSG_EQ (devices.Get (1)->GetNode (), nodes.Get (c), "Wrong second end");
+  TimeValue delay;
+  devices.Get (0)->GetChannel ()->GetAttribute ("Delay", delay);
+  NS_TEST_ASSERT_MSG_EQ (delay.Get (), MilliSeconds (20), "Wrong link delay");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief TestSuite for the point to point graph partitioner
+ */
+class PointToPointGraphPartitionerTestSuite : public TestSuite
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  PointToPointGraphPartitionerTestSuite ();
+};
+
+PointToPointGraphPartitionerTestSuite::PointToPointGraphPartitionerTestSuite ()
+  : TestSuite ("point-to-point-graph-partitioner", UNIT)
+{
+  AddTestCase (new PointToPointGraphLookaheadTest, TestCase::QUICK);
+  AddTestCase (new PointToPointGraphTrafficTest, TestCase::QUICK);
+  AddTestCase (new PointToPointGraphInstallTest, TestCase::QUICK);
+}
+
+static PointToPointGraphPartitionerTestSuite g_pointToPointGraphPartitionerTestSuite; //!< The testsuite
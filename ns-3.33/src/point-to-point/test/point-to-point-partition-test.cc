@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-partition-helper.h"
+#include "ns3/multithreaded-simulator-impl.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \brief Check the partitioning of a line of point to point links, and
+ * that packets cross the cut link at the same times as with the
+ * sequential simulator.
+ *
+ * n0 --1ms-- n1 --5ms-- n2 --1ms-- n3: the end nodes echo each packet
+ * one byte shorter, the middle nodes forward it.
+ */
+class PointToPointPartitionTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointPartitionTest ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /**
+   * \brief Build the line and run it
+   * \param type The simulator implementation
+   */
+  void RunScenario (const std::string &type);
+  /**
+   * \brief Send a packet on a device
+   * \param device The device
+   * \param size The packet size
+   */
+  void Send (Ptr<NetDevice> device, uint32_t size);
+  /**
+   * \brief Record a packet, and echo or forward it
+   * \param device The receiving device
+   * \param packet The packet
+   * \param protocol The protocol number
+   * \param from The sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  std::vector<std::vector<int64_t> > m_log; //!< Receive times, by node
+  uint32_t m_partitions;                   //!< Partitions found by the helper
+  Time m_lookahead;                        //!< Lookahead found by the helper
+  uint32_t m_cutLinks;                     //!< Links cut by the helper
+};
+
+PointToPointPartitionTest::PointToPointPartitionTest ()
+  : TestCase ("PointToPoint links between partitions"),
+    m_partitions (0),
+    m_cutLinks (0)
+{
+}
+
+void
+PointToPointPartitionTest::Send (Ptr<NetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointPartitionTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                    uint16_t protocol, const Address &from)
+{
+  Ptr<Node> node = device->GetNode ();
+  m_log[node->GetId ()].push_back (Simulator::Now ().GetTimeStep ());
+  if (node->GetNDevices () == 2)
+    {
+      Ptr<NetDevice> other = node->GetDevice (node->GetDevice (0) == device ? 1 : 0);
+      other->Send (packet->Copy (), other->GetBroadcast (), protocol);
+    }
+  else if (packet->GetSize () > 20)
+    {
+      Send (device, packet->GetSize () - 1);
+    }
+  return true;
+}
+
+void
+PointToPointPartitionTest::RunScenario (const std::string &type)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (type));
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      impl->SetAttribute ("ThreadCount", UintegerValue (2));
+    }
+
+  NodeContainer nodes;
+  nodes.Create (4);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  std::vector<NetDeviceContainer> devices;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      p2p.SetChannelAttribute ("Delay", StringValue (i == 1 ? "5ms" : "1ms"));
+      devices.push_back (p2p.Install (nodes.Get (i), nodes.Get (i + 1)));
+      for (uint32_t j = 0; j < 2; j++)
+        {
+          devices[i].Get (j)->SetReceiveCallback (MakeCallback (&PointToPointPartitionTest::Receive, this));
+        }
+    }
+  if (impl != 0)
+    {
+      PointToPointPartitionHelper partition;
+      m_partitions = partition.Install (nodes, 2);
+      m_lookahead = partition.GetLookahead ();
+      m_cutLinks = partition.GetCutLinkCount ();
+    }
+
+  m_log.assign (4, std::vector<int64_t> ());
+  Simulator::ScheduleWithContext (0, MicroSeconds (10), &PointToPointPartitionTest::Send, this,
+                                  devices[0].Get (0), 100);
+  Simulator::ScheduleWithContext (3, MicroSeconds (500), &PointToPointPartitionTest::Send, this,
+                                  devices[2].Get (1), 60);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+PointToPointPartitionTest::DoRun (void)
+{
+  RunScenario ("ns3::DefaultSimulatorImpl");
+  std::vector<std::vector<int64_t> > expected = m_log;
+  NS_TEST_ASSERT_MSG_GT (expected[3].size (), 10, "Too few packets crossed the line");
+
+  RunScenario ("ns3::MultithreadedSimulatorImpl");
+  NS_TEST_ASSERT_MSG_EQ (m_partitions, 2, "Wrong number of partitions");
+  NS_TEST_ASSERT_MSG_EQ (m_lookahead, MilliSeconds (5), "Wrong lookahead");
+  NS_TEST_ASSERT_MSG_EQ (m_cutLinks, 1, "Wrong number of cut links");
+  for (uint32_t node = 0; node < 4; node++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_log[node].size (), expected[node].size (), "Wrong number of packets at node " << node);
+      for (uint32_t k = 0; k < m_log[node].size (); k++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_log[node][k], expected[node][k], "Wrong receive time at node " << node);
+        }
+    }
+}
+
+void
+PointToPointPartitionTest::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \brief TestSuite for the point to point links between partitions
+ */
+class PointToPointPartitionTestSuite : public TestSuite
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  PointToPointPartitionTestSuite ();
+};
+
+PointToPointPartitionTestSuite::PointToPointPartitionTestSuite ()
+  : TestSuite ("devices-point-to-point-partition", UNIT)
+{
+  AddTestCase (new PointToPointPartitionTest, TestCase::QUICK);
+}
+
+static PointToPointPartitionTestSuite g_pointToPointPartitionTestSuite; //!< The testsuite
@@ -24,6 +24,8 @@
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/dynamic-queue-limits.h"
+#include "ns3/data-rate.h"
 
 using namespace ns3;
 
@@ -94,6 +96,104 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test the byte accounting of the dynamic queue limits
+ *
+ * The bytes of a packet must be held by the queue limits until the end of
+ * its transmission, not only while the packet is in the device queue.
+ */
+class PointToPointBqlTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointBqlTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send one packet to the device specified
+   *
+   * \param device NetDevice to send to
+   * \param size the packet size
+   */
+  void SendOnePacket (Ptr<PointToPointNetDevice> device, uint32_t size);
+
+  /**
+   * \brief Check the state of the transmission queue
+   *
+   * \param txq the transmission queue
+   * \param stopped whether the queue limits are expected to stop the queue
+   * \param msg the failure message
+   */
+  void CheckStopped (Ptr<NetDeviceQueue> txq, bool stopped, std::string msg);
+};
+
+PointToPointBqlTest::PointToPointBqlTest ()
+  : TestCase ("PointToPoint dynamic queue limits")
+{
+}
+
+void
+PointToPointBqlTest::SendOnePacket (Ptr<PointToPointNetDevice> device, uint32_t size)
+{
+  Ptr<Packet> p = Create<Packet> (size);
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+void
+PointToPointBqlTest::CheckStopped (Ptr<NetDeviceQueue> txq, bool stopped, std::string msg)
+{
+  NS_TEST_EXPECT_MSG_EQ (txq->IsStopped (), stopped, msg);
+}
+
+void
+PointToPointBqlTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetDataRate (DataRate ("8Mbps"));
+  Ptr<Queue<Packet> > queue = CreateObject<DropTailQueue<Packet> > ();
+  devA->SetQueue (queue);
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+
+  Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface> ();
+  ndqi->GetTxQueue (0)->ConnectQueueTraces (queue);
+  devA->AggregateObject (ndqi);
+  Ptr<NetDeviceQueue> txq = ndqi->GetTxQueue (0);
+  txq->SetQueueLimits (CreateObject<DynamicQueueLimits> ());
+
+  // 998 bytes of payload and the PPP header take 1 ms at 8 Mbit/s
+  Simulator::Schedule (Seconds (1.0), &PointToPointBqlTest::SendOnePacket, this, devA, 998);
+  // The packet left the device queue at once, but it is still on the wire
+  Simulator::Schedule (Seconds (1.0005), &PointToPointBqlTest::CheckStopped, this, txq, true,
+                       "The bytes being transmitted must count against the limit");
+  Simulator::Schedule (Seconds (1.0015), &PointToPointBqlTest::CheckStopped, this, txq, false,
+                       "The bytes must be released at the end of the transmission");
+
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_GT (txq->GetQueueLimits ()->Available (), 0, "The limit must grow when the queue starves");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -110,6 +210,7 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointBqlTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
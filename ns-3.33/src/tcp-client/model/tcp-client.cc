@@ -23,18 +23,29 @@
 #include "tcp-utils.h"
 #include "tcp-client.h"
 #include "ns3/log.h"
+#include "ns3/replication-context.h"
+#include "ns3/simulation-singleton.h"
 namespace ns3{
 namespace{
     uint32_t kMSS=1400;
     Time kRateCountGap=MilliSeconds(1000);
-    uint32_t TcpClientIdCounter=0;
+struct TcpClientIdCounter{
+    uint32_t count=0;
+};
+//a replication numbers its clients from 0
+uint32_t NextTcpClientId(){
+    if(ReplicationContext::IsActive()){
+        return SimulationSingleton<TcpClientIdCounter>::Get()->count++;
+    }
+    static TcpClientIdCounter counter;
+    return counter.count++;
+}
 }
 NS_LOG_COMPONENT_DEFINE("TcpClient");
 TcpClient::TcpClient(uint64_t bytes,uint32_t flag){
     m_targetBytes=bytes;
     m_traceFlag=flag;
-    m_uuid=TcpClientIdCounter;
-    TcpClientIdCounter++;
+    m_uuid=NextTcpClientId();
 }
 TcpClient::~TcpClient(){}
 void TcpClient::SetSegmentSize(uint32_t mss){
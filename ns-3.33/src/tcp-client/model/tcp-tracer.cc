@@ -25,10 +25,23 @@
 #include <string.h>
 #include <map>
 #include "ns3/simulator.h"
+#include "ns3/replication-context.h"
+#include "ns3/simulation-singleton.h"
 #include "tcp-tracer.h"
 namespace ns3{
 namespace{
-    char RootDir[FILENAME_MAX]={0};
+struct TraceFolder{
+    TraceFolder(){memset(RootDir,0,FILENAME_MAX);}
+    char RootDir[FILENAME_MAX];
+};
+//a replication writes to its own folder
+char *GetRootDir(){
+    if(ReplicationContext::IsActive()){
+        return SimulationSingleton<TraceFolder>::Get()->RootDir;
+    }
+    static TraceFolder folder;
+    return folder.RootDir;
+}
 }
 //https://stackoverflow.com/questions/675039/how-can-i-create-directory-tree-in-c-linux
 static bool IsDirExist(const std::string& path)
@@ -188,11 +201,13 @@ void InfoPriv::DoDispose(){
 }
 Ptr<InfoPriv> *InfoPriv::DoGet (void){
     static Ptr<InfoPriv> ptr = 0;
-    if(0==ptr){
-        ptr = CreateObject<InfoPriv>();
+    static thread_local Ptr<InfoPriv> replicationPtr = 0;
+    Ptr<InfoPriv> *pptr=ReplicationContext::IsActive()?&replicationPtr:&ptr;
+    if(0==*pptr){
+        *pptr = CreateObject<InfoPriv>();
         Simulator::ScheduleDestroy (&InfoPriv::Delete);
     }
-    return &ptr;
+    return pptr;
 }
 void InfoPriv::Delete (void){
     (*DoGet ()) = 0;
@@ -200,6 +215,7 @@ void InfoPriv::Delete (void){
 void InfoPriv::OpenLossFile(){
     char buf[FILENAME_MAX];
     std::string path = std::string (getcwd(buf, FILENAME_MAX))+ "/traces/";
+    const char *RootDir=GetRootDir();
     int len=strlen(RootDir);
     if(len>0){
         std::string parent_dir(RootDir,len);
@@ -214,6 +230,7 @@ void InfoPriv::OpenLossFile(){
 void InfoPriv::OpenUtilFile(){
     char buf[FILENAME_MAX];
     std::string path = std::string (getcwd(buf, FILENAME_MAX))+ "/traces/";
+    const char *RootDir=GetRootDir();
     int len=strlen(RootDir);
     if(len>0){
         std::string parent_dir(RootDir,len);
@@ -245,6 +262,7 @@ TcpTracer::~TcpTracer()
     }
 }
 void TcpTracer::SetTraceFolder(const char *path){
+    char *RootDir=GetRootDir();
     memset(RootDir,0,FILENAME_MAX);
     int len=strlen(path);
     if(len>0){
@@ -252,7 +270,7 @@ void TcpTracer::SetTraceFolder(const char *path){
     }
 }
 void TcpTracer::ClearTraceFolder(){
-    memset(RootDir,0,FILENAME_MAX);
+    memset(GetRootDir(),0,FILENAME_MAX);
 }
 void TcpTracer::SetExperimentInfo(uint32_t flow_num,uint32_t bottleneck_bw){
     InfoPriv::Get()->SetExperimentInfo(flow_num,bottleneck_bw);
@@ -282,6 +300,7 @@ void TcpTracer::OpenCwndTraceFile(std::string filename)
 {
     char buf[FILENAME_MAX];
     std::string path = std::string (getcwd(buf, FILENAME_MAX))+ "/traces/";
+    const char *RootDir=GetRootDir();
     int len=strlen(RootDir);
     if(len>0){
         std::string parent_dir(RootDir,len);
@@ -296,6 +315,7 @@ void TcpTracer::OpenCwndTraceFile(std::string filename)
 void TcpTracer::OpenInflightTraceFile(std::string filename){
     char buf[FILENAME_MAX];
     std::string path = std::string (getcwd(buf, FILENAME_MAX))+ "/traces/";
+    const char *RootDir=GetRootDir();
     int len=strlen(RootDir);
     if(len>0){
         std::string parent_dir(RootDir,len);
@@ -311,6 +331,7 @@ void TcpTracer::OpenRttTraceFile(std::string filename)
 {
     char buf[FILENAME_MAX];
     std::string path = std::string (getcwd(buf, FILENAME_MAX))+ "/traces/";
+    const char *RootDir=GetRootDir();
     int len=strlen(RootDir);
     if(len>0){
         std::string parent_dir(RootDir,len);
@@ -325,6 +346,7 @@ void TcpTracer::OpenRttTraceFile(std::string filename)
 void TcpTracer::OpenSendRateTraceFile(std::string filename){
     char buf[FILENAME_MAX];
     std::string path = std::string (getcwd(buf, FILENAME_MAX))+ "/traces/";
+    const char *RootDir=GetRootDir();
     int len=strlen(RootDir);
     if(len>0){
         std::string parent_dir(RootDir,len);
@@ -339,6 +361,7 @@ void TcpTracer::OpenSendRateTraceFile(std::string filename){
 void TcpTracer::OpenGoodputTraceFile(std::string filename){
     char buf[FILENAME_MAX];
     std::string path = std::string (getcwd(buf, FILENAME_MAX))+ "/traces/";
+    const char *RootDir=GetRootDir();
     int len=strlen(RootDir);
     if(len>0){
         std::string parent_dir(RootDir,len);
@@ -0,0 +1,661 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * FQ, the Fair Queue packet scheduler
+ *
+ * This implementation is based on linux kernel code by
+ * Authors:     Eric Dumazet <edumazet@google.com>
+ *
+ * Implemented in ns-3 by: SongyangZhang <sonyang.chang@foxmail.com>
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/packet.h"
+#include "ns3/departure-time-tag.h"
+#include "ns3/pacing-rate-tag.h"
+#include "ns3/net-device-queue-interface.h"
+#include "fq-queue-disc.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FqQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (FqFlow);
+
+TypeId FqFlow::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FqFlow")
+    .SetParent<QueueDiscClass> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<FqFlow> ()
+  ;
+  return tid;
+}
+
+FqFlow::FqFlow ()
+  : m_status (INACTIVE),
+    m_credit (0),
+    m_timeToSend (Time (0)),
+    m_timeNextPacket (Time (0)),
+    m_age (Time (0)),
+    m_index (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FqFlow::~FqFlow ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FqFlow::SetStatus (FlowStatus status)
+{
+  NS_LOG_FUNCTION (this);
+  m_status = status;
+}
+
+FqFlow::FlowStatus
+FqFlow::GetStatus (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_status;
+}
+
+void
+FqFlow::SetCredit (int32_t credit)
+{
+  NS_LOG_FUNCTION (this << credit);
+  m_credit = credit;
+}
+
+int32_t
+FqFlow::GetCredit (void) const
+{
+  return m_credit;
+}
+
+void
+FqFlow::IncreaseCredit (int32_t credit)
+{
+  NS_LOG_FUNCTION (this << credit);
+  m_credit += credit;
+}
+
+void
+FqFlow::SetTimeToSend (Time timeToSend)
+{
+  NS_LOG_FUNCTION (this << timeToSend);
+  m_timeToSend = timeToSend;
+}
+
+Time
+FqFlow::GetTimeToSend (void) const
+{
+  return m_timeToSend;
+}
+
+void
+FqFlow::SetTimeNextPacket (Time timeNextPacket)
+{
+  NS_LOG_FUNCTION (this << timeNextPacket);
+  m_timeNextPacket = timeNextPacket;
+}
+
+Time
+FqFlow::GetTimeNextPacket (void) const
+{
+  return m_timeNextPacket;
+}
+
+void
+FqFlow::SetAge (Time age)
+{
+  NS_LOG_FUNCTION (this << age);
+  m_age = age;
+}
+
+Time
+FqFlow::GetAge (void) const
+{
+  return m_age;
+}
+
+void
+FqFlow::SetIndex (uint32_t index)
+{
+  NS_LOG_FUNCTION (this);
+  m_index = index;
+}
+
+uint32_t
+FqFlow::GetIndex (void) const
+{
+  return m_index;
+}
+
+
+NS_OBJECT_ENSURE_REGISTERED (FqQueueDisc);
+
+TypeId FqQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FqQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<FqQueueDisc> ()
+    .AddAttribute ("MaxSize",
+                   "The maximum number of packets accepted by this queue disc",
+                   QueueSizeValue (QueueSize ("10000p")),
+                   MakeQueueSizeAccessor (&QueueDisc::SetMaxSize,
+                                          &QueueDisc::GetMaxSize),
+                   MakeQueueSizeChecker ())
+    .AddAttribute ("FlowLimit",
+                   "The maximum number of packets queued for each flow",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&FqQueueDisc::m_flowLimit),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Quantum",
+                   "The credit of each flow at each round, in bytes. If null, it is "
+                   "initialized to twice the MTU of the device (if any)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FqQueueDisc::SetQuantum,
+                                         &FqQueueDisc::GetQuantum),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("InitialQuantum",
+                   "The credit of a new flow, in bytes. If null, it is "
+                   "initialized to ten times the MTU of the device (if any)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FqQueueDisc::m_initialQuantum),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("FlowRefillDelay",
+                   "A flow idle for longer than this delay gets at least a quantum of credit",
+                   TimeValue (MilliSeconds (40)),
+                   MakeTimeAccessor (&FqQueueDisc::m_flowRefillDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("EnableRate",
+                   "True to pace the packets of each flow at its pacing rate",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&FqQueueDisc::m_rateEnable),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxRate",
+                   "The maximum pacing rate of a flow. If null, flows are only "
+                   "limited by their own pacing rate",
+                   DataRateValue (DataRate (0)),
+                   MakeDataRateAccessor (&FqQueueDisc::m_maxRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("LowRateThreshold",
+                   "Flows paced below this rate are paced packet by packet, "
+                   "regardless of their credit",
+                   DataRateValue (DataRate ("550Kbps")),
+                   MakeDataRateAccessor (&FqQueueDisc::m_lowRateThreshold),
+                   MakeDataRateChecker ())
+    .AddAttribute ("Perturbation",
+                   "The salt used as an additional input to the hash function used to classify packets",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FqQueueDisc::m_perturbation),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Horizon",
+                   "Packets whose departure time is later than now plus the horizon are not accepted",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&FqQueueDisc::m_horizon),
+                   MakeTimeChecker ())
+    .AddAttribute ("HorizonDrop",
+                   "True to drop packets beyond the horizon, false to cap their departure time",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&FqQueueDisc::m_horizonDrop),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FlowGcAge",
+                   "A flow inactive for longer than this delay is forgotten and "
+                   "its class is reused by a new flow",
+                   TimeValue (Seconds (3)),
+                   MakeTimeAccessor (&FqQueueDisc::m_gcAge),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+FqQueueDisc::FqQueueDisc ()
+  : QueueDisc (QueueDiscSizePolicy::MULTIPLE_QUEUES, QueueSizeUnit::PACKETS),
+    m_quantum (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FqQueueDisc::~FqQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FqQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_watchdog.Cancel ();
+  m_newFlows.clear ();
+  m_oldFlows.clear ();
+  m_throttled.clear ();
+  m_idleFlows.clear ();
+  QueueDisc::DoDispose ();
+}
+
+uint32_t
+FqQueueDisc::GetNThrottledFlows (void) const
+{
+  return m_throttled.size ();
+}
+
+uint32_t
+FqQueueDisc::GetNFlows (void) const
+{
+  return m_flowsIndices.size ();
+}
+
+void
+FqQueueDisc::SetQuantum (uint32_t quantum)
+{
+  NS_LOG_FUNCTION (this << quantum);
+  m_quantum = quantum;
+}
+
+uint32_t
+FqQueueDisc::GetQuantum (void) const
+{
+  return m_quantum;
+}
+
+Time
+FqQueueDisc::GetDepartureTime (Ptr<const QueueDiscItem> item) const
+{
+  DepartureTimeTag tag;
+  if (item->GetPacket ()->PeekPacketTag (tag))
+    {
+      return tag.GetDepartureTime ();
+    }
+  return Time (0);
+}
+
+bool
+FqQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  uint32_t flowHash;
+
+  if (GetNPacketFilters () == 0)
+    {
+      flowHash = item->Hash (m_perturbation);
+    }
+  else
+    {
+      int32_t ret = Classify (item);
+
+      if (ret != PacketFilter::PF_NO_MATCH)
+        {
+          flowHash = static_cast<uint32_t> (ret);
+        }
+      else
+        {
+          NS_LOG_ERROR ("No filter has been able to classify this packet, drop it.");
+          DropBeforeEnqueue (item, UNCLASSIFIED_DROP);
+          return false;
+        }
+    }
+
+  if (GetCurrentSize () + item > GetMaxSize ())
+    {
+      NS_LOG_LOGIC ("Queue disc limit exceeded -- dropping packet");
+      DropBeforeEnqueue (item, OVERLIMIT_DROP);
+      return false;
+    }
+
+  Time departure = GetDepartureTime (item);
+  Time horizon = Simulator::Now () + m_horizon;
+  if (departure > horizon)
+    {
+      if (m_horizonDrop)
+        {
+          NS_LOG_LOGIC ("Departure time " << departure << " beyond the horizon -- dropping packet");
+          DropBeforeEnqueue (item, HORIZON_DROP);
+          return false;
+        }
+      NS_LOG_LOGIC ("Departure time " << departure << " capped to the horizon");
+      DepartureTimeTag tag (horizon);
+      item->GetPacket ()->ReplacePacketTag (tag);
+      departure = horizon;
+    }
+
+  CollectIdleFlows (Simulator::Now ());
+
+  // Flows are identified by the whole hash value rather than a bucket index,
+  // so that distinct flows are paced independently
+  Ptr<FqFlow> flow;
+  std::map<uint32_t, uint32_t>::const_iterator it = m_flowsIndices.find (flowHash);
+  if (it == m_flowsIndices.end () && !m_freeClasses.empty ())
+    {
+      NS_LOG_DEBUG ("Reusing the class of a reclaimed flow for index " << flowHash);
+      uint32_t index = m_freeClasses.back ();
+      m_freeClasses.pop_back ();
+      flow = StaticCast<FqFlow> (GetQueueDiscClass (index));
+      flow->SetIndex (flowHash);
+      flow->SetCredit (m_initialQuantum);
+      flow->SetTimeToSend (Time (0));
+      flow->SetTimeNextPacket (Time (0));
+      flow->SetAge (Time (0));
+      m_flowsIndices[flowHash] = index;
+    }
+  else if (it == m_flowsIndices.end ())
+    {
+      NS_LOG_DEBUG ("Creating a new flow queue with index " << flowHash);
+      flow = m_flowFactory.Create<FqFlow> ();
+      Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc> ();
+      qd->Initialize ();
+      flow->SetQueueDisc (qd);
+      flow->SetIndex (flowHash);
+      flow->SetCredit (m_initialQuantum);
+      AddQueueDiscClass (flow);
+
+      m_flowsIndices[flowHash] = GetNQueueDiscClasses () - 1;
+    }
+  else
+    {
+      flow = StaticCast<FqFlow> (GetQueueDiscClass (it->second));
+    }
+
+  if (flow->GetQueueDisc ()->GetNPackets () >= m_flowLimit)
+    {
+      NS_LOG_LOGIC ("Flow limit exceeded -- dropping packet");
+      DropBeforeEnqueue (item, FLOW_LIMIT_DROP);
+      return false;
+    }
+
+  if (flow->GetQueueDisc ()->GetNPackets () == 0)
+    {
+      flow->SetTimeToSend (departure);
+    }
+
+  if (flow->GetStatus () == FqFlow::INACTIVE)
+    {
+      flow->SetStatus (FqFlow::NEW_FLOW);
+      m_newFlows.push_back (flow);
+      if (Simulator::Now () > flow->GetAge () + m_flowRefillDelay)
+        {
+          flow->SetCredit (std::max (flow->GetCredit (), static_cast<int32_t> (m_quantum)));
+        }
+    }
+
+  bool retval = flow->GetQueueDisc ()->Enqueue (item);
+
+  NS_LOG_DEBUG ("Packet enqueued into flow " << flowHash << "; departure time " << departure);
+
+  return retval;
+}
+
+void
+FqQueueDisc::CheckThrottled (Time now)
+{
+  NS_LOG_FUNCTION (this << now);
+
+  while (!m_throttled.empty () && m_throttled.begin ()->first <= now)
+    {
+      Ptr<FqFlow> flow = m_throttled.begin ()->second;
+      m_throttled.erase (m_throttled.begin ());
+      NS_LOG_DEBUG ("Flow " << flow->GetIndex () << " is no longer throttled");
+      flow->SetStatus (FqFlow::OLD_FLOW);
+      m_oldFlows.push_back (flow);
+    }
+}
+
+void
+FqQueueDisc::ArmWatchdog (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_throttled.empty ())
+    {
+      return;
+    }
+  Time next = m_throttled.begin ()->first;
+  if (m_watchdog.IsRunning () && m_watchdogTime == next)
+    {
+      return;
+    }
+  m_watchdog.Cancel ();
+  m_watchdogTime = next;
+  m_watchdog = Simulator::Schedule (next - Simulator::Now (), &QueueDisc::Run, this);
+  NS_LOG_LOGIC ("Watchdog scheduled at " << next);
+}
+
+Ptr<QueueDiscItem>
+FqQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Time now = Simulator::Now ();
+  CheckThrottled (now);
+
+  while (true)
+    {
+      std::list<Ptr<FqFlow> > *head = &m_newFlows;
+      if (head->empty ())
+        {
+          head = &m_oldFlows;
+          if (head->empty ())
+            {
+              NS_LOG_DEBUG ("No flow found to dequeue a packet");
+              ArmWatchdog ();
+              return 0;
+            }
+        }
+
+      Ptr<FqFlow> flow = head->front ();
+
+      if (flow->GetCredit () <= 0)
+        {
+          NS_LOG_DEBUG ("Increase credit for flow " << flow->GetIndex ());
+          flow->IncreaseCredit (m_quantum);
+          head->pop_front ();
+          flow->SetStatus (FqFlow::OLD_FLOW);
+          m_oldFlows.push_back (flow);
+          continue;
+        }
+
+      if (flow->GetQueueDisc ()->GetNPackets () == 0)
+        {
+          head->pop_front ();
+          // force a pass through the old flows to prevent starvation
+          if (head == &m_newFlows && !m_oldFlows.empty ())
+            {
+              flow->SetStatus (FqFlow::OLD_FLOW);
+              m_oldFlows.push_back (flow);
+            }
+          else
+            {
+              flow->SetStatus (FqFlow::INACTIVE);
+              flow->SetAge (now);
+              m_idleFlows.push_back (std::make_pair (now, flow));
+            }
+          continue;
+        }
+
+      Time timeNextPacket = std::max (flow->GetTimeToSend (), flow->GetTimeNextPacket ());
+      if (timeNextPacket > now)
+        {
+          NS_LOG_DEBUG ("Flow " << flow->GetIndex () << " throttled until " << timeNextPacket);
+          head->pop_front ();
+          flow->SetTimeNextPacket (timeNextPacket);
+          flow->SetStatus (FqFlow::THROTTLED);
+          m_throttled.insert (std::make_pair (timeNextPacket, flow));
+          continue;
+        }
+
+      Ptr<QueueDiscItem> item = flow->GetQueueDisc ()->Dequeue ();
+      NS_ASSERT (item);
+
+      Ptr<const QueueDiscItem> next = flow->GetQueueDisc ()->Peek ();
+      if (next)
+        {
+          flow->SetTimeToSend (GetDepartureTime (next));
+        }
+
+      flow->IncreaseCredit (-static_cast<int32_t> (item->GetSize ()));
+      if (m_rateEnable)
+        {
+          UpdatePacing (flow, item, now);
+        }
+
+      NS_LOG_DEBUG ("Dequeued packet " << item->GetPacket () << " from flow " << flow->GetIndex ());
+      return item;
+    }
+}
+
+void
+FqQueueDisc::UpdatePacing (Ptr<FqFlow> flow, Ptr<const QueueDiscItem> item, Time now)
+{
+  NS_LOG_FUNCTION (this << flow << item << now);
+
+  uint32_t plen = item->GetSize ();
+  uint64_t rate = m_maxRate.GetBitRate ();
+  // The departure time of a stamped packet was set by the sender at its own
+  // pacing rate, only the max rate of the queue disc applies on top of it
+  DepartureTimeTag departure;
+  if (!item->GetPacket ()->PeekPacketTag (departure))
+    {
+      PacingRateTag pacing;
+      if (item->GetPacket ()->PeekPacketTag (pacing)
+          && (rate == 0 || pacing.GetPacingRate ().GetBitRate () < rate))
+        {
+          rate = pacing.GetPacingRate ().GetBitRate ();
+        }
+      if (rate != 0 && rate <= m_lowRateThreshold.GetBitRate ())
+        {
+          flow->SetCredit (0);
+        }
+      else
+        {
+          // let the flow send a quantum of data back to back
+          plen = std::max (plen, m_quantum);
+          if (flow->GetCredit () > 0)
+            {
+              return;
+            }
+        }
+    }
+  if (rate == 0)
+    {
+      return;
+    }
+
+  Time len = DataRate (rate).CalculateBytesTxTime (plen);
+  // Since the sender rate can change later, clamp the delay to 1 second
+  len = std::min (len, Seconds (1));
+  // Account for the drift of the watchdog: the flow may be served later
+  // than its time of next packet
+  if (!flow->GetTimeNextPacket ().IsZero ())
+    {
+      len -= std::min (len / 2, now - flow->GetTimeNextPacket ());
+    }
+  flow->SetTimeNextPacket (now + len);
+}
+
+void
+FqQueueDisc::CollectIdleFlows (Time now)
+{
+  NS_LOG_FUNCTION (this << now);
+
+  // Flows are appended as they become inactive, so the oldest come first.
+  // An entry is stale if the flow was active again since
+  while (!m_idleFlows.empty () && m_idleFlows.front ().first + m_gcAge < now)
+    {
+      Ptr<FqFlow> flow = m_idleFlows.front ().second;
+      Time age = m_idleFlows.front ().first;
+      m_idleFlows.pop_front ();
+      if (flow->GetStatus () != FqFlow::INACTIVE || flow->GetAge () != age)
+        {
+          continue;
+        }
+      std::map<uint32_t, uint32_t>::iterator it = m_flowsIndices.find (flow->GetIndex ());
+      NS_ASSERT (it != m_flowsIndices.end ());
+      NS_ASSERT (flow->GetQueueDisc ()->GetNPackets () == 0);
+      NS_LOG_DEBUG ("Reclaiming flow " << flow->GetIndex () << " inactive since " << age);
+      m_freeClasses.push_back (it->second);
+      m_flowsIndices.erase (it);
+    }
+}
+
+bool
+FqQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNQueueDiscClasses () > 0)
+    {
+      NS_LOG_ERROR ("FqQueueDisc cannot have classes");
+      return false;
+    }
+
+  if (GetNInternalQueues () > 0)
+    {
+      NS_LOG_ERROR ("FqQueueDisc cannot have internal queues");
+      return false;
+    }
+
+  // we are at initialization time. If the user has not set the quantum
+  // values, set them according to the MTU of the device (if any)
+  if (!m_quantum || !m_initialQuantum)
+    {
+      Ptr<NetDeviceQueueInterface> ndqi = GetNetDeviceQueueInterface ();
+      Ptr<NetDevice> dev;
+      // if the NetDeviceQueueInterface object is aggregated to a
+      // NetDevice, get the MTU of such NetDevice
+      if (ndqi && (dev = ndqi->GetObject<NetDevice> ()))
+        {
+          if (!m_quantum)
+            {
+              m_quantum = 2 * dev->GetMtu ();
+              NS_LOG_DEBUG ("Setting the quantum to twice the MTU of the device: " << m_quantum);
+            }
+          if (!m_initialQuantum)
+            {
+              m_initialQuantum = 10 * dev->GetMtu ();
+              NS_LOG_DEBUG ("Setting the initial quantum to ten times the MTU of the device: " << m_initialQuantum);
+            }
+        }
+
+      if (!m_quantum || !m_initialQuantum)
+        {
+          NS_LOG_ERROR ("The quantum parameters cannot be null");
+          return false;
+        }
+    }
+
+  return true;
+}
+
+void
+FqQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_flowFactory.SetTypeId ("ns3::FqFlow");
+
+  m_queueDiscFactory.SetTypeId ("ns3::FifoQueueDisc");
+  m_queueDiscFactory.Set ("MaxSize", QueueSizeValue (GetMaxSize ()));
+}
+
+} // namespace ns3
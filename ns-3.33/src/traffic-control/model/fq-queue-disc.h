@@ -0,0 +1,283 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * FQ, the Fair Queue packet scheduler
+ *
+ * This implementation is based on linux kernel code by
+ * Authors:     Eric Dumazet <edumazet@google.com>
+ *
+ * Implemented in ns-3 by: SongyangZhang <sonyang.chang@foxmail.com>
+ */
+
+#ifndef FQ_QUEUE_DISC_H
+#define FQ_QUEUE_DISC_H
+
+#include "ns3/queue-disc.h"
+#include "ns3/object-factory.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/data-rate.h"
+#include <list>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A flow queue used by the Fq queue disc
+ */
+class FqFlow : public QueueDiscClass {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief FqFlow constructor
+   */
+  FqFlow ();
+
+  virtual ~FqFlow ();
+
+  /**
+   * \enum FlowStatus
+   * \brief Used to determine the status of this flow queue
+   */
+  enum FlowStatus
+    {
+      INACTIVE,
+      NEW_FLOW,
+      OLD_FLOW,
+      THROTTLED
+    };
+
+  /**
+   * \brief Set the status for this flow
+   * \param status the status for this flow
+   */
+  void SetStatus (FlowStatus status);
+  /**
+   * \brief Get the status of this flow
+   * \return the status of this flow
+   */
+  FlowStatus GetStatus (void) const;
+  /**
+   * \brief Set the credit for this flow
+   * \param credit the credit for this flow
+   */
+  void SetCredit (int32_t credit);
+  /**
+   * \brief Get the credit for this flow
+   * \return the credit for this flow
+   */
+  int32_t GetCredit (void) const;
+  /**
+   * \brief Increase the credit for this flow
+   * \param credit the amount by which the credit is to be increased
+   */
+  void IncreaseCredit (int32_t credit);
+  /**
+   * \brief Set the departure time stamped on the head packet of this flow
+   * \param timeToSend the departure time of the head packet
+   */
+  void SetTimeToSend (Time timeToSend);
+  /**
+   * \brief Get the departure time stamped on the head packet of this flow
+   * \return the departure time of the head packet
+   */
+  Time GetTimeToSend (void) const;
+  /**
+   * \brief Set the time this flow may send its next packet at its pacing rate
+   * \param timeNextPacket the time of the next packet
+   */
+  void SetTimeNextPacket (Time timeNextPacket);
+  /**
+   * \brief Get the time this flow may send its next packet at its pacing rate
+   * \return the time of the next packet
+   */
+  Time GetTimeNextPacket (void) const;
+  /**
+   * \brief Set the time this flow became inactive
+   * \param age the time this flow became inactive
+   */
+  void SetAge (Time age);
+  /**
+   * \brief Get the time this flow became inactive
+   * \return the time this flow became inactive
+   */
+  Time GetAge (void) const;
+  /**
+   * \brief Set the index for this flow
+   * \param index the index for this flow
+   */
+  void SetIndex (uint32_t index);
+  /**
+   * \brief Get the index of this flow
+   * \return the index of this flow
+   */
+  uint32_t GetIndex (void) const;
+
+private:
+  FlowStatus m_status;  //!< the status of this flow
+  int32_t m_credit;     //!< the credit for this flow
+  Time m_timeToSend;    //!< the departure time of the head packet
+  Time m_timeNextPacket; //!< the time of the next packet at the flow pacing rate
+  Time m_age;           //!< the time this flow became inactive
+  uint32_t m_index;     //!< the index for this flow
+};
+
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A Fq packet queue disc
+ *
+ * Packets are classified into per-flow queues, served by deficit round
+ * robin.  Each flow is paced: a packet carrying a DepartureTimeTag is not
+ * released before its earliest departure time (EDT), and packets without
+ * it are spaced according to the PacingRateTag of the sender, capped by
+ * MaxRate.  A flow whose next packet is not due yet is moved to a set of
+ * throttled flows ordered by time, and a single watchdog event restarts
+ * the queue disc when the first of them is due.  Lookup of a flow and of
+ * the next throttled flow is O(log n) in the number of flows.
+ *
+ * As the garbage collection of Linux fq, a flow left empty for longer
+ * than FlowGcAge is forgotten: its class is kept and handed to the next
+ * new flow, so the number of classes is bounded by the number of flows
+ * active at the same time rather than by all the flows ever seen.
+ */
+class FqQueueDisc : public QueueDisc {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief FqQueueDisc constructor
+   */
+  FqQueueDisc ();
+
+  virtual ~FqQueueDisc ();
+
+  /**
+   * \brief Get the number of flows waiting for the departure time of
+   *        their head packet
+   * \return the number of throttled flows
+   */
+  uint32_t GetNThrottledFlows (void) const;
+
+  /**
+   * \brief Get the number of flows known to the queue disc, including
+   *        the inactive flows not reclaimed yet
+   * \return the number of flows
+   */
+  uint32_t GetNFlows (void) const;
+
+  /**
+   * \brief Set the quantum value.
+   *
+   * \param quantum The number of bytes each flow gets to dequeue on each round of the scheduling algorithm
+   */
+  void SetQuantum (uint32_t quantum);
+
+  /**
+   * \brief Get the quantum value.
+   *
+   * \returns The number of bytes each flow gets to dequeue on each round of the scheduling algorithm
+   */
+  uint32_t GetQuantum (void) const;
+
+  // Reasons for dropping packets
+  static constexpr const char* UNCLASSIFIED_DROP = "Unclassified drop";  //!< No packet filter able to classify packet
+  static constexpr const char* OVERLIMIT_DROP = "Overlimit drop";        //!< Overlimit dropped packets
+  static constexpr const char* HORIZON_DROP = "Horizon drop";            //!< Departure time too far in the future
+  static constexpr const char* FLOW_LIMIT_DROP = "Flow limit drop";      //!< Flow queue full
+
+protected:
+  /**
+   * \brief Dispose of the object
+   */
+  virtual void DoDispose (void);
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  /**
+   * \brief Get the earliest departure time of a packet
+   * \param item the packet
+   * \return the time stamped by the sender, or zero if the packet is not paced
+   */
+  Time GetDepartureTime (Ptr<const QueueDiscItem> item) const;
+  /**
+   * \brief Move the flows whose head packet is due back to the old flows
+   * \param now the current time
+   */
+  void CheckThrottled (Time now);
+  /**
+   * \brief Schedule the watchdog for the earliest throttled flow, if any
+   */
+  void ArmWatchdog (void);
+  /**
+   * \brief Update the pacing state of a flow after dequeuing a packet
+   * \param flow the flow
+   * \param item the dequeued packet
+   * \param now the current time
+   */
+  void UpdatePacing (Ptr<FqFlow> flow, Ptr<const QueueDiscItem> item, Time now);
+  /**
+   * \brief Reclaim the flows inactive for longer than the gc age
+   * \param now the current time
+   */
+  void CollectIdleFlows (Time now);
+
+  uint32_t m_perturbation;   //!< hash perturbation value
+  uint32_t m_quantum;        //!< Credit assigned to flows at each round
+  uint32_t m_initialQuantum; //!< Credit assigned to new flows
+  uint32_t m_flowLimit;      //!< Max number of packets per flow
+  Time m_flowRefillDelay;    //!< Idle time after which a flow gets at least a quantum of credit
+  bool m_rateEnable;         //!< Whether flows are paced at their pacing rate
+  DataRate m_maxRate;        //!< Max pacing rate of a flow, zero for no limit
+  DataRate m_lowRateThreshold; //!< Flows paced below this rate are paced per packet
+  Time m_horizon;            //!< Packets departing later than now plus horizon are not accepted
+  bool m_horizonDrop;        //!< Drop packets beyond the horizon, instead of capping their departure time
+  Time m_gcAge;              //!< Idle time after which an inactive flow is reclaimed
+
+  std::list<Ptr<FqFlow> > m_newFlows;    //!< The list of new flows
+  std::list<Ptr<FqFlow> > m_oldFlows;    //!< The list of old flows
+  std::multimap<Time, Ptr<FqFlow> > m_throttled; //!< Throttled flows, ordered by departure time
+
+  std::map<uint32_t, uint32_t> m_flowsIndices;    //!< Map with the index of class for each flow
+  std::list<std::pair<Time, Ptr<FqFlow> > > m_idleFlows; //!< Flows made inactive, by time
+  std::vector<uint32_t> m_freeClasses;             //!< Indices of the classes of reclaimed flows
+
+  EventId m_watchdog;        //!< Event restarting the queue disc when a throttled flow is due
+  Time m_watchdogTime;       //!< Expiration time of the watchdog
+
+  ObjectFactory m_flowFactory;         //!< Factory to create a new flow
+  ObjectFactory m_queueDiscFactory;    //!< Factory to create a new queue
+};
+
+} // namespace ns3
+
+#endif /* FQ_QUEUE_DISC_H */
@@ -0,0 +1,577 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021 Northeastern University, China
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: SongyangZhang <sonyang.chang@foxmail.com>
+ */
+
+#include "ns3/test.h"
+#include "ns3/fq-queue-disc.h"
+#include "ns3/departure-time-tag.h"
+#include "ns3/pacing-rate-tag.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/traffic-control-layer.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Fq Queue Disc Test Item
+ */
+class FqQueueDiscTestItem : public QueueDiscItem {
+public:
+  /**
+   * Constructor
+   *
+   * \param p the packet
+   * \param addr the address
+   * \param hash the flow hash
+   */
+  FqQueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint32_t hash);
+  virtual ~FqQueueDiscTestItem ();
+  virtual void AddHeader (void);
+  virtual bool Mark (void);
+  virtual uint32_t Hash (uint32_t perturbation) const;
+
+private:
+  FqQueueDiscTestItem ();
+  /**
+   * \brief Copy constructor
+   * Disable default implementation to avoid misuse
+   */
+  FqQueueDiscTestItem (const FqQueueDiscTestItem &);
+  /**
+   * \brief Assignment operator
+   * \return this object
+   * Disable default implementation to avoid misuse
+   */
+  FqQueueDiscTestItem &operator = (const FqQueueDiscTestItem &);
+  uint32_t m_hash; ///< the flow hash
+};
+
+FqQueueDiscTestItem::FqQueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint32_t hash)
+  : QueueDiscItem (p, addr, 0),
+    m_hash (hash)
+{
+}
+
+FqQueueDiscTestItem::~FqQueueDiscTestItem ()
+{
+}
+
+void
+FqQueueDiscTestItem::AddHeader (void)
+{
+}
+
+bool
+FqQueueDiscTestItem::Mark (void)
+{
+  return false;
+}
+
+uint32_t
+FqQueueDiscTestItem::Hash (uint32_t perturbation) const
+{
+  return m_hash;
+}
+
+/**
+ * Create a test item, stamped with the given departure time if not null
+ * \param size the packet size
+ * \param hash the flow hash
+ * \param departure the departure time
+ * \param dest the destination address
+ * \return the item
+ */
+static Ptr<QueueDiscItem>
+CreateTestItem (uint32_t size, uint32_t hash, Time departure, Address dest = Address ())
+{
+  Ptr<Packet> p = Create<Packet> (size);
+  if (!departure.IsZero ())
+    {
+      p->AddPacketTag (DepartureTimeTag (departure));
+    }
+  return Create<FqQueueDiscTestItem> (p, dest, hash);
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Packets are released no earlier than their departure time
+ */
+class FqQueueDiscEdtTestCase : public TestCase
+{
+public:
+  FqQueueDiscEdtTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Dequeue a packet and check it belongs to the expected flow
+   * \param queue the queue disc
+   * \param hash the expected flow hash, or 0 if no packet is expected
+   * \param throttled the expected number of throttled flows after dequeue
+   */
+  void DequeueAndCheck (Ptr<FqQueueDisc> queue, uint32_t hash, uint32_t throttled);
+};
+
+FqQueueDiscEdtTestCase::FqQueueDiscEdtTestCase ()
+  : TestCase ("Check that FqQueueDisc honours the earliest departure time")
+{
+}
+
+void
+FqQueueDiscEdtTestCase::DequeueAndCheck (Ptr<FqQueueDisc> queue, uint32_t hash, uint32_t throttled)
+{
+  Ptr<QueueDiscItem> item = queue->Dequeue ();
+  if (hash == 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((item == 0), true, "No packet should be due at " << Simulator::Now ());
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ ((item != 0), true, "A packet should be due at " << Simulator::Now ());
+      if (item)
+        {
+          NS_TEST_EXPECT_MSG_EQ (item->Hash (0), hash, "Packet from the wrong flow");
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNThrottledFlows (), throttled, "Wrong number of throttled flows");
+}
+
+void
+FqQueueDiscEdtTestCase::DoRun (void)
+{
+  Ptr<FqQueueDisc> queue = CreateObject<FqQueueDisc> ();
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("Horizon", TimeValue (Seconds (1))), true,
+                         "Verify that we can actually set the attribute Horizon");
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("Quantum", UintegerValue (3000)), true,
+                         "Verify that we can actually set the attribute Quantum");
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("InitialQuantum", UintegerValue (15000)), true,
+                         "Verify that we can actually set the attribute InitialQuantum");
+  queue->Initialize ();
+
+  // flow 1 is paced, flow 2 is not
+  queue->Enqueue (CreateTestItem (1000, 1, MilliSeconds (10)));
+  queue->Enqueue (CreateTestItem (1000, 1, MilliSeconds (20)));
+  queue->Enqueue (CreateTestItem (1000, 2, Time (0)));
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 3, "There should be three packets in there");
+
+  // beyond the horizon
+  queue->Enqueue (CreateTestItem (1000, 3, Seconds (2)));
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 3, "The packet beyond the horizon should be dropped");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetStats ().GetNDroppedPackets (FqQueueDisc::HORIZON_DROP), 1,
+                         "The packet beyond the horizon should be dropped");
+
+  Simulator::Schedule (Time (0), &FqQueueDiscEdtTestCase::DequeueAndCheck, this, queue, 2, 1);
+  Simulator::Schedule (Time (0), &FqQueueDiscEdtTestCase::DequeueAndCheck, this, queue, 0, 1);
+  Simulator::Schedule (MilliSeconds (10), &FqQueueDiscEdtTestCase::DequeueAndCheck, this, queue, 1, 0);
+  Simulator::Schedule (MilliSeconds (15), &FqQueueDiscEdtTestCase::DequeueAndCheck, this, queue, 0, 1);
+  Simulator::Schedule (MilliSeconds (20), &FqQueueDiscEdtTestCase::DequeueAndCheck, this, queue, 1, 0);
+  Simulator::Schedule (MilliSeconds (25), &FqQueueDiscEdtTestCase::DequeueAndCheck, this, queue, 0, 0);
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 0, "All the packets should have been dequeued");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Paced packets are sent by the watchdog at their departure time
+ */
+class FqQueueDiscWatchdogTestCase : public TestCase
+{
+public:
+  FqQueueDiscWatchdogTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Receive callback of the receiving device
+   * \param device the device
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \return true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+  uint32_t m_received; ///< number of received packets
+};
+
+FqQueueDiscWatchdogTestCase::FqQueueDiscWatchdogTestCase ()
+  : TestCase ("Check that FqQueueDisc sends paced packets at their departure time"),
+    m_received (0)
+{
+}
+
+bool
+FqQueueDiscWatchdogTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  DepartureTimeTag tag;
+  bool found = p->PeekPacketTag (tag);
+  NS_TEST_EXPECT_MSG_EQ (found, true, "Packet lost its departure time");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), tag.GetDepartureTime (), "Packet not sent at its departure time");
+  m_received++;
+  return true;
+}
+
+void
+FqQueueDiscWatchdogTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice> ();
+  nodes.Get (0)->AddDevice (txDev);
+  Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice> ();
+  nodes.Get (1)->AddDevice (rxDev);
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  txDev->SetChannel (channel);
+  rxDev->SetChannel (channel);
+  txDev->SetNode (nodes.Get (0));
+  rxDev->SetNode (nodes.Get (1));
+  rxDev->SetReceiveCallback (MakeCallback (&FqQueueDiscWatchdogTestCase::Receive, this));
+
+  Ptr<FqQueueDisc> queue = CreateObject<FqQueueDisc> ();
+  queue->SetAttribute ("Quantum", UintegerValue (3000));
+  queue->SetAttribute ("InitialQuantum", UintegerValue (15000));
+  Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer> ();
+  nodes.Get (0)->AggregateObject (tc);
+  tc->SetRootQueueDiscOnDevice (txDev, queue);
+  tc->Initialize ();
+
+  // two flows pacing 1000 byte packets every 1ms and 3ms
+  for (uint32_t i = 1; i <= 10; i++)
+    {
+      tc->Send (txDev, CreateTestItem (1000, 1, MilliSeconds (i), rxDev->GetAddress ()));
+      tc->Send (txDev, CreateTestItem (1000, 2, MilliSeconds (3 * i), rxDev->GetAddress ()));
+    }
+
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, 20, "All the paced packets should have been sent");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 0, "All the packets should have been dequeued");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Flows are served by deficit round robin and limited in size
+ */
+class FqQueueDiscQuantumTestCase : public TestCase
+{
+public:
+  FqQueueDiscQuantumTestCase ();
+  virtual void DoRun (void);
+};
+
+FqQueueDiscQuantumTestCase::FqQueueDiscQuantumTestCase ()
+  : TestCase ("Check the quantum, initial quantum and flow limit of FqQueueDisc")
+{
+}
+
+void
+FqQueueDiscQuantumTestCase::DoRun (void)
+{
+  Ptr<FqQueueDisc> queue = CreateObject<FqQueueDisc> ();
+  queue->SetAttribute ("Quantum", UintegerValue (2000));
+  queue->SetAttribute ("InitialQuantum", UintegerValue (3000));
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("FlowLimit", UintegerValue (6)), true,
+                         "Verify that we can actually set the attribute FlowLimit");
+  queue->Initialize ();
+
+  for (uint32_t i = 0; i < 7; i++)
+    {
+      queue->Enqueue (CreateTestItem (1000, 1, Time (0)));
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 6, "The flow limit should have been enforced");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetStats ().GetNDroppedPackets (FqQueueDisc::FLOW_LIMIT_DROP), 1,
+                         "The packet beyond the flow limit should be dropped");
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      queue->Enqueue (CreateTestItem (1000, 2, Time (0)));
+    }
+
+  // new flows send their initial quantum first, then a quantum per round
+  uint32_t expected[] = {1, 1, 1, 2, 2, 2, 1, 1, 2, 2, 1, 2};
+  for (uint32_t i = 0; i < 12; i++)
+    {
+      Ptr<QueueDiscItem> item = queue->Dequeue ();
+      NS_TEST_ASSERT_MSG_EQ ((item != 0), true, "There should be a packet to dequeue");
+      NS_TEST_EXPECT_MSG_EQ (item->Hash (0), expected[i], "Packet " << i << " dequeued from the wrong flow");
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 0, "All the packets should have been dequeued");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Unstamped packets are paced at the pacing rate of their flow
+ */
+class FqQueueDiscPacingRateTestCase : public TestCase
+{
+public:
+  FqQueueDiscPacingRateTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Dequeue a packet and check whether one is expected
+   * \param queue the queue disc
+   * \param flag whether a packet is expected
+   */
+  void DequeueAndCheck (Ptr<FqQueueDisc> queue, bool flag);
+};
+
+FqQueueDiscPacingRateTestCase::FqQueueDiscPacingRateTestCase ()
+  : TestCase ("Check that FqQueueDisc paces flows at their pacing rate")
+{
+}
+
+void
+FqQueueDiscPacingRateTestCase::DequeueAndCheck (Ptr<FqQueueDisc> queue, bool flag)
+{
+  Ptr<QueueDiscItem> item = queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_EQ ((item != 0), flag, "Unexpected dequeue result at " << Simulator::Now ());
+}
+
+void
+FqQueueDiscPacingRateTestCase::DoRun (void)
+{
+  Ptr<FqQueueDisc> queue = CreateObject<FqQueueDisc> ();
+  queue->SetAttribute ("Quantum", UintegerValue (1000));
+  queue->SetAttribute ("InitialQuantum", UintegerValue (1000));
+  queue->Initialize ();
+
+  // 1000 byte packets at 8Mbps leave 1ms apart, then the sender halves its rate
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Ptr<QueueDiscItem> item = CreateTestItem (1000, 1, Time (0));
+      item->GetPacket ()->AddPacketTag (PacingRateTag (DataRate (i < 3 ? "8Mbps" : "4Mbps")));
+      queue->Enqueue (item);
+    }
+
+  Simulator::Schedule (Time (0), &FqQueueDiscPacingRateTestCase::DequeueAndCheck, this, queue, true);
+  Simulator::Schedule (Time (0), &FqQueueDiscPacingRateTestCase::DequeueAndCheck, this, queue, false);
+  Simulator::Schedule (MicroSeconds (500), &FqQueueDiscPacingRateTestCase::DequeueAndCheck, this, queue, false);
+  Simulator::Schedule (MilliSeconds (1), &FqQueueDiscPacingRateTestCase::DequeueAndCheck, this, queue, true);
+  Simulator::Schedule (MilliSeconds (2), &FqQueueDiscPacingRateTestCase::DequeueAndCheck, this, queue, true);
+  Simulator::Schedule (MilliSeconds (3), &FqQueueDiscPacingRateTestCase::DequeueAndCheck, this, queue, true);
+  Simulator::Schedule (MilliSeconds (4), &FqQueueDiscPacingRateTestCase::DequeueAndCheck, this, queue, false);
+  Simulator::Schedule (MilliSeconds (5), &FqQueueDiscPacingRateTestCase::DequeueAndCheck, this, queue, true);
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 0, "All the packets should have been dequeued");
+
+  // the max rate of the queue disc caps the pacing rate of the sender
+  queue = CreateObject<FqQueueDisc> ();
+  queue->SetAttribute ("Quantum", UintegerValue (1000));
+  queue->SetAttribute ("InitialQuantum", UintegerValue (1000));
+  queue->SetAttribute ("MaxRate", DataRateValue (DataRate ("4Mbps")));
+  queue->Initialize ();
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<QueueDiscItem> item = CreateTestItem (1000, 1, Time (0));
+      item->GetPacket ()->AddPacketTag (PacingRateTag (DataRate ("8Mbps")));
+      queue->Enqueue (item);
+    }
+  Time now = Simulator::Now ();
+  Simulator::Schedule (Time (0), &FqQueueDiscPacingRateTestCase::DequeueAndCheck, this, queue, true);
+  Simulator::Schedule (MilliSeconds (1), &FqQueueDiscPacingRateTestCase::DequeueAndCheck, this, queue, false);
+  Simulator::Schedule (MilliSeconds (2), &FqQueueDiscPacingRateTestCase::DequeueAndCheck, this, queue, true);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now () - now, MilliSeconds (2), "Unexpected end of the simulation");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Many flows are served without loss
+ */
+class FqQueueDiscManyFlowsTestCase : public TestCase
+{
+public:
+  FqQueueDiscManyFlowsTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Send callback of the queue disc
+   * \param item the packet sent by the watchdog
+   */
+  void Send (Ptr<QueueDiscItem> item);
+  uint32_t m_sent; ///< number of packets sent by the watchdog
+};
+
+FqQueueDiscManyFlowsTestCase::FqQueueDiscManyFlowsTestCase ()
+  : TestCase ("Check that FqQueueDisc handles many paced flows"),
+    m_sent (0)
+{
+}
+
+void
+FqQueueDiscManyFlowsTestCase::Send (Ptr<QueueDiscItem> item)
+{
+  m_sent++;
+}
+
+void
+FqQueueDiscManyFlowsTestCase::DoRun (void)
+{
+  Ptr<FqQueueDisc> queue = CreateObject<FqQueueDisc> ();
+  queue->SetAttribute ("Quantum", UintegerValue (3000));
+  queue->SetAttribute ("InitialQuantum", UintegerValue (15000));
+  queue->SetAttribute ("MaxSize", QueueSizeValue (QueueSize ("20000p")));
+  queue->SetSendCallback (MakeCallback (&FqQueueDiscManyFlowsTestCase::Send, this));
+  queue->Initialize ();
+
+  const uint32_t nFlows = 10000;
+  for (uint32_t i = 1; i <= nFlows; i++)
+    {
+      queue->Enqueue (CreateTestItem (1000, i, Time (0)));
+      queue->Enqueue (CreateTestItem (1000, i, MicroSeconds (i)));
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 2 * nFlows, "All the packets should have been enqueued");
+
+  // the unstamped packets leave first, then a flow is due every microsecond
+  uint32_t dequeued = 0;
+  while (queue->Dequeue ())
+    {
+      dequeued++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (dequeued, nFlows, "Only the packets due now should be dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNThrottledFlows (), nFlows, "All the flows should be throttled");
+
+  // the watchdog sends the paced packets as they become due
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_sent, nFlows, "All the paced packets should have been sent");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), MicroSeconds (nFlows), "The last packet should be sent on time");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 0, "All the packets should have been dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNThrottledFlows (), 0, "No flow should be throttled");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Flows idle for longer than the gc age are reclaimed
+ */
+class FqQueueDiscGcTestCase : public TestCase
+{
+public:
+  FqQueueDiscGcTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Enqueue a packet in each of the given flows, then dequeue all the packets
+   * \param queue the queue disc
+   * \param first the hash of the first flow
+   * \param last the hash of the last flow
+   */
+  void EnqueueAndDrain (Ptr<FqQueueDisc> queue, uint32_t first, uint32_t last);
+  /**
+   * Check the number of flows and of classes of the queue disc
+   * \param queue the queue disc
+   * \param flows the expected number of flows
+   * \param classes the expected number of classes
+   */
+  void CheckFlows (Ptr<FqQueueDisc> queue, uint32_t flows, uint32_t classes);
+};
+
+FqQueueDiscGcTestCase::FqQueueDiscGcTestCase ()
+  : TestCase ("Check that FqQueueDisc reclaims idle flows")
+{
+}
+
+void
+FqQueueDiscGcTestCase::EnqueueAndDrain (Ptr<FqQueueDisc> queue, uint32_t first, uint32_t last)
+{
+  for (uint32_t i = first; i <= last; i++)
+    {
+      queue->Enqueue (CreateTestItem (1000, i, Time (0)));
+    }
+  while (queue->Dequeue ())
+    {
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 0, "All the packets should have been dequeued");
+}
+
+void
+FqQueueDiscGcTestCase::CheckFlows (Ptr<FqQueueDisc> queue, uint32_t flows, uint32_t classes)
+{
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNFlows (), flows, "Wrong number of flows at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNQueueDiscClasses (), classes, "Wrong number of classes at " << Simulator::Now ());
+}
+
+void
+FqQueueDiscGcTestCase::DoRun (void)
+{
+  Ptr<FqQueueDisc> queue = CreateObject<FqQueueDisc> ();
+  queue->SetAttribute ("Quantum", UintegerValue (1000));
+  queue->SetAttribute ("InitialQuantum", UintegerValue (1000));
+  queue->SetAttribute ("FlowGcAge", TimeValue (Seconds (3)));
+  queue->Initialize ();
+
+  // flows 1 to 100 go idle at once, flow 1 is active again at 2s: when
+  // flows 101 to 200 arrive at 4s, flows 2 to 100 are reclaimed and their
+  // classes reused, flow 1 is kept and one more class is needed
+  Simulator::Schedule (Time (0), &FqQueueDiscGcTestCase::EnqueueAndDrain, this, queue, 1, 100);
+  Simulator::Schedule (Time (0), &FqQueueDiscGcTestCase::CheckFlows, this, queue, 100, 100);
+  Simulator::Schedule (Seconds (2), &FqQueueDiscGcTestCase::EnqueueAndDrain, this, queue, 1, 1);
+  Simulator::Schedule (Seconds (4), &FqQueueDiscGcTestCase::EnqueueAndDrain, this, queue, 101, 200);
+  Simulator::Schedule (Seconds (4), &FqQueueDiscGcTestCase::CheckFlows, this, queue, 101, 101);
+  // everything is reclaimed at last, without a new class
+  Simulator::Schedule (Seconds (10), &FqQueueDiscGcTestCase::EnqueueAndDrain, this, queue, 201, 201);
+  Simulator::Schedule (Seconds (10), &FqQueueDiscGcTestCase::CheckFlows, this, queue, 1, 101);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Fq Queue Disc Test Suite
+ */
+static class FqQueueDiscTestSuite : public TestSuite
+{
+public:
+  FqQueueDiscTestSuite ()
+    : TestSuite ("fq-queue-disc", UNIT)
+  {
+    AddTestCase (new FqQueueDiscEdtTestCase (), TestCase::QUICK);
+    AddTestCase (new FqQueueDiscWatchdogTestCase (), TestCase::QUICK);
+    AddTestCase (new FqQueueDiscQuantumTestCase (), TestCase::QUICK);
+    AddTestCase (new FqQueueDiscPacingRateTestCase (), TestCase::QUICK);
+    AddTestCase (new FqQueueDiscManyFlowsTestCase (), TestCase::QUICK);
+    AddTestCase (new FqQueueDiscGcTestCase (), TestCase::QUICK);
+  }
+} g_fqQueueTestSuite; ///< the test suite
@@ -158,7 +158,8 @@ YansWavePhyHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bo
       filename = pcapHelper.GetFilenameFromDevice (prefix, device);
     }
 
-  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, GetPcapDataLinkType ());
+  Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out, GetPcapDataLinkType (),
+                                                     GetCaptureFilter ());
 
   std::vector<Ptr<WifiPhy> >::iterator i;
   for (i = phys.begin (); i != phys.end (); ++i)
@@ -32,6 +32,7 @@
 #include <stdlib.h> // for exit ()
 #include <limits>
 #include <algorithm>
+#include <vector>
 
 using namespace ns3;
 
@@ -328,6 +329,23 @@ benchByteTags (uint32_t n)
     }
 }
 
+static void
+benchAllocate (uint32_t n)
+{
+  BenchTag<16> tag;
+
+  // A window of packets in flight, as in a TCP sender, so the packets,
+  // their tags and their buffers are taken from and released to the
+  // free lists rather than handed back and forth one by one
+  const uint32_t window = 64;
+  std::vector<Ptr<Packet> > inFlight (window);
+  for (uint32_t i = 0; i < n; i++) {
+    Ptr<Packet> p = Create<Packet> (1448);
+    p->AddPacketTag (tag);
+    inFlight[i % window] = p;
+  }
+}
+
 static uint64_t
 runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
 {
@@ -385,6 +403,7 @@ int main (int argc, char *argv[])
   runBench (&benchD, n, minIterations, "Intermixed add/remove headers and tags");
   runBench (&benchFragment, n, minIterations, "Fragmentation and concatenation");
   runBench (&benchByteTags, n, minIterations, "Benchmark byte tags");
+  runBench (&benchAllocate, n, minIterations, "Allocate and release tagged packets");
 
   return 0;
 }